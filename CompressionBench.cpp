@@ -0,0 +1,185 @@
+#if !defined(USE_HAL_DRIVER)
+#include "CompressionBench.h"
+#include "MemoryFileStore.h"
+#include "SimulatedBus.h"
+#include "com_protocol_upload.h"
+#include "crc16.h"
+#include "lzss.h"
+#include <math.h>
+#include <string.h>
+#include <chrono>
+#include <random>
+#include <string>
+
+namespace {
+
+const uint16_t HOST_ID = 1;
+const uint16_t NODE_ID = 2;
+const uint64_t NS_PER_MS = 1000000ULL;
+const int MOTION_MOTORS = 32;
+const int MOTION_FRAMES = 8000;
+const int CONFIG_LINES = 3000;
+const size_t RANDOM_BYTES = 256 * 1024;
+
+double secondsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+// 노드의 decompressFileData 와 같은 경로 : 64 바이트 출력마다 누적 CRC16 후 기록
+struct NodeSink {
+    uint8_t* out;
+    size_t position;
+    size_t capacity;
+    uint16_t checksum;
+
+    bool operator()(const uint8_t* chunk, size_t n) {
+        if (n > capacity - position) return false;
+        checksum = crc16XModemUpdate(checksum, chunk, n);
+        memcpy(out + position, chunk, n);
+        position += n;
+        return true;
+    }
+};
+
+// 압축 없이/LZSS 로 한 번 업로드하고 버스 시간(초)을 반환 (실패 시 음수)
+double timeUpload(const CompressionBenchConfig& config, const uint8_t* data, size_t size, FileCodec codec,
+                  bool& lzssUsed) {
+    SimulatedBusConfig busConfig;
+    busConfig.baudRate = config.baudRate;
+    SimulatedBus bus(busConfig);
+    AsyncCom_Protocol host(bus.addEndpoint(), bus.tick(), HOST_ID);
+    Com_Protocol node(bus.addEndpoint(), bus.tick(), NODE_ID);
+    MemoryFileStore store;
+    node.setFileStore(&store);
+    std::vector<Com_Protocol*> nodes;
+    nodes.push_back(&host);
+    nodes.push_back(&node);
+
+    FileUploadOptions options;
+    options.codec = codec;
+    options.dedup = false;
+    FileUploadResult result;
+    const uint64_t startNs = bus.nowNs();
+    const uint64_t deadline = startNs + config.uploadLimitMs * NS_PER_MS;
+    uploadFile(host, NODE_ID, data, static_cast<uint32_t>(size), options, result);
+    while (!result.done && bus.nowNs() < deadline) {
+        bus.run(nodes, NS_PER_MS);
+        host.poll();
+    }
+    if (!result.ok || store.current() != std::vector<uint8_t>(data, data + size)) return -1.0;
+    lzssUsed = result.codec == FileCodec::LZSS;
+    return static_cast<double>(bus.nowNs() - startNs) / 1e9;
+}
+
+} // namespace
+
+std::vector<uint8_t> makeCompressionSample(CompressionSample sample) {
+    std::vector<uint8_t> file;
+    switch (sample) {
+        case CompressionSample::MOTION: {
+            // 모터마다 20~219 프레임에 걸쳐 다음 목표로 선형 이동, 1/3 은 제자리 유지
+            std::mt19937 rng(11);
+            std::vector<double> position(MOTION_MOTORS, 0.0);
+            std::vector<double> target(MOTION_MOTORS, 0.0);
+            std::vector<int> remaining(MOTION_MOTORS, 0);
+            file.reserve(MOTION_MOTORS * MOTION_FRAMES * 2);
+            for (int frame = 0; frame < MOTION_FRAMES; frame++) {
+                for (int motor = 0; motor < MOTION_MOTORS; motor++) {
+                    if (remaining[motor] == 0) {
+                        remaining[motor] = 20 + static_cast<int>(rng() % 200);
+                        target[motor] = (rng() % 3 == 0) ? position[motor] : static_cast<int>(rng() % 4096) - 2048;
+                    }
+                    position[motor] += (target[motor] - position[motor]) / remaining[motor];
+                    remaining[motor]--;
+                    int16_t value = static_cast<int16_t>(lround(position[motor]));
+                    file.push_back(static_cast<uint8_t>(static_cast<uint16_t>(value) >> 8));
+                    file.push_back(static_cast<uint8_t>(value & 0xFF));
+                }
+            }
+            break;
+        }
+        case CompressionSample::CONFIG: {
+            std::mt19937 rng(2);
+            std::string text;
+            for (int i = 0; i < CONFIG_LINES; i++) {
+                text += "motor." + std::to_string(i % 64) + ".param" + std::to_string(i % 17) + " = " +
+                        std::to_string(rng() % 10000) + "\n";
+            }
+            file.assign(text.begin(), text.end());
+            break;
+        }
+        case CompressionSample::RANDOM: {
+            std::mt19937 rng(3);
+            file.resize(RANDOM_BYTES);
+            for (size_t i = 0; i < file.size(); i++) file[i] = static_cast<uint8_t>(rng());
+            break;
+        }
+    }
+    return file;
+}
+
+const char* compressionSampleName(CompressionSample sample) {
+    switch (sample) {
+        case CompressionSample::MOTION: return "motion";
+        case CompressionSample::CONFIG: return "config";
+        case CompressionSample::RANDOM: return "random";
+    }
+    return "unknown";
+}
+
+CompressionBenchResult runCompressionBench(const CompressionBenchConfig& config, const uint8_t* data, size_t size) {
+    CompressionBenchResult result;
+    result.fileBytes = size;
+    if (data == nullptr || size == 0) return result;
+
+    // 업로드와 같은 블록 나눔 : 블록 한도에 들어가는 만큼 입력 사용
+    std::vector<uint8_t> packed;
+    std::vector<size_t> blockSizes;
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    for (size_t offset = 0; offset < size;) {
+        uint8_t block[FileUploadOptions::MAX_BLOCK_SIZE];
+        size_t input = size - offset < FileUploadOptions::MAX_PACKED_INPUT ? size - offset :
+                       FileUploadOptions::MAX_PACKED_INPUT;
+        size_t consumed = 0;
+        size_t n = LzssEncoder::compress(data + offset, input, block, sizeof(block), consumed);
+        if (consumed == 0) return result;
+        packed.insert(packed.end(), block, block + n);
+        blockSizes.push_back(n);
+        offset += consumed;
+    }
+    double compressSeconds = secondsSince(start);
+    result.packedBytes = packed.size();
+
+    std::vector<uint8_t> restored(size);
+    NodeSink sink = { restored.data(), 0, size, 0 };
+    const uint32_t rounds = config.decodeRounds > 0 ? config.decodeRounds : 1;
+    start = std::chrono::steady_clock::now();
+    for (uint32_t round = 0; round < rounds; round++) {
+        sink.position = 0;
+        sink.checksum = 0;
+        size_t packedOffset = 0;
+        for (size_t n : blockSizes) {
+            LzssDecoder decoder;
+            if (!decoder.decode(packed.data() + packedOffset, n, sink)) return result;
+            packedOffset += n;
+        }
+    }
+    double decompressSeconds = secondsSince(start) / rounds;
+    if (sink.position != size || memcmp(restored.data(), data, size) != 0 ||
+        sink.checksum != crc16XModem(data, size)) {
+        return result;
+    }
+
+    const double bytes = static_cast<double>(size);
+    result.compressMBps = compressSeconds > 0.0 ? bytes / 1e6 / compressSeconds : 0.0;
+    result.decompressMBps = decompressSeconds > 0.0 ? bytes / 1e6 / decompressSeconds : 0.0;
+    result.decompressNsPerByte = decompressSeconds * 1e9 / bytes;
+
+    bool rawCodec = false;
+    result.rawUploadSeconds = timeUpload(config, data, size, FileCodec::NONE, rawCodec);
+    result.lzssUploadSeconds = timeUpload(config, data, size, FileCodec::LZSS, result.lzssUsed);
+    result.ok = result.rawUploadSeconds >= 0.0 && result.lzssUploadSeconds >= 0.0;
+    return result;
+}
+
+#endif
@@ -0,0 +1,56 @@
+#ifndef COMPRESSION_BENCH_H_
+#define COMPRESSION_BENCH_H_
+
+#if !defined(USE_HAL_DRIVER)
+#include <stdint.h>
+#include <stddef.h>
+#include <vector>
+
+/*
+ * LZSS 블록 압축 측정 (호스트 전용)
+ *
+ *  업로드와 같은 방식(블록 한도 MAX_BLOCK_SIZE, 입력 최대 MAX_PACKED_INPUT)으로 파일을 블록별로 압축하고
+ *  노드와 같은 방식(블록마다 새 LzssDecoder, 64 바이트씩 CRC16 누적 후 기록)으로 복원해 시간을 잽니다.
+ *  이어서 SimulatedBus 위 1:1 링크에서 uploadFile 을 압축 없이/LZSS 로 한 번씩 보내 시뮬레이션 시간을 비교합니다.
+ *
+ *  - compress / decompress : 호스트 CPU 시간 (decompress 는 decodeRounds 번 평균, MCU 에서는 클럭 비례로 더 느림)
+ *  - upload : 버스 시간 (REQUEST_RECEIVE ~ VERIFY_CHECKSUM ACK, dedup 끔)
+ *
+ *  std::vector<uint8_t> file = makeCompressionSample(CompressionSample::MOTION);
+ *  CompressionBenchConfig config;
+ *  CompressionBenchResult r = runCompressionBench(config, file.data(), file.size());
+ *  printf("%.1f%% %.2f -> %.2f s\n", 100.0 * r.packedBytes / r.fileBytes, r.rawUploadSeconds, r.lzssUploadSeconds);
+ */
+
+enum class CompressionSample : uint8_t {
+    MOTION,     // 32 모터 x 8000 프레임 int16 위치 (키프레임 보간, 정지 구간 포함), 500KB
+    CONFIG,     // "motor.N.paramM = V" 텍스트 3000 줄
+    RANDOM      // 무작위 256KB (압축 없이 보내야 함)
+};
+
+struct CompressionBenchConfig {
+    uint32_t baudRate = 115200;
+    uint32_t decodeRounds = 20;
+    uint32_t uploadLimitMs = 600000;    // 시뮬레이션 시간 상한 (넘으면 ok = false)
+};
+
+struct CompressionBenchResult {
+    bool ok = false;                    // 복원 결과와 두 업로드의 노드 파일이 원본과 같음
+    size_t fileBytes = 0;
+    size_t packedBytes = 0;             // 블록별 압축 결과 합
+    double compressMBps = 0.0;
+    double decompressMBps = 0.0;
+    double decompressNsPerByte = 0.0;   // 복원된 바이트 기준
+    double rawUploadSeconds = 0.0;
+    double lzssUploadSeconds = 0.0;
+    bool lzssUsed = false;              // LZSS 업로드가 실제로 압축해 보냄 (95% 이상이면 압축 없이 보냄)
+};
+
+std::vector<uint8_t> makeCompressionSample(CompressionSample sample);
+
+CompressionBenchResult runCompressionBench(const CompressionBenchConfig& config, const uint8_t* data, size_t size);
+
+const char* compressionSampleName(CompressionSample sample);
+
+#endif
+#endif /* COMPRESSION_BENCH_H_ */
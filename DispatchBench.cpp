@@ -0,0 +1,173 @@
+#if !defined(USE_HAL_DRIVER)
+#include "DispatchBench.h"
+#include "com_protocol_class.h"
+#include "crc16.h"
+#include "payload_schema.h"
+#include <chrono>
+#include <vector>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+namespace {
+
+const uint16_t NODE_ID = 1;
+const uint16_t HOST_ID = 2;
+const uint16_t CMD_PING = 0x0001;
+const uint16_t CMD_CONFIG = 0x0003;
+const size_t CONFIG_PAYLOAD_LENGTH = 32;
+
+// 두 엔진이 같은 스트림을 읽는 메모리 전송 (응답은 바이트 수만 셈)
+struct BenchBuffer {
+    const std::vector<uint8_t>* stream;
+    size_t position;
+    uint64_t written;
+};
+
+size_t readBuffer(BenchBuffer& buffer, uint8_t* out, size_t length) {
+    size_t n = 0;
+    const std::vector<uint8_t>& stream = *buffer.stream;
+    while (n < length && buffer.position < stream.size()) out[n++] = stream[buffer.position++];
+    return n;
+}
+
+class VirtualSerial : public ISerialInterface {
+public:
+    explicit VirtualSerial(BenchBuffer* buffer) : buffer_(buffer) {}
+
+    virtual void init() override {}
+    virtual bool open() override { return true; }
+    virtual void close() override {}
+    virtual size_t write(const uint8_t*, size_t length) override { buffer_->written += length; return length; }
+    virtual size_t read(uint8_t* data, size_t length) override { return readBuffer(*buffer_, data, length); }
+    virtual bool isOpen() override { return true; }
+    virtual void flush() override {}
+
+private:
+    BenchBuffer* buffer_;
+};
+
+class VirtualTick : public ITick {
+public:
+    virtual bool delay(uint32_t) override { return false; }
+    virtual uint32_t elapsed(uint32_t) override { return 0; }
+    virtual uint32_t getElapsed(uint32_t time1, uint32_t time2) override { return time2 - time1; }
+    virtual uint32_t getTickCount(void) override { return 0; }
+    virtual void tickUpdate() override {}
+    virtual bool tickCheck(uint32_t) override { return false; }
+};
+
+class StaticSerial final {
+public:
+    explicit StaticSerial(BenchBuffer* buffer) : buffer_(buffer) {}
+
+    size_t write(const uint8_t*, size_t length) { buffer_->written += length; return length; }
+    size_t read(uint8_t* data, size_t length) { return readBuffer(*buffer_, data, length); }
+    bool isOpen() { return true; }
+
+private:
+    BenchBuffer* buffer_;
+};
+
+class StaticTick final {
+public:
+    uint32_t getTickCount() { return 0; }
+};
+
+class StaticNode : public Com_ProtocolEngine<StaticNode, StaticSerial, StaticTick> {
+public:
+    StaticNode(StaticSerial* serial, StaticTick* tick) : Com_ProtocolEngine(serial, tick, NODE_ID) {}
+};
+
+void appendFrame(std::vector<uint8_t>& out, uint16_t cmd, uint16_t seq, const uint8_t* payload, size_t length) {
+    uint8_t head[14] = { 0x16, 0x16, 0x16, 0x16 };
+    storeBigEndian<uint16_t>(head + 4, static_cast<uint16_t>(8 + length + 2));
+    storeBigEndian<uint16_t>(head + 6, NODE_ID);
+    storeBigEndian<uint16_t>(head + 8, HOST_ID);
+    storeBigEndian<uint16_t>(head + 10, cmd);
+    storeBigEndian<uint16_t>(head + 12, seq);
+    uint16_t crc = crc16XModemUpdate(crc16XModemUpdate(0x0000, head + 6, 8), payload, length);
+
+    out.insert(out.end(), head, head + sizeof(head));
+    out.insert(out.end(), payload, payload + length);
+    out.push_back(static_cast<uint8_t>(crc >> 8));
+    out.push_back(static_cast<uint8_t>(crc & 0xFF));
+}
+
+uint64_t cycleCount() {
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    return 0;
+#endif
+}
+
+struct Sample {
+    uint64_t cycles;
+    uint64_t ns;
+};
+
+// 스트림을 처음부터 한 번 공급 (응답 바이트는 마지막 회차 값)
+template <typename Protocol>
+Sample feedOnce(Protocol& protocol, BenchBuffer& buffer) {
+    buffer.position = 0;
+    buffer.written = 0;
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    uint64_t cycles = cycleCount();
+    protocol.processReceivedData();
+    cycles = cycleCount() - cycles;
+    Sample sample;
+    sample.cycles = cycles;
+    sample.ns = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - start).count());
+    return sample;
+}
+
+} // namespace
+
+DispatchBenchResult runDispatchBench(const DispatchBenchConfig& config) {
+    DispatchBenchResult result;
+
+    std::vector<uint8_t> stream;
+    const uint8_t ping[] = { 'P', 'I', 'N', 'G' };
+    uint8_t configPayload[CONFIG_PAYLOAD_LENGTH] = { 0 };
+    for (uint32_t i = 0; i < config.frames; i++) {
+        if (i & 1) appendFrame(stream, CMD_CONFIG, static_cast<uint16_t>(i), configPayload, sizeof(configPayload));
+        else appendFrame(stream, CMD_PING, static_cast<uint16_t>(i), ping, sizeof(ping));
+    }
+    result.bytes = stream.size();
+    if (stream.empty()) return result;
+
+    BenchBuffer virtualBuffer = { &stream, 0, 0 };
+    VirtualSerial virtualSerial(&virtualBuffer);
+    VirtualTick virtualTick;
+    Com_Protocol virtualNode(&virtualSerial, &virtualTick, NODE_ID);
+
+    BenchBuffer staticBuffer = { &stream, 0, 0 };
+    StaticSerial staticSerial(&staticBuffer);
+    StaticTick staticTick;
+    StaticNode staticNode(&staticSerial, &staticTick);
+
+    Sample bestVirtual = { UINT64_MAX, UINT64_MAX };
+    Sample bestStatic = { UINT64_MAX, UINT64_MAX };
+    for (uint32_t round = 0; round < config.rounds; round++) {
+        Sample v = feedOnce(virtualNode, virtualBuffer);
+        Sample s = feedOnce(staticNode, staticBuffer);
+        if (v.cycles < bestVirtual.cycles) bestVirtual.cycles = v.cycles;
+        if (v.ns < bestVirtual.ns) bestVirtual.ns = v.ns;
+        if (s.cycles < bestStatic.cycles) bestStatic.cycles = s.cycles;
+        if (s.ns < bestStatic.ns) bestStatic.ns = s.ns;
+    }
+    if (config.rounds == 0) return result;
+
+    const double bytes = static_cast<double>(stream.size());
+    result.virtualReplyBytes = virtualBuffer.written;
+    result.staticReplyBytes = staticBuffer.written;
+    result.virtualCyclesPerByte = bestVirtual.cycles / bytes;
+    result.staticCyclesPerByte = bestStatic.cycles / bytes;
+    result.virtualNsPerByte = bestVirtual.ns / bytes;
+    result.staticNsPerByte = bestStatic.ns / bytes;
+    return result;
+}
+
+#endif
@@ -0,0 +1,44 @@
+#ifndef DISPATCH_BENCH_H_
+#define DISPATCH_BENCH_H_
+
+#if !defined(USE_HAL_DRIVER)
+#include <stdint.h>
+#include <stddef.h>
+
+/*
+ * 가상 어댑터 / 정적 정책 엔진 수신 비용 비교 (호스트 전용)
+ *
+ *  PING 과 CONFIG(32 바이트 페이로드) 프레임을 번갈아 만든 스트림을 메모리 전송으로 한 번에 공급하고
+ *  processReceivedData() 한 번(수신 -> 분기 -> 응답)에 걸린 시간을 바이트 수로 나눕니다.
+ *
+ *  - Com_Protocol : ISerialInterface / ITick 가상 호출 + 가상 핸들러
+ *  - Com_ProtocolEngine<..., final 전송, final 틱> : 같은 핸들러가 인라인
+ *
+ *  두 쪽 모두 같은 스트림을 rounds 번 반복하고 가장 작은 값을 씁니다. (캐시/주파수 변동 제외)
+ *  cycles 는 x86 TSC 로 재며, TSC 가 없는 CPU 에서는 0 입니다.
+ *
+ *  DispatchBenchConfig config;
+ *  DispatchBenchResult r = runDispatchBench(config);
+ *  printf("%.2f -> %.2f cycles/byte\n", r.virtualCyclesPerByte, r.staticCyclesPerByte);
+ */
+
+struct DispatchBenchConfig {
+    uint32_t frames = 200000;       // PING / CONFIG 합계
+    uint32_t rounds = 15;
+};
+
+struct DispatchBenchResult {
+    uint64_t bytes = 0;             // 스트림 길이
+    uint64_t virtualReplyBytes = 0; // 한 번 공급할 때 보낸 응답 바이트 (양쪽이 같아야 함)
+    uint64_t staticReplyBytes = 0;
+
+    double virtualCyclesPerByte = 0.0;
+    double staticCyclesPerByte = 0.0;
+    double virtualNsPerByte = 0.0;
+    double staticNsPerByte = 0.0;
+};
+
+DispatchBenchResult runDispatchBench(const DispatchBenchConfig& config);
+
+#endif
+#endif /* DISPATCH_BENCH_H_ */
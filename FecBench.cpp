@@ -0,0 +1,73 @@
+#if !defined(USE_HAL_DRIVER)
+#include "FecBench.h"
+#include "SimulatedBus.h"
+#include "com_protocol_class.h"
+#include <vector>
+
+namespace {
+
+const uint16_t HOST_ID = 1;
+const uint16_t NODE_ID = 2;
+const uint16_t CMD_PING = 0x0001;
+const uint16_t CMD_PONG = 0x8001;
+const uint64_t NS_PER_MS = 1000000ULL;
+const uint64_t POLL_NS = 100000ULL;             // 응답을 기다리는 동안 버스를 진행하는 단위
+const size_t MAX_PAYLOAD = 240;                 // FEC 부호어(255) 안에 들어가는 여유
+
+class BenchHost : public Com_Protocol {
+public:
+    BenchHost(ISerialInterface* serial, ITick* tick) : Com_Protocol(serial, tick, HOST_ID), pongs(0) {}
+
+    uint32_t pongs;
+
+protected:
+    virtual void handleResponse(uint16_t senderId, uint16_t cmd, uint8_t* payload, size_t length) override {
+        if (senderId == NODE_ID && cmd == CMD_PONG) pongs++;
+        Com_Protocol::handleResponse(senderId, cmd, payload, length);
+    }
+};
+
+} // namespace
+
+FecBenchResult runFecBench(const FecBenchConfig& config, double bitErrorRate, uint8_t parity) {
+    FecBenchResult result;
+
+    SimulatedBusConfig busConfig;
+    busConfig.baudRate = config.baudRate;
+    busConfig.seed = config.seed;
+    SimulatedBus bus(busConfig);
+    BenchHost host(bus.addEndpoint(), bus.tick());
+    Com_Protocol node(bus.addEndpoint(), bus.tick(), NODE_ID);
+    if (!host.setFecParity(parity) || !node.setFecParity(parity)) return result;
+    bus.setBitErrorRate(bitErrorRate);
+    std::vector<Com_Protocol*> nodes;
+    nodes.push_back(&host);
+    nodes.push_back(&node);
+
+    uint8_t payload[MAX_PAYLOAD];
+    const size_t payloadLength = config.payloadLength < MAX_PAYLOAD ? config.payloadLength : MAX_PAYLOAD;
+    for (size_t i = 0; i < payloadLength; i++) payload[i] = static_cast<uint8_t>(i * 7);
+
+    const uint64_t startNs = bus.nowNs();
+    const uint64_t endNs = startNs + config.durationMs * NS_PER_MS;
+    while (bus.nowNs() < endNs) {
+        const uint32_t before = host.pongs;
+        host.sendData(NODE_ID, HOST_ID, CMD_PING, payload, payloadLength);
+        result.requests++;
+
+        const uint64_t deadline = bus.nowNs() + config.responseTimeoutMs * NS_PER_MS;
+        while (host.pongs == before && bus.nowNs() < deadline) bus.run(nodes, POLL_NS);
+        if (host.pongs != before) result.replies++;
+    }
+
+    const double seconds = static_cast<double>(bus.nowNs() - startNs) / 1e9;
+    result.goodput = seconds > 0.0 ? static_cast<double>(result.replies) * payloadLength / seconds : 0.0;
+    const ProtocolMetrics hostMetrics = host.getMetrics();
+    const ProtocolMetrics nodeMetrics = node.getMetrics();
+    result.correctedBytes = hostMetrics.fecCorrectedBytes + nodeMetrics.fecCorrectedBytes;
+    result.uncorrectable = hostMetrics.fecUncorrectable + nodeMetrics.fecUncorrectable;
+    result.crcErrors = hostMetrics.crcErrors + nodeMetrics.crcErrors;
+    return result;
+}
+
+#endif
@@ -0,0 +1,43 @@
+#ifndef FEC_BENCH_H_
+#define FEC_BENCH_H_
+
+#if !defined(USE_HAL_DRIVER)
+#include <stdint.h>
+#include <stddef.h>
+
+/*
+ * 잡음 링크의 FEC goodput 측정 (호스트 전용)
+ *
+ *  SimulatedBus 위 1:1 링크에서 호스트가 PING(payloadLength 바이트)을 보내고 PONG 을 받아야 다음을 보내는
+ *  stop-and-wait 전송을 durationMs 동안 반복합니다. 비트 에러는 SimulatedBus::setBitErrorRate() 로 넣고,
+ *  양쪽의 setFecParity(parity) 가 같습니다. (parity 0 : FEC 없음)
+ *
+ *  - goodput : PONG 을 받은 요청의 페이로드 바이트 / 시뮬레이션 시간
+ *  - 응답이 없으면 responseTimeoutMs 뒤에 다음 요청 (재전송 대신 새 요청, 같은 페이로드)
+ *
+ *  FecBenchConfig config;
+ *  FecBenchResult r = runFecBench(config, 1e-3, 16);
+ *  printf("%.0f B/s, %u bytes corrected\n", r.goodput, r.correctedBytes);
+ */
+
+struct FecBenchConfig {
+    uint32_t baudRate = 115200;
+    size_t payloadLength = 128;
+    uint32_t durationMs = 5000;
+    uint32_t responseTimeoutMs = 30;
+    uint32_t seed = 7;
+};
+
+struct FecBenchResult {
+    uint32_t requests = 0;
+    uint32_t replies = 0;
+    double goodput = 0.0;               // B/s
+    uint32_t correctedBytes = 0;        // 양쪽 수신기가 정정한 바이트 합
+    uint32_t uncorrectable = 0;         // 정정 실패로 버린 FEC 프레임 (양쪽 합)
+    uint32_t crcErrors = 0;             // CRC 실패로 버린 프레임 (양쪽 합)
+};
+
+FecBenchResult runFecBench(const FecBenchConfig& config, double bitErrorRate, uint8_t parity);
+
+#endif
+#endif /* FEC_BENCH_H_ */
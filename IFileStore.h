@@ -0,0 +1,43 @@
+#ifndef I_FILE_STORE_H_
+#define I_FILE_STORE_H_
+
+#include <stdint.h>
+#include <stddef.h>
+
+static const size_t FILE_CONTENT_HASH_SIZE = 32;   // SHA-256
+
+// 파일 수신 재개용 체크포인트 (수신 측이 영구 저장)
+struct FileCheckpoint {
+    uint32_t fileId;        // 송신 측이 REQUEST_RECEIVE 로 보낸 파일 식별 해시
+    uint32_t fileSize;
+    uint32_t nextBlock;     // 연속으로 수신 완료한 마지막 블록 + 1
+    uint32_t receivedSize;  // nextBlock 이전까지의 바이트 수 (다음 쓰기 오프셋)
+    uint16_t checksum;      // receivedSize 까지의 누적 CRC16
+    uint8_t codec;          // 블록 압축 방식 (FileCodec)
+    bool hasContentHash;    // REQUEST_RECEIVE 에 내용 해시가 있었음
+    uint8_t contentHash[FILE_CONTENT_HASH_SIZE];
+};
+
+// CMD_FILE_RECEIVE 로 받은 파일을 소비하는 저장소 (플래시, SD, RAM 등)
+// write() 가 반환된 데이터는 전원이 꺼져도 남아 있어야 체크포인트 이후부터 재개할 수 있음
+class IFileStore {
+public:
+    virtual ~IFileStore() {}
+
+    virtual bool begin(uint32_t fileSize) = 0;      // 새 파일 수신 시작 (이전 임시 내용 폐기)
+    virtual bool write(uint32_t offset, const uint8_t* data, size_t length) = 0;
+    // 체크섬 검증 완료 : 수신한 파일을 현재 파일로 확정하고 내용 해시를 함께 저장 (nullptr : 해시 모름)
+    virtual bool commit(const uint8_t* contentHash) = 0;
+    virtual void abort() = 0;                       // 수신 중인 임시 내용 폐기
+    // 현재 파일의 크기와 내용 해시 (파일이 없거나 해시를 모르면 false)
+    virtual bool currentContent(uint32_t& fileSize, uint8_t (&contentHash)[FILE_CONTENT_HASH_SIZE]) = 0;
+    // 현재(확정된) 파일 읽기 : 델타 전송의 블록 서명 계산과 COPY 명령에 사용
+    virtual uint32_t currentSize() = 0;
+    virtual size_t readCurrent(uint32_t offset, uint8_t* buffer, size_t length) = 0;   // 범위 밖은 짧게 읽음
+
+    virtual bool saveCheckpoint(const FileCheckpoint& checkpoint) = 0;
+    virtual bool loadCheckpoint(FileCheckpoint& checkpoint) = 0;   // 저장된 체크포인트가 없으면 false
+    virtual void clearCheckpoint() = 0;
+};
+
+#endif /* I_FILE_STORE_H_ */
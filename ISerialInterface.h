@@ -8,6 +8,9 @@
 
 //qt
 
+#include <stdint.h>
+#include <stddef.h>
+
 class ISerialInterface {
 public:
     virtual ~ISerialInterface() = default;
@@ -19,6 +22,13 @@ public:
     virtual size_t read(uint8_t* buffer, size_t length) = 0;
     virtual bool isOpen() = 0;
     virtual void flush() = 0;
+
+    // 링크 속도 재설정 훅 (CMD_LINK_SPEED) : 지원하지 않는 전송은 기본 구현 유지
+    // setBaudRate 는 송신 중인 바이트를 모두 내보낸 뒤 속도를 바꾸고 수신을 재개해야 함
+    virtual bool setBaudRate(uint32_t) { return false; }
+    virtual uint32_t getBaudRate() const { return 0; }   // 0 : 재설정 미지원
+    // setBaudRate 로 설정할 수 있는 속도인지 (속도는 바꾸지 않음, 제안을 수락하기 전에 확인)
+    virtual bool supportsBaudRate(uint32_t baudRate) const { return baudRate != 0 && getBaudRate() != 0; }
 };
 
 #endif /* I_SERIAL_INTERFACE_H_ */
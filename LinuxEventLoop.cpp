@@ -0,0 +1,73 @@
+#if defined(__linux__)
+#include "LinuxEventLoop.h"
+
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+#include <errno.h>
+
+LinuxEventLoop::LinuxEventLoop() :
+    epollFd_(epoll_create1(EPOLL_CLOEXEC)),
+    wakeFd_(eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC)),
+    stopRequested_(false)
+{
+    if (epollFd_ >= 0 && wakeFd_ >= 0) {
+        struct epoll_event ev = {};
+        ev.events = EPOLLIN;
+        ev.data.fd = wakeFd_;
+        epoll_ctl(epollFd_, EPOLL_CTL_ADD, wakeFd_, &ev);
+    }
+}
+
+LinuxEventLoop::~LinuxEventLoop() {
+    if (wakeFd_ >= 0) close(wakeFd_);
+    if (epollFd_ >= 0) close(epollFd_);
+}
+
+bool LinuxEventLoop::addReadable(int fd) {
+    if (epollFd_ < 0 || fd < 0) return false;
+
+    struct epoll_event ev = {};
+    ev.events = EPOLLIN;
+    ev.data.fd = fd;
+    return epoll_ctl(epollFd_, EPOLL_CTL_ADD, fd, &ev) == 0;
+}
+
+bool LinuxEventLoop::removeReadable(int fd) {
+    if (epollFd_ < 0 || fd < 0) return false;
+    return epoll_ctl(epollFd_, EPOLL_CTL_DEL, fd, nullptr) == 0;
+}
+
+void LinuxEventLoop::wakeup() {
+    if (wakeFd_ < 0) return;
+    uint64_t one = 1;
+    ssize_t ret = ::write(wakeFd_, &one, sizeof(one));
+    (void)ret;
+}
+
+void LinuxEventLoop::stop() {
+    stopRequested_.store(true, std::memory_order_release);
+    wakeup();
+}
+
+int LinuxEventLoop::wait(int timeoutMs) {
+    if (epollFd_ < 0) return 0;
+
+    struct epoll_event events[MAX_EVENTS];
+    int n = epoll_wait(epollFd_, events, MAX_EVENTS, timeoutMs);
+    if (n < 0) return 0;  // EINTR 등 : 타임아웃과 동일하게 처리
+
+    int readable = 0;
+    for (int i = 0; i < n; i++) {
+        if (events[i].data.fd == wakeFd_) {
+            uint64_t count;
+            ssize_t ret = ::read(wakeFd_, &count, sizeof(count));
+            (void)ret;
+        } else {
+            readable++;
+        }
+    }
+    return readable;
+}
+
+#endif
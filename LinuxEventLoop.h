@@ -0,0 +1,90 @@
+#ifndef LINUX_EVENT_LOOP_H_
+#define LINUX_EVENT_LOOP_H_
+
+#if defined(__linux__)
+#include <stdint.h>
+#include <atomic>
+
+// epoll + eventfd 기반 이벤트 루프
+// 바이트 도착 또는 프레임 타임아웃 시점에만 깨어나므로 유휴 시 CPU 사용이 없음
+//
+//   LinuxSerialImpl serial("/dev/ttyUSB0", 115200);
+//   LinuxTickImpl tick;
+//   Com_Protocol protocol(&serial, &tick, 0x0001);
+//   serial.open();
+//
+//   LinuxEventLoop loop;
+//   loop.addReadable(serial.fd());
+//   loop.run(protocol);            // 다른 스레드에서 loop.stop() 으로 종료
+//
+// 파싱/처리 단계 분리 (setPacketQueue) : 처리 단계 스레드는 fd 없는 루프를 하나 더 두고 큐 알림으로 깨움
+//   LinuxEventLoop handlers;
+//   protocol.setPacketQueue(16);
+//   protocol.setPacketNotify(&LinuxEventLoop::wakeupCallback, &handlers);
+//   std::thread worker([&]() { handlers.runHandlers(protocol); });
+//   loop.run(protocol);            // 파싱 단계
+class LinuxEventLoop {
+public:
+    LinuxEventLoop();
+    ~LinuxEventLoop();
+
+    bool addReadable(int fd);       // fd 가 읽기 가능해지면 깨어남
+    bool removeReadable(int fd);
+
+    void wakeup();                  // 다른 스레드에서 대기 중인 루프를 깨움
+    static void wakeupCallback(void* context) { static_cast<LinuxEventLoop*>(context)->wakeup(); }
+    void stop();                    // run() 종료 요청 (스레드 안전)
+    bool isStopRequested() const { return stopRequested_.load(std::memory_order_acquire); }
+
+    // 이벤트 대기 : 읽기 가능한 fd 수 반환 (0: 타임아웃 또는 wakeup), timeoutMs < 0 이면 무한 대기
+    int wait(int timeoutMs);
+
+    // 프로토콜 수신 루프 : 다음 프레임 타임아웃을 epoll 대기 시간으로 사용
+    template <typename Protocol>
+    void run(Protocol& protocol);
+
+    // 처리 단계 루프 : 큐 알림(wakeup) 또는 링크 속도/모션 타이머 시점에 processQueuedPackets()
+    template <typename Protocol>
+    void runHandlers(Protocol& protocol);
+
+private:
+    static const int MAX_EVENTS = 16;
+
+    int epollFd_;
+    int wakeFd_;
+    std::atomic<bool> stopRequested_;
+
+    LinuxEventLoop(const LinuxEventLoop&);
+    LinuxEventLoop& operator=(const LinuxEventLoop&);
+};
+
+template <typename Protocol>
+void LinuxEventLoop::run(Protocol& protocol) {
+    stopRequested_.store(false, std::memory_order_release);
+    while (!isStopRequested()) {
+        uint32_t remaining = protocol.timeUntilReceiveTimeout();
+        int timeoutMs = (remaining == Protocol::NO_RECEIVE_DEADLINE) ? -1 : static_cast<int>(remaining);
+
+        if (wait(timeoutMs) > 0) {
+            protocol.notifyRxFromISR();
+        }
+        // 데이터 도착 또는 타임아웃 : 타임아웃만 발생한 경우에도 상태 머신 리셋을 위해 호출
+        protocol.processReceivedData();
+    }
+}
+
+template <typename Protocol>
+void LinuxEventLoop::runHandlers(Protocol& protocol) {
+    stopRequested_.store(false, std::memory_order_release);
+    while (!isStopRequested()) {
+        protocol.processQueuedPackets();
+
+        // 처리하는 동안 들어온 패킷은 eventfd 에 남아 있으므로 알림을 놓치지 않음
+        uint32_t remaining = protocol.timeUntilQueuedWork();
+        int timeoutMs = (remaining == Protocol::NO_RECEIVE_DEADLINE) ? -1 : static_cast<int>(remaining);
+        wait(timeoutMs);
+    }
+}
+
+#endif
+#endif /* LINUX_EVENT_LOOP_H_ */
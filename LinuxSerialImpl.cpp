@@ -0,0 +1,143 @@
+#if defined(__linux__)
+#include "LinuxSerialImpl.h"
+
+#include <fcntl.h>
+#include <poll.h>
+#include <string.h>
+#include <termios.h>
+#include <unistd.h>
+#include <errno.h>
+
+// baud 값 -> termios 속도 상수
+static speed_t toSpeed(uint32_t baudRate) {
+    switch (baudRate) {
+        case 9600:    return B9600;
+        case 19200:   return B19200;
+        case 38400:   return B38400;
+        case 57600:   return B57600;
+        case 115200:  return B115200;
+        case 230400:  return B230400;
+        case 460800:  return B460800;
+        case 921600:  return B921600;
+        case 1000000: return B1000000;
+        case 2000000: return B2000000;
+        case 3000000: return B3000000;
+        default:      return 0;
+    }
+}
+
+LinuxSerialImpl::LinuxSerialImpl(const char* device, uint32_t baudRate) :
+    baudRate_(baudRate),
+    fd_(-1)
+{
+    strncpy(device_, device, MAX_DEVICE_LENGTH - 1);
+    device_[MAX_DEVICE_LENGTH - 1] = '\0';
+}
+
+LinuxSerialImpl::~LinuxSerialImpl() {
+    close();
+}
+
+void LinuxSerialImpl::init() {
+    open();
+}
+
+bool LinuxSerialImpl::open() {
+    if (fd_ >= 0) return true;
+
+    fd_ = ::open(device_, O_RDWR | O_NOCTTY | O_NONBLOCK | O_CLOEXEC);
+    if (fd_ < 0) return false;
+
+    if (!applyBaudRate(baudRate_)) {
+        close();
+        return false;
+    }
+    tcflush(fd_, TCIOFLUSH);
+    return true;
+}
+
+void LinuxSerialImpl::close() {
+    if (fd_ >= 0) {
+        ::close(fd_);
+        fd_ = -1;
+    }
+}
+
+bool LinuxSerialImpl::applyBaudRate(uint32_t baudRate) {
+    speed_t speed = toSpeed(baudRate);
+    if (speed == 0) return false;
+
+    struct termios tio;
+    if (tcgetattr(fd_, &tio) != 0) return false;
+
+    cfmakeraw(&tio);
+    tio.c_cflag |= (CLOCAL | CREAD);
+    tio.c_cflag &= ~(CSTOPB | CRTSCTS);
+    tio.c_cc[VMIN] = 0;
+    tio.c_cc[VTIME] = 0;
+    cfsetispeed(&tio, speed);
+    cfsetospeed(&tio, speed);
+
+    if (tcsetattr(fd_, TCSANOW, &tio) != 0) return false;
+    baudRate_ = baudRate;
+    return true;
+}
+
+bool LinuxSerialImpl::supportsBaudRate(uint32_t baudRate) const {
+    return toSpeed(baudRate) != 0;
+}
+
+bool LinuxSerialImpl::setBaudRate(uint32_t baudRate) {
+    if (toSpeed(baudRate) == 0) return false;
+    if (fd_ < 0) {
+        // 열기 전 : open() 시 적용
+        baudRate_ = baudRate;
+        return true;
+    }
+    // 이전 속도로 보낸 응답(ACK)이 모두 나간 뒤 변경, 이전 속도로 받은 잔여 바이트는 폐기
+    tcdrain(fd_);
+    if (!applyBaudRate(baudRate)) return false;
+    tcflush(fd_, TCIFLUSH);
+    return true;
+}
+
+size_t LinuxSerialImpl::write(const uint8_t* data, size_t length) {
+    if (fd_ < 0) return 0;
+
+    size_t written = 0;
+    while (written < length) {
+        ssize_t n = ::write(fd_, data + written, length - written);
+        if (n > 0) {
+            written += n;
+        } else if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+            // 송신 버퍼가 가득 참 : 비워질 때까지 대기
+            struct pollfd pfd = { fd_, POLLOUT, 0 };
+            poll(&pfd, 1, -1);
+        } else if (n < 0 && errno == EINTR) {
+            continue;
+        } else {
+            break;
+        }
+    }
+    return written;
+}
+
+size_t LinuxSerialImpl::read(uint8_t* buffer, size_t length) {
+    if (fd_ < 0) return 0;
+
+    ssize_t n = ::read(fd_, buffer, length);
+    return n > 0 ? static_cast<size_t>(n) : 0;  // EAGAIN 포함 : 읽을 데이터 없음
+}
+
+bool LinuxSerialImpl::isOpen() {
+    return fd_ >= 0;
+}
+
+void LinuxSerialImpl::flush() {
+    // 수신 버퍼 비우기
+    if (fd_ >= 0) {
+        tcflush(fd_, TCIFLUSH);
+    }
+}
+
+#endif
@@ -0,0 +1,38 @@
+#ifndef LINUX_SERIAL_IMPL_H_
+#define LINUX_SERIAL_IMPL_H_
+
+#if defined(__linux__)
+#include "ISerialInterface.h"
+
+// termios 기반 리눅스 시리얼 포트 (논블로킹)
+class LinuxSerialImpl : public ISerialInterface {
+public:
+    LinuxSerialImpl(const char* device, uint32_t baudRate);
+    virtual ~LinuxSerialImpl();
+
+    virtual void init() override;
+    virtual bool open() override;
+    virtual void close() override;
+    virtual size_t write(const uint8_t* data, size_t length) override;
+    virtual size_t read(uint8_t* buffer, size_t length) override;
+    virtual bool isOpen() override;
+    virtual void flush() override;
+    virtual bool setBaudRate(uint32_t baudRate) override;   // 송신 버퍼를 비운 뒤 변경
+    virtual uint32_t getBaudRate() const override { return baudRate_; }
+    virtual bool supportsBaudRate(uint32_t baudRate) const override;   // termios 표준 속도만
+
+    // 이벤트 루프(epoll) 등록용 파일 디스크립터
+    int fd() const { return fd_; }
+
+private:
+    static const size_t MAX_DEVICE_LENGTH = 64;
+
+    char device_[MAX_DEVICE_LENGTH];
+    uint32_t baudRate_;
+    int fd_;
+
+    bool applyBaudRate(uint32_t baudRate);
+};
+
+#endif
+#endif /* LINUX_SERIAL_IMPL_H_ */
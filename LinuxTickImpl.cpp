@@ -0,0 +1,38 @@
+#if defined(__linux__)
+#include "LinuxTickImpl.h"
+#include <time.h>
+
+LinuxTickImpl::LinuxTickImpl() : tickTime(0) {
+    tickTime = getTickCount();
+}
+
+LinuxTickImpl::~LinuxTickImpl() {
+}
+
+bool LinuxTickImpl::delay(uint32_t time) {
+    return (getTickCount() - tickTime) >= time;
+}
+
+uint32_t LinuxTickImpl::elapsed(uint32_t time) {
+    return getTickCount() - time;
+}
+
+uint32_t LinuxTickImpl::getElapsed(uint32_t time1, uint32_t time2) {
+    return time2 - time1;
+}
+
+uint32_t LinuxTickImpl::getTickCount(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return static_cast<uint32_t>(ts.tv_sec * 1000ULL + ts.tv_nsec / 1000000);
+}
+
+void LinuxTickImpl::tickUpdate() {
+    tickTime = getTickCount();
+}
+
+bool LinuxTickImpl::tickCheck(uint32_t time) {
+    return delay(time);
+}
+
+#endif
@@ -0,0 +1,26 @@
+#ifndef LINUXTICKIMPL_H
+#define LINUXTICKIMPL_H
+
+#if defined(__linux__)
+#include "ITick.h"
+
+// CLOCK_MONOTONIC 기반 ms 틱
+class LinuxTickImpl : public ITick {
+public:
+    LinuxTickImpl();
+    virtual ~LinuxTickImpl();
+
+    virtual bool delay(uint32_t time) override;
+    virtual uint32_t elapsed(uint32_t time) override;
+    virtual uint32_t getElapsed(uint32_t time1, uint32_t time2) override;
+    virtual uint32_t getTickCount(void) override;
+    virtual void tickUpdate() override;
+    virtual bool tickCheck(uint32_t time) override;
+
+private:
+    uint32_t tickTime;
+};
+
+#endif
+
+#endif // LINUXTICKIMPL_H
@@ -0,0 +1,51 @@
+#if !defined(USE_HAL_DRIVER)
+#include "MemoryFileStore.h"
+#include <string.h>
+
+bool MemoryFileStore::begin(uint32_t fileSize) {
+    pending_.assign(fileSize, 0);
+    return true;
+}
+
+bool MemoryFileStore::write(uint32_t offset, const uint8_t* data, size_t length) {
+    if (offset > pending_.size() || length > pending_.size() - offset) return false;
+    memcpy(pending_.data() + offset, data, length);
+    return true;
+}
+
+bool MemoryFileStore::commit(const uint8_t* contentHash) {
+    current_.swap(pending_);
+    pending_.clear();
+    hasContentHash_ = contentHash != nullptr;
+    if (hasContentHash_) memcpy(contentHash_, contentHash, FILE_CONTENT_HASH_SIZE);
+    return true;
+}
+
+bool MemoryFileStore::currentContent(uint32_t& fileSize, uint8_t (&contentHash)[FILE_CONTENT_HASH_SIZE]) {
+    if (!hasContentHash_) return false;
+    fileSize = static_cast<uint32_t>(current_.size());
+    memcpy(contentHash, contentHash_, FILE_CONTENT_HASH_SIZE);
+    return true;
+}
+
+size_t MemoryFileStore::readCurrent(uint32_t offset, uint8_t* buffer, size_t length) {
+    if (offset >= current_.size()) return 0;
+    if (length > current_.size() - offset) length = current_.size() - offset;
+    memcpy(buffer, current_.data() + offset, length);
+    return length;
+}
+
+bool MemoryFileStore::saveCheckpoint(const FileCheckpoint& checkpoint) {
+    checkpoint_ = checkpoint;
+    hasCheckpoint_ = true;
+    checkpointWrites_++;
+    return true;
+}
+
+bool MemoryFileStore::loadCheckpoint(FileCheckpoint& checkpoint) {
+    if (!hasCheckpoint_) return false;
+    checkpoint = checkpoint_;
+    return true;
+}
+
+#endif
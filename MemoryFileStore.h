@@ -0,0 +1,40 @@
+#ifndef MEMORY_FILE_STORE_H_
+#define MEMORY_FILE_STORE_H_
+
+#if !defined(USE_HAL_DRIVER)
+#include "IFileStore.h"
+#include <vector>
+
+// RAM 기반 파일 저장소 (호스트 시뮬레이션/검증용)
+// 체크포인트와 임시 내용은 객체가 살아 있는 동안 유지되므로 노드 재시작(엔진 재생성)을 흉내낼 수 있음
+class MemoryFileStore : public IFileStore {
+public:
+    MemoryFileStore() : hasCheckpoint_(false), checkpointWrites_(0), hasContentHash_(false) {}
+
+    virtual bool begin(uint32_t fileSize) override;
+    virtual bool write(uint32_t offset, const uint8_t* data, size_t length) override;
+    virtual bool commit(const uint8_t* contentHash) override;
+    virtual void abort() override { pending_.clear(); }
+    virtual bool currentContent(uint32_t& fileSize, uint8_t (&contentHash)[FILE_CONTENT_HASH_SIZE]) override;
+    virtual uint32_t currentSize() override { return static_cast<uint32_t>(current_.size()); }
+    virtual size_t readCurrent(uint32_t offset, uint8_t* buffer, size_t length) override;
+
+    virtual bool saveCheckpoint(const FileCheckpoint& checkpoint) override;
+    virtual bool loadCheckpoint(FileCheckpoint& checkpoint) override;
+    virtual void clearCheckpoint() override { hasCheckpoint_ = false; }
+
+    const std::vector<uint8_t>& current() const { return current_; }   // 확정된 파일
+    uint32_t checkpointWrites() const { return checkpointWrites_; }
+
+private:
+    std::vector<uint8_t> current_;
+    std::vector<uint8_t> pending_;
+    FileCheckpoint checkpoint_;
+    bool hasCheckpoint_;
+    uint32_t checkpointWrites_;
+    bool hasContentHash_;
+    uint8_t contentHash_[FILE_CONTENT_HASH_SIZE];
+};
+
+#endif
+#endif /* MEMORY_FILE_STORE_H_ */
@@ -0,0 +1,228 @@
+#if !defined(USE_HAL_DRIVER)
+#include "ParserStress.h"
+#include "com_protocol_class.h"
+#include "crc16.h"
+#include "payload_schema.h"
+#include <chrono>
+#include <random>
+#include <vector>
+
+namespace {
+
+const uint16_t NODE_ID = 1;
+const uint16_t HOST_ID = 2;
+const uint16_t CMD_PING = 0x0001;
+const uint32_t FOREIGN_INDEX = 0xFFFFFFFF;      // 공격 구간에 쓰는 프레임 번호 (집계 제외)
+const size_t PING_PAYLOAD_LENGTH = 12;          // 프레임 번호(4) + 채움(8)
+const uint16_t RECEIVE_BUFFER_LENGTH = 256;     // Com_ProtocolEngine 수신 버퍼
+const uint32_t DRAIN_MS = 300;                  // 스트림 종료 후 타임아웃 처리 여유
+
+// 공급 위치를 시뮬레이션 시간으로 제한하는 수신 전용 전송
+class StressSerial : public ISerialInterface {
+public:
+    explicit StressSerial(const std::vector<uint8_t>& stream) : stream_(stream), position_(0), available_(0) {}
+
+    virtual void init() override {}
+    virtual bool open() override { return true; }
+    virtual void close() override {}
+    virtual size_t write(const uint8_t* data, size_t length) override { return length; }
+    virtual size_t read(uint8_t* buffer, size_t length) override {
+        size_t n = 0;
+        while (n < length && position_ < available_) buffer[n++] = stream_[position_++];
+        return n;
+    }
+    virtual bool isOpen() override { return true; }
+    virtual void flush() override {}
+
+    void setAvailable(size_t available) { available_ = available < stream_.size() ? available : stream_.size(); }
+
+private:
+    const std::vector<uint8_t>& stream_;
+    size_t position_;
+    size_t available_;
+};
+
+class StressTick : public ITick {
+public:
+    StressTick() : now(0), tickTime(0) {}
+
+    virtual bool delay(uint32_t time) override { return (now - tickTime) >= time; }
+    virtual uint32_t elapsed(uint32_t time) override { return now - time; }
+    virtual uint32_t getElapsed(uint32_t time1, uint32_t time2) override { return time2 - time1; }
+    virtual uint32_t getTickCount(void) override { return now; }
+    virtual void tickUpdate() override { tickTime = now; }
+    virtual bool tickCheck(uint32_t time) override { return delay(time); }
+
+    uint32_t now;
+
+private:
+    uint32_t tickTime;
+};
+
+// 수락된 PING 의 프레임 번호와 시각 기록 (응답 없음)
+class StressNode : public Com_Protocol {
+public:
+    StressNode(ISerialInterface* serial, StressTick* tick, std::vector<int64_t>& acceptMs) :
+        Com_Protocol(serial, tick, NODE_ID), tick_(tick), acceptMs_(acceptMs) {}
+
+protected:
+    virtual void handlePing(uint16_t senderId, uint8_t* payload, size_t length) override {
+        if (length < 4) return;
+        uint32_t index = loadBigEndian<uint32_t>(payload);
+        if (index < acceptMs_.size() && acceptMs_[index] < 0) acceptMs_[index] = tick_->now;
+    }
+
+private:
+    StressTick* tick_;
+    std::vector<int64_t>& acceptMs_;
+};
+
+void appendFrame(std::vector<uint8_t>& out, uint16_t receiverId, uint16_t cmd, uint16_t seq,
+                 const uint8_t* payload, size_t length) {
+    uint8_t head[14] = { 0x16, 0x16, 0x16, 0x16 };
+    storeBigEndian<uint16_t>(head + 4, static_cast<uint16_t>(8 + length + 2));
+    storeBigEndian<uint16_t>(head + 6, receiverId);
+    storeBigEndian<uint16_t>(head + 8, HOST_ID);
+    storeBigEndian<uint16_t>(head + 10, cmd);
+    storeBigEndian<uint16_t>(head + 12, seq);
+
+    uint16_t crc = crc16XModemUpdate(0x0000, head + 6, 8);
+    crc = crc16XModemUpdate(crc, payload, length);
+
+    out.insert(out.end(), head, head + sizeof(head));
+    out.insert(out.end(), payload, payload + length);
+    out.push_back(static_cast<uint8_t>(crc >> 8));
+    out.push_back(static_cast<uint8_t>(crc & 0xFF));
+}
+
+void appendPing(std::vector<uint8_t>& out, uint32_t index, uint16_t seq) {
+    uint8_t payload[PING_PAYLOAD_LENGTH];
+    storeBigEndian<uint32_t>(payload, index);
+    for (size_t i = 4; i < PING_PAYLOAD_LENGTH; i++) payload[i] = static_cast<uint8_t>(index + i);
+    appendFrame(out, NODE_ID, CMD_PING, seq, payload, PING_PAYLOAD_LENGTH);
+}
+
+void appendAttack(std::vector<uint8_t>& out, StressPattern pattern, const ParserStressConfig& config,
+                  uint16_t seq, std::mt19937& rng) {
+    switch (pattern) {
+        case StressPattern::START_FLOOD:
+            out.insert(out.end(), config.floodLength, 0x16);
+            break;
+
+        case StressPattern::TRUNCATED_FRAME: {
+            std::vector<uint8_t> frame;
+            appendPing(frame, FOREIGN_INDEX, seq);
+            // 길이 필드 이후 ~ CRC 직전 사이에서 자름
+            size_t cut = 7 + rng() % (frame.size() - 8);
+            out.insert(out.end(), frame.begin(), frame.begin() + cut);
+            break;
+        }
+
+        case StressPattern::BOGUS_LENGTH: {
+            uint8_t bogus[8] = { 0x16, 0x16, 0x16, 0x16 };
+            storeBigEndian<uint16_t>(bogus + 4, static_cast<uint16_t>(RECEIVE_BUFFER_LENGTH - rng() % 4));
+            storeBigEndian<uint16_t>(bogus + 6, NODE_ID);
+            out.insert(out.end(), bogus, bogus + sizeof(bogus));
+            break;
+        }
+
+        case StressPattern::CRC_FAILURE: {
+            size_t start = out.size();
+            appendPing(out, FOREIGN_INDEX, seq);
+            size_t offset = 6 + rng() % (out.size() - start - 6);
+            out[start + offset] ^= static_cast<uint8_t>(1u << (rng() % 8));
+            break;
+        }
+
+        case StressPattern::MIXED:
+        default:
+            appendAttack(out, static_cast<StressPattern>(rng() % 4), config, seq, rng);
+            break;
+    }
+}
+
+} // namespace
+
+const char* stressPatternName(StressPattern pattern) {
+    switch (pattern) {
+        case StressPattern::START_FLOOD: return "start-flood";
+        case StressPattern::TRUNCATED_FRAME: return "truncated-frame";
+        case StressPattern::BOGUS_LENGTH: return "bogus-length";
+        case StressPattern::CRC_FAILURE: return "crc-failure";
+        case StressPattern::MIXED: return "mixed";
+    }
+    return "unknown";
+}
+
+ParserStressResult runParserStress(const ParserStressConfig& config) {
+    ParserStressResult result;
+    if (config.frames == 0 || config.baudRate == 0) return result;
+
+    // 스트림 생성 : [공격 구간][유효 PING] x frames
+    std::mt19937 rng(config.seed);
+    std::vector<uint8_t> stream;
+    std::vector<size_t> attackEnd(config.frames);
+    uint16_t seq = 0;
+    size_t frameBytes = 0;
+
+    for (uint32_t i = 0; i < config.frames; i++) {
+        appendAttack(stream, config.pattern, config, seq++, rng);
+        attackEnd[i] = stream.size();
+        size_t before = stream.size();
+        appendPing(stream, i, seq++);
+        frameBytes = stream.size() - before;
+    }
+
+    std::vector<int64_t> acceptMs(config.frames, -1);
+    StressSerial serial(stream);
+    StressTick tick;
+    StressNode node(&serial, &tick, acceptMs);
+    node.setResyncRescan(config.resyncRescan);
+
+    // 1ms 마다 그동안 도착한 바이트를 공급하고 한 번 처리
+    const double bytesPerMs = double(config.baudRate) / config.bitsPerByte / 1000.0;
+    const uint32_t streamMs = static_cast<uint32_t>(stream.size() / bytesPerMs) + 1;
+    std::chrono::steady_clock::duration busy(0);
+
+    for (uint32_t ms = 1; ms <= streamMs + DRAIN_MS; ms++) {
+        tick.now = ms;
+        serial.setAvailable(static_cast<size_t>(ms * bytesPerMs));
+
+        std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
+        node.processReceivedData();
+        busy += std::chrono::steady_clock::now() - begin;
+    }
+
+    // 집계 : 공격 구간 i 이후 처음 수락된 프레임까지의 시간
+    result.framesSent = config.frames;
+    result.bytesFed = stream.size();
+
+    int64_t nextAccept = -1;
+    double recoverySum = 0.0;
+    uint32_t recovered = 0;
+    for (uint32_t i = config.frames; i-- > 0;) {
+        if (acceptMs[i] >= 0) {
+            result.framesAccepted++;
+            nextAccept = acceptMs[i];
+        }
+        if (nextAccept < 0) {
+            result.unrecovered++;
+            continue;
+        }
+        int64_t attackEndMs = static_cast<int64_t>(attackEnd[i] / bytesPerMs);
+        uint32_t recoveryMs = static_cast<uint32_t>(nextAccept > attackEndMs ? nextAccept - attackEndMs : 0);
+        if (recoveryMs > result.worstRecoveryMs) result.worstRecoveryMs = recoveryMs;
+        recoverySum += recoveryMs;
+        recovered++;
+    }
+
+    result.acceptedBytes = static_cast<uint64_t>(result.framesAccepted) * frameBytes;
+    result.goodput = double(result.acceptedBytes) / double(result.bytesFed);
+    result.bytesPerRecoveredFrame = result.framesAccepted ? double(result.bytesFed) / result.framesAccepted : 0.0;
+    result.meanRecoveryMs = recovered ? recoverySum / recovered : 0.0;
+    result.hostNsPerByte = double(std::chrono::duration_cast<std::chrono::nanoseconds>(busy).count()) /
+                           double(result.bytesFed);
+    return result;
+}
+
+#endif
@@ -0,0 +1,63 @@
+#ifndef PARSER_STRESS_H_
+#define PARSER_STRESS_H_
+
+#if !defined(USE_HAL_DRIVER)
+#include <stdint.h>
+#include <stddef.h>
+
+/*
+ * 수신 파서 재동기화 스트레스 측정 (호스트 전용)
+ *
+ *  유효 PING 프레임마다 앞에 공격 구간 1개를 끼운 스트림을 보레이트 속도로
+ *  Com_Protocol 에 공급하고, 1ms 마다 processReceivedData() 를 호출합니다.
+ *
+ *  - START_FLOOD     : 0x16 연속 (floodLength 바이트)
+ *  - TRUNCATED_FRAME : 유효 프레임을 임의 위치에서 잘라냄
+ *  - BOGUS_LENGTH    : 시작 시퀀스 + 수신 버퍼(256) 바로 아래의 길이 + 자신의 ID 후 중단
+ *  - CRC_FAILURE     : 유효 프레임에서 길이 이후 1바이트 변조
+ *  - MIXED           : 위 4가지를 무작위로 섞음
+ *
+ *  ParserStressConfig config;
+ *  config.pattern = StressPattern::BOGUS_LENGTH;
+ *  config.resyncRescan = true;
+ *  ParserStressResult r = runParserStress(config);
+ */
+
+enum class StressPattern : uint8_t {
+    START_FLOOD,
+    TRUNCATED_FRAME,
+    BOGUS_LENGTH,
+    CRC_FAILURE,
+    MIXED
+};
+
+struct ParserStressConfig {
+    StressPattern pattern = StressPattern::MIXED;
+    uint32_t frames = 10000;        // 유효 프레임 수 (프레임마다 앞에 공격 구간 1개)
+    uint32_t baudRate = 115200;
+    uint8_t bitsPerByte = 10;
+    size_t floodLength = 64;        // START_FLOOD 길이
+    bool resyncRescan = false;      // Com_ProtocolEngine::setResyncRescan()
+    uint32_t seed = 1;
+};
+
+struct ParserStressResult {
+    uint32_t framesSent = 0;
+    uint32_t framesAccepted = 0;
+    uint64_t bytesFed = 0;              // 공격 구간 포함 전체 공급 바이트
+    uint64_t acceptedBytes = 0;         // 수락된 유효 프레임 바이트
+
+    double goodput = 0.0;               // acceptedBytes / bytesFed
+    double bytesPerRecoveredFrame = 0.0;// bytesFed / framesAccepted
+    double meanRecoveryMs = 0.0;        // 공격 구간 끝 -> 다음 유효 프레임 수락
+    uint32_t worstRecoveryMs = 0;
+    uint32_t unrecovered = 0;           // 이후 어떤 프레임도 수락되지 않은 공격 구간
+    double hostNsPerByte = 0.0;         // processReceivedData() 호스트 CPU 시간
+};
+
+ParserStressResult runParserStress(const ParserStressConfig& config);
+
+const char* stressPatternName(StressPattern pattern);
+
+#endif
+#endif /* PARSER_STRESS_H_ */
@@ -0,0 +1,236 @@
+#if defined(__linux__)
+#include "PortBench.h"
+#include "LinuxEventLoop.h"
+#include "LinuxTickImpl.h"
+#include "com_protocol_class.h"
+#include "crc16.h"
+#include "payload_schema.h"
+
+#include <sys/epoll.h>
+#include <sys/resource.h>
+#include <sys/socket.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <chrono>
+#include <memory>
+#include <thread>
+
+namespace {
+
+const uint16_t NODE_ID = 1;
+const uint16_t HOST_ID = 2;
+const uint16_t CMD_PING = 0x0001;
+const size_t PING_PAYLOAD_LENGTH = 12;
+const size_t PONG_FRAME_LENGTH = 4 + 2 + 8 + 4 + 2;     // 시작 + 길이 + 헤더 + "PONG" + CRC
+const int MAX_EVENTS = 64;
+
+// 논블로킹 socketpair 한쪽 끝 (송신은 버퍼가 빌 때까지 재시도)
+class FdSerial : public ISerialInterface {
+public:
+    explicit FdSerial(int fd) : fd_(fd) {}
+
+    virtual void init() override {}
+    virtual bool open() override { return true; }
+    virtual void close() override {}
+    virtual size_t write(const uint8_t* data, size_t length) override {
+        size_t written = 0;
+        while (written < length) {
+            ssize_t n = ::write(fd_, data + written, length - written);
+            if (n > 0) written += static_cast<size_t>(n);
+            else if (n < 0 && errno == EAGAIN) usleep(10);
+            else break;
+        }
+        return written;
+    }
+    virtual size_t read(uint8_t* buffer, size_t length) override {
+        ssize_t n = ::read(fd_, buffer, length);
+        return n > 0 ? static_cast<size_t>(n) : 0;
+    }
+    virtual bool isOpen() override { return true; }
+    virtual void flush() override {}
+
+private:
+    int fd_;
+};
+
+class BenchNode : public Com_Protocol {
+public:
+    BenchNode(ISerialInterface* serial, ITick* tick, uint32_t workUs) : Com_Protocol(serial, tick, NODE_ID), workUs_(workUs) {}
+
+protected:
+    virtual void handlePing(uint16_t senderId, uint8_t* payload, size_t length) override {
+        const std::chrono::steady_clock::time_point end =
+            std::chrono::steady_clock::now() + std::chrono::microseconds(workUs_);
+        while (std::chrono::steady_clock::now() < end) {}
+        Com_Protocol::handlePing(senderId, payload, length);
+    }
+
+private:
+    uint32_t workUs_;
+};
+
+void appendPing(std::vector<uint8_t>& out, uint16_t seq) {
+    uint8_t payload[PING_PAYLOAD_LENGTH] = { 0 };
+    uint8_t head[14] = { 0x16, 0x16, 0x16, 0x16 };
+    storeBigEndian<uint16_t>(head + 4, static_cast<uint16_t>(8 + PING_PAYLOAD_LENGTH + 2));
+    storeBigEndian<uint16_t>(head + 6, NODE_ID);
+    storeBigEndian<uint16_t>(head + 8, HOST_ID);
+    storeBigEndian<uint16_t>(head + 10, CMD_PING);
+    storeBigEndian<uint16_t>(head + 12, seq);
+    uint16_t crc = crc16XModemUpdate(crc16XModemUpdate(0x0000, head + 6, 8), payload, sizeof(payload));
+
+    out.insert(out.end(), head, head + sizeof(head));
+    out.insert(out.end(), payload, payload + sizeof(payload));
+    out.push_back(static_cast<uint8_t>(crc >> 8));
+    out.push_back(static_cast<uint8_t>(crc & 0xFF));
+}
+
+double processCpuSeconds() {
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_utime.tv_sec + usage.ru_utime.tv_usec / 1e6 + usage.ru_stime.tv_sec + usage.ru_stime.tv_usec / 1e6;
+}
+
+// 측정 쪽 포트 상태
+struct Generator {
+    int fd;
+    uint16_t seq;
+    uint32_t outstanding;
+    size_t pendingBytes;    // PONG 한 프레임에 못 미친 수신 바이트
+    uint64_t replies;
+};
+
+void sendPing(Generator& generator) {
+    std::vector<uint8_t> frame;
+    appendPing(frame, generator.seq++);
+    ssize_t n = ::write(generator.fd, frame.data(), frame.size());
+    if (n == static_cast<ssize_t>(frame.size())) generator.outstanding++;
+}
+
+} // namespace
+
+PortBenchResult runPortBench(const PortBenchConfig& config) {
+    PortBenchResult result;
+    if (config.ports == 0) return result;
+
+    std::vector<int> nodeFds;
+    std::vector<Generator> generators;
+    for (size_t i = 0; i < config.ports; i++) {
+        int pair[2];
+        if (socketpair(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0, pair) != 0) break;
+        nodeFds.push_back(pair[0]);
+        Generator generator = { pair[1], 0, 0, 0, 0 };
+        generators.push_back(generator);
+    }
+    const int epollFd = epoll_create1(EPOLL_CLOEXEC);
+
+    LinuxTickImpl tick;
+    std::vector<std::unique_ptr<FdSerial> > serials;
+    std::vector<std::unique_ptr<BenchNode> > nodes;
+    std::unique_ptr<PortRuntime> runtime;
+    std::vector<std::unique_ptr<LinuxEventLoop> > loops;
+    std::vector<std::thread> threads;
+
+    bool ready = nodeFds.size() == config.ports && epollFd >= 0;
+    for (size_t i = 0; ready && i < config.ports; i++) {
+        struct epoll_event ev = {};
+        ev.events = EPOLLIN;
+        ev.data.u64 = i;
+        ready = epoll_ctl(epollFd, EPOLL_CTL_ADD, generators[i].fd, &ev) == 0;
+        serials.emplace_back(new FdSerial(nodeFds[i]));
+    }
+    if (ready && !config.threadPerPort) {
+        runtime.reset(new PortRuntime(config.workers));
+        for (size_t i = 0; i < config.ports; i++) {
+            size_t port = runtime->addPort(serials[i].get(), nodeFds[i]);
+            nodes.emplace_back(new BenchNode(runtime->portSerial(port), &tick, config.handlerWorkUs));
+            runtime->bindProtocol(port, *nodes[i]);
+        }
+        ready = runtime->start();
+    } else if (ready) {
+        for (size_t i = 0; i < config.ports; i++) {
+            nodes.emplace_back(new BenchNode(serials[i].get(), &tick, config.handlerWorkUs));
+            loops.emplace_back(new LinuxEventLoop());
+            loops[i]->addReadable(nodeFds[i]);
+        }
+        for (size_t i = 0; i < config.ports; i++) {
+            LinuxEventLoop* loop = loops[i].get();
+            BenchNode* node = nodes[i].get();
+            threads.emplace_back([loop, node]() { loop->run(*node); });
+        }
+    }
+
+    if (ready) {
+        size_t busy = static_cast<size_t>(config.ports * config.busyFraction);
+        if (busy == 0) busy = 1;
+        if (busy > config.ports) busy = config.ports;
+
+        const double cpuStart = processCpuSeconds();
+        const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        const std::chrono::steady_clock::time_point end = start + std::chrono::milliseconds(config.durationMs);
+        std::chrono::steady_clock::time_point lastIdle = start;
+        for (size_t i = 0; i < busy; i++) {
+            for (uint32_t k = 0; k < config.window; k++) sendPing(generators[i]);
+        }
+
+        while (std::chrono::steady_clock::now() < end) {
+            struct epoll_event events[MAX_EVENTS];
+            int count = epoll_wait(epollFd, events, MAX_EVENTS, 1);
+            for (int e = 0; e < count; e++) {
+                const size_t index = static_cast<size_t>(events[e].data.u64);
+                Generator& generator = generators[index];
+                uint8_t buffer[4096];
+                ssize_t n;
+                while ((n = ::read(generator.fd, buffer, sizeof(buffer))) > 0) {
+                    generator.pendingBytes += static_cast<size_t>(n);
+                    while (generator.pendingBytes >= PONG_FRAME_LENGTH) {
+                        generator.pendingBytes -= PONG_FRAME_LENGTH;
+                        if (generator.outstanding > 0) generator.outstanding--;
+                        generator.replies++;
+                        if (index < busy) sendPing(generator);
+                    }
+                }
+            }
+            const std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+            if (now - lastIdle >= std::chrono::milliseconds(config.idleIntervalMs)) {
+                lastIdle = now;
+                for (size_t i = busy; i < config.ports; i++) {
+                    if (generators[i].outstanding == 0) sendPing(generators[i]);
+                }
+            }
+        }
+        const double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        const double cpu = processCpuSeconds() - cpuStart;
+
+        uint64_t busyMin = UINT64_MAX;
+        uint64_t busyMax = 0;
+        for (size_t i = 0; i < config.ports; i++) {
+            result.frames += generators[i].replies;
+            result.portFrames.push_back(generators[i].replies);
+            if (i < busy) {
+                if (generators[i].replies < busyMin) busyMin = generators[i].replies;
+                if (generators[i].replies > busyMax) busyMax = generators[i].replies;
+            }
+        }
+        result.framesPerSecond = elapsed > 0.0 ? result.frames / elapsed : 0.0;
+        result.cpuUsPerFrame = result.frames > 0 ? cpu * 1e6 / result.frames : 0.0;
+        result.busyFairness = busyMax > 0 ? static_cast<double>(busyMin) / busyMax : 0.0;
+        if (runtime) {
+            result.runtime = runtime->runtimeStats();
+            for (size_t i = 0; i < config.ports; i++) result.portCpuNs.push_back(runtime->stats(i).cpuNs);
+        }
+        result.ok = true;
+    }
+
+    if (runtime) runtime->stop();
+    for (size_t i = 0; i < loops.size(); i++) loops[i]->stop();
+    for (size_t i = 0; i < threads.size(); i++) threads[i].join();
+    runtime.reset();
+    if (epollFd >= 0) close(epollFd);
+    for (size_t i = 0; i < nodeFds.size(); i++) close(nodeFds[i]);
+    for (size_t i = 0; i < generators.size(); i++) close(generators[i].fd);
+    return result;
+}
+
+#endif
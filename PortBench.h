@@ -0,0 +1,53 @@
+#ifndef PORT_BENCH_H_
+#define PORT_BENCH_H_
+
+#if defined(__linux__)
+#include "PortRuntime.h"
+#include <stdint.h>
+#include <stddef.h>
+#include <vector>
+
+/*
+ * 다중 포트 확장 측정 (Linux 호스트 전용)
+ *
+ *  socketpair 로 만든 루프백 포트 ports 개에 노드(Com_Protocol, PING 핸들러 안에서 handlerWorkUs 동안 바쁘게 대기)를
+ *  하나씩 두고, 측정 스레드가 반대쪽 끝에서 PING 을 보내 PONG 을 셉니다.
+ *
+ *  - 포트의 busyFraction (최소 1개) 은 미응답 PING window 개를 유지하며 연속 전송, 나머지는 idleIntervalMs 마다 1개
+ *  - threadPerPort = false : PortRuntime(workers) 하나에 모든 포트 (runtimeStats(), 포트별 cpuNs 보고)
+ *  - threadPerPort = true  : 비교 기준, 포트마다 LinuxEventLoop 스레드
+ *  - cpuUsPerFrame 은 측정 스레드를 포함한 프로세스 전체 CPU 시간 (getrusage)
+ *
+ *  PortBenchConfig config;
+ *  config.ports = 64;
+ *  config.workers = 4;
+ *  PortBenchResult r = runPortBench(config);
+ *  printf("%.0f frames/s, steals %llu\n", r.framesPerSecond, static_cast<unsigned long long>(r.runtime.steals));
+ */
+
+struct PortBenchConfig {
+    size_t ports = 16;
+    size_t workers = 1;                 // PortRuntime 워커 수 (0 : CPU 수)
+    bool threadPerPort = false;
+    uint32_t handlerWorkUs = 20;        // 핸들러 작업 흉내 (파일 쓰기/CRC 등)
+    uint32_t durationMs = 2000;
+    double busyFraction = 0.25;
+    uint32_t window = 4;
+    uint32_t idleIntervalMs = 10;
+};
+
+struct PortBenchResult {
+    bool ok = false;                    // 포트 생성/런타임 시작 성공
+    uint64_t frames = 0;                // 받은 PONG 합
+    double framesPerSecond = 0.0;
+    double cpuUsPerFrame = 0.0;
+    double busyFairness = 0.0;          // 연속 전송 포트 처리량 최소/최대 (1 : 균등)
+    RuntimeStats runtime;               // PortRuntime 일 때만
+    std::vector<uint64_t> portFrames;   // 포트별 PONG 수
+    std::vector<uint64_t> portCpuNs;    // 포트별 PortStats::cpuNs (PortRuntime 일 때만)
+};
+
+PortBenchResult runPortBench(const PortBenchConfig& config);
+
+#endif
+#endif /* PORT_BENCH_H_ */
@@ -0,0 +1,418 @@
+#if defined(__linux__)
+#include "PortRuntime.h"
+
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <time.h>
+#include <unistd.h>
+#include <string.h>
+
+namespace {
+
+// submit() 이 워커 스레드에서 호출되었는지 판단 (자기 큐에 넣어 캐시 지역성 유지)
+thread_local WorkStealingPool* currentPool = nullptr;
+thread_local size_t currentWorker = 0;
+
+uint64_t monotonicMs() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return static_cast<uint64_t>(ts.tv_sec) * 1000ULL + static_cast<uint64_t>(ts.tv_nsec) / 1000000ULL;
+}
+
+uint64_t threadCpuNs() {
+    struct timespec ts;
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+    return static_cast<uint64_t>(ts.tv_sec) * 1000000000ULL + static_cast<uint64_t>(ts.tv_nsec);
+}
+
+void updateMax(std::atomic<size_t>& target, size_t value) {
+    if (value > target.load(std::memory_order_relaxed)) target.store(value, std::memory_order_relaxed);
+}
+
+} // namespace
+
+// ---------------------------------------------------------------------------
+// WorkStealingPool
+
+WorkStealingPool::WorkStealingPool(size_t workers) :
+    queued_(0), sleeping_(0), nextWorker_(0), stopRequested_(false),
+    tasks_(0), steals_(0), parks_(0)
+{
+    if (workers == 0) workers = 1;
+    for (size_t i = 0; i < workers; i++) workers_.emplace_back(new Worker());
+}
+
+WorkStealingPool::~WorkStealingPool() {
+    stop();
+}
+
+void WorkStealingPool::start() {
+    stopRequested_.store(false, std::memory_order_release);
+    for (size_t i = 0; i < workers_.size(); i++) {
+        if (!workers_[i]->thread.joinable()) {
+            workers_[i]->thread = std::thread(&WorkStealingPool::workerLoop, this, i);
+        }
+    }
+}
+
+void WorkStealingPool::stop() {
+    {
+        std::lock_guard<std::mutex> lock(parkMutex_);
+        stopRequested_.store(true, std::memory_order_release);
+    }
+    parkCondition_.notify_all();
+
+    for (size_t i = 0; i < workers_.size(); i++) {
+        if (workers_[i]->thread.joinable()) workers_[i]->thread.join();
+    }
+    for (size_t i = 0; i < workers_.size(); i++) {
+        std::lock_guard<std::mutex> lock(workers_[i]->mutex);
+        workers_[i]->queue.clear();
+    }
+    queued_.store(0);
+}
+
+void WorkStealingPool::submit(TaskFunction function, void* context) {
+    size_t index = (currentPool == this) ? currentWorker
+                                         : nextWorker_.fetch_add(1, std::memory_order_relaxed) % workers_.size();
+    Task task = { function, context };
+    {
+        std::lock_guard<std::mutex> lock(workers_[index]->mutex);
+        workers_[index]->queue.push_back(task);
+    }
+
+    // queued_ 증가 후 sleeping_ 확인, 잠드는 쪽은 sleeping_ 증가 후 queued_ 확인 (둘 중 하나는 상대를 봄)
+    queued_.fetch_add(1);
+    if (sleeping_.load() > 0) {
+        std::lock_guard<std::mutex> lock(parkMutex_);
+        parkCondition_.notify_one();
+    }
+}
+
+RuntimeStats WorkStealingPool::stats() const {
+    RuntimeStats stats;
+    stats.tasks = tasks_.load(std::memory_order_relaxed);
+    stats.steals = steals_.load(std::memory_order_relaxed);
+    stats.parks = parks_.load(std::memory_order_relaxed);
+    return stats;
+}
+
+bool WorkStealingPool::popLocal(size_t index, Task& task) {
+    Worker& worker = *workers_[index];
+    std::lock_guard<std::mutex> lock(worker.mutex);
+    if (worker.queue.empty()) return false;
+    task = worker.queue.front();
+    worker.queue.pop_front();
+    queued_.fetch_sub(1);
+    return true;
+}
+
+bool WorkStealingPool::steal(size_t index, Task& task) {
+    for (size_t i = 1; i < workers_.size(); i++) {
+        Worker& victim = *workers_[(index + i) % workers_.size()];
+        std::lock_guard<std::mutex> lock(victim.mutex);
+        if (victim.queue.empty()) continue;
+        task = victim.queue.back();
+        victim.queue.pop_back();
+        queued_.fetch_sub(1);
+        steals_.fetch_add(1, std::memory_order_relaxed);
+        return true;
+    }
+    return false;
+}
+
+void WorkStealingPool::workerLoop(size_t index) {
+    currentPool = this;
+    currentWorker = index;
+
+    while (!stopRequested_.load(std::memory_order_acquire)) {
+        Task task;
+        if (popLocal(index, task) || steal(index, task)) {
+            task.function(task.context);
+            tasks_.fetch_add(1, std::memory_order_relaxed);
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(parkMutex_);
+        sleeping_.fetch_add(1);
+        while (queued_.load() == 0 && !stopRequested_.load(std::memory_order_acquire)) {
+            parks_.fetch_add(1, std::memory_order_relaxed);
+            parkCondition_.wait(lock);
+        }
+        sleeping_.fetch_sub(1);
+    }
+
+    currentPool = nullptr;
+}
+
+// ---------------------------------------------------------------------------
+// PortSerial
+
+PortSerial::PortSerial(ISerialInterface* serial) :
+    serial_(serial), rxHead_(0), rxLength_(0), txHead_(0), rxBytes_(0), txBytes_(0)
+{
+}
+
+size_t PortSerial::write(const uint8_t* data, size_t length) {
+    txBuffer_.insert(txBuffer_.end(), data, data + length);
+    return length;
+}
+
+size_t PortSerial::read(uint8_t* buffer, size_t length) {
+    // 엔진은 1바이트씩 읽으므로 직렬 포트 read() 는 RX_CHUNK 단위로 묶음
+    if (rxHead_ == rxLength_) {
+        rxHead_ = 0;
+        rxLength_ = serial_->read(rxBuffer_, RX_CHUNK);
+        rxBytes_ += rxLength_;
+        if (rxLength_ == 0) return 0;
+    }
+    size_t n = rxLength_ - rxHead_;
+    if (n > length) n = length;
+    memcpy(buffer, rxBuffer_ + rxHead_, n);
+    rxHead_ += n;
+    return n;
+}
+
+void PortSerial::flush() {
+    rxHead_ = rxLength_ = 0;
+    serial_->flush();
+}
+
+bool PortSerial::setBaudRate(uint32_t baudRate) {
+    drain();
+    return serial_->setBaudRate(baudRate);
+}
+
+size_t PortSerial::drain() {
+    if (txHead_ < txBuffer_.size()) {
+        size_t n = serial_->write(txBuffer_.data() + txHead_, txBuffer_.size() - txHead_);
+        txHead_ += n;
+        txBytes_ += n;
+    }
+    if (txHead_ == txBuffer_.size()) {
+        txBuffer_.clear();
+        txHead_ = 0;
+    }
+    return txQueued();
+}
+
+// ---------------------------------------------------------------------------
+// PortRuntime
+
+PortRuntime::PortRuntime(size_t workers) :
+    pool_(workers ? workers : std::thread::hardware_concurrency()),
+    epollFd_(epoll_create1(EPOLL_CLOEXEC)),
+    wakeFd_(eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC)),
+    running_(false),
+    reactorDeadlineMs_(NO_DEADLINE)
+{
+    if (epollFd_ >= 0 && wakeFd_ >= 0) {
+        struct epoll_event ev = {};
+        ev.events = EPOLLIN;
+        ev.data.u64 = WAKE_EVENT;
+        epoll_ctl(epollFd_, EPOLL_CTL_ADD, wakeFd_, &ev);
+    }
+}
+
+PortRuntime::~PortRuntime() {
+    stop();
+    if (wakeFd_ >= 0) close(wakeFd_);
+    if (epollFd_ >= 0) close(epollFd_);
+}
+
+size_t PortRuntime::addPort(ISerialInterface* serial, int fd) {
+    std::unique_ptr<Port> port(new Port());
+    port->runtime = this;
+    port->serial.reset(new PortSerial(serial));
+    port->fd = fd;
+    port->protocol = nullptr;
+    port->process = nullptr;
+    port->timeUntilTimeout = nullptr;
+    port->state.store(0);
+    port->deadlineMs.store(NO_DEADLINE);
+    port->postQueueMax = 0;
+    port->runs.store(0);
+    port->rxEvents.store(0);
+    port->timeouts.store(0);
+    port->posted.store(0);
+    port->rxBytes.store(0);
+    port->txBytes.store(0);
+    port->cpuNs.store(0);
+    port->txQueueDepth.store(0);
+    port->txQueueMax.store(0);
+
+    size_t index = ports_.size();
+    if (fd >= 0 && epollFd_ >= 0) {
+        // 엣지 트리거 : 포트 작업이 읽을 수 있는 만큼 읽으므로 이후 도착분만 다시 알림
+        struct epoll_event ev = {};
+        ev.events = EPOLLIN | EPOLLET;
+        ev.data.u64 = index;
+        epoll_ctl(epollFd_, EPOLL_CTL_ADD, fd, &ev);
+    }
+    ports_.push_back(std::move(port));
+    return index;
+}
+
+bool PortRuntime::start() {
+    if (running_.load() || epollFd_ < 0 || wakeFd_ < 0) return false;
+    for (size_t i = 0; i < ports_.size(); i++) {
+        if (!ports_[i]->protocol) return false;
+    }
+
+    running_.store(true);
+    pool_.start();
+    reactor_ = std::thread(&PortRuntime::reactorLoop, this);
+    return true;
+}
+
+void PortRuntime::stop() {
+    if (!running_.exchange(false)) return;
+    wakeReactor();
+    if (reactor_.joinable()) reactor_.join();
+    pool_.stop();
+
+    // 큐에서 버려진 포트 작업 : 다시 start() 하면 새로 예약되도록 상태 초기화
+    for (size_t i = 0; i < ports_.size(); i++) ports_[i]->state.store(0);
+}
+
+void PortRuntime::notify(size_t port) {
+    Port& p = *ports_[port];
+    p.rxEvents.fetch_add(1, std::memory_order_relaxed);
+    schedule(p, PENDING_RX);
+}
+
+void PortRuntime::post(size_t port, std::function<void()> work) {
+    Port& p = *ports_[port];
+    {
+        std::lock_guard<std::mutex> lock(p.postMutex);
+        p.posts.push_back(std::move(work));
+        if (p.posts.size() > p.postQueueMax) p.postQueueMax = p.posts.size();
+    }
+    p.posted.fetch_add(1, std::memory_order_relaxed);
+    schedule(p, PENDING_POST);
+}
+
+PortStats PortRuntime::stats(size_t port) const {
+    Port& p = *ports_[port];
+    PortStats stats;
+    stats.runs = p.runs.load(std::memory_order_relaxed);
+    stats.rxEvents = p.rxEvents.load(std::memory_order_relaxed);
+    stats.timeouts = p.timeouts.load(std::memory_order_relaxed);
+    stats.posted = p.posted.load(std::memory_order_relaxed);
+    stats.rxBytes = p.rxBytes.load(std::memory_order_relaxed);
+    stats.txBytes = p.txBytes.load(std::memory_order_relaxed);
+    stats.cpuNs = p.cpuNs.load(std::memory_order_relaxed);
+    {
+        std::lock_guard<std::mutex> lock(p.postMutex);
+        stats.postQueueDepth = p.posts.size();
+        stats.postQueueMax = p.postQueueMax;
+    }
+    stats.txQueueDepth = p.txQueueDepth.load(std::memory_order_relaxed);
+    stats.txQueueMax = p.txQueueMax.load(std::memory_order_relaxed);
+    return stats;
+}
+
+// 대기 비트를 남기고, 포트 작업이 풀에 없을 때만 새로 넣음
+void PortRuntime::schedule(Port& port, uint32_t pending) {
+    uint32_t previous = port.state.fetch_or(pending | SCHEDULED, std::memory_order_acq_rel);
+    if (!(previous & SCHEDULED)) pool_.submit(&PortRuntime::runPortTask, &port);
+}
+
+void PortRuntime::runPortTask(void* context) {
+    Port* port = static_cast<Port*>(context);
+    port->runtime->runPort(*port);
+}
+
+void PortRuntime::runPort(Port& port) {
+    uint64_t cpuStart = threadCpuNs();
+    uint32_t pending = port.state.fetch_and(SCHEDULED, std::memory_order_acq_rel) & ~SCHEDULED;
+    PortSerial& serial = *port.serial;
+
+    if (pending & PENDING_POST) {
+        std::deque<std::function<void()> > posts;
+        {
+            std::lock_guard<std::mutex> lock(port.postMutex);
+            posts.swap(port.posts);
+        }
+        for (size_t i = 0; i < posts.size(); i++) posts[i]();
+    }
+
+    // post() 만 있어도 호출 : 타임아웃과 수신 상태를 같은 순서로 처리
+    port.process(port.protocol);
+
+    size_t batch = serial.txQueued();
+    size_t remaining = serial.drain();
+    updateMax(port.txQueueMax, batch);
+    port.txQueueDepth.store(remaining, std::memory_order_relaxed);
+
+    // 다음 프레임 타임아웃 : 수신 스레드가 더 늦게 깨어날 예정이면 깨워서 대기 시간 갱신
+    uint64_t remainingMs = port.timeUntilTimeout(port.protocol);
+    uint64_t deadline = (remainingMs == NO_DEADLINE) ? NO_DEADLINE : monotonicMs() + remainingMs;
+    port.deadlineMs.store(deadline);
+    if (deadline < reactorDeadlineMs_.load()) wakeReactor();
+
+    port.rxBytes.store(serial.rxBytes_, std::memory_order_relaxed);
+    port.txBytes.store(serial.txBytes_, std::memory_order_relaxed);
+    port.runs.fetch_add(1, std::memory_order_relaxed);
+    port.cpuNs.fetch_add(threadCpuNs() - cpuStart, std::memory_order_relaxed);
+
+    // 실행 중 새 작업이 들어왔거나 송신이 남았으면 큐 뒤에 다시 넣음 (다른 포트에 차례 양보)
+    if (remaining > 0) port.state.fetch_or(PENDING_RX, std::memory_order_acq_rel);
+    uint32_t expected = SCHEDULED;
+    if (!port.state.compare_exchange_strong(expected, 0, std::memory_order_acq_rel)) {
+        pool_.submit(&PortRuntime::runPortTask, &port);
+    }
+}
+
+int PortRuntime::pollTimeouts() {
+    // 검사 중 갱신된 기한은 항상 wakeReactor() 를 부르도록 먼저 최대값으로 설정
+    reactorDeadlineMs_.store(NO_DEADLINE);
+
+    uint64_t now = monotonicMs();
+    uint64_t next = NO_DEADLINE;
+    for (size_t i = 0; i < ports_.size(); i++) {
+        Port& port = *ports_[i];
+        uint64_t deadline = port.deadlineMs.load();
+        if (deadline == NO_DEADLINE) continue;
+        if (deadline <= now) {
+            if (port.deadlineMs.compare_exchange_strong(deadline, NO_DEADLINE)) {
+                port.timeouts.fetch_add(1, std::memory_order_relaxed);
+                schedule(port, PENDING_RX);
+            }
+        } else if (deadline < next) {
+            next = deadline;
+        }
+    }
+
+    reactorDeadlineMs_.store(next);
+    return next == NO_DEADLINE ? -1 : static_cast<int>(next - now);
+}
+
+void PortRuntime::wakeReactor() {
+    if (wakeFd_ < 0) return;
+    uint64_t one = 1;
+    ssize_t ret = ::write(wakeFd_, &one, sizeof(one));
+    (void)ret;
+}
+
+void PortRuntime::reactorLoop() {
+    struct epoll_event events[MAX_EVENTS];
+
+    while (running_.load()) {
+        int timeoutMs = pollTimeouts();
+        int n = epoll_wait(epollFd_, events, MAX_EVENTS, timeoutMs);
+        for (int i = 0; i < n; i++) {
+            if (events[i].data.u64 == WAKE_EVENT) {
+                uint64_t count;
+                ssize_t ret = ::read(wakeFd_, &count, sizeof(count));
+                (void)ret;
+            } else {
+                Port& port = *ports_[events[i].data.u64];
+                port.rxEvents.fetch_add(1, std::memory_order_relaxed);
+                schedule(port, PENDING_RX);
+            }
+        }
+    }
+}
+
+#endif
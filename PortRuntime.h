@@ -0,0 +1,256 @@
+#ifndef PORT_RUNTIME_H_
+#define PORT_RUNTIME_H_
+
+#if defined(__linux__)
+#include "ISerialInterface.h"
+#include <stdint.h>
+#include <stddef.h>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/*
+ * 다중 포트 호스트 런타임 (Linux)
+ *
+ *  여러 버스의 Com_Protocol 인스턴스를 작업 훔치기(work-stealing) 스레드 풀 하나에서 실행합니다.
+ *  포트마다 스레드를 두지 않으므로 유휴 버스는 CPU 를 쓰지 않고, 바쁜 버스의 작업은 남는 워커가 가져갑니다.
+ *
+ *  - 수신 스레드(epoll) 1개가 fd 읽기 이벤트와 포트별 프레임 타임아웃을 감시해 포트 작업을 풀에 넣음
+ *  - 포트 작업 : post() 작업 실행 -> processReceivedData() (파싱 + 핸들러) -> 송신 버퍼 비우기
+ *  - 한 포트의 작업은 한 번에 한 워커에서만, 들어온 순서대로 실행 (인스턴스 잠금 불필요)
+ *  - 포트 직렬 포트는 PortSerial 로 감쌈 : 수신은 묶어서 read(), 핸들러의 송신은 모았다가 작업 끝에 write()
+ *
+ *  PortRuntime runtime;                                        // 워커 수 : CPU 수
+ *  size_t port = runtime.addPort(&serial, serial.fd());
+ *  Com_Protocol protocol(runtime.portSerial(port), &tick, 0x0001);
+ *  runtime.bindProtocol(port, protocol);                       // AsyncCom_Protocol 이면 poll()/요청 타임아웃 포함
+ *  runtime.start();
+ *  runtime.post(port, [&]() { protocol.sendPing(0x0002); });  // 다른 스레드에서 송신
+ *  PortStats stats = runtime.stats(port);
+ */
+
+struct PortStats {
+    uint64_t runs = 0;              // 실행된 포트 작업 수
+    uint64_t rxEvents = 0;          // fd 읽기 이벤트 + notify()
+    uint64_t timeouts = 0;          // 프레임 타임아웃으로 실행한 횟수
+    uint64_t posted = 0;            // post() 작업 수
+    uint64_t rxBytes = 0;
+    uint64_t txBytes = 0;
+    uint64_t cpuNs = 0;             // 포트 작업의 스레드 CPU 시간 합
+    size_t postQueueDepth = 0;      // 실행을 기다리는 post() 작업
+    size_t postQueueMax = 0;
+    size_t txQueueDepth = 0;        // 송신 버퍼에 남은 바이트 (write() 가 덜 나간 경우)
+    size_t txQueueMax = 0;          // 작업 한 번에 모인 최대 송신 바이트
+};
+
+struct RuntimeStats {
+    uint64_t tasks = 0;             // 실행된 포트 작업 수 (전체)
+    uint64_t steals = 0;            // 다른 워커 큐에서 가져온 작업 수
+    uint64_t parks = 0;             // 일이 없어 잠든 횟수
+};
+
+// bindProtocol 의 선택 훅 : poll()/timeUntilRequestTimeout() 이 있는 타입(AsyncCom_Protocol)은
+// 포트 작업마다 poll() 로 만료된 요청을 재개하고, 요청 타임아웃도 수신 스레드의 대기 기한에 넣음
+// (훅은 bindProtocol 에 넘긴 정적 타입으로 찾으므로 AsyncCom_Protocol 은 기반 클래스 참조로 넘기지 않음)
+struct PortProtocolHooks {
+    template <typename P>
+    static auto poll(P& protocol, int) -> decltype(protocol.poll(), void()) { protocol.poll(); }
+    template <typename P>
+    static void poll(P&, long) {}
+
+    template <typename P>
+    static auto timeUntilRequestTimeout(P& protocol, int) -> decltype(static_cast<uint32_t>(protocol.timeUntilRequestTimeout())) {
+        return protocol.timeUntilRequestTimeout();
+    }
+    template <typename P>
+    static uint32_t timeUntilRequestTimeout(P&, long) { return P::NO_RECEIVE_DEADLINE; }
+};
+
+// 워커별 큐 + 훔치기 : 자기 큐는 앞에서(FIFO, 포트 간 공정성), 다른 큐는 뒤에서 가져옴
+class WorkStealingPool {
+public:
+    typedef void (*TaskFunction)(void* context);
+
+    explicit WorkStealingPool(size_t workers);
+    ~WorkStealingPool();
+
+    void start();
+    void stop();                    // 큐에 남은 작업은 실행하지 않음
+    void submit(TaskFunction function, void* context);   // 워커 스레드에서 호출하면 자기 큐에 넣음
+
+    size_t workerCount() const { return workers_.size(); }
+    RuntimeStats stats() const;
+
+private:
+    struct Task {
+        TaskFunction function;
+        void* context;
+    };
+
+    struct Worker {
+        std::mutex mutex;
+        std::deque<Task> queue;
+        std::thread thread;
+    };
+
+    std::vector<std::unique_ptr<Worker> > workers_;
+    std::atomic<size_t> queued_;    // 모든 큐의 작업 수
+    std::atomic<size_t> sleeping_;
+    std::atomic<size_t> nextWorker_;
+    std::atomic<bool> stopRequested_;
+    std::mutex parkMutex_;
+    std::condition_variable parkCondition_;
+
+    std::atomic<uint64_t> tasks_;
+    std::atomic<uint64_t> steals_;
+    std::atomic<uint64_t> parks_;
+
+    void workerLoop(size_t index);
+    bool popLocal(size_t index, Task& task);
+    bool steal(size_t index, Task& task);
+
+    WorkStealingPool(const WorkStealingPool&);
+    WorkStealingPool& operator=(const WorkStealingPool&);
+};
+
+// 포트 작업 안에서만 쓰이는 직렬 포트 래퍼 (포트 작업 밖에서 송신하려면 post() 사용)
+class PortSerial : public ISerialInterface {
+public:
+    explicit PortSerial(ISerialInterface* serial);
+
+    virtual void init() override { serial_->init(); }
+    virtual bool open() override { return serial_->open(); }
+    virtual void close() override { serial_->close(); }
+    virtual size_t write(const uint8_t* data, size_t length) override;  // 송신 버퍼에 추가
+    virtual size_t read(uint8_t* buffer, size_t length) override;       // 수신 버퍼에서, 비면 묶어서 읽음
+    virtual bool isOpen() override { return serial_->isOpen(); }
+    virtual void flush() override;
+    virtual bool setBaudRate(uint32_t baudRate) override;   // 송신 버퍼를 비운 뒤 변경
+    virtual uint32_t getBaudRate() const override { return serial_->getBaudRate(); }
+    virtual bool supportsBaudRate(uint32_t baudRate) const override { return serial_->supportsBaudRate(baudRate); }
+
+    size_t drain();                 // 송신 버퍼를 직렬 포트로 내보냄, 남은 바이트 수 반환
+    size_t txQueued() const { return txBuffer_.size() - txHead_; }
+
+private:
+    friend class PortRuntime;
+    static const size_t RX_CHUNK = 256;
+
+    ISerialInterface* serial_;
+    uint8_t rxBuffer_[RX_CHUNK];
+    size_t rxHead_;
+    size_t rxLength_;
+    std::vector<uint8_t> txBuffer_;
+    size_t txHead_;
+    uint64_t rxBytes_;
+    uint64_t txBytes_;
+};
+
+class PortRuntime {
+public:
+    explicit PortRuntime(size_t workers = 0);   // 0 : std::thread::hardware_concurrency()
+    ~PortRuntime();
+
+    // 포트 등록 (start() 전) : fd < 0 이면 notify() 로만 깨움
+    size_t addPort(ISerialInterface* serial, int fd = -1);
+    ISerialInterface* portSerial(size_t port) { return ports_[port]->serial.get(); }
+    template <typename Protocol>
+    void bindProtocol(size_t port, Protocol& protocol);
+
+    bool start();
+    void stop();                    // 실행 중인 포트 작업이 끝날 때까지 대기
+
+    void notify(size_t port);       // 수신 데이터 도착 (fd 없는 전송용, 스레드 안전)
+    void post(size_t port, std::function<void()> work);   // 포트 작업 순서에 맞춰 실행 (스레드 안전)
+
+    size_t portCount() const { return ports_.size(); }
+    size_t workerCount() const { return pool_.workerCount(); }
+    PortStats stats(size_t port) const;
+    RuntimeStats runtimeStats() const { return pool_.stats(); }
+
+private:
+    static const uint64_t NO_DEADLINE = UINT64_MAX;
+    static const size_t WAKE_EVENT = SIZE_MAX;
+    static const int MAX_EVENTS = 64;
+
+    // 포트 상태 비트 : SCHEDULED 가 설정된 동안 포트 작업은 풀에 하나만 존재
+    static const uint32_t PENDING_RX = 1u << 0;
+    static const uint32_t PENDING_POST = 1u << 1;
+    static const uint32_t SCHEDULED = 1u << 2;
+
+    struct Port {
+        PortRuntime* runtime;
+        std::unique_ptr<PortSerial> serial;
+        int fd;
+
+        void* protocol;
+        void (*process)(void* protocol);
+        uint64_t (*timeUntilTimeout)(void* protocol);   // 프레임/요청 타임아웃 중 가까운 쪽까지 남은 ms, 없으면 NO_DEADLINE
+
+        std::atomic<uint32_t> state;
+        std::atomic<uint64_t> deadlineMs;   // 다음 프레임 타임아웃 (steady clock ms)
+
+        std::mutex postMutex;
+        std::deque<std::function<void()> > posts;
+        size_t postQueueMax;
+
+        std::atomic<uint64_t> runs;
+        std::atomic<uint64_t> rxEvents;
+        std::atomic<uint64_t> timeouts;
+        std::atomic<uint64_t> posted;
+        std::atomic<uint64_t> rxBytes;
+        std::atomic<uint64_t> txBytes;
+        std::atomic<uint64_t> cpuNs;
+        std::atomic<size_t> txQueueDepth;
+        std::atomic<size_t> txQueueMax;
+    };
+
+    WorkStealingPool pool_;
+    std::vector<std::unique_ptr<Port> > ports_;
+    int epollFd_;
+    int wakeFd_;
+    std::thread reactor_;
+    std::atomic<bool> running_;
+    std::atomic<uint64_t> reactorDeadlineMs_;   // 수신 스레드가 다음에 깨어날 시각
+
+    static void runPortTask(void* context);
+    template <typename Protocol>
+    static void processThunk(void* protocol) {
+        Protocol& p = *static_cast<Protocol*>(protocol);
+        p.processReceivedData();
+        PortProtocolHooks::poll(p, 0);
+    }
+    template <typename Protocol>
+    static uint64_t timeoutThunk(void* protocol) {
+        Protocol& p = *static_cast<Protocol*>(protocol);
+        uint32_t remaining = p.timeUntilReceiveTimeout();
+        uint32_t request = PortProtocolHooks::timeUntilRequestTimeout(p, 0);
+        if (request < remaining) remaining = request;
+        return remaining == Protocol::NO_RECEIVE_DEADLINE ? NO_DEADLINE : remaining;
+    }
+
+    void schedule(Port& port, uint32_t pending);
+    void runPort(Port& port);
+    void reactorLoop();
+    int pollTimeouts();             // 만료된 포트를 깨우고 다음 대기 시간(ms, -1 : 무한) 반환
+    void wakeReactor();
+
+    PortRuntime(const PortRuntime&);
+    PortRuntime& operator=(const PortRuntime&);
+};
+
+template <typename Protocol>
+void PortRuntime::bindProtocol(size_t port, Protocol& protocol) {
+    Port& p = *ports_[port];
+    p.protocol = &protocol;
+    p.process = &processThunk<Protocol>;
+    p.timeUntilTimeout = &timeoutThunk<Protocol>;
+}
+
+#endif
+#endif /* PORT_RUNTIME_H_ */
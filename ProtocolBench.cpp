@@ -0,0 +1,172 @@
+/*
+ * 호스트 측정/회귀 검사 실행 파일 (README 의 측정값 재현용)
+ *
+ *  응용 프로그램에 모든 .cpp 를 넣어도 main 이 생기지 않도록 PROTOCOL_BENCH_MAIN 을 정의할 때만 빌드됩니다.
+ *
+ *  g++ -std=c++20 -O2 -pthread -DPROTOCOL_BENCH_MAIN -I. $(ls *.cpp | grep -v -E '^(STM32|Qt)') -o protocol_bench
+ *  ./protocol_bench selftest       // runProtocolSelfTests, 실패 수를 종료 코드로
+ *  ./protocol_bench dispatch       // 가상 어댑터 / 정적 정책 엔진 cycles/byte
+ *  ./protocol_bench fec            // 비트 에러율별 goodput (FEC parity 0/8/16/32)
+ *  ./protocol_bench compression    // LZSS 압축률, 호스트 압축/해제 속도, 115200bps/1Mbps 업로드 시간
+ *  ./protocol_bench ports          // 포트 1~64 개 : 포트별 스레드 / PortRuntime(워커 1, 4) 처리량과 포트별 CPU
+ */
+#if defined(PROTOCOL_BENCH_MAIN) && !defined(USE_HAL_DRIVER)
+#include "CompressionBench.h"
+#include "DispatchBench.h"
+#include "FecBench.h"
+#include "PortBench.h"
+#include "ProtocolSelfTest.h"
+#include <stdio.h>
+#include <string.h>
+#include <thread>
+
+namespace {
+
+int runSelfTests() {
+    std::vector<SelfTestResult> results;
+    size_t failed = runProtocolSelfTests(results);
+    for (const SelfTestResult& r : results) printf("%s %s %s\n", r.passed ? "ok  " : "FAIL", r.name, r.detail.c_str());
+    printf("%zu/%zu passed\n", results.size() - failed, results.size());
+    return static_cast<int>(failed);
+}
+
+int runDispatch() {
+    DispatchBenchConfig config;
+    DispatchBenchResult r = runDispatchBench(config);
+    printf("%u frames (PING + 32-byte CONFIG), %llu bytes, best of %u\n", static_cast<unsigned>(config.frames),
+           static_cast<unsigned long long>(r.bytes), static_cast<unsigned>(config.rounds));
+    printf("%-28s %8s %8s\n", "", "cyc/B", "ns/B");
+    printf("%-28s %8.2f %8.2f\n", "Com_Protocol (virtual)", r.virtualCyclesPerByte, r.virtualNsPerByte);
+    printf("%-28s %8.2f %8.2f\n", "Com_ProtocolEngine (static)", r.staticCyclesPerByte, r.staticNsPerByte);
+    if (r.virtualReplyBytes != r.staticReplyBytes) {
+        printf("reply bytes differ: %llu / %llu\n", static_cast<unsigned long long>(r.virtualReplyBytes),
+               static_cast<unsigned long long>(r.staticReplyBytes));
+        return 1;
+    }
+    return 0;
+}
+
+int runFec() {
+    const double bitErrorRates[] = { 0.0, 1e-4, 3e-4, 1e-3, 3e-3 };
+    const uint8_t parities[] = { 0, 8, 16, 32 };
+    FecBenchConfig config;
+    printf("goodput B/s: %u bps, %zu-byte PING stop-and-wait, %u ms simulated\n",
+           static_cast<unsigned>(config.baudRate), config.payloadLength, static_cast<unsigned>(config.durationMs));
+    printf("%-8s", "BER");
+    for (uint8_t parity : parities) printf("  parity %-3u", static_cast<unsigned>(parity));
+    printf("\n");
+    for (double ber : bitErrorRates) {
+        printf("%-8g", ber);
+        for (uint8_t parity : parities) printf("  %10.0f", runFecBench(config, ber, parity).goodput);
+        printf("\n");
+    }
+    return 0;
+}
+
+int runCompression() {
+    const CompressionSample samples[] = { CompressionSample::MOTION, CompressionSample::CONFIG, CompressionSample::RANDOM };
+    const uint32_t baudRates[] = { 115200, 1000000 };
+    int failed = 0;
+    printf("%-8s %8s %7s %9s %9s %6s", "file", "bytes", "packed", "comp MB/s", "dec MB/s", "ns/B");
+    for (uint32_t baudRate : baudRates) printf("  %7u bps raw -> lzss", static_cast<unsigned>(baudRate));
+    printf("\n");
+    for (CompressionSample sample : samples) {
+        std::vector<uint8_t> file = makeCompressionSample(sample);
+        CompressionBenchConfig config;
+        CompressionBenchResult r;
+        printf("%-8s %8zu", compressionSampleName(sample), file.size());
+        for (size_t i = 0; i < sizeof(baudRates) / sizeof(baudRates[0]); i++) {
+            config.baudRate = baudRates[i];
+            r = runCompressionBench(config, file.data(), file.size());
+            if (!r.ok) failed++;
+            if (i == 0) {
+                printf(" %6.1f%% %9.1f %9.1f %6.1f", 100.0 * r.packedBytes / r.fileBytes, r.compressMBps,
+                       r.decompressMBps, r.decompressNsPerByte);
+            }
+            printf("  %8.2f -> %8.2f s%s", r.rawUploadSeconds, r.lzssUploadSeconds, r.lzssUsed ? "" : "*");
+        }
+        printf("\n");
+    }
+    printf("* LZSS requested but sent uncompressed (packed >= 95%%)\n");
+    return failed;
+}
+
+int runPorts() {
+    const size_t portCounts[] = { 1, 4, 16, 64 };
+    const uint32_t workUs[] = { 20, 0 };
+    struct Mode {
+        const char* name;
+        bool threadPerPort;
+        size_t workers;
+    };
+    const Mode modes[] = { { "thread/port", true, 0 }, { "runtime w1", false, 1 }, { "runtime w4", false, 4 } };
+    int failed = 0;
+    PortBenchConfig base;
+    printf("socketpair ports, %.0f%% busy (window %u), others 1 PING / %u ms, %u ms each, %u CPU\n",
+           base.busyFraction * 100, static_cast<unsigned>(base.window), static_cast<unsigned>(base.idleIntervalMs),
+           static_cast<unsigned>(base.durationMs), std::thread::hardware_concurrency());
+    printf("%-5s %-5s %-12s %9s %8s %5s %9s %7s %7s %11s %11s\n", "ports", "work", "mode", "frames/s", "cpu us/f",
+           "fair", "tasks", "steals", "parks", "port cpu avg", "port cpu max");
+    for (uint32_t work : workUs) {
+        for (size_t ports : portCounts) {
+            for (const Mode& mode : modes) {
+                PortBenchConfig config;
+                config.ports = ports;
+                config.handlerWorkUs = work;
+                config.threadPerPort = mode.threadPerPort;
+                config.workers = mode.workers;
+                PortBenchResult r = runPortBench(config);
+                if (!r.ok) {
+                    printf("%-5zu %3uus %-12s failed\n", ports, static_cast<unsigned>(work), mode.name);
+                    failed++;
+                    continue;
+                }
+                printf("%-5zu %3uus %-12s %9.0f %8.1f %5.2f", ports, static_cast<unsigned>(work), mode.name,
+                       r.framesPerSecond, r.cpuUsPerFrame, r.busyFairness);
+                if (r.portCpuNs.empty()) {
+                    printf(" %9s %7s %7s %11s %11s\n", "-", "-", "-", "-", "-");
+                    continue;
+                }
+                uint64_t total = 0;
+                uint64_t most = 0;
+                for (uint64_t ns : r.portCpuNs) {
+                    total += ns;
+                    if (ns > most) most = ns;
+                }
+                printf(" %9llu %7llu %7llu %9.1fms %9.1fms\n", static_cast<unsigned long long>(r.runtime.tasks),
+                       static_cast<unsigned long long>(r.runtime.steals), static_cast<unsigned long long>(r.runtime.parks),
+                       total / 1e6 / r.portCpuNs.size(), most / 1e6);
+            }
+        }
+    }
+    return failed;
+}
+
+struct BenchCommand {
+    const char* name;
+    int (*run)();
+};
+
+const BenchCommand COMMANDS[] = {
+    { "selftest", runSelfTests },
+    { "dispatch", runDispatch },
+    { "fec", runFec },
+    { "compression", runCompression },
+    { "ports", runPorts },
+};
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const size_t count = sizeof(COMMANDS) / sizeof(COMMANDS[0]);
+    if (argc >= 2) {
+        for (size_t i = 0; i < count; i++) {
+            if (strcmp(argv[1], COMMANDS[i].name) == 0) return COMMANDS[i].run();
+        }
+    }
+    printf("usage: %s <command>\n", argc > 0 ? argv[0] : "protocol_bench");
+    for (size_t i = 0; i < count; i++) printf("  %s\n", COMMANDS[i].name);
+    return 2;
+}
+
+#endif
@@ -0,0 +1,739 @@
+#if !defined(USE_HAL_DRIVER)
+#include "ProtocolSelfTest.h"
+#include "com_protocol_class.h"
+#include "MemoryFileStore.h"
+#include "SimulatedBus.h"
+#include "com_protocol_upload.h"
+#include "crc16.h"
+#include "payload_schema.h"
+#include "protocol_messages.h"
+#include "sha256.h"
+#include <deque>
+#include <stdio.h>
+
+namespace {
+
+const uint16_t NODE_ID = 1;
+const uint16_t HOST_ID = 2;
+const uint16_t CMD_PING = 0x0001;
+const uint16_t CMD_PONG = 0x8001;
+const uint16_t CMD_FILE_RECEIVE = 0x0002;
+const uint16_t CMD_FILE_RECEIVE_ACK = 0x8002;
+const uint16_t CMD_SYNC = 0x0020;
+const uint16_t CMD_LINK_SPEED = 0x0021;
+const uint16_t CMD_LINK_SPEED_ACK = 0x8021;
+
+// 읽기는 rx 에 넣어 둔 바이트, 쓰기는 tx 에 모음
+class TestSerial : public ISerialInterface {
+public:
+    TestSerial() : baudRate(115200), maxBaudRate(1000000) {}
+
+    virtual void init() override {}
+    virtual bool open() override { return true; }
+    virtual void close() override {}
+    virtual size_t write(const uint8_t* data, size_t length) override {
+        tx.insert(tx.end(), data, data + length);
+        return length;
+    }
+    virtual size_t read(uint8_t* buffer, size_t length) override {
+        size_t n = 0;
+        while (n < length && !rx.empty()) {
+            buffer[n++] = rx.front();
+            rx.pop_front();
+        }
+        return n;
+    }
+    virtual bool isOpen() override { return true; }
+    virtual void flush() override {}
+    virtual uint32_t getBaudRate() const override { return baudRate; }
+    virtual bool supportsBaudRate(uint32_t rate) const override { return rate != 0 && rate <= maxBaudRate; }
+
+    std::deque<uint8_t> rx;
+    std::vector<uint8_t> tx;
+    uint32_t baudRate;
+    uint32_t maxBaudRate;   // supportsBaudRate 상한
+};
+
+class TestTick : public ITick {
+public:
+    TestTick() : now(0) {}
+
+    virtual bool delay(uint32_t) override { return true; }
+    virtual uint32_t elapsed(uint32_t time) override { return now - time; }
+    virtual uint32_t getElapsed(uint32_t time1, uint32_t time2) override { return time2 - time1; }
+    virtual uint32_t getTickCount(void) override { return now; }
+    virtual void tickUpdate() override {}
+    virtual bool tickCheck(uint32_t) override { return false; }
+
+    uint32_t now;
+};
+
+struct Frame {
+    uint16_t cmd;
+    std::vector<uint8_t> payload;   // 프레임 CRC 제외
+};
+
+uint16_t frameCrc(uint16_t receiverId, uint16_t cmd, uint16_t seq, const uint8_t* payload, size_t length) {
+    uint8_t header[8];
+    storeBigEndian<uint16_t>(header, receiverId);
+    storeBigEndian<uint16_t>(header + 2, HOST_ID);
+    storeBigEndian<uint16_t>(header + 4, cmd);
+    storeBigEndian<uint16_t>(header + 6, seq);
+    return crc16XModemUpdate(crc16XModemUpdate(0x0000, header, 8), payload, length);
+}
+
+// HOST_ID -> receiverId (그룹/브로드캐스트 주소 포함)
+void appendFrameTo(std::deque<uint8_t>& out, uint16_t receiverId, uint16_t cmd, uint16_t seq,
+                   const uint8_t* payload, size_t length) {
+    uint8_t head[14] = { 0x16, 0x16, 0x16, 0x16 };
+    storeBigEndian<uint16_t>(head + 4, static_cast<uint16_t>(8 + length + 2));
+    storeBigEndian<uint16_t>(head + 6, receiverId);
+    storeBigEndian<uint16_t>(head + 8, HOST_ID);
+    storeBigEndian<uint16_t>(head + 10, cmd);
+    storeBigEndian<uint16_t>(head + 12, seq);
+    uint16_t crc = frameCrc(receiverId, cmd, seq, payload, length);
+
+    out.insert(out.end(), head, head + sizeof(head));
+    out.insert(out.end(), payload, payload + length);
+    out.push_back(static_cast<uint8_t>(crc >> 8));
+    out.push_back(static_cast<uint8_t>(crc & 0xFF));
+}
+
+void appendFrame(std::deque<uint8_t>& out, uint16_t cmd, uint16_t seq, const uint8_t* payload, size_t length) {
+    appendFrameTo(out, NODE_ID, cmd, seq, payload, length);
+}
+
+// RECEIVING_DATA 블록 : [Stage, BlockIndex(4)] + 데이터
+void appendFileBlock(std::deque<uint8_t>& out, uint16_t seq, uint32_t blockIndex, const uint8_t* data, size_t length) {
+    std::vector<uint8_t> block(FileDataHeaderSchema::SIZE + length);
+    FileDataHeaderMessage header;
+    header.stage = FileTransferStage::RECEIVING_DATA;
+    header.blockIndex = blockIndex;
+    FileDataHeaderSchema::serialize(header, block.data(), block.size());
+    if (length > 0) memcpy(block.data() + FileDataHeaderSchema::SIZE, data, length);
+    appendFrame(out, CMD_FILE_RECEIVE, seq, block.data(), block.size());
+}
+
+void appendFileVerify(std::deque<uint8_t>& out, uint16_t seq, const std::vector<uint8_t>& file) {
+    FileVerifyChecksumMessage verify;
+    verify.stage = FileTransferStage::VERIFY_CHECKSUM;
+    verify.checksum = crc16XModem(file.data(), file.size());
+    uint8_t payload[FileVerifyChecksumSchema::SIZE];
+    FileVerifyChecksumSchema::serialize(verify, payload);
+    appendFrame(out, CMD_FILE_RECEIVE, seq, payload, sizeof(payload));
+}
+
+// [Stage, Result, BlockIndex(4)] 응답
+std::vector<uint8_t> blockAck(FileTransferStage stage, uint8_t result, uint32_t blockIndex) {
+    FileReceiveAckMessage ack;
+    ack.stage = stage;
+    ack.success = result;
+    ack.blockIndex = blockIndex;
+    std::vector<uint8_t> bytes(FileReceiveAckBlockSchema::SIZE);
+    FileReceiveAckBlockSchema::serialize(ack, bytes.data(), bytes.size());
+    return bytes;
+}
+
+// SimulatedBus 위에서 uploadFile 이 끝날 때까지 진행 (시뮬레이션 시간 limitMs 안에 끝나지 않으면 false)
+bool runUpload(SimulatedBus& bus, AsyncCom_Protocol& host, const std::vector<Com_Protocol*>& nodes, uint16_t targetId,
+               const std::vector<uint8_t>& file, const FileUploadOptions& options, FileUploadResult& result,
+               uint32_t limitMs) {
+    const uint64_t deadline = bus.nowNs() + limitMs * 1000000ULL;
+    uploadFile(host, targetId, file.data(), static_cast<uint32_t>(file.size()), options, result);
+    while (!result.done && bus.nowNs() < deadline) {
+        bus.run(nodes, 1000000ULL);
+        host.poll();
+    }
+    return result.done;
+}
+
+// 노드가 보낸 프레임 분리 (송신 경로가 만든 바이트이므로 CRC 는 확인하지 않음)
+std::vector<Frame> takeFrames(TestSerial& serial) {
+    std::vector<Frame> frames;
+    const std::vector<uint8_t>& tx = serial.tx;
+    size_t i = 0;
+    while (i + 6 <= tx.size()) {
+        uint16_t length = loadBigEndian<uint16_t>(&tx[i + 4]);
+        if (i + 6 + length > tx.size() || length < 10) break;
+        Frame frame;
+        frame.cmd = loadBigEndian<uint16_t>(&tx[i + 10]);
+        frame.payload.assign(tx.begin() + i + 14, tx.begin() + i + 6 + length - 2);
+        frames.push_back(frame);
+        i += 6 + length;
+    }
+    serial.tx.clear();
+    return frames;
+}
+
+std::string hex(const std::vector<uint8_t>& bytes) {
+    std::string text;
+    char byte[4];
+    for (size_t i = 0; i < bytes.size(); i++) {
+        snprintf(byte, sizeof(byte), i ? " %02x" : "%02x", bytes[i]);
+        text += byte;
+    }
+    return text;
+}
+
+// 응답이 정확히 하나의 CMD_FILE_RECEIVE_ACK 이고 기대한 바이트인지 확인
+bool expectFileAck(TestSerial& serial, const std::vector<uint8_t>& expected, const char* step, std::string& detail) {
+    std::vector<Frame> frames = takeFrames(serial);
+    if (frames.size() == 1 && frames[0].cmd == CMD_FILE_RECEIVE_ACK && frames[0].payload == expected) return true;
+    detail = std::string(step) + ": expected [" + hex(expected) + "], got " +
+             (frames.empty() ? std::string("no reply") : "[" + hex(frames[0].payload) + "]");
+    return false;
+}
+
+// ContentHash 만 있는 REQUEST_RECEIVE 는 Codec 바이트가 없으므로 압축 없이 수락해야 함
+// (프레임 CRC 상위 바이트가 LZSS(1) 인 FileId 를 골라, CRC 를 Codec 으로 읽으면 바로 드러나게 함)
+bool testFileRequestHashOnly(std::string& detail) {
+    TestSerial serial;
+    TestTick tick;
+    MemoryFileStore store;
+    Com_Protocol node(&serial, &tick, NODE_ID);
+    node.setFileStore(&store);
+
+    uint8_t data[16];
+    for (size_t i = 0; i < sizeof(data); i++) data[i] = static_cast<uint8_t>(0xA0 + i);
+
+    FileRequestReceiveMessage request;
+    request.stage = FileTransferStage::REQUEST_RECEIVE;
+    request.fileSize = sizeof(data);
+    Sha256::hash(data, sizeof(data), request.contentHash);
+    uint8_t payload[FileRequestReceiveHashSchema::SIZE];
+    for (request.fileId = 1; ; request.fileId++) {
+        FileRequestReceiveHashSchema::serialize(request, payload);
+        if ((frameCrc(NODE_ID, CMD_FILE_RECEIVE, 0, payload, sizeof(payload)) >> 8) ==
+            static_cast<uint8_t>(FileCodec::LZSS)) break;
+    }
+    appendFrame(serial.rx, CMD_FILE_RECEIVE, 0, payload, sizeof(payload));
+    node.processReceivedData();
+    if (!expectFileAck(serial, { 0x01, FILE_ACK_SUCCESS }, "REQUEST_RECEIVE", detail)) return false;
+
+    uint8_t block[FileDataHeaderSchema::SIZE + sizeof(data)];
+    FileDataHeaderMessage header;
+    header.stage = FileTransferStage::RECEIVING_DATA;
+    header.blockIndex = 0;
+    FileDataHeaderSchema::serialize(header, block, sizeof(block));
+    memcpy(block + FileDataHeaderSchema::SIZE, data, sizeof(data));
+    appendFrame(serial.rx, CMD_FILE_RECEIVE, 1, block, sizeof(block));
+    node.processReceivedData();
+    if (!expectFileAck(serial, { 0x03, FILE_ACK_SUCCESS, 0, 0, 0, 0 }, "RECEIVING_DATA", detail)) return false;
+
+    FileVerifyChecksumMessage verify;
+    verify.stage = FileTransferStage::VERIFY_CHECKSUM;
+    verify.checksum = crc16XModem(data, sizeof(data));
+    uint8_t verifyPayload[FileVerifyChecksumSchema::SIZE];
+    FileVerifyChecksumSchema::serialize(verify, verifyPayload);
+    appendFrame(serial.rx, CMD_FILE_RECEIVE, 2, verifyPayload, sizeof(verifyPayload));
+    node.processReceivedData();
+    if (!expectFileAck(serial, { 0x04, FILE_ACK_SUCCESS }, "VERIFY_CHECKSUM", detail)) return false;
+
+    if (store.current() != std::vector<uint8_t>(data, data + sizeof(data))) {
+        detail = "committed file differs from sent data";
+        return false;
+    }
+    return true;
+}
+
+// 늦은 호출 : 간격 학습으로 타임아웃이 짧아진 뒤, 프레임 도중에 호출이 15ms 늦어져도
+// 그사이 직렬 포트에 도착해 있는 나머지 바이트로 프레임을 마쳐야 함 (타임아웃으로 버리지 않음)
+bool testLatePollAfterTraining(std::string& detail) {
+    TestSerial serial;
+    TestTick tick;
+    Com_Protocol node(&serial, &tick, NODE_ID);
+    const uint8_t ping[] = { 'P', 'I', 'N', 'G' };
+
+    uint16_t seq = 0;
+    for (int i = 0; i < 200; i++, seq++) {
+        appendFrame(serial.rx, CMD_PING, seq, ping, sizeof(ping));
+        node.processReceivedData();
+        tick.now++;
+    }
+    serial.tx.clear();
+
+    std::deque<uint8_t> frame;
+    appendFrame(frame, CMD_PING, seq, ping, sizeof(ping));
+    serial.rx.insert(serial.rx.end(), frame.begin(), frame.begin() + 10);
+    node.processReceivedData();
+    const uint32_t timeout = node.getFrameTimeout();
+    serial.rx.insert(serial.rx.end(), frame.begin() + 10, frame.end());
+    tick.now += 15;
+    node.processReceivedData();
+
+    std::vector<Frame> frames = takeFrames(serial);
+    const uint32_t timeouts = node.getMetrics().frameTimeouts;
+    if (frames.size() == 1 && frames[0].cmd == CMD_PONG && timeouts == 0) return true;
+    char text[96];
+    snprintf(text, sizeof(text), "frame timeout %ums, 15ms late poll: %u replies, %u frame timeouts",
+             static_cast<unsigned>(timeout), static_cast<unsigned>(frames.size()), static_cast<unsigned>(timeouts));
+    detail = text;
+    return false;
+}
+
+// 링크 속도 제안 : 전송이 설정할 수 없는 속도는 ACK 에서 바로 거절하고 전환을 예약하지 않음, 지원 속도는 수락
+bool testLinkSpeedUnsupportedRate(std::string& detail) {
+    TestSerial serial;
+    TestTick tick;
+    Com_Protocol node(&serial, &tick, NODE_ID);
+
+    SyncMessage sync;
+    sync.timestamp = 0;
+    sync.authToken = 0xABCD;
+    uint8_t syncPayload[SyncSchema::SIZE];
+    SyncSchema::serialize(sync, syncPayload);
+    appendFrame(serial.rx, CMD_SYNC, 0, syncPayload, sizeof(syncPayload));
+    node.processReceivedData();
+    serial.tx.clear();
+
+    const uint32_t rates[] = { 3000000, 1000000 };     // maxBaudRate 초과 (거절), 지원 (수락)
+    for (uint16_t i = 0; i < 2; i++) {
+        const bool supported = rates[i] <= serial.maxBaudRate;
+        LinkSpeedMessage propose;
+        propose.stage = LinkSpeedStage::PROPOSE;
+        propose.baudRate = rates[i];
+        uint8_t payload[LinkSpeedSchema::SIZE];
+        LinkSpeedSchema::serialize(propose, payload);
+        appendFrame(serial.rx, CMD_LINK_SPEED, static_cast<uint16_t>(1 + i), payload, sizeof(payload));
+        node.processReceivedData();
+
+        std::vector<Frame> frames = takeFrames(serial);
+        LinkSpeedAckMessage ack;
+        const Com_Protocol::LinkSpeedState state = node.getLinkSpeedState();
+        const Com_Protocol::LinkSpeedState expectedState =
+            supported ? Com_Protocol::LinkSpeedState::SWITCH_PENDING : Com_Protocol::LinkSpeedState::IDLE;
+        if (frames.size() == 1 && frames[0].cmd == CMD_LINK_SPEED_ACK &&
+            LinkSpeedAckSchema::deserialize(frames[0].payload.data(), frames[0].payload.size(), ack) &&
+            ack.accepted == (supported ? 1 : 0) && ack.baudRate == rates[i] && state == expectedState) continue;
+
+        char text[96];
+        snprintf(text, sizeof(text), "PROPOSE %u: expected accepted %d, got [%s], link state %d",
+                 static_cast<unsigned>(rates[i]), supported ? 1 : 0,
+                 frames.empty() ? "no reply" : hex(frames[0].payload).c_str(), static_cast<int>(state));
+        detail = text;
+        return false;
+    }
+    return true;
+}
+
+// FEC 프레임 : 부호어(길이 필드 제외)의 parity/2 바이트가 깨져도 정정해 전달, 하나 더 깨지면 버림
+// (길이 필드는 parity 크기와 부호어 경계를 정하므로 복호 전에 읽어야 해서 깨뜨리지 않음)
+bool testFecCorrectsHalfParity(std::string& detail) {
+    const uint8_t parities[] = { 2, 8, 16 };
+    for (size_t p = 0; p < sizeof(parities); p++) {
+        const uint8_t parity = parities[p];
+        TestSerial hostSerial;
+        TestTick tick;
+        Com_Protocol host(&hostSerial, &tick, HOST_ID);
+        host.setFecParity(parity);
+        host.sendPing(NODE_ID);
+        const std::vector<uint8_t> frame = hostSerial.tx;
+
+        // 부호어 : 시작 시퀀스(4) 뒤 길이(2) + 헤더 + 페이로드 + CRC + parity, 깨뜨리는 범위는 길이 필드 뒤
+        const size_t first = 4 + 2;
+        const size_t span = frame.size() - first;
+        for (size_t errors = parity / 2; errors <= static_cast<size_t>(parity / 2 + 1); errors++) {
+            TestSerial serial;
+            Com_Protocol node(&serial, &tick, NODE_ID);
+            std::vector<uint8_t> corrupted = frame;
+            for (size_t k = 0; k < errors; k++) corrupted[first + (k * span) / errors] ^= 0x5A;
+            serial.rx.insert(serial.rx.end(), corrupted.begin(), corrupted.end());
+            node.processReceivedData();
+
+            std::vector<Frame> frames = takeFrames(serial);
+            const bool correctable = errors <= static_cast<size_t>(parity / 2);
+            const bool delivered = frames.size() == 1 && frames[0].cmd == CMD_PONG;
+            const uint32_t corrected = node.getFecCorrectedBytes();
+            if (delivered == correctable && corrected == (correctable ? errors : 0)) continue;
+
+            char text[128];
+            snprintf(text, sizeof(text), "parity %u, %u corrupted bytes: expected %s, got %u replies, %u corrected",
+                     static_cast<unsigned>(parity), static_cast<unsigned>(errors),
+                     correctable ? "PONG" : "drop", static_cast<unsigned>(frames.size()), static_cast<unsigned>(corrected));
+            detail = text;
+            return false;
+        }
+    }
+    return true;
+}
+
+// 재개 : 업로드 도중 노드가 재시작(엔진 재생성)해도 RESUME_QUERY 로 저장소 체크포인트의 다음 블록부터 이어 받고
+// 끝까지 받은 파일의 누적 체크섬이 맞아야 함 (체크포인트 이후 받은 블록은 다시 보냄)
+bool testResumeFromCheckpoint(std::string& detail) {
+    const uint32_t FILE_ID = 0x00C0FFEE;
+    const size_t BLOCK_SIZE = 64;
+    const uint32_t BLOCKS = 40;
+    const uint32_t SENT_BEFORE_RESTART = 21;
+    const uint32_t RESUME_BLOCK = 16;               // CHECKPOINT_INTERVAL_BLOCKS(16) 마다 저장한 마지막 체크포인트
+
+    std::vector<uint8_t> file(BLOCK_SIZE * BLOCKS);
+    for (size_t i = 0; i < file.size(); i++) file[i] = static_cast<uint8_t>(i * 31 + (i >> 7));
+
+    TestSerial serial;
+    TestTick tick;
+    MemoryFileStore store;
+    uint16_t seq = 0;
+    char step[48];
+
+    FileRequestReceiveMessage request;
+    request.stage = FileTransferStage::REQUEST_RECEIVE;
+    request.fileSize = static_cast<uint32_t>(file.size());
+    request.fileId = FILE_ID;
+    uint8_t requestPayload[FileRequestReceiveIdSchema::SIZE];
+    {
+        Com_Protocol node(&serial, &tick, NODE_ID);
+        node.setFileStore(&store);
+        FileRequestReceiveIdSchema::serialize(request, requestPayload);
+        appendFrame(serial.rx, CMD_FILE_RECEIVE, seq++, requestPayload, sizeof(requestPayload));
+        node.processReceivedData();
+        if (!expectFileAck(serial, { 0x01, FILE_ACK_SUCCESS }, "REQUEST_RECEIVE", detail)) return false;
+
+        for (uint32_t i = 0; i < SENT_BEFORE_RESTART; i++) {
+            appendFileBlock(serial.rx, seq++, i, &file[i * BLOCK_SIZE], BLOCK_SIZE);
+            node.processReceivedData();
+            snprintf(step, sizeof(step), "block %u", static_cast<unsigned>(i));
+            if (!expectFileAck(serial, blockAck(FileTransferStage::RECEIVING_DATA, FILE_ACK_SUCCESS, i), step, detail)) return false;
+        }
+    }
+
+    // 재시작 : 세션은 사라지고 저장소의 체크포인트와 임시 내용만 남음
+    Com_Protocol node(&serial, &tick, NODE_ID);
+    node.setFileStore(&store);
+    request.stage = FileTransferStage::RESUME_QUERY;
+    FileRequestReceiveIdSchema::serialize(request, requestPayload);
+    appendFrame(serial.rx, CMD_FILE_RECEIVE, seq++, requestPayload, sizeof(requestPayload));
+    node.processReceivedData();
+    if (!expectFileAck(serial, blockAck(FileTransferStage::RESUME_QUERY, FILE_ACK_SUCCESS, RESUME_BLOCK),
+                       "RESUME_QUERY", detail)) return false;
+
+    for (uint32_t i = RESUME_BLOCK; i < BLOCKS; i++) {
+        appendFileBlock(serial.rx, seq++, i, &file[i * BLOCK_SIZE], BLOCK_SIZE);
+        node.processReceivedData();
+        snprintf(step, sizeof(step), "resumed block %u", static_cast<unsigned>(i));
+        if (!expectFileAck(serial, blockAck(FileTransferStage::RECEIVING_DATA, FILE_ACK_SUCCESS, i), step, detail)) return false;
+    }
+
+    appendFileVerify(serial.rx, seq++, file);
+    node.processReceivedData();
+    if (!expectFileAck(serial, { 0x04, FILE_ACK_SUCCESS }, "VERIFY_CHECKSUM", detail)) return false;
+    if (store.current() != file) {
+        detail = "committed file differs from sent data";
+        return false;
+    }
+    return true;
+}
+
+// 델타 : 노드의 현재 파일에서 블록 몇 개만 바꾼 파일은 바뀐 블록만 RECEIVING_DATA 로, 나머지는 DELTA_COPY 로 재구성
+bool testDeltaEditedBlocks(std::string& detail) {
+    const uint32_t DELTA_BLOCK = 512;
+    const uint32_t BLOCKS = 64;
+    const uint32_t EDITED[] = { 3, 17, 18, 50 };
+    const uint32_t EDITED_BYTES = sizeof(EDITED) / sizeof(EDITED[0]) * DELTA_BLOCK;
+
+    SimulatedBusConfig busConfig;
+    busConfig.baudRate = 1000000;
+    SimulatedBus bus(busConfig);
+    AsyncCom_Protocol host(bus.addEndpoint(), bus.tick(), HOST_ID);
+    Com_Protocol node(bus.addEndpoint(), bus.tick(), NODE_ID);
+    MemoryFileStore store;
+    node.setFileStore(&store);
+    std::vector<Com_Protocol*> nodes;
+    nodes.push_back(&host);
+    nodes.push_back(&node);
+
+    std::vector<uint8_t> original(DELTA_BLOCK * BLOCKS);
+    uint32_t x = 0x12345678;
+    for (size_t i = 0; i < original.size(); i++) {
+        x = x * 1103515245u + 12345u;
+        original[i] = static_cast<uint8_t>(x >> 24);
+    }
+    FileUploadOptions options;
+    FileUploadResult initial;
+    if (!runUpload(bus, host, nodes, NODE_ID, original, options, initial, 10000) || !initial.ok) {
+        detail = "initial full upload failed";
+        return false;
+    }
+
+    // 블록마다 가운데 16 바이트만 변경 (서명 블록 경계 유지)
+    std::vector<uint8_t> edited = original;
+    for (uint32_t block : EDITED) {
+        for (uint32_t i = 0; i < 16; i++) edited[block * DELTA_BLOCK + DELTA_BLOCK / 2 + i] ^= 0xA5;
+    }
+    options.delta = true;
+    options.deltaBlockSize = DELTA_BLOCK;
+    FileUploadResult result;
+    if (!runUpload(bus, host, nodes, NODE_ID, edited, options, result, 10000) || !result.ok) {
+        detail = "delta upload failed";
+        return false;
+    }
+    if (store.current() != edited) {
+        detail = "rebuilt file differs from edited data";
+        return false;
+    }
+    char text[128];
+    if (result.literalBytes != EDITED_BYTES || result.copiedBytes != edited.size() - EDITED_BYTES) {
+        snprintf(text, sizeof(text), "literal %u copied %u, expected literal %u copied %u",
+                 static_cast<unsigned>(result.literalBytes), static_cast<unsigned>(result.copiedBytes),
+                 static_cast<unsigned>(EDITED_BYTES), static_cast<unsigned>(edited.size() - EDITED_BYTES));
+        detail = text;
+        return false;
+    }
+    return true;
+}
+
+// PING 마다 호출 횟수를 PONG 페이로드로 응답 (핸들러가 다시 실행되면 응답 바이트가 달라짐)
+class CountingNode : public Com_Protocol {
+public:
+    CountingNode(ISerialInterface* serial, ITick* tick) : Com_Protocol(serial, tick, NODE_ID), pings(0) {}
+
+    uint8_t pings;
+    std::vector<uint8_t> order;     // 처리한 PING 페이로드의 첫 바이트
+
+protected:
+    virtual void handlePing(uint16_t senderId, uint8_t* payload, size_t length) override {
+        pings++;
+        if (length > 0) order.push_back(payload[0]);
+        sendData(senderId, getMyId(), CMD_PONG, &pings, 1);
+    }
+};
+
+// 응답 캐시 : 같은 (송신자, 시퀀스, 명령, CRC) 의 재전송은 핸들러 없이 처음 응답을 그대로 다시 보내고,
+// SYNC 뒤에는 그 송신자의 항목이 무효가 되어 같은 요청도 다시 처리
+bool testReplyCacheReplay(std::string& detail) {
+    TestSerial serial;
+    TestTick tick;
+    CountingNode node(&serial, &tick);
+    node.setReplyCache(4);
+    const uint8_t ping[] = { 'P', 'I', 'N', 'G' };
+
+    appendFrame(serial.rx, CMD_PING, 7, ping, sizeof(ping));
+    node.processReceivedData();
+    std::vector<uint8_t> first = serial.tx;
+    serial.tx.clear();
+
+    appendFrame(serial.rx, CMD_PING, 7, ping, sizeof(ping));
+    node.processReceivedData();
+    std::vector<uint8_t> second = serial.tx;
+    serial.tx.clear();
+    if (node.pings != 1 || node.getReplyCacheHits() != 1) {
+        detail = "retransmission ran the handler: pings " + std::to_string(node.pings) + ", hits " +
+                 std::to_string(node.getReplyCacheHits());
+        return false;
+    }
+    if (first.empty() || second != first) {
+        detail = "replayed reply [" + hex(second) + "] differs from [" + hex(first) + "]";
+        return false;
+    }
+
+    SyncMessage sync;
+    sync.timestamp = 1;
+    sync.authToken = 0xABCD;
+    uint8_t syncPayload[SyncSchema::SIZE];
+    SyncSchema::serialize(sync, syncPayload);
+    appendFrame(serial.rx, CMD_SYNC, 0, syncPayload, sizeof(syncPayload));
+    node.processReceivedData();
+    serial.tx.clear();
+
+    appendFrame(serial.rx, CMD_PING, 7, ping, sizeof(ping));
+    node.processReceivedData();
+    std::vector<Frame> frames = takeFrames(serial);
+    if (node.pings != 2 || frames.size() != 1 || frames[0].payload != std::vector<uint8_t>(1, 2)) {
+        detail = "request after SYNC was not handled again: pings " + std::to_string(node.pings);
+        return false;
+    }
+    return true;
+}
+
+// 큐 모드 : 파싱 단계는 핸들러 없이 큐에만 넣고 가득 차면 새 프레임을 버려 queueDrops 로 집계,
+// 처리 단계는 받은 순서대로 처리하며 timeUntilQueuedWork() 는 대기 패킷이 있는 동안 0
+bool testQueueDropsAndOrder(std::string& detail) {
+    const size_t QUEUE_PACKETS = 3;
+    const uint8_t FRAMES = 5;
+
+    TestSerial serial;
+    TestTick tick;
+    CountingNode node(&serial, &tick);
+    if (!node.setPacketQueue(QUEUE_PACKETS)) {
+        detail = "setPacketQueue failed";
+        return false;
+    }
+    for (uint8_t i = 0; i < FRAMES; i++) {
+        const uint8_t ping[] = { i, 'P', 'I', 'N', 'G' };
+        appendFrame(serial.rx, CMD_PING, i, ping, sizeof(ping));
+    }
+    node.processReceivedData();
+
+    char text[128];
+    const uint32_t drops = node.getMetrics().queueDrops;
+    if (node.pings != 0 || !serial.tx.empty() || node.getQueueDepth() != QUEUE_PACKETS || drops != FRAMES - QUEUE_PACKETS) {
+        snprintf(text, sizeof(text), "after parsing: handled %u, tx %zu bytes, depth %zu, queueDrops %u",
+                 static_cast<unsigned>(node.pings), serial.tx.size(), node.getQueueDepth(), static_cast<unsigned>(drops));
+        detail = text;
+        return false;
+    }
+    if (node.timeUntilQueuedWork() != 0) {
+        detail = "timeUntilQueuedWork() is not 0 while packets are queued";
+        return false;
+    }
+
+    const size_t handled = node.processQueuedPackets();
+    const std::vector<uint8_t> expected = { 0, 1, 2 };
+    if (handled != QUEUE_PACKETS || node.order != expected || takeFrames(serial).size() != QUEUE_PACKETS) {
+        detail = "handled " + std::to_string(handled) + " in order [" + hex(node.order) + "], expected [" + hex(expected) + "]";
+        return false;
+    }
+    if (node.getQueueDepth() != 0 || node.timeUntilQueuedWork() != Com_Protocol::NO_RECEIVE_DEADLINE) {
+        detail = "queue not idle after processQueuedPackets()";
+        return false;
+    }
+    return true;
+}
+
+// 동시 세션 : 세션 1/2 (저장소 각각) 업로드가 번갈아 진행되어 둘 다 체크섬 검증까지 끝나고,
+// 그동안 세션 1 의 저장소를 함께 쓰는 세션 3 의 요청은 FILE_ACK_BUSY
+bool testConcurrentSessions(std::string& detail) {
+    SimulatedBusConfig busConfig;
+    busConfig.baudRate = 1000000;
+    SimulatedBus bus(busConfig);
+    AsyncCom_Protocol host(bus.addEndpoint(), bus.tick(), HOST_ID);
+    host.setMaxInFlight(1);     // 반이중 버스 : 두 대화의 요청이 응답과 겹치지 않게
+    Com_Protocol node(bus.addEndpoint(), bus.tick(), NODE_ID);
+    MemoryFileStore motionStore;
+    MemoryFileStore configStore;
+    node.setFileStore(1, &motionStore);
+    node.setFileStore(2, &configStore);
+    node.setFileStore(3, &motionStore);
+    std::vector<Com_Protocol*> nodes;
+    nodes.push_back(&host);
+    nodes.push_back(&node);
+
+    std::vector<uint8_t> motion(20000);
+    std::vector<uint8_t> config(12000);
+    for (size_t i = 0; i < motion.size(); i++) motion[i] = static_cast<uint8_t>(i * 7 + (i >> 9));
+    for (size_t i = 0; i < config.size(); i++) config[i] = static_cast<uint8_t>(i * 13 + (i >> 6));
+
+    FileUploadOptions motionOptions;
+    motionOptions.sessionId = 1;
+    FileUploadOptions configOptions;
+    configOptions.sessionId = 2;
+    FileUploadResult motionResult;
+    FileUploadResult configResult;
+    uploadFile(host, NODE_ID, motion.data(), static_cast<uint32_t>(motion.size()), motionOptions, motionResult);
+    uploadFile(host, NODE_ID, config.data(), static_cast<uint32_t>(config.size()), configOptions, configResult);
+
+    const uint64_t deadline = bus.nowNs() + 10000 * 1000000ULL;
+    while (node.getActiveFileSessions() < 2 && !motionResult.done && bus.nowNs() < deadline) {
+        bus.run(nodes, 1000000ULL);
+        host.poll();
+    }
+    if (node.getActiveFileSessions() != 2) {
+        detail = "sessions 1 and 2 were never active together";
+        return false;
+    }
+
+    FileUploadOptions sharedOptions;
+    sharedOptions.sessionId = 3;
+    FileUploadResult sharedResult;
+    uploadFile(host, NODE_ID, config.data(), static_cast<uint32_t>(config.size()), sharedOptions, sharedResult);
+    while (!(motionResult.done && configResult.done && sharedResult.done) && bus.nowNs() < deadline) {
+        bus.run(nodes, 1000000ULL);
+        host.poll();
+    }
+
+    if (!sharedResult.done || !sharedResult.busy || sharedResult.ok) {
+        detail = "session 3 on a store in use was not refused with FILE_ACK_BUSY";
+        return false;
+    }
+    if (!motionResult.ok || !configResult.ok) {
+        detail = std::string("upload failed: session 1 ") + (motionResult.ok ? "ok" : "failed") +
+                 ", session 2 " + (configResult.ok ? "ok" : "failed");
+        return false;
+    }
+    if (motionStore.current() != motion || configStore.current() != config) {
+        detail = "committed files differ from sent data";
+        return false;
+    }
+    return true;
+}
+
+// 그룹 주소 : 가입한 노드만 그룹으로 보낸 PING 을 처리하고 응답(PONG)은 보내지 않음,
+// 같은 노드도 자신의 ID 로 받은 PING 에는 응답하고, 탈퇴한 뒤에는 그룹 프레임을 받지 않음
+bool testGroupAcceptAndSuppress(std::string& detail) {
+    const uint16_t GROUP_ID = 0xFF01;
+    const uint8_t ping[] = { 'P', 'I', 'N', 'G' };
+
+    TestSerial memberSerial;
+    TestSerial otherSerial;
+    TestTick tick;
+    CountingNode member(&memberSerial, &tick);
+    CountingNode other(&otherSerial, &tick);
+    if (!member.joinGroup(GROUP_ID)) {
+        detail = "joinGroup failed";
+        return false;
+    }
+
+    appendFrameTo(memberSerial.rx, GROUP_ID, CMD_PING, 0, ping, sizeof(ping));
+    appendFrameTo(otherSerial.rx, GROUP_ID, CMD_PING, 0, ping, sizeof(ping));
+    member.processReceivedData();
+    other.processReceivedData();
+    if (member.pings != 1 || member.getMetrics().groupFrames != 1 || other.pings != 0) {
+        detail = "group PING handled by member " + std::to_string(member.pings) + ", non-member " +
+                 std::to_string(other.pings) + " (expected 1, 0)";
+        return false;
+    }
+    if (!memberSerial.tx.empty() || !otherSerial.tx.empty()) {
+        detail = "reply sent to a group-addressed request: [" + hex(memberSerial.tx) + "]";
+        return false;
+    }
+
+    appendFrame(memberSerial.rx, CMD_PING, 1, ping, sizeof(ping));
+    member.processReceivedData();
+    std::vector<Frame> frames = takeFrames(memberSerial);
+    if (member.pings != 2 || frames.size() != 1 || frames[0].cmd != CMD_PONG) {
+        detail = "unicast PING after a group PING was not answered";
+        return false;
+    }
+
+    member.leaveGroup(GROUP_ID);
+    appendFrameTo(memberSerial.rx, GROUP_ID, CMD_PING, 2, ping, sizeof(ping));
+    member.processReceivedData();
+    if (member.pings != 2) {
+        detail = "group PING accepted after leaveGroup";
+        return false;
+    }
+    return true;
+}
+
+struct SelfTest {
+    const char* name;
+    bool (*run)(std::string& detail);
+};
+
+const SelfTest SELF_TESTS[] = {
+    { "file-request-hash-only", testFileRequestHashOnly },
+    { "late-poll-after-training", testLatePollAfterTraining },
+    { "link-speed-unsupported-rate", testLinkSpeedUnsupportedRate },
+    { "fec-corrects-half-parity", testFecCorrectsHalfParity },
+    { "resume-from-checkpoint", testResumeFromCheckpoint },
+    { "delta-edited-blocks", testDeltaEditedBlocks },
+    { "reply-cache-replay", testReplyCacheReplay },
+    { "queue-drops-and-order", testQueueDropsAndOrder },
+    { "concurrent-sessions", testConcurrentSessions },
+    { "group-accept-and-suppress", testGroupAcceptAndSuppress },
+};
+
+} // namespace
+
+size_t runProtocolSelfTests(std::vector<SelfTestResult>& results) {
+    size_t failed = 0;
+    for (size_t i = 0; i < sizeof(SELF_TESTS) / sizeof(SELF_TESTS[0]); i++) {
+        SelfTestResult result;
+        result.name = SELF_TESTS[i].name;
+        result.passed = SELF_TESTS[i].run(result.detail);
+        if (!result.passed) failed++;
+        results.push_back(result);
+    }
+    return failed;
+}
+
+#endif
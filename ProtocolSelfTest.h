@@ -0,0 +1,43 @@
+#ifndef PROTOCOL_SELF_TEST_H_
+#define PROTOCOL_SELF_TEST_H_
+
+#if !defined(USE_HAL_DRIVER)
+#include <stdint.h>
+#include <stddef.h>
+#include <string>
+#include <vector>
+
+/*
+ * 프로토콜 회귀 검사 (호스트 전용)
+ *
+ *  메모리 전송과 가상 tick 위에서 노드(Com_Protocol)에 바이트 단위로 만든 프레임을 공급하고
+ *  응답 프레임과 상태를 확인합니다. 실제 장비에서 발견된 결함의 재현 시나리오를 검사 하나로 남깁니다.
+ *  호스트 쪽 흐름(uploadFile)까지 필요한 검사는 SimulatedBus 위에서 AsyncCom_Protocol 과 함께 돌립니다.
+ *
+ *  - file-request-hash-only : ContentHash 만 있는 REQUEST_RECEIVE (41 바이트) 뒤 압축 없는 블록 수신
+ *  - late-poll-after-training : 적응형 타임아웃이 짧아진 뒤 프레임 도중 호출이 늦어져도 이미 도착한 바이트로 수락
+ *  - link-speed-unsupported-rate : 전송이 설정할 수 없는 속도 제안은 ACK 에서 거절 (Accepted 0, 전환 없음)
+ *  - fec-corrects-half-parity : FEC 프레임은 parity/2 바이트 오류까지 정정해 전달, 하나 더 많으면 버림
+ *  - resume-from-checkpoint : 노드 재시작 뒤 RESUME_QUERY 가 체크포인트 블록을 알려 주고 이어 받은 파일의 체크섬이 맞음
+ *  - delta-edited-blocks : 블록 4 개만 바꾼 파일의 델타 업로드가 바뀐 블록만 literal 로 보내고 나머지는 복사로 재구성
+ *  - reply-cache-replay : 같은 요청의 재전송은 핸들러 없이 같은 응답 바이트, SYNC 뒤에는 다시 처리
+ *  - queue-drops-and-order : 큐 모드에서 가득 찬 큐는 새 프레임을 버려 queueDrops 로 세고, 남은 패킷은 FIFO 로 처리
+ *  - concurrent-sessions : 세션 1/2 업로드가 동시에 끝나고, 사용 중인 저장소를 쓰는 세션 3 은 FILE_ACK_BUSY
+ *  - group-accept-and-suppress : 그룹 주소 프레임은 가입한 노드만 처리하고 그 요청의 응답은 보내지 않음
+ *
+ *  std::vector<SelfTestResult> results;
+ *  size_t failed = runProtocolSelfTests(results);
+ *  for (const SelfTestResult& r : results) printf("%s %s %s\n", r.passed ? "ok  " : "FAIL", r.name, r.detail.c_str());
+ */
+
+struct SelfTestResult {
+    const char* name;
+    bool passed;
+    std::string detail;     // 실패 시 기대값과 실제값
+};
+
+// 모든 검사를 실행하고 실패한 수를 반환 (results 에 검사마다 한 항목 추가)
+size_t runProtocolSelfTests(std::vector<SelfTestResult>& results);
+
+#endif
+#endif /* PROTOCOL_SELF_TEST_H_ */
@@ -0,0 +1,133 @@
+#if !defined(USE_HAL_DRIVER)
+#include "ReplaySerialImpl.h"
+#include "crc16.h"
+#include <string.h>
+
+ReplaySerialImpl::ReplaySerialImpl(FILE* capture, ITick* tick, ReplayMode mode) :
+    file_(capture),
+    tick_(tick),
+    mode_(mode),
+    opened_(false),
+    finished_(false),
+    recordOffset_(0),
+    recordRemaining_(0),
+    haveRecord_(false),
+    captureTime_(0),
+    replayStart_(0),
+    rxReplayedBytes_(0),
+    txCapturedBytes_(0),
+    txWrittenBytes_(0),
+    txCapturedCrc_(0),
+    txWrittenCrc_(0)
+{
+}
+
+ReplaySerialImpl::~ReplaySerialImpl() {
+}
+
+void ReplaySerialImpl::init() {
+    open();
+}
+
+bool ReplaySerialImpl::open() {
+    if (opened_) return true;
+    if (!file_) return false;
+
+    uint8_t header[SerialCaptureFormat::HEADER_SIZE];
+    if (fread(header, 1, sizeof(header), file_) != sizeof(header) ||
+        memcmp(header, SerialCaptureFormat::MAGIC, 4) != 0 ||
+        header[4] != SerialCaptureFormat::VERSION) {
+        finished_ = true;
+        return false;
+    }
+
+    opened_ = true;
+    if (tick_) replayStart_ = tick_->getTickCount();
+    return true;
+}
+
+void ReplaySerialImpl::close() {
+    opened_ = false;
+}
+
+// 재생 중 프로토콜이 보내는 응답 : 전송하지 않고 캡처의 TX 와 비교용으로만 누적
+size_t ReplaySerialImpl::write(const uint8_t* data, size_t length) {
+    txWrittenCrc_ = crc16XModemUpdate(txWrittenCrc_, data, length);
+    txWrittenBytes_ += length;
+    return length;
+}
+
+bool ReplaySerialImpl::readVarint(uint32_t& value) {
+    value = 0;
+    for (int shift = 0; shift < 35; shift += 7) {
+        int c = fgetc(file_);
+        if (c == EOF) return false;
+        value |= static_cast<uint32_t>(c & 0x7F) << shift;
+        if (!(c & 0x80)) return true;
+    }
+    return false;
+}
+
+// 다음 RX 레코드까지 이동 (TX 레코드는 비교용 CRC 에 누적)
+bool ReplaySerialImpl::nextRxRecord() {
+    for (;;) {
+        int direction = fgetc(file_);
+        uint32_t delta, length;
+        if (direction == EOF || !readVarint(delta) || !readVarint(length)) {
+            return false;
+        }
+        captureTime_ += delta;
+
+        if (direction == SerialCaptureFormat::DIR_RX) {
+            recordOffset_ = captureTime_;
+            recordRemaining_ = length;
+            return true;
+        }
+
+        uint8_t chunk[256];
+        while (length > 0) {
+            size_t n = length < sizeof(chunk) ? length : sizeof(chunk);
+            if (fread(chunk, 1, n, file_) != n) return false;
+            txCapturedCrc_ = crc16XModemUpdate(txCapturedCrc_, chunk, n);
+            txCapturedBytes_ += n;
+            length -= n;
+        }
+    }
+}
+
+size_t ReplaySerialImpl::read(uint8_t* buffer, size_t length) {
+    if (!opened_ || finished_) return 0;
+
+    if (!haveRecord_ || recordRemaining_ == 0) {
+        if (!nextRxRecord()) {
+            finished_ = true;
+            return 0;
+        }
+        haveRecord_ = true;
+    }
+
+    // 원래 타이밍 : 레코드 시각이 되기 전에는 데이터 없음
+    if (mode_ == ReplayMode::ORIGINAL_TIMING && tick_ &&
+        (tick_->getTickCount() - replayStart_) < recordOffset_) {
+        return 0;
+    }
+
+    size_t n = length < recordRemaining_ ? length : recordRemaining_;
+    n = fread(buffer, 1, n, file_);
+    if (n == 0) {
+        finished_ = true;
+        return 0;
+    }
+    recordRemaining_ -= n;
+    rxReplayedBytes_ += n;
+    return n;
+}
+
+bool ReplaySerialImpl::isOpen() {
+    return opened_;
+}
+
+void ReplaySerialImpl::flush() {
+}
+
+#endif
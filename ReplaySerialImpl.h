@@ -0,0 +1,91 @@
+#ifndef REPLAY_SERIAL_IMPL_H_
+#define REPLAY_SERIAL_IMPL_H_
+
+#if !defined(USE_HAL_DRIVER)
+#include "ISerialInterface.h"
+#include "ITick.h"
+#include "SerialCapture.h"
+#include <stdio.h>
+#include <chrono>
+
+// 캡처 파일(SerialCapture.h)의 RX 레코드를 수신 데이터로 다시 공급하는 전송 구현
+// 파일을 순차적으로 읽으므로 수 시간 분량의 캡처도 메모리에 올리지 않음
+class ReplaySerialImpl : public ISerialInterface {
+public:
+    enum class ReplayMode : uint8_t {
+        ORIGINAL_TIMING,    // 캡처 당시의 틱 간격대로 공급 (ITick 필요)
+        AS_FAST_AS_POSSIBLE // 읽기 요청마다 즉시 공급
+    };
+
+    ReplaySerialImpl(FILE* capture, ITick* tick, ReplayMode mode);
+    virtual ~ReplaySerialImpl();
+
+    virtual void init() override;
+    virtual bool open() override;       // 캡처 헤더 검증
+    virtual void close() override;
+    virtual size_t write(const uint8_t* data, size_t length) override;
+    virtual size_t read(uint8_t* buffer, size_t length) override;
+    virtual bool isOpen() override;
+    virtual void flush() override;
+
+    bool finished() const { return finished_; }
+
+    // 회귀 검사 : 프로토콜이 보낸 바이트가 캡처의 TX 바이트와 같은지 (CRC16 누적 비교)
+    bool txMatchesCapture() const { return txCapturedBytes_ == txWrittenBytes_ && txCapturedCrc_ == txWrittenCrc_; }
+
+    uint64_t rxReplayedBytes() const { return rxReplayedBytes_; }
+    uint64_t txCapturedBytes() const { return txCapturedBytes_; }
+    uint64_t txWrittenBytes() const { return txWrittenBytes_; }
+
+private:
+    FILE* file_;
+    ITick* tick_;
+    ReplayMode mode_;
+    bool opened_;
+    bool finished_;
+
+    // 현재 RX 레코드
+    uint32_t recordOffset_;     // 캡처 시작 기준 틱
+    uint32_t recordRemaining_;  // 아직 공급하지 않은 바이트 수
+    bool haveRecord_;
+    uint32_t captureTime_;      // 누적 틱 (캡처 기준)
+    uint32_t replayStart_;      // 재생 시작 틱 (ORIGINAL_TIMING)
+
+    uint64_t rxReplayedBytes_;
+    uint64_t txCapturedBytes_;
+    uint64_t txWrittenBytes_;
+    uint16_t txCapturedCrc_;
+    uint16_t txWrittenCrc_;
+
+    bool readVarint(uint32_t& value);
+    bool nextRxRecord();
+};
+
+// 재생 결과 (처리량 벤치마크)
+struct ReplayStats {
+    uint64_t bytes;
+    double seconds;
+    double megabytesPerSecond;
+    bool txMatches;
+};
+
+// 캡처가 끝날 때까지 processReceivedData() 를 반복 호출
+template <typename Protocol>
+ReplayStats runReplay(Protocol& protocol, ReplaySerialImpl& replay) {
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    while (!replay.finished()) {
+        protocol.processReceivedData();
+    }
+    protocol.processReceivedData();
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+    ReplayStats stats;
+    stats.bytes = replay.rxReplayedBytes();
+    stats.seconds = elapsed.count();
+    stats.megabytesPerSecond = stats.seconds > 0 ? (stats.bytes / 1e6) / stats.seconds : 0;
+    stats.txMatches = replay.txMatchesCapture();
+    return stats;
+}
+
+#endif
+#endif /* REPLAY_SERIAL_IMPL_H_ */
@@ -1,6 +1,6 @@
 #include "STM32SerialImpl.h"
 
-STM32SerialImpl::STM32SerialImpl(UART_HandleTypeDef* huart, IRQn_Type UART_IRQn) : huart_(huart), UART_IRQn_(UART_IRQn) {
+STM32SerialImpl::STM32SerialImpl(UART_HandleTypeDef* huart, IRQn_Type UART_IRQn) : huart_(huart), UART_IRQn_(UART_IRQn), rxNotify_(nullptr), rxNotifyContext_(nullptr) {
     serial_.init(huart, UART_IRQn_);
 }
 
@@ -39,6 +39,27 @@ void STM32SerialImpl::flush() {
     }
 }
 
+// 링크 속도 변경 : 송신 완료를 기다린 뒤 UART 재설정 후 수신 인터럽트 재시작
+bool STM32SerialImpl::setBaudRate(uint32_t baudRate) {
+    if (baudRate == 0) return false;
+
+    uint32_t start = HAL_GetTick();
+    while (huart_->gState != HAL_UART_STATE_READY) {
+        if (HAL_GetTick() - start > 100) return false;
+    }
+
+    HAL_UART_Abort(huart_);
+    huart_->Init.BaudRate = baudRate;
+    if (HAL_UART_Init(huart_) != HAL_OK) return false;
+
+    serial_.init(huart_, UART_IRQn_);
+    return true;
+}
+
+uint32_t STM32SerialImpl::getBaudRate() const {
+    return huart_->Init.BaudRate;
+}
+
 void STM32SerialImpl::TxCpltCallback(UART_HandleTypeDef *huart) {
     if (huart == huart_) {
         serial_.TxCpltCallback(huart);
@@ -48,9 +69,17 @@ void STM32SerialImpl::TxCpltCallback(UART_HandleTypeDef *huart) {
 void STM32SerialImpl::RxCpltCallback(UART_HandleTypeDef *huart) {
     if (huart == huart_) {
         serial_.RxCpltCallback(huart);
+        if (rxNotify_) {
+            rxNotify_(rxNotifyContext_);
+        }
     }
 }
 
+void STM32SerialImpl::setRxNotify(void (*notify)(void* context), void* context) {
+    rxNotifyContext_ = context;
+    rxNotify_ = notify;
+}
+
 void STM32SerialImpl::loop() {
     serial_.loop();
 }
@@ -12,12 +12,18 @@ public:
     virtual size_t read(uint8_t* buffer, size_t length) override;
     virtual bool isOpen() override;
     virtual void flush() override;
+    virtual bool setBaudRate(uint32_t baudRate) override;
+    virtual uint32_t getBaudRate() const override;
 
     // UART 콜백 함수 추가
     void TxCpltCallback(UART_HandleTypeDef *huart);
     void RxCpltCallback(UART_HandleTypeDef *huart);
     void loop();
 
+    // 수신 알림 훅 : RxCpltCallback(인터럽트 문맥)에서 호출됨
+    // 예) serial.setRxNotify(&Com_Protocol::notifyRxCallback, &protocol);
+    void setRxNotify(void (*notify)(void* context), void* context);
+
     // LED 초기화 함수 추가
     void init_txLed(GPIO_TypeDef *Port, uint16_t Pin, GPIO_PinState OnState);
     void init_rxLed(GPIO_TypeDef *Port, uint16_t Pin, GPIO_PinState OnState);
@@ -27,6 +33,9 @@ private:
     UART_HandleTypeDef* huart_;
     IRQn_Type UART_IRQn_;
     Serial serial_;
+
+    void (*rxNotify_)(void* context);
+    void* rxNotifyContext_;
 };
 
 #endif
@@ -0,0 +1,121 @@
+#include "SerialCapture.h"
+#include <string.h>
+
+static size_t encodeVarint(uint8_t* out, uint32_t value) {
+    size_t n = 0;
+    while (value >= 0x80) {
+        out[n++] = static_cast<uint8_t>(value | 0x80);
+        value >>= 7;
+    }
+    out[n++] = static_cast<uint8_t>(value);
+    return n;
+}
+
+CaptureSerialTap::CaptureSerialTap(ISerialInterface* inner, ITick* tick, ICaptureSink* sink) :
+    inner_(inner),
+    tick_(tick),
+    sink_(sink),
+    headerWritten_(false),
+    lastTick_(0),
+    pendingDirection_(0),
+    pendingTick_(0),
+    pendingLength_(0)
+{
+}
+
+CaptureSerialTap::~CaptureSerialTap() {
+    flushCapture();
+}
+
+void CaptureSerialTap::init() {
+    inner_->init();
+}
+
+bool CaptureSerialTap::open() {
+    return inner_->open();
+}
+
+void CaptureSerialTap::close() {
+    flushCapture();
+    inner_->close();
+}
+
+size_t CaptureSerialTap::write(const uint8_t* data, size_t length) {
+    size_t written = inner_->write(data, length);
+    if (written > 0) {
+        record(SerialCaptureFormat::DIR_TX, data, written);
+    }
+    return written;
+}
+
+size_t CaptureSerialTap::read(uint8_t* buffer, size_t length) {
+    size_t readCount = inner_->read(buffer, length);
+    if (readCount > 0) {
+        record(SerialCaptureFormat::DIR_RX, buffer, readCount);
+    }
+    return readCount;
+}
+
+bool CaptureSerialTap::isOpen() {
+    return inner_->isOpen();
+}
+
+void CaptureSerialTap::flush() {
+    inner_->flush();
+}
+
+void CaptureSerialTap::record(uint8_t direction, const uint8_t* data, size_t length) {
+    if (!sink_) return;
+
+    uint32_t now = tick_->getTickCount();
+
+    // 방향이나 틱이 바뀌면 이전 레코드를 기록
+    if (pendingLength_ > 0 && (direction != pendingDirection_ || now != pendingTick_)) {
+        flushCapture();
+    }
+
+    while (length > 0) {
+        if (pendingLength_ == 0) {
+            pendingDirection_ = direction;
+            pendingTick_ = now;
+        }
+        size_t chunk = PENDING_SIZE - pendingLength_;
+        if (chunk > length) chunk = length;
+        memcpy(pending_ + pendingLength_, data, chunk);
+        pendingLength_ += chunk;
+        data += chunk;
+        length -= chunk;
+
+        if (pendingLength_ == PENDING_SIZE) {
+            flushCapture();
+        }
+    }
+}
+
+void CaptureSerialTap::flushCapture() {
+    if (!sink_) return;
+
+    if (!headerWritten_) {
+        uint8_t header[SerialCaptureFormat::HEADER_SIZE];
+        memcpy(header, SerialCaptureFormat::MAGIC, 4);
+        header[4] = SerialCaptureFormat::VERSION;
+        header[5] = SerialCaptureFormat::TICK_UNIT_MS;
+        sink_->writeCapture(header, sizeof(header));
+        headerWritten_ = true;
+        lastTick_ = pendingLength_ > 0 ? pendingTick_ : tick_->getTickCount();
+    }
+
+    if (pendingLength_ == 0) return;
+
+    uint8_t recordHeader[1 + 5 + 5];
+    size_t n = 0;
+    recordHeader[n++] = pendingDirection_;
+    n += encodeVarint(recordHeader + n, pendingTick_ - lastTick_);
+    n += encodeVarint(recordHeader + n, static_cast<uint32_t>(pendingLength_));
+
+    sink_->writeCapture(recordHeader, n);
+    sink_->writeCapture(pending_, pendingLength_);
+
+    lastTick_ = pendingTick_;
+    pendingLength_ = 0;
+}
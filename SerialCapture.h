@@ -0,0 +1,87 @@
+#ifndef SERIAL_CAPTURE_H_
+#define SERIAL_CAPTURE_H_
+
+#include "ISerialInterface.h"
+#include "ITick.h"
+#include <stdint.h>
+#include <stddef.h>
+
+#if !defined(USE_HAL_DRIVER)
+#include <stdio.h>
+#endif
+
+/*
+ * 캡처 파일 포맷 (리틀/빅 엔디안 무관, 가변 길이 정수 사용)
+ *
+ *  헤더   : "SCAP"(4) + 버전(1) + 틱 단위(1, 1 = ms)
+ *  레코드 : 방향(1, 0 = RX, 1 = TX) + 틱 증분(varint) + 길이(varint) + 데이터
+ *
+ *  같은 틱, 같은 방향의 연속된 read/write 는 한 레코드로 합쳐 저장됩니다.
+ */
+namespace SerialCaptureFormat {
+    static const uint8_t MAGIC[4] = { 'S', 'C', 'A', 'P' };
+    static const uint8_t VERSION = 1;
+    static const uint8_t TICK_UNIT_MS = 1;
+    static const size_t HEADER_SIZE = 6;
+
+    enum Direction : uint8_t {
+        DIR_RX = 0,
+        DIR_TX = 1
+    };
+}
+
+// 캡처 출력 대상 (MCU 에서는 RAM/플래시, 호스트에서는 파일)
+class ICaptureSink {
+public:
+    virtual ~ICaptureSink() {}
+    virtual void writeCapture(const uint8_t* data, size_t length) = 0;
+};
+
+#if !defined(USE_HAL_DRIVER)
+class FileCaptureSink : public ICaptureSink {
+public:
+    explicit FileCaptureSink(FILE* file) : file_(file) {}
+    virtual void writeCapture(const uint8_t* data, size_t length) override {
+        if (file_) fwrite(data, 1, length, file_);
+    }
+
+private:
+    FILE* file_;
+};
+#endif
+
+// ISerialInterface 데코레이터 : 실제 전송은 inner 로 넘기고 읽기/쓰기 바이트를 캡처
+class CaptureSerialTap : public ISerialInterface {
+public:
+    CaptureSerialTap(ISerialInterface* inner, ITick* tick, ICaptureSink* sink);
+    virtual ~CaptureSerialTap();
+
+    virtual void init() override;
+    virtual bool open() override;
+    virtual void close() override;
+    virtual size_t write(const uint8_t* data, size_t length) override;
+    virtual size_t read(uint8_t* buffer, size_t length) override;
+    virtual bool isOpen() override;
+    virtual void flush() override;
+
+    void flushCapture();    // 합쳐 두었던 레코드를 즉시 기록
+
+private:
+    static const size_t PENDING_SIZE = 256;
+
+    ISerialInterface* inner_;
+    ITick* tick_;
+    ICaptureSink* sink_;
+
+    bool headerWritten_;
+    uint32_t lastTick_;
+
+    uint8_t pendingDirection_;
+    uint32_t pendingTick_;
+    size_t pendingLength_;
+    uint8_t pending_[PENDING_SIZE];
+
+    void record(uint8_t direction, const uint8_t* data, size_t length);
+};
+
+#endif /* SERIAL_CAPTURE_H_ */
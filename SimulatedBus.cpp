@@ -0,0 +1,161 @@
+#if !defined(USE_HAL_DRIVER)
+#include "SimulatedBus.h"
+
+SimulatedBusEndpoint::SimulatedBusEndpoint(SimulatedBus* bus) :
+    bus_(bus),
+    baudRate_(bus->config_.baudRate),
+    txReadyNs_(0),
+    lastRxEndNs_(0),
+    bitsUntilError_(0)
+{
+}
+
+size_t SimulatedBusEndpoint::write(const uint8_t* data, size_t length) {
+    if (tx_.empty()) {
+        // 새 송신 : 마지막 수신 이후 전환 지연 적용
+        uint64_t turnaroundEnd = lastRxEndNs_ + bus_->config_.turnaroundUs * 1000ULL;
+        txReadyNs_ = bus_->nowNs_ > turnaroundEnd ? bus_->nowNs_ : turnaroundEnd;
+    }
+    tx_.insert(tx_.end(), data, data + length);
+    return length;
+}
+
+// 송신 대기 중인 바이트는 새 속도로 전송됨 (실제 UART 처럼 송신 완료 후 호출해야 함)
+bool SimulatedBusEndpoint::setBaudRate(uint32_t baudRate) {
+    if (baudRate == 0) return false;
+    baudRate_ = baudRate;
+    return true;
+}
+
+size_t SimulatedBusEndpoint::read(uint8_t* buffer, size_t length) {
+    size_t n = 0;
+    while (n < length && !rx_.empty()) {
+        buffer[n++] = rx_.front();
+        rx_.pop_front();
+    }
+    return n;
+}
+
+uint32_t SimulatedTick::getTickCount(void) {
+    return static_cast<uint32_t>(bus_->nowNs() / 1000000ULL);
+}
+
+SimulatedBus::SimulatedBus(const SimulatedBusConfig& config) :
+    config_(config),
+    nowNs_(0),
+    byteTimeNs_(static_cast<uint64_t>(config.bitsPerByte) * 1000000000ULL / config.baudRate),
+    tick_(this),
+    rng_(config.seed)
+{
+}
+
+SimulatedBusEndpoint* SimulatedBus::addEndpoint() {
+    endpoints_.push_back(std::unique_ptr<SimulatedBusEndpoint>(new SimulatedBusEndpoint(this)));
+    SimulatedBusEndpoint* endpoint = endpoints_.back().get();
+    endpoint->bitsUntilError_ = drawBitsUntilError();
+    return endpoint;
+}
+
+void SimulatedBus::setBitErrorRate(double bitErrorRate) {
+    config_.bitErrorRate = bitErrorRate;
+    for (size_t i = 0; i < endpoints_.size(); i++) {
+        endpoints_[i]->bitsUntilError_ = drawBitsUntilError();
+    }
+}
+
+uint64_t SimulatedBus::drawBitsUntilError() {
+    if (config_.bitErrorRate <= 0.0) return UINT64_MAX;
+    std::geometric_distribution<uint64_t> dist(config_.bitErrorRate);
+    return dist(rng_);
+}
+
+// 수신 측별 비트 에러 주입 : 다음 에러 위치를 기하 분포로 뽑아 비트마다 난수를 쓰지 않음
+uint8_t SimulatedBus::applyBitErrors(SimulatedBusEndpoint* endpoint, uint8_t value) {
+    uint64_t bits = 8;
+    uint8_t bit = 0;
+    while (endpoint->bitsUntilError_ < bits) {
+        bit += static_cast<uint8_t>(endpoint->bitsUntilError_);
+        value ^= static_cast<uint8_t>(1u << bit);
+        stats_.bitErrors++;
+        bits -= endpoint->bitsUntilError_ + 1;
+        bit++;
+        endpoint->bitsUntilError_ = drawBitsUntilError();
+    }
+    if (endpoint->bitsUntilError_ != UINT64_MAX) endpoint->bitsUntilError_ -= bits;
+    return value;
+}
+
+uint64_t SimulatedBus::byteTimeAt(uint32_t baudRate) const {
+    return static_cast<uint64_t>(config_.bitsPerByte) * 1000000000ULL / baudRate;
+}
+
+bool SimulatedBus::txIdle() const {
+    for (size_t i = 0; i < endpoints_.size(); i++) {
+        if (!endpoints_[i]->tx_.empty()) return false;
+    }
+    return true;
+}
+
+void SimulatedBus::advance(uint64_t ns) {
+    nowNs_ += ns;
+    stats_.elapsedNs += ns;
+}
+
+void SimulatedBus::step() {
+    // 이번 바이트 시간에 송신하는 노드 수집
+    active_.clear();
+    uint8_t value = 0;
+    uint32_t baudRate = config_.baudRate;
+
+    for (size_t i = 0; i < endpoints_.size(); i++) {
+        SimulatedBusEndpoint* endpoint = endpoints_[i].get();
+        if (endpoint->tx_.empty() || endpoint->txReadyNs_ > nowNs_) continue;
+
+        value = endpoint->tx_.front();
+        endpoint->tx_.pop_front();
+        if (active_.empty()) baudRate = endpoint->baudRate_;
+        active_.push_back(endpoint);
+    }
+
+    // 바이트 시간은 (첫) 송신 측 속도 기준
+    uint64_t byteTimeNs = (baudRate == config_.baudRate) ? byteTimeNs_ : byteTimeAt(baudRate);
+    uint64_t endNs = nowNs_ + byteTimeNs;
+
+    if (!active_.empty()) {
+        stats_.bytesSent++;
+        stats_.busyNs += byteTimeNs;
+
+        if (active_.size() > 1) {
+            // 충돌 : 구동기끼리 충돌한 값은 예측 불가
+            stats_.collisions++;
+            value = static_cast<uint8_t>(rng_());
+        }
+
+        for (size_t i = 0; i < endpoints_.size(); i++) {
+            SimulatedBusEndpoint* endpoint = endpoints_[i].get();
+            // 이번 바이트 시간에 송신한 노드는 수신하지 않음
+            bool sending = false;
+            for (size_t j = 0; j < active_.size(); j++) {
+                if (active_[j] == endpoint) { sending = true; break; }
+            }
+            if (sending) continue;
+
+            if (endpoint->baudRate_ != baudRate) {
+                // 속도 불일치 : 프레이밍이 맞지 않아 값은 예측 불가
+                stats_.baudMismatches++;
+                endpoint->rx_.push_back(static_cast<uint8_t>(rng_()));
+                endpoint->lastRxEndNs_ = endNs;
+                stats_.bytesDelivered++;
+                continue;
+            }
+            endpoint->rx_.push_back(applyBitErrors(endpoint, value));
+            endpoint->lastRxEndNs_ = endNs;
+            stats_.bytesDelivered++;
+        }
+    }
+
+    nowNs_ = endNs;
+    stats_.elapsedNs += byteTimeNs;
+}
+
+#endif
@@ -0,0 +1,166 @@
+#ifndef SIMULATED_BUS_H_
+#define SIMULATED_BUS_H_
+
+#if !defined(USE_HAL_DRIVER)
+#include "ISerialInterface.h"
+#include "ITick.h"
+#include <stdint.h>
+#include <deque>
+#include <memory>
+#include <random>
+#include <vector>
+#include <functional>
+
+/*
+ * 가상 멀티드롭 RS485 버스 (호스트 스케일링 테스트용)
+ *
+ *  - 바이트 단위 이산 시뮬레이션 : 실제 시간보다 빠르게 실행
+ *  - 보레이트에 따른 직렬화 지연 (bitsPerByte / baudRate)
+ *  - 반이중 전환 지연 : 마지막 수신 후 turnaroundUs 가 지나야 송신 시작
+ *  - 충돌 : 같은 바이트 시간에 둘 이상 송신하면 모든 수신 측에 깨진 바이트 전달
+ *  - 비트 에러 : 수신 측마다 독립적으로 bitErrorRate 확률로 비트 반전
+ *  - 송신 중인 노드는 버스를 수신하지 않음 (에코 없음)
+ *  - 엔드포인트별 보레이트 (setBaudRate) : 송신 측과 속도가 다른 수신 측에는 깨진 바이트 전달
+ *
+ *  SimulatedBus bus(config);
+ *  std::vector<Com_Protocol*> nodes;
+ *  for (int i = 0; i < 64; i++) nodes.push_back(new Com_Protocol(bus.addEndpoint(), bus.tick(), i + 1));
+ *  bus.run(nodes, 10 * 1000000ULL, [&]() { ... 1ms 마다 호출 ... });
+ */
+
+struct SimulatedBusConfig {
+    uint32_t baudRate = 115200;
+    uint8_t bitsPerByte = 10;       // start + 8 data + stop
+    uint32_t turnaroundUs = 50;     // 수신 -> 송신 전환 지연
+    double bitErrorRate = 0.0;
+    uint32_t seed = 1;
+};
+
+struct SimulatedBusStats {
+    uint64_t bytesSent = 0;         // 버스에 실린 바이트 (충돌 포함)
+    uint64_t bytesDelivered = 0;    // 수신 측에 전달된 바이트 합
+    uint64_t collisions = 0;        // 충돌한 바이트 시간 수
+    uint64_t bitErrors = 0;         // 주입된 비트 에러 수
+    uint64_t baudMismatches = 0;    // 송신 측과 속도가 달라 깨진 수신 바이트 수
+    uint64_t busyNs = 0;            // 버스 점유 시간
+    uint64_t elapsedNs = 0;         // 시뮬레이션 경과 시간
+
+    double utilization() const { return elapsedNs ? double(busyNs) / double(elapsedNs) : 0.0; }
+};
+
+class SimulatedBus;
+
+class SimulatedBusEndpoint : public ISerialInterface {
+public:
+    virtual void init() override {}
+    virtual bool open() override { return true; }
+    virtual void close() override {}
+    virtual size_t write(const uint8_t* data, size_t length) override;
+    virtual size_t read(uint8_t* buffer, size_t length) override;
+    virtual bool isOpen() override { return true; }
+    virtual void flush() override { rx_.clear(); }
+    virtual bool setBaudRate(uint32_t baudRate) override;
+    virtual uint32_t getBaudRate() const override { return baudRate_; }
+
+    bool hasRxData() const { return !rx_.empty(); }
+    size_t txPending() const { return tx_.size(); }
+
+private:
+    friend class SimulatedBus;
+    explicit SimulatedBusEndpoint(SimulatedBus* bus);
+
+    SimulatedBus* bus_;
+    std::deque<uint8_t> rx_;
+    std::deque<uint8_t> tx_;
+    uint32_t baudRate_;
+    uint64_t txReadyNs_;        // 이 시각 이후 송신 가능 (전환 지연)
+    uint64_t lastRxEndNs_;
+    uint64_t bitsUntilError_;   // 다음 비트 에러까지 남은 비트 수 (기하 분포)
+};
+
+// 버스 시뮬레이션 시간을 ms 틱으로 제공
+class SimulatedTick : public ITick {
+public:
+    explicit SimulatedTick(SimulatedBus* bus) : bus_(bus), tickTime(0) {}
+
+    virtual bool delay(uint32_t time) override { return (getTickCount() - tickTime) >= time; }
+    virtual uint32_t elapsed(uint32_t time) override { return getTickCount() - time; }
+    virtual uint32_t getElapsed(uint32_t time1, uint32_t time2) override { return time2 - time1; }
+    virtual uint32_t getTickCount(void) override;
+    virtual void tickUpdate() override { tickTime = getTickCount(); }
+    virtual bool tickCheck(uint32_t time) override { return delay(time); }
+
+private:
+    SimulatedBus* bus_;
+    uint32_t tickTime;
+};
+
+class SimulatedBus {
+public:
+    explicit SimulatedBus(const SimulatedBusConfig& config);
+
+    SimulatedBusEndpoint* addEndpoint();    // 버스가 소유
+    ITick* tick() { return &tick_; }
+
+    uint64_t nowNs() const { return nowNs_; }
+    uint64_t byteTimeNs() const { return byteTimeNs_; }     // 기본 보레이트 기준
+    const SimulatedBusStats& stats() const { return stats_; }
+    void setBitErrorRate(double bitErrorRate);
+
+    void step();                // 한 바이트 시간 진행
+    bool txIdle() const;        // 송신 대기 중인 노드가 없음
+    void advance(uint64_t ns);  // 버스 활동 없이 시간만 진행
+
+    // durationNs 동안 시뮬레이션 : 수신 데이터가 있는 노드와 1ms 마다 전체 노드의 processReceivedData() 호출
+    template <typename Protocol>
+    void run(const std::vector<Protocol*>& nodes, uint64_t durationNs,
+             const std::function<void()>& everyMillisecond = std::function<void()>());
+
+private:
+    friend class SimulatedBusEndpoint;
+
+    SimulatedBusConfig config_;
+    uint64_t nowNs_;
+    uint64_t byteTimeNs_;
+    std::vector<std::unique_ptr<SimulatedBusEndpoint> > endpoints_;
+    SimulatedTick tick_;
+    SimulatedBusStats stats_;
+    std::mt19937_64 rng_;
+    std::vector<SimulatedBusEndpoint*> active_;     // 이번 바이트 시간의 송신 노드
+
+    uint64_t byteTimeAt(uint32_t baudRate) const;
+    uint64_t drawBitsUntilError();
+    uint8_t applyBitErrors(SimulatedBusEndpoint* endpoint, uint8_t value);
+};
+
+template <typename Protocol>
+void SimulatedBus::run(const std::vector<Protocol*>& nodes, uint64_t durationNs,
+                       const std::function<void()>& everyMillisecond) {
+    const uint64_t MS = 1000000ULL;
+    uint64_t endNs = nowNs_ + durationNs;
+    uint64_t nextMs = (nowNs_ / MS + 1) * MS;
+
+    while (nowNs_ < endNs) {
+        if (txIdle()) {
+            // 버스 유휴 : 다음 ms 경계로 바로 이동
+            advance((nextMs < endNs ? nextMs : endNs) - nowNs_);
+        } else {
+            step();
+        }
+
+        for (size_t i = 0; i < nodes.size(); i++) {
+            if (endpoints_[i]->hasRxData()) nodes[i]->processReceivedData();
+        }
+
+        if (nowNs_ >= nextMs) {
+            nextMs = (nowNs_ / MS + 1) * MS;
+            for (size_t i = 0; i < nodes.size(); i++) {
+                nodes[i]->processReceivedData();    // 프레임 타임아웃 처리
+            }
+            if (everyMillisecond) everyMillisecond();
+        }
+    }
+}
+
+#endif
+#endif /* SIMULATED_BUS_H_ */
@@ -0,0 +1,204 @@
+#include "TraceExport.h"
+
+#if !defined(USE_HAL_DRIVER)
+#include "protocol_trace.h"
+#include <string.h>
+#include <vector>
+
+namespace {
+
+const uint32_t TID_PARSER = 1;
+const uint32_t TID_DISPATCH = 2;
+
+uint32_t load32(const uint8_t* p) {
+    return (static_cast<uint32_t>(p[0]) << 24) | (static_cast<uint32_t>(p[1]) << 16) |
+           (static_cast<uint32_t>(p[2]) << 8) | p[3];
+}
+
+const char* rxStateName(uint8_t state) {
+    static const char* const NAMES[] = {
+        "WAIT_START", "READ_LENGTH", "READ_RECEIVER_ID", "READ_SENDER_ID",
+        "READ_CMD", "READ_SEQ", "READ_PAYLOAD", "READ_FEC_BLOCK"
+    };
+    return state < sizeof(NAMES) / sizeof(NAMES[0]) ? NAMES[state] : "UNKNOWN";
+}
+
+class ChromeTraceWriter {
+public:
+    explicit ChromeTraceWriter(FILE* out) : out_(out), first_(true) {}
+
+    void begin() { fputs("{\"displayTimeUnit\":\"ns\",\"traceEvents\":[", out_); }
+    bool end() {
+        fputs("\n]}\n", out_);
+        return ferror(out_) == 0;
+    }
+
+    void metadata(uint32_t pid, uint32_t tid, const char* kind, const char* name) {
+        separator();
+        fprintf(out_, "{\"ph\":\"M\",\"pid\":%u,\"tid\":%u,\"name\":\"%s\",\"args\":{\"name\":\"%s\"}}",
+                pid, tid, kind, name);
+    }
+
+    // X : 완료 구간, B/E : 시작/끝, i : 순간
+    void complete(uint32_t pid, uint32_t tid, const char* name, double ts, double dur, const char* args) {
+        separator();
+        fprintf(out_, "{\"ph\":\"X\",\"pid\":%u,\"tid\":%u,\"name\":\"%s\",\"ts\":%.3f,\"dur\":%.3f%s}",
+                pid, tid, name, ts, dur, args);
+    }
+    void event(char phase, uint32_t pid, uint32_t tid, const char* name, double ts, const char* args) {
+        separator();
+        fprintf(out_, "{\"ph\":\"%c\",\"pid\":%u,\"tid\":%u,\"name\":\"%s\",\"ts\":%.3f%s%s}",
+                phase, pid, tid, name, ts, phase == 'i' ? ",\"s\":\"t\"" : "", args);
+    }
+
+private:
+    FILE* out_;
+    bool first_;
+
+    void separator() {
+        fputs(first_ ? "\n" : ",\n", out_);
+        first_ = false;
+    }
+};
+
+// 덤프 하나 : 파서 상태는 다음 전환(또는 폐기)에서 구간으로, 분기/송신은 B/E 쌍으로 기록
+bool exportNode(const uint8_t* dump, size_t length, ChromeTraceWriter& writer, TraceExportResult& result,
+                size_t& consumed) {
+    using namespace ProtocolTraceFormat;
+    if (length < HEADER_SIZE || memcmp(dump, MAGIC, 4) != 0 || dump[4] != VERSION) return false;
+    uint32_t pid = static_cast<uint32_t>((dump[6] << 8) | dump[7]);
+    uint32_t hz = load32(dump + 8);
+    uint32_t count = load32(dump + 12);
+    if (hz == 0 || (length - HEADER_SIZE) / EVENT_SIZE < count) return false;
+    consumed = HEADER_SIZE + static_cast<size_t>(count) * EVENT_SIZE;
+
+    char name[32];
+    snprintf(name, sizeof(name), "node 0x%04X", pid);
+    writer.metadata(pid, TID_PARSER, "process_name", name);
+    writer.metadata(pid, TID_PARSER, "thread_name", "rx parser");
+    writer.metadata(pid, TID_DISPATCH, "thread_name", "dispatch/tx");
+
+    const double usPerTick = 1000000.0 / hz;
+    uint64_t ticks = 0;
+    uint32_t previous = 0;
+    bool haveState = false;
+    uint8_t state = WAIT_START;
+    double stateStart = 0.0;
+    uint16_t stateLength = 0;
+    std::vector<uint8_t> open;      // 열린 B 구간 (DISPATCH_BEGIN / WRITE_BEGIN)
+    char args[96];
+
+    const uint8_t* p = dump + HEADER_SIZE;
+    for (uint32_t i = 0; i < count; i++, p += EVENT_SIZE) {
+        uint32_t raw = load32(p);
+        ticks = i == 0 ? raw : ticks + static_cast<uint32_t>(raw - previous);
+        previous = raw;
+        double ts = ticks * usPerTick;
+        uint8_t type = p[4];
+        uint8_t arg8 = p[5];
+        uint16_t arg16 = static_cast<uint16_t>((p[6] << 8) | p[7]);
+        uint32_t arg32 = load32(p + 8);
+
+        switch (type) {
+            case RX_STATE:
+            case RX_ABORT:
+                if (haveState && state != WAIT_START) {
+                    // 길이 필드는 READ_LENGTH 이후에만 유효
+                    if (state == READ_LENGTH) {
+                        snprintf(args, sizeof(args), ",\"args\":{\"aborted\":%s}", type == RX_ABORT ? "true" : "false");
+                    } else {
+                        snprintf(args, sizeof(args), ",\"args\":{\"length\":%u,\"aborted\":%s}",
+                                 stateLength, type == RX_ABORT ? "true" : "false");
+                    }
+                    writer.complete(pid, TID_PARSER, rxStateName(state), stateStart, ts - stateStart, args);
+                }
+                if (type == RX_ABORT) {
+                    snprintf(args, sizeof(args), ",\"args\":{\"state\":\"%s\"}", rxStateName(arg8));
+                    writer.event('i', pid, TID_PARSER, "abort", ts, args);
+                }
+                haveState = true;
+                state = type == RX_STATE ? arg8 : static_cast<uint8_t>(WAIT_START);
+                stateStart = ts;
+                stateLength = arg16;
+                break;
+
+            case DISPATCH_BEGIN:
+                snprintf(name, sizeof(name), "CMD 0x%04X", arg16);
+                snprintf(args, sizeof(args), ",\"args\":{\"sender\":%u,\"seq\":%u}", arg32 >> 16, arg32 & 0xFFFF);
+                writer.event('B', pid, TID_DISPATCH, name, ts, args);
+                open.push_back(DISPATCH_BEGIN);
+                break;
+
+            case WRITE_BEGIN:
+                snprintf(args, sizeof(args), ",\"args\":{\"bytes\":%u}", arg32);
+                writer.event('B', pid, TID_DISPATCH, "write", ts, args);
+                open.push_back(WRITE_BEGIN);
+                break;
+
+            case DISPATCH_END:
+            case WRITE_END: {
+                uint8_t begin = type == DISPATCH_END ? DISPATCH_BEGIN : WRITE_BEGIN;
+                if (open.empty() || open.back() != begin) {
+                    result.unmatched++;
+                    break;
+                }
+                open.pop_back();
+                writer.event('E', pid, TID_DISPATCH, "", ts, "");
+                break;
+            }
+
+            case REPLY_REPLAY:
+                snprintf(name, sizeof(name), "replay CMD 0x%04X", arg16);
+                snprintf(args, sizeof(args), ",\"args\":{\"sender\":%u,\"seq\":%u}", arg32 >> 16, arg32 & 0xFFFF);
+                writer.event('i', pid, TID_DISPATCH, name, ts, args);
+                break;
+
+            default:
+                break;
+        }
+        result.events++;
+    }
+    result.nodes++;
+    return true;
+}
+
+}  // namespace
+
+TraceExportResult exportChromeTrace(const uint8_t* dump, size_t length, FILE* out) {
+    TraceExportResult result;
+    if (!dump || !out) return result;
+
+    ChromeTraceWriter writer(out);
+    writer.begin();
+    bool valid = length > 0;
+    size_t offset = 0;
+    while (offset < length) {
+        size_t consumed = 0;
+        if (!exportNode(dump + offset, length - offset, writer, result, consumed)) {
+            valid = false;
+            break;
+        }
+        offset += consumed;
+    }
+    result.ok = writer.end() && valid;
+    return result;
+}
+
+TraceExportResult exportChromeTraceFile(const char* dumpPath, const char* jsonPath) {
+    TraceExportResult result;
+    FILE* in = fopen(dumpPath, "rb");
+    if (!in) return result;
+    std::vector<uint8_t> dump;
+    uint8_t chunk[4096];
+    size_t n;
+    while ((n = fread(chunk, 1, sizeof(chunk), in)) > 0) dump.insert(dump.end(), chunk, chunk + n);
+    fclose(in);
+
+    FILE* out = fopen(jsonPath, "w");
+    if (!out) return result;
+    result = exportChromeTrace(dump.data(), dump.size(), out);
+    if (fclose(out) != 0) result.ok = false;
+    return result;
+}
+
+#endif
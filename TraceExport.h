@@ -0,0 +1,33 @@
+#ifndef TRACE_EXPORT_H_
+#define TRACE_EXPORT_H_
+
+#if !defined(USE_HAL_DRIVER)
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+
+/*
+ * 트레이스 덤프 -> Chrome/Perfetto trace JSON 변환 (호스트 전용)
+ *
+ *  입력은 Com_ProtocolEngine::dumpTrace() 출력 (ProtocolTraceFormat) 이며, 여러 노드의 덤프를 이어 붙여도 됩니다.
+ *  노드마다 프로세스 하나 (pid = 노드 ID), 스레드 두 개로 표시합니다.
+ *   - "rx parser"    : 파서 상태 구간 (READ_LENGTH ~ READ_PAYLOAD, 폐기된 구간은 args.aborted)
+ *   - "dispatch/tx"  : processCommand 구간 (CMD, 송신자, 시퀀스) 과 그 안팎의 serial write 구간 (바이트 수)
+ *  시각은 덤프의 시계 Hz 로 us 로 바꾸고, 32비트 넘침은 이벤트 간격이 한 바퀴보다 짧다고 보고 이어 붙입니다.
+ *
+ *  FILE* json = fopen("trace.json", "w");
+ *  TraceExportResult r = exportChromeTrace(dump, length, json);      // chrome://tracing 또는 ui.perfetto.dev 에서 열기
+ */
+
+struct TraceExportResult {
+    bool ok = false;            // 덤프 형식이 올바르고 JSON 을 모두 씀
+    uint32_t nodes = 0;         // 덤프 수
+    uint32_t events = 0;        // 읽은 이벤트 수
+    uint32_t unmatched = 0;     // 링 시작 전에 열린 구간의 끝 (건너뜀)
+};
+
+TraceExportResult exportChromeTrace(const uint8_t* dump, size_t length, FILE* out);
+TraceExportResult exportChromeTraceFile(const char* dumpPath, const char* jsonPath);
+
+#endif
+#endif /* TRACE_EXPORT_H_ */
@@ -0,0 +1,208 @@
+/*
+ * com_protocol_async.cpp
+ *
+ *  C++20 코루틴 기반 요청/응답 API (호스트 빌드 전용)
+ */
+#include "com_protocol_async.h"
+
+#if defined(__cpp_impl_coroutine) && !defined(USE_HAL_DRIVER)
+
+ConversationFramePool& conversationFramePool() {
+    static ConversationFramePool pool;
+    return pool;
+}
+
+AsyncCom_Protocol::RequestAwaiter::RequestAwaiter(AsyncCom_Protocol* protocol, uint16_t targetId, uint16_t cmd,
+                                                  const uint8_t* payload, size_t length, uint32_t timeoutMs,
+                                                  uint8_t retries, bool sleep, uint8_t matchLength) :
+    protocol_(protocol),
+    targetId_(targetId),
+    cmd_(cmd),
+    payload_(payload),
+    length_(length),
+    timeoutMs_(timeoutMs),
+    seq_(0),
+    sleep_(sleep),
+    sent_(false),
+    retriesLeft_(retries),
+    matchLength_(0),
+    deadline_(0),
+    prev_(nullptr),
+    next_(nullptr)
+{
+    result_.ok = false;
+    result_.retransmits = 0;
+    result_.senderId = 0;
+    result_.cmd = 0;
+    result_.length = 0;
+    if (matchLength > MAX_MATCH_LENGTH) matchLength = MAX_MATCH_LENGTH;
+    if (matchLength > length) matchLength = static_cast<uint8_t>(length);
+    if (matchLength > 0) memcpy(match_, payload, matchLength);
+    matchLength_ = matchLength;
+}
+
+// 대기 목록에 등록한 뒤 요청 전송 (응답은 이후 processReceivedData() 에서만 도착)
+void AsyncCom_Protocol::RequestAwaiter::await_suspend(std::coroutine_handle<> handle) {
+    handle_ = handle;
+    deadline_ = protocol_->tick_->getTickCount() + timeoutMs_;
+    protocol_->enqueue(this);
+    if (sleep_) return;
+    if (protocol_->maxInFlight_ == 0 || protocol_->inFlight_ < protocol_->maxInFlight_) protocol_->transmit(this);
+}
+
+AsyncCom_Protocol::AsyncCom_Protocol(ISerialInterface* serial, ITick* tick, uint16_t my_id) :
+    Com_Protocol(serial, tick, my_id),
+    pendingHead_(nullptr),
+    pendingTail_(nullptr),
+    pendingCount_(0),
+    maxInFlight_(0),
+    inFlight_(0)
+{
+}
+
+AsyncCom_Protocol::~AsyncCom_Protocol() {
+    // 대기 중인 코루틴 프레임 해제 (재개하지 않음)
+    while (pendingHead_) {
+        RequestAwaiter* awaiter = pendingHead_;
+        unlink(awaiter);
+        awaiter->handle_.destroy();
+    }
+}
+
+void AsyncCom_Protocol::enqueue(RequestAwaiter* awaiter) {
+    awaiter->next_ = nullptr;
+    awaiter->prev_ = pendingTail_;
+    if (pendingTail_) {
+        pendingTail_->next_ = awaiter;
+    } else {
+        pendingHead_ = awaiter;
+    }
+    pendingTail_ = awaiter;
+    pendingCount_++;
+}
+
+void AsyncCom_Protocol::transmit(RequestAwaiter* awaiter) {
+    awaiter->sent_ = true;
+    awaiter->deadline_ = tick_->getTickCount() + awaiter->timeoutMs_;
+    awaiter->seq_ = getTxSequence();
+    sendData(awaiter->targetId_, my_id_, awaiter->cmd_, awaiter->payload_, awaiter->length_);
+    if (awaiter->retriesLeft_ == 0) awaiter->payload_ = nullptr;
+    inFlight_++;
+}
+
+void AsyncCom_Protocol::sendDeferred() {
+    for (RequestAwaiter* awaiter = pendingHead_; awaiter; awaiter = awaiter->next_) {
+        if (maxInFlight_ != 0 && inFlight_ >= maxInFlight_) return;
+        if (!awaiter->sleep_ && !awaiter->sent_) transmit(awaiter);
+    }
+}
+
+void AsyncCom_Protocol::unlink(RequestAwaiter* awaiter) {
+    if (awaiter->prev_) {
+        awaiter->prev_->next_ = awaiter->next_;
+    } else {
+        pendingHead_ = awaiter->next_;
+    }
+    if (awaiter->next_) {
+        awaiter->next_->prev_ = awaiter->prev_;
+    } else {
+        pendingTail_ = awaiter->prev_;
+    }
+    awaiter->prev_ = nullptr;
+    awaiter->next_ = nullptr;
+    pendingCount_--;
+}
+
+// 응답 매칭 : 먼저 등록된 요청부터 (송신자 ID, CMD | CMD_ACK_BIT, 지정한 경우 페이로드 앞부분) 비교
+void AsyncCom_Protocol::handleResponse(uint16_t senderId, uint16_t cmd, uint8_t* payload, size_t length) {
+    for (RequestAwaiter* awaiter = pendingHead_; awaiter; awaiter = awaiter->next_) {
+        if (awaiter->sleep_ || !awaiter->sent_ || (awaiter->cmd_ | CMD_ACK_BIT) != cmd) continue;
+        if (awaiter->targetId_ != 0xFFFF && awaiter->targetId_ != senderId) continue;
+        if (awaiter->matchLength_ > 0 &&
+            (length < awaiter->matchLength_ || memcmp(payload, awaiter->match_, awaiter->matchLength_) != 0)) continue;
+
+        unlink(awaiter);
+
+        RequestResult& result = awaiter->result_;
+        result.ok = true;
+        result.senderId = senderId;
+        result.cmd = cmd;
+        result.length = length < RequestResult::MAX_PAYLOAD ? length : RequestResult::MAX_PAYLOAD;
+        if (result.length > 0) {
+            memcpy(result.payload, payload, result.length);
+        }
+
+        // 기다리던 요청을 먼저 보내고 재개 : 재개한 대화의 다음 요청은 대기 순서의 뒤로 감
+        inFlight_--;
+        sendDeferred();
+
+        // 재개 후 프레임이 해제될 수 있으므로 awaiter 는 더 이상 사용하지 않음
+        awaiter->handle_.resume();
+        return;
+    }
+
+    // 대기 중인 요청이 없는 응답
+    Com_Protocol::handleResponse(senderId, cmd, payload, length);
+}
+
+void AsyncCom_Protocol::poll() {
+    if (!pendingHead_) return;
+
+    uint32_t now = tick_->getTickCount();
+
+    // 만료된 요청을 먼저 분리한 뒤 재개 (재개 중 새 요청이 등록되어도 안전)
+    RequestAwaiter* expiredHead = nullptr;
+    RequestAwaiter* expiredTail = nullptr;
+    RequestAwaiter* awaiter = pendingHead_;
+    while (awaiter) {
+        RequestAwaiter* next = awaiter->next_;
+        if (!awaiter->sleep_ && !awaiter->sent_) {
+            awaiter = next;     // 전송 전 : 타임아웃 시작 안 함
+            continue;
+        }
+        if (static_cast<int32_t>(now - awaiter->deadline_) >= 0 && awaiter->retriesLeft_ > 0) {
+            // 재전송 : 같은 시퀀스 번호이므로 노드는 중복으로 인식하고 저장한 응답을 다시 보냄
+            awaiter->retriesLeft_--;
+            awaiter->result_.retransmits++;
+            awaiter->deadline_ = now + awaiter->timeoutMs_;
+            sendFrame(awaiter->targetId_, my_id_, awaiter->cmd_, awaiter->seq_, awaiter->payload_, awaiter->length_);
+        } else if (static_cast<int32_t>(now - awaiter->deadline_) >= 0) {
+            unlink(awaiter);
+            if (awaiter->sent_) inFlight_--;
+            if (expiredTail) {
+                expiredTail->next_ = awaiter;
+            } else {
+                expiredHead = awaiter;
+            }
+            expiredTail = awaiter;
+        }
+        awaiter = next;
+    }
+    if (expiredHead) sendDeferred();
+
+    while (expiredHead) {
+        RequestAwaiter* expired = expiredHead;
+        expiredHead = expired->next_;
+        expired->next_ = nullptr;
+        expired->result_.ok = false;
+        // 1:1 요청의 응답 타임아웃은 링크 에러로 집계 (링크 속도 자동 복귀 판단)
+        if (!expired->sleep_ && expired->targetId_ != 0xFFFF) reportLinkError();
+        expired->handle_.resume();
+    }
+}
+
+uint32_t AsyncCom_Protocol::timeUntilRequestTimeout() {
+    if (!pendingHead_) return NO_RECEIVE_DEADLINE;
+
+    uint32_t now = tick_->getTickCount();
+    uint32_t nearest = NO_RECEIVE_DEADLINE;
+    for (RequestAwaiter* awaiter = pendingHead_; awaiter; awaiter = awaiter->next_) {
+        if (!awaiter->sleep_ && !awaiter->sent_) continue;
+        int32_t remaining = static_cast<int32_t>(awaiter->deadline_ - now);
+        if (remaining <= 0) return 0;
+        if (static_cast<uint32_t>(remaining) < nearest) nearest = remaining;
+    }
+    return nearest;
+}
+
+#endif
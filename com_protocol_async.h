@@ -0,0 +1,230 @@
+/*
+ * com_protocol_async.h
+ *
+ *  C++20 코루틴 기반 요청/응답 API (호스트 빌드 전용, -std=c++20)
+ *
+ *  Conversation pingTwice(AsyncCom_Protocol& protocol, uint16_t target) {
+ *      RequestResult r = co_await protocol.request(target, CMD_PING, ping, 4);
+ *      if (!r.ok) co_return;                       // 타임아웃
+ *      r = co_await protocol.request(target, CMD_STATUS_SYNC, nullptr, 0);
+ *  }
+ *
+ *  while (running) {
+ *      protocol.processReceivedData();   // 응답 수신 시 대기 중인 코루틴 재개
+ *      protocol.poll();                  // 타임아웃된 요청 재개
+ *  }
+ *
+ *  - 대화마다 스레드를 만들지 않음 : 모두 processReceivedData()/poll() 을 호출한 스레드에서 재개
+ *  - 코루틴 프레임은 고정 블록 풀(ConversationFramePool)에서 할당 (힙 사용 없음, 인스턴스 간 공유라 할당/해제는 잠금)
+ *  - 응답 매칭 : (송신자 ID, 요청 CMD | CMD_ACK_BIT), 브로드캐스트 요청은 첫 응답과 매칭
+ *    matchLength > 0 이면 응답 페이로드가 요청 페이로드의 앞 matchLength 바이트로 시작해야 매칭
+ *    (같은 노드에 같은 CMD 로 여러 대화를 동시에 진행할 때, 예 : 파일 세션 [Stage | FLAG, SessionId])
+ *  - retries > 0 : 타임아웃마다 같은 시퀀스 번호로 재전송 (노드의 응답 캐시가 핸들러 재실행 없이 응답)
+ *  - co_await protocol.sleep(ms) : 요청 없이 poll() 에서 재개 (흐름 제어 대기 등)
+ *  - setMaxInFlight(1) : 반이중 버스에서 여러 대화를 동시에 진행할 때 응답(또는 최종 타임아웃) 전에는 다음 요청을
+ *    보내지 않음. 기다리는 요청은 등록 순서대로 보내고, 응답을 받은 대화의 다음 요청은 뒤로 가므로 대화마다 번갈아 전송
+ */
+
+#ifndef COM_PROTOCOL_CLASS_COM_PROTOCOL_ASYNC_H_
+#define COM_PROTOCOL_CLASS_COM_PROTOCOL_ASYNC_H_
+
+#if defined(__cpp_impl_coroutine) && !defined(USE_HAL_DRIVER)
+#include "com_protocol_class.h"
+#include <coroutine>
+#include <cstddef>
+#include <exception>
+#include <mutex>
+
+// 고정 크기 블록 풀 : 할당/해제마다 잠금 (PortRuntime 에서는 여러 워커의 대화가 같은 풀을 쓰고,
+// 한 대화도 포트 작업마다 다른 워커에서 재개되어 할당한 스레드와 해제하는 스레드가 다를 수 있음)
+template <size_t BLOCK_SIZE, size_t BLOCK_COUNT>
+class FixedBlockPool {
+public:
+    FixedBlockPool() : freeList_(nullptr), inUse_(0), peakInUse_(0), failures_(0) {
+        for (size_t i = 0; i < BLOCK_COUNT; i++) {
+            Block* block = reinterpret_cast<Block*>(storage_ + i * BLOCK_SIZE);
+            block->next = freeList_;
+            freeList_ = block;
+        }
+    }
+
+    // 블록보다 크거나 풀이 소진되면 nullptr
+    void* allocate(size_t size) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (size > BLOCK_SIZE || !freeList_) {
+            failures_++;
+            return nullptr;
+        }
+        Block* block = freeList_;
+        freeList_ = block->next;
+        if (++inUse_ > peakInUse_) peakInUse_ = inUse_;
+        return block;
+    }
+
+    void deallocate(void* p) {
+        if (!p) return;
+        std::lock_guard<std::mutex> lock(mutex_);
+        Block* block = static_cast<Block*>(p);
+        block->next = freeList_;
+        freeList_ = block;
+        inUse_--;
+    }
+
+    size_t inUse() const { std::lock_guard<std::mutex> lock(mutex_); return inUse_; }
+    size_t peakInUse() const { std::lock_guard<std::mutex> lock(mutex_); return peakInUse_; }
+    size_t failures() const { std::lock_guard<std::mutex> lock(mutex_); return failures_; }
+
+    static const size_t blockSize = BLOCK_SIZE;
+    static const size_t blockCount = BLOCK_COUNT;
+
+private:
+    struct Block { Block* next; };
+    static_assert(BLOCK_SIZE >= sizeof(Block) && BLOCK_SIZE % alignof(std::max_align_t) == 0,
+                  "block size must hold a pointer and keep max alignment");
+
+    alignas(std::max_align_t) unsigned char storage_[BLOCK_SIZE * BLOCK_COUNT];
+    mutable std::mutex mutex_;
+    Block* freeList_;
+    size_t inUse_;
+    size_t peakInUse_;
+    size_t failures_;
+};
+
+// 동시 대화 512개, 프레임 최대 1.5KB (파일 업로드 : 요청 버퍼 + 응답 결과 2개 분)
+typedef FixedBlockPool<1536, 512> ConversationFramePool;
+ConversationFramePool& conversationFramePool();
+
+// 요청 결과 (응답 페이로드는 복사되어 전달됨)
+struct RequestResult {
+    static const size_t MAX_PAYLOAD = 248;   // 수신 버퍼(256) - 헤더(8)
+
+    bool ok;                // false : 타임아웃
+    uint8_t retransmits;    // 같은 시퀀스 번호로 재전송한 횟수
+    uint16_t senderId;
+    uint16_t cmd;
+    size_t length;          // 페이로드 길이 (프레임 CRC 제외)
+    uint8_t payload[MAX_PAYLOAD];
+};
+
+// 시작 즉시 실행되고 끝나면 스스로 해제되는 대화 코루틴
+class Conversation {
+public:
+    struct promise_type {
+        Conversation get_return_object() { return Conversation(true); }
+        // 프레임 풀 소진 시 코루틴을 시작하지 않음
+        static Conversation get_return_object_on_allocation_failure() { return Conversation(false); }
+
+        std::suspend_never initial_suspend() noexcept { return {}; }
+        std::suspend_never final_suspend() noexcept { return {}; }
+        void return_void() {}
+        void unhandled_exception() { std::terminate(); }
+
+        static void* operator new(size_t size) noexcept { return conversationFramePool().allocate(size); }
+        static void operator delete(void* p) noexcept { conversationFramePool().deallocate(p); }
+    };
+
+    bool started() const { return started_; }
+
+private:
+    explicit Conversation(bool started) : started_(started) {}
+    bool started_;
+};
+
+class AsyncCom_Protocol : public Com_Protocol {
+public:
+    static const uint32_t DEFAULT_REQUEST_TIMEOUT_MS = 500;
+    static const uint8_t MAX_MATCH_LENGTH = 2;
+
+    class RequestAwaiter {
+    public:
+        bool await_ready() const noexcept { return false; }
+        void await_suspend(std::coroutine_handle<> handle);
+        RequestResult await_resume() const noexcept { return result_; }
+
+    private:
+        friend class AsyncCom_Protocol;
+
+        RequestAwaiter(AsyncCom_Protocol* protocol, uint16_t targetId, uint16_t cmd,
+                       const uint8_t* payload, size_t length, uint32_t timeoutMs, uint8_t retries,
+                       bool sleep = false, uint8_t matchLength = 0);
+        RequestAwaiter(const RequestAwaiter&) = delete;
+        RequestAwaiter& operator=(const RequestAwaiter&) = delete;
+
+        AsyncCom_Protocol* protocol_;
+        uint16_t targetId_;
+        uint16_t cmd_;
+        const uint8_t* payload_;    // await_suspend 에서 전송할 때까지만 유효하면 됨 (재전송 시 응답까지)
+        size_t length_;
+        uint32_t timeoutMs_;
+        uint16_t seq_;              // 요청에 사용한 시퀀스 번호
+        bool sleep_;                // sleep() : 전송하지 않고 응답과도 매칭하지 않음
+        bool sent_;                 // false : setMaxInFlight 한도로 전송 대기 중 (타임아웃도 전송 후 시작)
+        uint8_t retriesLeft_;
+        uint8_t matchLength_;
+        uint8_t match_[MAX_MATCH_LENGTH];   // 응답이 이 바이트로 시작해야 함 (요청 페이로드 앞부분 복사)
+        uint32_t deadline_;
+        std::coroutine_handle<> handle_;
+        RequestAwaiter* prev_;      // 대기 목록 (프레임 내부에 위치하므로 별도 할당 없음)
+        RequestAwaiter* next_;
+        RequestResult result_;
+    };
+
+    AsyncCom_Protocol(ISerialInterface* serial, ITick* tick, uint16_t my_id);
+    virtual ~AsyncCom_Protocol();
+
+    // co_await 시 요청을 전송하고 응답 또는 타임아웃까지 대기
+    // retries > 0 이면 타임아웃마다 같은 시퀀스 번호로 재전송하므로 payload 는 응답까지 유효해야 함
+    // (co_await 중인 호출자의 지역 버퍼면 충분)
+    RequestAwaiter request(uint16_t targetId, uint16_t cmd, const uint8_t* payload, size_t length,
+                           uint32_t timeoutMs = DEFAULT_REQUEST_TIMEOUT_MS, uint8_t retries = 0,
+                           uint8_t matchLength = 0) {
+        return RequestAwaiter(this, targetId, cmd, payload, length, timeoutMs, retries, false, matchLength);
+    }
+
+    // co_await 시 ms 동안 대기 (결과 ok 는 항상 false)
+    RequestAwaiter sleep(uint32_t ms) {
+        return RequestAwaiter(this, my_id_, 0, nullptr, 0, ms, 0, true);
+    }
+
+    // 타임아웃된 요청을 재개 : processReceivedData() 와 같은 루프에서 호출
+    void poll();
+
+    // 동시에 응답을 기다리는 요청 수 제한 (0 : 제한 없음, 기본)
+    void setMaxInFlight(size_t requests) { maxInFlight_ = requests; }
+    size_t inFlightCount() const { return inFlight_; }
+
+    size_t pendingCount() const { return pendingCount_; }
+    // 가장 가까운 요청 타임아웃까지 남은 ms (대기 중인 요청이 없으면 NO_RECEIVE_DEADLINE)
+    uint32_t timeUntilRequestTimeout();
+
+    using Com_Protocol::CMD_PING;
+    using Com_Protocol::CMD_FILE_RECEIVE;
+    using Com_Protocol::CMD_CONFIG;
+    using Com_Protocol::CMD_ID_SCAN;
+    using Com_Protocol::CMD_STATS;
+    using Com_Protocol::CMD_GROUP;
+    using Com_Protocol::CMD_STATUS_SYNC;
+    using Com_Protocol::CMD_SYNC;
+    using Com_Protocol::CMD_MAIN_POWER_CONTROL;
+    using Com_Protocol::CMD_PLAY_CONTROL;
+    using Com_Protocol::CMD_MOTION_STREAM;
+    using Com_Protocol::CMD_JOG_MOVE_CW_CCW;
+
+protected:
+    virtual void handleResponse(uint16_t senderId, uint16_t cmd, uint8_t* payload, size_t length) override;
+
+private:
+    RequestAwaiter* pendingHead_;
+    RequestAwaiter* pendingTail_;
+    size_t pendingCount_;
+    size_t maxInFlight_;
+    size_t inFlight_;
+
+    void enqueue(RequestAwaiter* awaiter);
+    void unlink(RequestAwaiter* awaiter);
+    void transmit(RequestAwaiter* awaiter);
+    void sendDeferred();    // 한도 안에서 전송 대기 중인 요청을 등록 순서대로 전송
+};
+
+#endif
+#endif /* COM_PROTOCOL_CLASS_COM_PROTOCOL_ASYNC_H_ */
@@ -0,0 +1,189 @@
+/*
+ * com_protocol_config.cpp
+ *
+ *  CMD_CONFIG 설정 저장소 호스트 사본 (호스트 빌드 전용)
+ */
+#include "com_protocol_config.h"
+
+#if defined(__cpp_impl_coroutine) && !defined(USE_HAL_DRIVER)
+#include "protocol_messages.h"
+
+namespace {
+
+bool parseConfigAck(const RequestResult& response, ConfigOp expected, ConfigAckMessage& ack) {
+    if (!response.ok) return false;
+    if (!ConfigAckSchema::deserialize(response.payload, response.length, ack)) return false;
+    return ack.op == expected;
+}
+
+// 응답 항목을 사본에 반영 : 형식 오류면 false (반영한 항목은 그대로 둠, 다음 동기화에서 다시 받음)
+bool applyConfigEntries(const RequestResult& response, uint8_t count, ConfigMirror& mirror) {
+    size_t end = response.length;
+    size_t offset = ConfigAckSchema::SIZE;
+    for (uint8_t i = 0; i < count; i++) {
+        if (offset + CONFIG_ENTRY_HEADER > end) return false;
+        uint16_t key = loadBigEndian<uint16_t>(response.payload + offset);
+        ConfigType type = static_cast<ConfigType>(response.payload[offset + 2]);
+        size_t size = configValueSize(type);
+        if (size == 0 || offset + CONFIG_ENTRY_HEADER + size > end) return false;
+        mirror.update(key, type, configDecodeValue(type, response.payload + offset + CONFIG_ENTRY_HEADER));
+        offset += CONFIG_ENTRY_HEADER + size;
+    }
+    return true;
+}
+
+// writes[first] 부터 한 프레임에 들어가는 만큼 SET 요청 작성, 담은 항목 수 반환
+size_t buildConfigSet(const ConfigWrite* writes, size_t count, size_t first, uint8_t* frame, size_t& length) {
+    length = ConfigRequestSchema::SIZE;
+    size_t packed = 0;
+    while (first + packed < count && packed < UINT8_MAX) {
+        const ConfigWrite& write = writes[first + packed];
+        size_t size = CONFIG_ENTRY_HEADER + configValueSize(write.type);
+        if (length + size > CONFIG_MAX_PAYLOAD) break;
+        storeBigEndian<uint16_t>(frame + length, write.key);
+        frame[length + 2] = static_cast<uint8_t>(write.type);
+        configEncodeValue(write.type, write.raw, frame + length + CONFIG_ENTRY_HEADER);
+        length += size;
+        packed++;
+    }
+
+    ConfigRequestMessage request;
+    request.op = ConfigOp::SET;
+    request.count = static_cast<uint8_t>(packed);
+    ConfigRequestSchema::serialize(request, frame, ConfigRequestSchema::SIZE);
+    return packed;
+}
+
+}  // namespace
+
+bool ConfigMirror::get(uint16_t key, uint32_t& raw) const {
+    auto it = values_.find(key);
+    if (it == values_.end()) return false;
+    raw = it->second.raw;
+    return true;
+}
+
+bool ConfigMirror::getType(uint16_t key, ConfigType& type) const {
+    auto it = values_.find(key);
+    if (it == values_.end()) return false;
+    type = it->second.type;
+    return true;
+}
+
+void ConfigMirror::clear() {
+    values_.clear();
+    synced_ = false;
+    generation_ = 0;
+    version_ = 0;
+}
+
+void ConfigMirror::markSynced(uint32_t generation, uint32_t version) {
+    synced_ = true;
+    generation_ = generation;
+    version_ = version;
+}
+
+// 첫 쪽 응답의 버전까지 반영된 것으로 기록 : 동기화 도중 바뀐 키는 그 버전보다 커서 다음 동기화에 다시 포함됨
+Conversation syncConfig(AsyncCom_Protocol& protocol, uint16_t targetId, ConfigMirror& mirror,
+                        ConfigSyncResult& result, uint32_t timeoutMs, uint8_t retries) {
+    result = ConfigSyncResult();
+
+    ConfigDiffMessage diff;
+    diff.op = ConfigOp::DIFF;
+    diff.sinceVersion = mirror.synced() ? mirror.version() : 0;
+    diff.startKey = 0;
+    bool firstPage = true;
+    uint32_t generation = 0;
+    uint32_t version = 0;
+    uint8_t frame[ConfigDiffSchema::SIZE];
+
+    while (true) {
+        ConfigDiffSchema::serialize(diff, frame);
+        const RequestResult& response = co_await protocol.request(targetId, AsyncCom_Protocol::CMD_CONFIG,
+                                                                  frame, sizeof(frame), timeoutMs, retries);
+        result.retransmits += response.retransmits;
+        ConfigAckMessage ack;
+        if (!parseConfigAck(response, ConfigOp::DIFF, ack)) break;
+        result.frames++;
+        if (ack.status != CONFIG_OK) {
+            result.status = ack.status;
+            break;
+        }
+
+        // 노드 재부팅 : 이전 사본의 버전은 의미가 없음
+        bool rebooted = firstPage ? (mirror.synced() && ack.generation != mirror.generation())
+                                  : ack.generation != generation;
+        if (rebooted) {
+            if (result.reloaded) break;     // 동기화 중 또 재부팅
+            mirror.clear();
+            result.reloaded = true;
+            diff.sinceVersion = 0;
+            diff.startKey = 0;
+            firstPage = true;
+            continue;
+        }
+        if (firstPage) {
+            generation = ack.generation;
+            version = ack.version;
+            firstPage = false;
+        }
+
+        if (!applyConfigEntries(response, ack.count, mirror)) break;
+        result.entries += ack.count;
+
+        if (ack.key == CONFIG_NO_KEY) {
+            mirror.markSynced(generation, version);
+            result.ok = true;
+            break;
+        }
+        diff.startKey = ack.key;
+    }
+    result.done = true;
+}
+
+// 사본이 노드와 같은 버전이었고 이 SET 만 적용되었으면 (버전 +1 이하) 사본 버전도 함께 올림
+Conversation writeConfig(AsyncCom_Protocol& protocol, uint16_t targetId, const ConfigWrite* writes, size_t count,
+                         ConfigMirror& mirror, ConfigSyncResult& result, uint32_t timeoutMs, uint8_t retries) {
+    result = ConfigSyncResult();
+
+    size_t next = 0;
+    uint8_t frame[CONFIG_MAX_PAYLOAD];
+
+    while (next < count) {
+        size_t length = 0;
+        size_t packed = buildConfigSet(writes, count, next, frame, length);
+        if (packed == 0) {
+            result.status = CONFIG_MALFORMED;   // 알 수 없는 타입
+            result.failedKey = writes[next].key;
+            break;
+        }
+
+        const RequestResult& response = co_await protocol.request(targetId, AsyncCom_Protocol::CMD_CONFIG,
+                                                                  frame, length, timeoutMs, retries);
+        result.retransmits += response.retransmits;
+        ConfigAckMessage ack;
+        if (!parseConfigAck(response, ConfigOp::SET, ack)) break;
+        result.frames++;
+        if (ack.status != CONFIG_OK) {
+            result.status = ack.status;
+            result.failedKey = ack.key;
+            break;
+        }
+
+        uint32_t before = mirror.version();
+        for (size_t i = next; i < next + packed; i++) {
+            mirror.update(writes[i].key, writes[i].type, writes[i].raw);
+        }
+        if (mirror.synced() && ack.generation == mirror.generation() &&
+            ack.version >= before && ack.version - before <= 1) {
+            mirror.markSynced(ack.generation, ack.version);
+        }
+        result.entries += static_cast<uint32_t>(packed);
+        next += packed;
+    }
+
+    result.ok = next == count;
+    result.done = true;
+}
+
+#endif
@@ -0,0 +1,85 @@
+/*
+ * com_protocol_config.h
+ *
+ *  CMD_CONFIG 설정 저장소 호스트 사본 (호스트 빌드 전용, -std=c++20)
+ *
+ *  ConfigMirror mirror;
+ *  ConfigSyncResult result;
+ *  syncConfig(protocol, target, mirror, result);           // 처음 : 전체, 이후 : 바뀐 키만
+ *  ...
+ *  ConfigWrite writes[] = { { 0x0001, ConfigType::U16, 1200 }, ... };
+ *  writeConfig(protocol, target, writes, count, mirror, result);
+ *  while (!result.done) {
+ *      protocol.processReceivedData();
+ *      protocol.poll();
+ *  }
+ *
+ *  - syncConfig : DIFF 로 mirror.version() 이후 바뀐 키를 여러 프레임에 나눠 받음
+ *    (노드 generation 이 바뀌었으면 사본을 비우고 처음부터 다시 받음)
+ *  - writeConfig : 쓰기 목록을 프레임(최대 CONFIG_MAX_PAYLOAD)마다 최대한 묶어 SET,
+ *    프레임 단위로 전부 적용 또는 전부 거부. 거부되면 그 프레임에서 멈추고 result.failedKey 에 키 기록
+ *  - 요청은 retries 만큼 같은 시퀀스 번호로 재전송 (SET 은 같은 값을 다시 써도 버전이 바뀌지 않음)
+ *  - writes 는 쓰기가 끝날 때까지 유효해야 함
+ */
+
+#ifndef COM_PROTOCOL_CLASS_COM_PROTOCOL_CONFIG_H_
+#define COM_PROTOCOL_CLASS_COM_PROTOCOL_CONFIG_H_
+
+#include "com_protocol_async.h"
+
+#if defined(__cpp_impl_coroutine) && !defined(USE_HAL_DRIVER)
+#include "protocol_messages.h"
+#include <unordered_map>
+
+struct ConfigWrite {
+    uint16_t key;
+    ConfigType type;            // 노드의 키 타입과 같아야 함 (다르면 CONFIG_TYPE_MISMATCH)
+    uint32_t raw;               // 원시 값 (부호 있는 타입은 부호 확장, F32 는 IEEE-754 비트)
+};
+
+// 노드 설정 저장소 사본 : 키 -> (타입, 값)
+class ConfigMirror {
+public:
+    bool get(uint16_t key, uint32_t& raw) const;
+    bool getType(uint16_t key, ConfigType& type) const;
+    void update(uint16_t key, ConfigType type, uint32_t raw) { values_[key] = Value{ type, raw }; }
+    void clear();
+    // 노드 저장소의 (generation, version) 까지 반영됨을 기록 (syncConfig, writeConfig 가 호출)
+    void markSynced(uint32_t generation, uint32_t version);
+
+    bool synced() const { return synced_; }         // 한 번 이상 전체를 받음
+    uint32_t generation() const { return generation_; }
+    uint32_t version() const { return version_; }    // 이 버전까지 반영됨
+    size_t size() const { return values_.size(); }
+
+private:
+    struct Value {
+        ConfigType type;
+        uint32_t raw;
+    };
+    std::unordered_map<uint16_t, Value> values_;
+    bool synced_ = false;
+    uint32_t generation_ = 0;
+    uint32_t version_ = 0;
+};
+
+struct ConfigSyncResult {
+    bool done = false;
+    bool ok = false;
+    uint8_t status = CONFIG_OK;         // 노드가 거부한 경우의 CONFIG_*
+    uint16_t failedKey = CONFIG_NO_KEY;
+    bool reloaded = false;              // generation 이 바뀌어 전체를 다시 받음
+    uint32_t frames = 0;                // 응답을 받은 요청 수
+    uint32_t entries = 0;               // 받은(sync) 또는 적용된(write) 키 수
+    uint32_t retransmits = 0;
+};
+
+Conversation syncConfig(AsyncCom_Protocol& protocol, uint16_t targetId, ConfigMirror& mirror,
+                        ConfigSyncResult& result, uint32_t timeoutMs = 500, uint8_t retries = 2);
+
+Conversation writeConfig(AsyncCom_Protocol& protocol, uint16_t targetId, const ConfigWrite* writes, size_t count,
+                         ConfigMirror& mirror, ConfigSyncResult& result,
+                         uint32_t timeoutMs = 500, uint8_t retries = 2);
+
+#endif
+#endif /* COM_PROTOCOL_CLASS_COM_PROTOCOL_CONFIG_H_ */
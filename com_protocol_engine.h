@@ -0,0 +1,2687 @@
+/*
+ * com_protocol_engine.h
+ *
+ *  정적 다형성(CRTP/정책) 기반 프로토콜 엔진
+ *
+ *  Derived : 핸들러 집합 (handlePing 등을 재정의하는 클래스, CRTP)
+ *  Serial  : 전송 정책 (write/read/isOpen 을 제공하는 타입, setBaudRate/getBaudRate 는 선택)
+ *  Tick    : 시간 정책 (getTickCount 를 제공하는 타입)
+ *
+ *  Serial/Tick 에 final 구현 클래스를 넘기면 수신 -> 분기 -> 응답 경로 전체가
+ *  가상 호출 없이 인라인됩니다. 기존 가상 인터페이스 방식은 Com_Protocol
+ *  (com_protocol_class.h) 이 이 엔진 위의 어댑터로 제공합니다.
+ */
+
+#ifndef COM_PROTOCOL_CLASS_COM_PROTOCOL_ENGINE_H_
+#define COM_PROTOCOL_CLASS_COM_PROTOCOL_ENGINE_H_
+
+#include "crc16.h"
+#include "IFileStore.h"
+#include "lzss.h"
+#include "rolling_checksum.h"
+#include "sha256.h"
+#include "protocol_messages.h"
+#include "reed_solomon.h"
+#include "reply_cache.h"
+#include "config_store.h"
+#include "motion_buffer.h"
+#include "group_membership.h"
+#include "packet_queue.h"
+#include "protocol_clock.h"
+#include "protocol_metrics.h"
+#include "link_quality.h"
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+
+// 트레이스 지점 : COM_PROTOCOL_TRACE 없이 빌드하면 코드가 생성되지 않음 (protocol_trace.h)
+// 분기/송신 지점은 처리 단계 링에 기록 (큐 모드에서는 파싱과 다른 스레드이므로 링을 나눔)
+#if defined(COM_PROTOCOL_TRACE)
+#include "protocol_trace.h"
+#define COM_PROTOCOL_TRACE_EVENT(...) trace_.record(__VA_ARGS__)
+#define COM_PROTOCOL_HANDLER_TRACE_EVENT(...) handlerTrace().record(__VA_ARGS__)
+#else
+#define COM_PROTOCOL_TRACE_EVENT(...) ((void)0)
+#define COM_PROTOCOL_HANDLER_TRACE_EVENT(...) ((void)0)
+#endif
+
+// Serial 정책의 링크 속도 훅 (선택) : setBaudRate/getBaudRate 가 없는 타입은 미지원으로 처리
+// (속도 0 : 링크 속도 협상 거절, 적응형 타임아웃 대신 고정 타임아웃)
+struct SerialBaudRate {
+    template <typename S>
+    static auto get(S& serial, int) -> decltype(static_cast<uint32_t>(serial.getBaudRate())) { return serial.getBaudRate(); }
+    template <typename S>
+    static uint32_t get(S&, long) { return 0; }
+
+    template <typename S>
+    static auto set(S& serial, uint32_t baudRate, int) -> decltype(static_cast<bool>(serial.setBaudRate(baudRate))) {
+        return serial.setBaudRate(baudRate);
+    }
+    template <typename S>
+    static bool set(S&, uint32_t, long) { return false; }
+
+    // supportsBaudRate 가 없으면 현재 속도를 알려주는 전송이 0 이 아닌 속도를 받는다고 봄
+    template <typename S>
+    static auto supports(S& serial, uint32_t baudRate, int) -> decltype(static_cast<bool>(serial.supportsBaudRate(baudRate))) {
+        return serial.supportsBaudRate(baudRate);
+    }
+    template <typename S>
+    static bool supports(S& serial, uint32_t baudRate, long) { return baudRate != 0 && get(serial, 0) != 0; }
+};
+
+template <typename Derived, typename Serial, typename Tick>
+class Com_ProtocolEngine {
+public:
+    Com_ProtocolEngine(Serial* serial, Tick* tick, uint16_t my_id);
+
+    void sendData(uint16_t receiverId, uint16_t senderId, uint16_t cmd,
+                 const uint8_t* data, size_t length);
+    void receiveData(uint8_t* buffer, size_t length);
+    bool isDataAvailable() const;
+    void processReceivedData();
+
+    // 이벤트 구동 수신 : 바이트 도착 또는 프레임 타임아웃 시점에만 processReceivedData() 호출
+    static const uint32_t NO_RECEIVE_DEADLINE = 0xFFFFFFFF;
+    void notifyRxFromISR();                 // 수신 인터럽트(또는 I/O 이벤트)에서 호출
+    static void notifyRxCallback(void* context) { static_cast<Com_ProtocolEngine*>(context)->notifyRxFromISR(); }
+    bool isRxPending() const { return rxPending_; }
+    uint32_t timeUntilReceiveTimeout();     // 프레임/링크 속도 협상 타임아웃까지 남은 ms, 없으면 NO_RECEIVE_DEADLINE
+    bool needsProcessing();                 // 수신 대기 데이터가 있거나 타임아웃이 만료된 경우 true
+
+    // 프레임 타임아웃 : 마지막 바이트 이후 (남은 바이트의 전송 시간 + 바이트 간격 여유) 동안 조용하면 프레임 후보 폐기
+    // (호출 시 읽을 바이트가 없을 때만 : 호출이 늦어 이미 도착해 있는 바이트는 프레임의 나머지로 처리)
+    // 전송 시간은 Serial::getBaudRate() 기준, 여유는 관측한 간격의 평균 + 4 x 편차 (처음과 속도를 모를 때 100ms)
+    // false : 항상 고정 100ms
+    void setAdaptiveTimeout(bool enable) { adaptiveTimeout_ = enable; }
+    bool isAdaptiveTimeoutEnabled() const { return adaptiveTimeout_; }
+    uint32_t getFrameTimeout() const;       // 수신 중인 프레임 후보에 지금 적용되는 타임아웃 ms (대기 중이면 최대 길이 기준)
+
+    // 링크 품질 추정 (파싱 단계가 갱신) : 바이트 간격, 검증 실패 비율, 시퀀스 누락 비율의 지수 가중 평균
+    const LinkQualityEstimator& getLinkQuality() const { return quality_; }
+    void resetLinkQuality() { quality_.reset(); }
+
+    // 파싱/처리 단계 분리 : processReceivedData() 는 검증한 프레임을 패킷 버퍼에 복사해 큐에 넣기만 하고,
+    // 핸들러, 링크 속도/모션 타이머, 모든 송신(응용의 sendData 포함)은 processQueuedPackets() 를 부르는 쪽에서 실행
+    // (Linux : 다른 스레드, RTOS : 낮은 우선순위 태스크). 큐가 가득 차면 프레임을 버리고 queueDrops 로 집계
+    // packets 0 : 사용 안 함 (기본, 수신 루프에서 바로 핸들러 실행). 두 단계를 시작하기 전에 설정
+    bool setPacketQueue(size_t packets) { return packetQueue_.resize(packets, bufferLength_ - 8); }
+    bool isPacketQueueEnabled() const { return packetQueue_.enabled(); }
+    void setPacketNotify(void (*notify)(void* context), void* context);    // 큐에 넣을 때마다 파싱 단계에서 호출
+    size_t processQueuedPackets(size_t maxPackets = 0);     // 처리한 패킷 수 (maxPackets 0 : 큐가 빌 때까지)
+    uint32_t timeUntilQueuedWork();         // 대기 패킷이 있거나 타이머가 만료되면 0, 할 일이 없으면 NO_RECEIVE_DEADLINE
+    size_t getQueueDepth() const { return packetQueue_.depth(); }
+
+    // 재동기화 재스캔 : 프레임 후보가 거부(길이/수신자/CRC/타임아웃)되면
+    // 시작 시퀀스 이후에 받은 바이트를 버리지 않고 다시 스캔 (수신 버퍼 2개 추가 할당)
+    void setResyncRescan(bool enable);
+    bool isResyncRescanEnabled() const { return resyncRescan_; }
+
+    // 순방향 오류 정정 (송신 측 설정) : 프레임마다 리드-솔로몬 parity 를 붙여 parity/2 바이트 오류까지 정정
+    // 0 : 사용 안 함, 짝수 2~64. 수신은 길이 필드의 FEC 플래그로 판단하므로 별도 설정 불필요
+    bool setFecParity(uint8_t paritySize) { return fec_.setParitySize(paritySize); }
+    uint8_t getFecParity() const { return fec_.paritySize(); }
+    uint32_t getFecCorrectedBytes() const { return fecCorrectedBytes_; }
+
+    // 파일 수신 저장소 : 설정하면 수신 데이터 기록과 재개용 체크포인트 저장에 사용 (nullptr : 기록 안 함)
+    void setFileStore(IFileStore* store) { fileStore_ = store; }
+    // 세션별 저장소 (예 : 1 모션 파일, 2 설정 파일), 지정하지 않은 세션은 기본 저장소 사용
+    // 한 저장소는 한 번에 한 세션만 사용하며 다른 세션의 요청에는 FILE_ACK_BUSY 로 응답
+    bool setFileStore(uint8_t sessionId, IFileStore* store);
+    // 마지막 프레임 이후 ms 동안 조용한 수신 세션은 표에서 해제 (체크포인트는 남아 RESUME_QUERY 로 재개, 0 : 해제 안 함)
+    void setFileSessionTimeout(uint32_t ms) { fileSessionTimeoutMs_ = ms; }
+    size_t getActiveFileSessions() const;
+
+    // 중복 요청 억제 : 같은 (송신자, 시퀀스, CMD, 요청 CRC) 요청은 핸들러를 다시 실행하지 않고 저장한 응답을 재전송
+    // entries 0 : 사용 안 함 (기본), 최대 ReplyCache::MAX_ENTRIES. 항목당 응답 ReplyCache::MAX_REPLY 바이트까지 저장
+    bool setReplyCache(size_t entries) { return replyCache_.resize(entries); }
+    uint32_t getReplyCacheHits() const { return replyCache_.hits(); }
+
+    // 설정 저장소 : 설정하면 기본 handleConfig 가 CMD_CONFIG 요청(GET/SET/DIFF)에 CMD_CONFIG_ACK 로 응답
+    // (nullptr : 응답 안 함, Derived 에서 handleConfig 를 재정의해도 저장소는 쓰이지 않음)
+    void setConfigStore(ConfigStore* store) { configStore_ = store; }
+
+    // 모션 스트리밍 (CMD_MOTION_STREAM) : slots 프레임 x frameBytes 바이트 지터 버퍼 (slots 0 : 사용 안 함)
+    // 재생 시각이 된 프레임은 processReceivedData() 안에서 handleMotionFrame() 으로 전달
+    bool setMotionBuffer(size_t slots, size_t frameBytes);
+    MotionStreamState getMotionState() const { return motion_.state; }
+    uint32_t getMotionPlayhead();           // 재생 시각 (프레임 타임스탬프 기준 ms)
+    uint16_t getMotionUnderruns() const { return motion_.underruns; }
+    uint16_t getMotionLateFrames() const { return motion_.lateFrames; }
+    uint16_t getMotionMissedFrames() const { return motion_.missedFrames; }
+
+    void sendPing(uint16_t targetId);// ping 요청 함수
+    void sendIdScan(uint16_t targetId);// id 스캔 요청 함수
+
+    void sendSync();// 동기화 요청 함수
+    void sendSyncAck(uint16_t targetId, uint32_t timestamp);// 동기화 응답 함수
+
+    // 링크 속도 협상 (CMD_SYNC 이후, 1:1 링크)
+    //  제안(PROPOSE) -> ACK -> 양쪽 전환 -> 핑 버스트 확인 -> CONFIRM -> ACTIVE
+    //  확인 실패, 확인 타임아웃, 전환 후 에러 급증 시 협상 전 기본 속도로 자동 복귀
+    enum class LinkSpeedState : uint8_t {
+        IDLE,               // 협상 없음 (기본 속도)
+        PROPOSED,           // 요청 측 : ACK 대기
+        PROBING,            // 요청 측 : 새 속도에서 핑 버스트 진행
+        CONFIRMING,         // 요청 측 : CONFIRM ACK 대기
+        SWITCH_PENDING,     // 응답 측 : ACK 송신 완료 대기 후 전환
+        AWAIT_CONFIRM,      // 응답 측 : 새 속도에서 CONFIRM 대기
+        ACTIVE              // 새 속도 사용 중 (에러 급증 감시)
+    };
+    bool requestLinkSpeed(uint16_t targetId, uint32_t baudRate);   // 동기화 전이거나 협상 중이면 false
+    LinkSpeedState getLinkSpeedState() const { return link_.state; }
+    uint32_t getFallbackBaudRate() const { return link_.fallbackBaudRate; }  // 복귀할 기본 속도 (IDLE 이면 0)
+    void reportLinkError() { link_.windowErrors++; }  // 응답 타임아웃 등 상위 계층에서 감지한 에러
+
+    // 계측 스냅숏 (ProtocolMetrics 복사), CMD_STATS 요청에도 같은 값으로 응답
+    // 큐 모드에서는 처리 단계(processQueuedPackets 를 부르는 쪽)에서 호출
+    ProtocolMetrics getMetrics();
+    void resetMetrics();
+
+#if defined(COM_PROTOCOL_TRACE)
+    // 트레이스 링 덤프 (ProtocolTraceFormat), 쓴 바이트 수 반환. 엔진을 돌리는 동안 다른 스레드에서 호출 가능
+    // 큐 모드에서는 파싱 단계 덤프 뒤에 처리 단계 덤프를 이어 붙임 (같은 노드 ID)
+    size_t dumpTrace(uint8_t* out, size_t capacity) const {
+        size_t written = trace_.dump(out, capacity, my_id_);
+        if (packetQueue_.enabled() && written > 0) {
+            written += handlerTrace_.dump(out + written, capacity - written, my_id_);
+        }
+        return written;
+    }
+    void clearTrace() {
+        trace_.clear();
+        handlerTrace_.clear();
+    }
+#endif
+
+    // my_id getter 추가
+    uint16_t getMyId() const { return my_id_; }
+    void setMyId(uint16_t id) { my_id_ = id; }
+
+    // 그룹 주소 (0xFF00 ~ 0xFFFE) : 가입한 그룹으로 보낸 프레임은 자신의 ID 로 받은 것처럼 처리하되 응답은 보내지 않음
+    // (여러 노드의 응답이 버스에서 충돌). 호스트는 CMD_GROUP 으로도 바꿀 수 있으며, 큐 모드에서는 처리 단계에서만 호출
+    bool joinGroup(uint16_t groupId) { return groups_.join(groupId); }     // 범위 밖이면 false
+    bool leaveGroup(uint16_t groupId) { return groups_.leave(groupId); }
+    void clearGroups() { groups_.clear(); }
+    bool isGroupMember(uint16_t groupId) const { return groups_.contains(groupId); }
+    size_t getGroupCount() const { return groups_.count(); }
+
+protected:
+    // 엔진은 기반 클래스로만 사용 (Derived 를 통해 소멸)
+    ~Com_ProtocolEngine();
+
+    // 기본 핸들러 : Derived 에서 같은 이름으로 재정의하면 그쪽이 호출됨
+    // (Derived 에서 protected 로 재정의할 경우 엔진을 friend 로 선언)
+    /* 네트워크 0x0000 ~ 0x00FF */
+    void handlePing(uint16_t senderId, uint8_t* payload, size_t length);//CMD_PONG
+    void handleData(uint16_t senderId, uint8_t* payload, size_t length) {}
+    void handleConfig(uint16_t senderId, uint8_t* payload, size_t length);//CMD_CONFIG_ACK
+    void handleIdScan(uint16_t senderId, uint8_t* payload, size_t length);//CMD_ID_SCAN
+
+    // 상태 동기화
+    void handleStatusSync(uint16_t senderId, uint8_t* payload, size_t length);//CMD_STATUS_SYNC
+    // 제어
+    void handleMainPowerControl(uint16_t senderId, uint8_t* payload, size_t length);//CMD_MAIN_POWER_CONTROL
+    void handlePlayControl(uint16_t senderId, uint8_t* payload, size_t length);//CMD_PLAY_CONTROL
+    void handleJogMoveCwCcw(uint16_t senderId, uint8_t* payload, size_t length);//CMD_JOG_MOVE_CW_CCW
+    // 모션 스트리밍 : 재생 시각이 된 프레임 (length : OPEN 의 FrameBytes)
+    void handleMotionFrame(uint32_t timestampMs, const uint8_t* data, size_t length) {}
+    void handleUnknownCommand(uint16_t cmd) {}
+    // 응답(ACK 비트가 설정된 CMD) 수신 : 기본 동작은 handleUnknownCommand 와 동일
+    void handleResponse(uint16_t senderId, uint16_t cmd, uint8_t* payload, size_t length) { derived().handleUnknownCommand(cmd); }
+    // 파일 수신 세션의 저장소 선택 : 기본 동작은 setFileStore(sessionId, store) 로 지정한 저장소, 없으면 기본 저장소
+    // (게이트웨이는 송신자별 저장소를 돌려주도록 재정의)
+    IFileStore* selectFileStore(uint16_t senderId, uint8_t sessionId);
+
+
+    // 파싱 후 : 호출되는 함수
+    void setMainPower(uint8_t powerFlag);//CMD_MAIN_POWER_CONTROL
+    void setJogMoveCwCcw(uint8_t id, uint8_t subId, uint32_t speed, uint8_t direction);//CMD_JOG_MOVE_CW_CCW
+
+
+    // 명령어 정의
+    /* 네트워크 0x0000 ~ 0x00FF */
+    static const uint16_t CMD_ACK_BIT = 0x8000;
+    static const uint16_t CMD_PING = 0x0001;
+    static const uint16_t CMD_PONG = CMD_PING | CMD_ACK_BIT;  // PONG 응답용 명령어 추가
+    static const uint16_t CMD_FILE_RECEIVE = 0x0002;  // CMD_FILE을 CMD_FILE_RECEIVE로 변경
+    static const uint16_t CMD_FILE_RECEIVE_ACK = CMD_FILE_RECEIVE | CMD_ACK_BIT;
+    static const uint16_t CMD_CONFIG = 0x0003;
+    static const uint16_t CMD_CONFIG_ACK = CMD_CONFIG | CMD_ACK_BIT;
+    static const uint16_t CMD_ID_SCAN = 0x0004;
+    static const uint16_t CMD_ID_SCAN_ACK = CMD_ID_SCAN | CMD_ACK_BIT;
+    static const uint16_t CMD_STATS = 0x0005;
+    static const uint16_t CMD_STATS_ACK = CMD_STATS | CMD_ACK_BIT;
+    static const uint16_t CMD_GROUP = 0x0006;
+    static const uint16_t CMD_GROUP_ACK = CMD_GROUP | CMD_ACK_BIT;
+
+    // 상태 동기화
+    static const uint16_t CMD_STATUS_SYNC = 0x0010;
+    static const uint16_t CMD_STATUS_SYNC_ACK = CMD_STATUS_SYNC | CMD_ACK_BIT;
+    // 새 세션 연결 (인증 및 타임스탬프 포함)
+    static const uint16_t CMD_SYNC = 0x0020;
+    static const uint16_t CMD_SYNC_ACK = CMD_SYNC | CMD_ACK_BIT;
+    // 링크 속도 협상 (CMD_SYNC 이후)
+    static const uint16_t CMD_LINK_SPEED = 0x0021;
+    static const uint16_t CMD_LINK_SPEED_ACK = CMD_LINK_SPEED | CMD_ACK_BIT;
+
+
+    /* 제어 0x0100 ~ 0x01FF */
+    static const uint16_t CMD_MAIN_POWER_CONTROL = 0x0100;
+    static const uint16_t CMD_MAIN_POWER_CONTROL_ACK = CMD_MAIN_POWER_CONTROL | CMD_ACK_BIT;
+
+    static const uint16_t CMD_PLAY_CONTROL = 0x0110;
+    static const uint16_t CMD_PLAY_CONTROL_ACK = CMD_PLAY_CONTROL | CMD_ACK_BIT;
+    static const uint16_t CMD_MOTION_STREAM = 0x0111;
+    static const uint16_t CMD_MOTION_STREAM_ACK = CMD_MOTION_STREAM | CMD_ACK_BIT;
+
+    static const uint16_t CMD_JOG_MOVE_CW_CCW = 0x0120;
+    static const uint16_t CMD_JOG_MOVE_CW_CCW_ACK = CMD_JOG_MOVE_CW_CCW | CMD_ACK_BIT;
+
+
+    // 파일 전송 관련 상수
+    static const uint8_t MAX_RETRY_COUNT = 5;
+    static const uint16_t MAX_FILENAME_LENGTH = 256;
+    static const uint32_t MAX_FILE_SIZE = 1024 * 1024; // 1MB
+    static const uint32_t CHECKPOINT_INTERVAL_BLOCKS = 16;  // 재개 시 최대 재전송 블록 수
+    static const size_t FILE_COPY_CHUNK = 64;                // DELTA_COPY / 서명 계산 시 스택 버퍼
+    static const size_t MAX_FILE_SESSIONS = 4;               // 동시에 진행하는 수신 세션 (송신자 ID, SessionId)
+    static const uint32_t FILE_SESSION_TIMEOUT_MS = 30000;
+
+    // 파일 전송 관련 함수
+    void handleFileReceive(uint16_t senderId, uint8_t* payload, size_t length);
+
+    Tick* tick_;
+    Serial* serial_;
+
+    uint16_t my_id_;
+
+    uint16_t calculateCRC16(const uint8_t* data, size_t length) { return crc16XModem(data, length); }
+
+    // 시퀀스 번호를 지정해 전송 (재전송 : 수신 측 응답 캐시가 중복으로 인식)
+    void sendFrame(uint16_t receiverId, uint16_t senderId, uint16_t cmd, uint16_t seq,
+                   const uint8_t* data, size_t length);
+    uint16_t getTxSequence() const { return currentSequenceNumber_; }   // 다음 sendData() 가 쓸 번호
+
+private:
+    static const uint8_t START_MARKER = 0x16;
+    static const uint8_t START_SEQUENCE_LENGTH = 4;
+    static const uint32_t PACKET_TIMEOUT_MS = 100;         // 고정 타임아웃, 적응형의 첫 여유
+    static const uint32_t RX_GUARD_MIN_MS = 3;              // 적응형 여유 하한 (tick 1ms 분해능 + 호출 주기)
+    static const uint32_t RX_GUARD_MAX_MS = 1000;
+    static const uint32_t RX_BITS_PER_BYTE = 11;            // 8E1/8N2 까지 포함한 바이트당 비트
+
+    // FEC 프레임 길이 필드 : [1(FEC) | parity/2 (6비트) | 전체 길이 (9비트)]
+    // 상위 바이트가 0x80 이상이므로 시작 마커(0x16)와 겹치지 않음
+    static const uint16_t FEC_LENGTH_FLAG = 0x8000;
+    static const uint8_t FEC_PARITY_SHIFT = 9;
+    static const uint16_t FEC_PARITY_MASK = 0x3F;
+    static const uint16_t FEC_LENGTH_MASK = 0x01FF;
+
+    // 추가: 시퀀스 번호 점프 임계치
+    static const uint16_t SEQUENCE_JUMP_THRESHOLD = 3;
+    // 기대 번호보다 이만큼 이내로 작은 번호는 재전송으로 보고 수신 시퀀스를 되돌리지 않음
+    static const uint16_t SEQUENCE_REPLAY_WINDOW = 256;
+
+    // 링크 속도 협상 관련 상수
+    static const uint32_t LINK_SWITCH_DELAY_MS = 20;        // 응답 측 : ACK 송신 후 전환까지
+    static const uint32_t LINK_SETTLE_MS = 10;              // 요청 측 : 상대 전환 후 첫 핑까지 여유
+    static const uint32_t LINK_RESPONSE_TIMEOUT_MS = 100;   // ACK/PONG 대기
+    static const uint32_t LINK_CONFIRM_TIMEOUT_MS = 2000;   // 응답 측 : 전환 후 CONFIRM 대기
+    static const uint8_t LINK_PING_BURST = 8;
+    static const uint8_t LINK_PING_BURST_MIN_OK = 7;        // 버스트 중 허용 손실 1개
+    static const uint32_t LINK_ERROR_WINDOW_MS = 1000;
+    static const uint16_t LINK_ERROR_SPIKE_THRESHOLD = 8;   // 창 안의 최소 에러 수
+    static const uint16_t LINK_ERROR_SPIKE_PERCENT = 20;    // 에러 / 수신 프레임 비율
+
+    Derived& derived() { return *static_cast<Derived*>(this); }
+
+    // 송신 및 수신 시퀀스 번호 관련 변수
+    uint16_t currentSequenceNumber_;    // 송신 시퀀스 번호
+    uint16_t expectedSequenceNumber_;   // 수신측에서 기대하는 다음 시퀀스 번호
+    uint32_t missingPacketCount_;       // 누락된 패킷 수
+
+    // 순서는 ProtocolTraceFormat::RxState 와 같음
+    enum class ReceiveState {
+        WAIT_START,
+        READ_LENGTH,
+        READ_RECEIVER_ID,
+        READ_SENDER_ID,
+        READ_CMD,
+        READ_SEQ,         // 추가: 시퀀스 번호 읽기
+        READ_PAYLOAD,
+        READ_FEC_BLOCK    // FEC 프레임 : 길이 이후 전체(헤더~CRC + parity)를 모은 뒤 정정
+    };
+
+    ReceiveState currentState_;
+    uint32_t lastReceiveTime_;
+    uint16_t expectedLength_;
+
+    uint16_t senderId_;
+    uint16_t receivedId_;
+    uint16_t payloadIndex_;
+    uint8_t startSequenceCount_;
+
+    uint8_t* receiveBuffer_;
+    size_t bufferLength_;
+
+    volatile bool rxPending_;   // ISR 에서 설정, processReceivedData() 에서 해제
+
+    uint16_t receivedCRC_;
+    uint16_t calculatedCRC_;
+    uint16_t cmd_;  // CMD 필드
+
+    uint16_t seq_; // 수신된 시퀀스 번호
+
+    // 재스캔용 버퍼 (setResyncRescan(true) 시 할당)
+    bool resyncRescan_;
+    uint8_t* rawFrame_;         // 현재 프레임 후보의 원본 바이트 (시작 시퀀스 제외)
+    uint16_t rawLength_;
+    uint8_t* rescanBuffer_;     // 다시 스캔할 바이트 (직렬 포트보다 먼저 소비)
+    uint16_t rescanIndex_;
+    uint16_t rescanLength_;
+
+    bool readNextByte(uint8_t& data, bool& rescanned);
+    void enterState(ReceiveState state) {
+        COM_PROTOCOL_TRACE_EVENT(ProtocolTraceFormat::RX_STATE, static_cast<uint8_t>(state), expectedLength_);
+        currentState_ = state;
+    }
+    void abortFrame();          // 현재 프레임 후보 폐기 후 WAIT_START 로 복귀
+
+    // 적응형 프레임 타임아웃과 링크 품질
+    bool adaptiveTimeout_;
+    LinkQualityEstimator quality_;
+    uint32_t rxFrameGap_;       // 현재 프레임 후보의 최대 읽기 간격 (ms)
+    bool rxStalled_;            // 타임아웃으로 버린 직후 : 다음 바이트가 잘린 프레임의 나머지인지 확인
+    size_t remainingFrameBytes() const;
+    uint32_t frameTimeoutFor(size_t remainingBytes) const;
+    void noteReadGap(uint8_t data, uint32_t now);   // 호출마다 첫 바이트에서만 (바이트당 분기 하나)
+    void sampleFrameQuality(bool failed) {
+        quality_.sampleFrame(failed);
+        quality_.sampleGap(rxFrameGap_);
+    }
+
+    void processCommand(uint16_t senderId, uint16_t receiverId,
+                       uint16_t cmd, uint8_t* payload, size_t payloadLength);
+
+    void trackSequence();       // seq_ 로 수신 시퀀스 갱신 (재전송된 지난 번호도 수락, 중복은 응답 캐시가 판단)
+
+    // 중복 요청 응답 캐시
+    ReplyCache replyCache_;
+    ReplyCache::Entry* replyCapture_;   // 핸들러 실행 중 : 요청 송신자에게 보내는 응답 바이트 기록
+    uint16_t handlerReceiverId_;        // 핸들러 실행 중인 프레임의 수신자 ID (브로드캐스트/그룹 판단)
+    uint16_t handlerSenderId_;
+    void dispatchCommand(const PacketQueue::Packet& packet);
+    void writeFrameBytes(const uint8_t* data, size_t length, bool capture);
+
+    // FEC
+    ReedSolomon fec_;           // 송신용 (생성 다항식 보관)
+    uint8_t rxFecParity_;       // 수신 중인 FEC 프레임의 parity 크기
+    uint32_t fecCorrectedBytes_;
+    void processFecBlock();
+
+    // 파싱 -> 처리 단계 큐
+    PacketQueue packetQueue_;
+    void (*packetNotify_)(void* context);
+    void* packetNotifyContext_;
+    void deliverFrame(uint8_t* payload, size_t payloadLength);     // 검증한 프레임 (payloadLength 는 CRC 포함) : 큐에 넣거나 바로 분기
+
+    // 링크 속도 협상 상태
+    bool sessionSynced_;        // CMD_SYNC(응답 측) 또는 CMD_SYNC_ACK(요청 측) 이후 true
+    struct LinkSpeedContext {
+        LinkSpeedState state;
+        uint16_t peerId;
+        uint32_t targetBaudRate;
+        uint32_t fallbackBaudRate;
+        uint32_t deadline;
+        uint8_t pingsSent;
+        uint8_t pongsReceived;
+        bool pingOutstanding;
+        uint32_t windowStart;
+        uint16_t windowErrors;      // reportLinkError()
+        uint32_t windowRxErrors;    // 창 시작 시점의 linkRxErrors_
+        uint32_t windowRxFrames;
+    } link_;
+
+    // 수신 에러/프레임 누적값 : 파싱 단계만 증가시키고 에러 감시 창은 시작 시점 값과의 차로 계산
+    std::atomic<uint32_t> linkRxErrors_;
+    std::atomic<uint32_t> linkRxFrames_;
+    static void bump(std::atomic<uint32_t>& counter) {
+        counter.store(counter.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    }
+    void restartLinkWindow(uint32_t now);
+    uint32_t serialBaudRate() const { return serial_ ? SerialBaudRate::get(*serial_, 0) : 0; }
+    bool setSerialBaudRate(uint32_t baudRate) { return SerialBaudRate::set(*serial_, baudRate, 0); }
+    bool serialSupportsBaudRate(uint32_t baudRate) const { return serial_ && SerialBaudRate::supports(*serial_, baudRate, 0); }
+
+    void handleLinkSpeed(uint16_t senderId, uint8_t* payload, size_t length);
+    void handleLinkSpeedResponse(uint16_t senderId, uint16_t cmd, uint8_t* payload, size_t length);
+    void serviceLinkSpeed(uint32_t currentTime);
+    void sendLinkSpeed(LinkSpeedStage stage);
+    void revertLinkSpeed();
+    void settleLinkSpeed(uint32_t currentTime);
+    static bool deadlinePassed(uint32_t now, uint32_t deadline) { return static_cast<int32_t>(now - deadline) >= 0; }
+
+    // 파일 수신 세션 표 : (송신자 ID, SessionId) 마다 진행 위치, 체크섬, 타임아웃이 독립
+    struct FileTransferContext {
+        uint16_t senderId;
+        uint8_t sessionId;
+        bool isTransferring;            // false : 빈 칸
+        IFileStore* store;              // nullptr : 기록 안 함
+        uint32_t lastActivity;          // 이 세션의 마지막 프레임 (tick)
+        uint32_t fileSize;
+        uint32_t currentIndex;
+        uint32_t receivedSize;
+        uint16_t checksum;              // 수신한 전체 데이터의 누적 CRC16
+        uint32_t fileId;                // 0 : 재개 불가 (체크포인트 저장 안 함)
+        uint32_t blocksSinceCheckpoint;
+        bool hasContentHash;            // 확정 시 저장소에 함께 기록할 내용 해시 (SHA-256)
+        uint8_t contentHash[FILE_CONTENT_HASH_SIZE];
+        FileCodec codec;                // RECEIVING_DATA 블록 압축 방식
+    } fileSessions_[MAX_FILE_SESSIONS];
+
+    struct FileStoreBinding {
+        uint8_t sessionId;
+        IFileStore* store;
+    } fileStoreBindings_[MAX_FILE_SESSIONS];
+    size_t fileStoreBindingCount_;
+
+    IFileStore* fileStore_;             // 기본 저장소
+    uint32_t fileSessionTimeoutMs_;
+    bool fileReplyFramed_;              // 처리 중인 요청이 세션 형식 : 응답도 같은 형식으로
+    uint8_t fileReplySession_;
+    ConfigStore* configStore_;
+
+    // 모션 스트리밍 상태 : 재생 시각 = clockBase + (현재 tick - clockStart)
+    struct MotionStreamContext {
+        MotionStreamState state;
+        bool armed;             // 워터마크에 도달하면 재생 (AUTO_START 또는 PLAY 명령)
+        bool clockValid;        // 첫 프레임 타임스탬프로 시계를 맞춤
+        bool ended;             // END 수신
+        uint32_t totalFrames;
+        uint16_t watermark;
+        uint32_t clockStart;
+        uint32_t clockBase;
+        uint32_t playheadMs;    // 재생 중이 아닐 때의 재생 시각
+        uint32_t lastTimestamp; // 마지막으로 재생한 프레임
+        uint32_t framePeriod;   // 마지막 두 프레임의 간격 : 다음 프레임이 이때까지 없으면 언더런
+        bool played;
+        uint16_t underruns;
+        uint16_t lateFrames;
+        uint16_t missedFrames;
+    } motion_;
+    MotionJitterBuffer motionBuffer_;
+
+    // 계측 : metrics_ 는 처리 단계(분기, 송신, 핸들러 시간)만 쓰고, 파싱 단계 카운터는 따로 atomic 으로 둠
+    // (큐 모드에서 두 단계가 다른 스레드). resetMetrics() 는 파싱 단계 카운터의 그 시점 값을 기준으로 기록하고
+    // 스냅숏은 기준과의 차로 계산 (linkRxErrors_ 의 에러 감시 창과 같은 방식)
+    ProtocolMetrics metrics_;
+    enum RxCounter {
+        RX_BYTES,
+        RX_CRC_ERRORS,
+        RX_LENGTH_ERRORS,
+        RX_FRAME_TIMEOUTS,
+        RX_FOREIGN_FRAMES,
+        RX_MISSING_PACKETS,
+        RX_FEC_UNCORRECTABLE,
+        RX_FEC_CORRECTED_BYTES,
+        RX_QUEUE_DROPS,
+        RX_COUNTERS
+    };
+    std::atomic<uint32_t> rxCounters_[RX_COUNTERS];
+    uint32_t rxCounterBase_[RX_COUNTERS];
+    std::atomic<uint32_t> queueHighWater_;     // 파싱 단계가 올리고 resetMetrics() 가 0 으로
+    void countRx(RxCounter counter, uint32_t amount = 1) {
+        rxCounters_[counter].store(rxCounters_[counter].load(std::memory_order_relaxed) + amount,
+                                   std::memory_order_relaxed);
+    }
+    void snapshotMetrics(ProtocolMetrics& snapshot);
+    void handleStats(uint16_t senderId, uint8_t* payload, size_t length);
+
+    // 그룹 주소 소속 : 수신자 ID 를 읽는 즉시 비트 하나로 판단
+    GroupMembership groups_;
+    bool acceptsReceiver(uint16_t receiverId) const {
+        return receiverId == my_id_ || receiverId == 0xFFFF || groups_.contains(receiverId);   // 0xFFFF 는 브로드캐스트
+    }
+    void handleGroup(uint16_t senderId, uint8_t* payload, size_t length);
+
+    void handleMotionStream(uint16_t senderId, uint8_t* payload, size_t length);
+    void sendMotionStreamAck(uint16_t receiverId, MotionStreamStage stage, uint8_t status);
+    uint32_t motionPlayhead(uint32_t now) const;
+    void startMotionIfReady(uint32_t now);
+    void serviceMotion(uint32_t currentTime);
+    uint32_t timeUntilMotionFrame(uint32_t now) const;     // 다음 재생/언더런 판정까지 ms
+    uint32_t timeUntilServiceDeadline(uint32_t now) const;  // 링크 속도/모션 타이머까지 ms
+
+    FileTransferContext* findFileSession(uint16_t senderId, uint8_t sessionId);
+    // 같은 키의 세션 또는 빈 칸 (표가 가득 찼거나 store 를 다른 세션이 사용 중이면 nullptr)
+    FileTransferContext* openFileSession(uint16_t senderId, uint8_t sessionId, IFileStore* store);
+    void expireFileSessions(uint32_t now);
+    void resetFileTransferContext(FileTransferContext& session);
+    void saveFileCheckpoint(FileTransferContext& session);
+    bool appendFileData(FileTransferContext& session, const uint8_t* data, size_t length);   // 새 파일의 다음 위치에 기록 + 누적 CRC
+    bool copyCurrentFile(FileTransferContext& session, uint32_t offset, uint32_t length);    // DELTA_COPY
+    bool decompressFileData(FileTransferContext& session, const uint8_t* data, size_t length);    // FileCodec::LZSS 블록
+    void sendFileSignatures(uint16_t receiverId, IFileStore* store, const FileSignatureQueryMessage& query);
+
+    // 파일 수신 응답 전송 : response[0] 은 세션 형식용 여유 바이트, 본문은 response + 1 부터 length 바이트
+    void sendFileReply(uint16_t receiverId, uint8_t* response, size_t length);
+    void sendFileReceiveAck(uint16_t receiverId, FileTransferStage stage,
+                           uint8_t result, uint32_t data = 0);                // result : FILE_ACK_*
+    void sendFileReceiveBlockAck(uint16_t receiverId, FileTransferStage stage,
+                                uint8_t result, uint32_t blockIndex);   // 블록 번호 0 도 항상 포함
+
+#if defined(COM_PROTOCOL_TRACE)
+    ProtocolTraceRing trace_;           // 파싱 단계 (큐를 쓰지 않으면 전부)
+    ProtocolTraceRing handlerTrace_;    // 큐 모드의 처리 단계
+    ProtocolTraceRing& handlerTrace() { return packetQueue_.enabled() ? handlerTrace_ : trace_; }
+    // 분기 이벤트의 인자 : 송신자 ID(상위 16비트) + 시퀀스 번호
+    static uint32_t traceOrigin(const PacketQueue::Packet& packet) {
+        return (static_cast<uint32_t>(packet.senderId) << 16) | packet.seq;
+    }
+#endif
+};
+
+/*
+ * 구현부 (템플릿이므로 헤더에 위치)
+ */
+#define COM_PROTOCOL_ENGINE_TEMPLATE template <typename Derived, typename Serial, typename Tick>
+#define COM_PROTOCOL_ENGINE Com_ProtocolEngine<Derived, Serial, Tick>
+
+// 생성자: 멤버 변수 초기화 (새로운 시퀀스 관련 변수 포함)
+COM_PROTOCOL_ENGINE_TEMPLATE
+COM_PROTOCOL_ENGINE::Com_ProtocolEngine(Serial* serial, Tick* tick, uint16_t my_id) :
+    tick_(tick),
+    serial_(serial),
+    my_id_(my_id),  // my_id로 my_id_ 초기화
+    currentSequenceNumber_(0),
+    expectedSequenceNumber_(0),
+    missingPacketCount_(0),
+    currentState_(ReceiveState::WAIT_START),
+    lastReceiveTime_(0),
+    expectedLength_(0),
+    payloadIndex_(0),
+    startSequenceCount_(0),
+    receiveBuffer_(nullptr),
+    bufferLength_(256),
+    rxPending_(false),
+    resyncRescan_(false),
+    rawFrame_(nullptr),
+    rawLength_(0),
+    rescanBuffer_(nullptr),
+    rescanIndex_(0),
+    rescanLength_(0),
+    adaptiveTimeout_(true),
+    rxFrameGap_(0),
+    rxStalled_(false),
+    replyCapture_(nullptr),
+    handlerReceiverId_(0),
+    handlerSenderId_(0),
+    rxFecParity_(0),
+    fecCorrectedBytes_(0),
+    packetNotify_(nullptr),
+    packetNotifyContext_(nullptr),
+    sessionSynced_(false),
+    linkRxErrors_(0),
+    linkRxFrames_(0),
+    fileStoreBindingCount_(0),
+    fileStore_(nullptr),
+    fileSessionTimeoutMs_(FILE_SESSION_TIMEOUT_MS),
+    fileReplyFramed_(false),
+    fileReplySession_(FILE_DEFAULT_SESSION),
+    configStore_(nullptr),
+    queueHighWater_(0)
+{
+    memset(&link_, 0, sizeof(link_));
+    link_.state = LinkSpeedState::IDLE;
+    memset(&motion_, 0, sizeof(motion_));
+    motion_.state = MotionStreamState::IDLE;
+    metrics_.clear();
+    for (size_t i = 0; i < RX_COUNTERS; i++) {
+        rxCounters_[i].store(0, std::memory_order_relaxed);
+        rxCounterBase_[i] = 0;
+    }
+    ProtocolClock::enableCycleCounter();    // 핸들러 시간 히스토그램 (MCU 에서 꺼져 있으면 항상 0)
+    for (size_t i = 0; i < MAX_FILE_SESSIONS; i++) {
+        resetFileTransferContext(fileSessions_[i]);
+    }
+    receiveBuffer_ = new uint8_t[bufferLength_];
+}
+
+// 소멸자: 동적 할당된 메모리 해제
+COM_PROTOCOL_ENGINE_TEMPLATE
+COM_PROTOCOL_ENGINE::~Com_ProtocolEngine() {
+    if (receiveBuffer_) {
+        delete[] receiveBuffer_;
+        receiveBuffer_ = nullptr;
+    }
+    delete[] rawFrame_;
+    delete[] rescanBuffer_;
+}
+
+// 원본 바이트 버퍼 크기 : 길이(2) + 최대 프레임(bufferLength_)
+COM_PROTOCOL_ENGINE_TEMPLATE
+void COM_PROTOCOL_ENGINE::setResyncRescan(bool enable) {
+    if (enable && !rawFrame_) {
+        rawFrame_ = new uint8_t[bufferLength_ + 2];
+        rescanBuffer_ = new uint8_t[bufferLength_ + 2];
+    }
+    rawLength_ = 0;
+    resyncRescan_ = enable;
+}
+
+// 데이터 전송 함수 (헤더에 시퀀스 번호 포함)
+COM_PROTOCOL_ENGINE_TEMPLATE
+void COM_PROTOCOL_ENGINE::sendData(uint16_t receiverId, uint16_t senderId, uint16_t cmd,
+                                   const uint8_t* data, size_t length) {
+    if (!serial_) return;
+
+    sendFrame(receiverId, senderId, cmd, currentSequenceNumber_, data, length);
+
+    // 송신 시퀀스 번호 증가
+    currentSequenceNumber_++;
+}
+
+COM_PROTOCOL_ENGINE_TEMPLATE
+void COM_PROTOCOL_ENGINE::sendFrame(uint16_t receiverId, uint16_t senderId, uint16_t cmd, uint16_t seq,
+                                    const uint8_t* data, size_t length) {
+    if (!serial_) return;
+
+    // 그룹 주소로 받은 요청의 응답은 보내지 않음 (가입한 노드가 모두 응답하면 충돌)
+    if (GroupMembership::isGroupId(handlerReceiverId_) && receiverId == handlerSenderId_) return;
+
+    // 요청 핸들러 안에서 요청 송신자에게 보내는 프레임은 응답 캐시에도 기록
+    const bool capture = replyCapture_ && receiverId == replyCapture_->senderId;
+
+    // 시작 시퀀스(4) + 전체 길이(2) + 헤더(8)를 한 번에 전송
+    uint8_t frameHead[START_SEQUENCE_LENGTH + 2 + 8];
+    for (int i = 0; i < START_SEQUENCE_LENGTH; i++) {
+        frameHead[i] = START_MARKER;
+    }
+
+    // 전체 길이 계산 (필수)
+    uint16_t totalLength = 8 + length + 2; // header(8) + payload + CRC(2)
+    const uint8_t parity = fec_.paritySize();
+    // FEC 부호어(길이 + 헤더 + 페이로드 + CRC + parity)가 255 바이트를 넘으면 일반 프레임으로 전송
+    const bool useFec = parity > 0 && static_cast<size_t>(2 + totalLength + parity) <= ReedSolomon::MAX_CODEWORD;
+    uint16_t lengthField = totalLength;
+    if (useFec) {
+        lengthField |= FEC_LENGTH_FLAG | static_cast<uint16_t>((parity / 2) << FEC_PARITY_SHIFT);
+    }
+    frameHead[4] = static_cast<uint8_t>(lengthField >> 8);
+    frameHead[5] = static_cast<uint8_t>(lengthField & 0xFF);
+
+    // 헤더 생성 (시퀀스 번호 포함)
+    uint8_t* headerBytes = frameHead + 6;
+    headerBytes[0] = static_cast<uint8_t>(receiverId >> 8);
+    headerBytes[1] = static_cast<uint8_t>(receiverId & 0xFF);
+    headerBytes[2] = static_cast<uint8_t>(senderId >> 8);
+    headerBytes[3] = static_cast<uint8_t>(senderId & 0xFF);
+    headerBytes[4] = static_cast<uint8_t>(cmd >> 8);
+    headerBytes[5] = static_cast<uint8_t>(cmd & 0xFF);
+    headerBytes[6] = static_cast<uint8_t>(seq >> 8);
+    headerBytes[7] = static_cast<uint8_t>(seq & 0xFF);
+
+    metrics_.txFrames++;
+    metrics_.countCommand(cmd, true);
+    metrics_.txSize[ProtocolMetrics::sizeBucket(totalLength)]++;
+
+    writeFrameBytes(frameHead, sizeof(frameHead), capture);
+
+    // 페이로드 전송
+    if (length > 0) {
+        writeFrameBytes(data, length, capture);
+    }
+
+    // CRC 계산 및 전송 (헤더에 이어서 페이로드를 계산, 임시 버퍼 없음)
+    uint16_t crc = crc16XModemUpdate(0x0000, headerBytes, 8);
+    if (length > 0) {
+        crc = crc16XModemUpdate(crc, data, length);
+    }
+
+    uint8_t crcBytes[2] = {
+        static_cast<uint8_t>(crc >> 8),
+        static_cast<uint8_t>(crc & 0xFF)
+    };
+    writeFrameBytes(crcBytes, 2, capture);
+
+    // FEC parity : 길이 필드부터 CRC 까지를 부호화
+    if (useFec) {
+        uint8_t parityBytes[ReedSolomon::MAX_PARITY];
+        memset(parityBytes, 0, parity);
+        fec_.encodeUpdate(parityBytes, frameHead + START_SEQUENCE_LENGTH, 2 + 8);
+        if (length > 0) {
+            fec_.encodeUpdate(parityBytes, data, length);
+        }
+        fec_.encodeUpdate(parityBytes, crcBytes, 2);
+        writeFrameBytes(parityBytes, parity, capture);
+    }
+}
+
+COM_PROTOCOL_ENGINE_TEMPLATE
+void COM_PROTOCOL_ENGINE::writeFrameBytes(const uint8_t* data, size_t length, bool capture) {
+    COM_PROTOCOL_HANDLER_TRACE_EVENT(ProtocolTraceFormat::WRITE_BEGIN, 0, 0, static_cast<uint32_t>(length));
+    serial_->write(data, length);
+    COM_PROTOCOL_HANDLER_TRACE_EVENT(ProtocolTraceFormat::WRITE_END);
+    metrics_.txBytes += static_cast<uint32_t>(length);
+    if (capture) replyCache_.append(replyCapture_, data, length);
+}
+
+// 데이터 수신
+COM_PROTOCOL_ENGINE_TEMPLATE
+void COM_PROTOCOL_ENGINE::receiveData(uint8_t* buffer, size_t length) {
+    if (!serial_ || !buffer) return;
+
+    serial_->read(buffer, length);
+}
+
+// 수신 가능한 데이터가 있는지 확인
+COM_PROTOCOL_ENGINE_TEMPLATE
+bool COM_PROTOCOL_ENGINE::isDataAvailable() const {
+    return (serial_ && serial_->isOpen());
+}
+
+// 수신 상태 머신
+COM_PROTOCOL_ENGINE_TEMPLATE
+void COM_PROTOCOL_ENGINE::processReceivedData() {
+    if (!serial_ || !receiveBuffer_) return;
+
+    // 이후 도착하는 바이트는 다시 rxPending_ 을 설정하므로 읽기 전에 해제
+    rxPending_ = false;
+
+    uint32_t currentTime = tick_->getTickCount();
+
+    // 타이머는 송신하므로 큐 모드에서는 처리 단계(processQueuedPackets)에서 실행
+    if (!packetQueue_.enabled()) {
+        // 링크 속도 협상 타이머 (전환, 핑 버스트, 확인 타임아웃, 에러 급증 감시)
+        serviceLinkSpeed(currentTime);
+
+        // 모션 스트리밍 : 재생 시각이 된 프레임 전달
+        serviceMotion(currentTime);
+    }
+
+    uint8_t data;
+    bool rescanned;
+    bool available = readNextByte(data, rescanned);
+
+    // 패킷 타임아웃 체크 : 읽을 바이트가 없을 때만. 호출이 늦어 그사이 도착해 있는 바이트는
+    // 링크가 끊긴 것이 아니라 늦게 읽은 것이므로 먼저 프레임의 나머지로 처리
+    if (!available && currentState_ != ReceiveState::WAIT_START &&
+        (currentTime - lastReceiveTime_) > getFrameTimeout()) {
+        bump(linkRxErrors_);
+        countRx(RX_FRAME_TIMEOUTS);
+        abortFrame();
+        rxStalled_ = true;
+        available = readNextByte(data, rescanned);     // 재스캔 모드 : 버린 후보의 바이트
+    }
+
+    uint32_t readBytes = 0;     // 계측 : 루프 안에서는 지역 변수로 세고 끝에서 반영
+    for (; available; available = readNextByte(data, rescanned)) {
+        // 재스캔 바이트는 이전에 도착한 것이므로 수신 시각을 갱신하지 않음
+        if (!rescanned) {
+            if (readBytes == 0) noteReadGap(data, currentTime);
+            lastReceiveTime_ = currentTime;
+            readBytes++;
+        }
+
+        if (resyncRescan_ && currentState_ != ReceiveState::WAIT_START &&
+            rawLength_ < bufferLength_ + 2) {
+            rawFrame_[rawLength_++] = data;
+        }
+
+        switch (currentState_) {
+            case ReceiveState::WAIT_START:
+                if (data == START_MARKER) {
+                    startSequenceCount_++;
+                    if (startSequenceCount_ == START_SEQUENCE_LENGTH) {
+                        enterState(ReceiveState::READ_LENGTH);
+                        payloadIndex_ = 0;
+                        rawLength_ = 0;
+                        rxFrameGap_ = 0;
+                        memset(receiveBuffer_, 0, bufferLength_);
+                    }
+                } else {
+                    startSequenceCount_ = 0;
+                }
+                break;
+
+            case ReceiveState::READ_LENGTH:
+                // 시작 마커가 4개보다 많이 이어지는 경우 : 유효한 길이의 상위 바이트는
+                // 0x16 이 될 수 없으므로(길이 <= bufferLength_) 시작 시퀀스의 연속으로 처리
+                if (payloadIndex_ == 0 && data == START_MARKER) {
+                    rawLength_ = 0;
+                    break;
+                }
+                receiveBuffer_[payloadIndex_++] = data;
+                if (payloadIndex_ == 2) {
+                    expectedLength_ = (receiveBuffer_[0] << 8) | receiveBuffer_[1];
+                    if (expectedLength_ & FEC_LENGTH_FLAG) {
+                        // FEC 프레임 : 길이 필드를 포함한 부호어 전체를 receiveBuffer_ 에 모음
+                        rxFecParity_ = static_cast<uint8_t>(((expectedLength_ >> FEC_PARITY_SHIFT) & FEC_PARITY_MASK) * 2);
+                        expectedLength_ &= FEC_LENGTH_MASK;
+                        size_t codewordLength = 2 + expectedLength_ + rxFecParity_;
+                        if (rxFecParity_ == 0 || expectedLength_ < 10 ||
+                            codewordLength > ReedSolomon::MAX_CODEWORD || codewordLength > bufferLength_) {
+                            bump(linkRxErrors_);
+                            countRx(RX_LENGTH_ERRORS);
+                            abortFrame();
+                        } else {
+                            enterState(ReceiveState::READ_FEC_BLOCK);
+                        }
+                    } else if (expectedLength_ > bufferLength_ || expectedLength_ < 10) {
+                        bump(linkRxErrors_);
+                        countRx(RX_LENGTH_ERRORS);
+                        abortFrame();
+                    } else {
+                        enterState(ReceiveState::READ_RECEIVER_ID);
+                        payloadIndex_ = 0;
+                    }
+                }
+                break;
+
+            case ReceiveState::READ_RECEIVER_ID:
+                receiveBuffer_[payloadIndex_++] = data;
+                if (payloadIndex_ == 2) {
+                    uint16_t receivedId = (receiveBuffer_[0] << 8) | receiveBuffer_[1];
+                    // 수신자 ID가 my_id, 브로드캐스트, 가입한 그룹 중 하나인지 확인
+                    if (!acceptsReceiver(receivedId)) {
+                        countRx(RX_FOREIGN_FRAMES);
+                        abortFrame();
+                        continue;
+                    }
+                    receivedId_ = receivedId;
+                    enterState(ReceiveState::READ_SENDER_ID);
+                    payloadIndex_ = 0;
+                }
+                break;
+
+            case ReceiveState::READ_SENDER_ID:
+                receiveBuffer_[payloadIndex_++] = data;
+                if (payloadIndex_ == 2) {
+                    senderId_ = (receiveBuffer_[0] << 8) | receiveBuffer_[1];
+                    enterState(ReceiveState::READ_CMD);
+                    payloadIndex_ = 0;
+                }
+                break;
+
+            case ReceiveState::READ_CMD:
+                receiveBuffer_[payloadIndex_++] = data;
+                if (payloadIndex_ == 2) {
+                    cmd_ = (receiveBuffer_[0] << 8) | receiveBuffer_[1];
+                    enterState(ReceiveState::READ_SEQ);
+                    payloadIndex_ = 0;
+                }
+                break;
+
+            case ReceiveState::READ_SEQ:
+                receiveBuffer_[payloadIndex_++] = data;
+                if (payloadIndex_ == 2) {
+                    seq_ = (receiveBuffer_[0] << 8) | receiveBuffer_[1];
+                    trackSequence();
+                    enterState(ReceiveState::READ_PAYLOAD);
+                    payloadIndex_ = 0;
+                }
+                break;
+
+            case ReceiveState::READ_PAYLOAD:
+                receiveBuffer_[payloadIndex_++] = data;
+                if (payloadIndex_ == expectedLength_-8) {
+                    // 마지막 2바이트는 CRC
+                    receivedCRC_ = (receiveBuffer_[payloadIndex_ - 2] << 8) |
+                                  receiveBuffer_[payloadIndex_ - 1];
+
+                    // 헤더(수신자 ID, 송신자 ID, CMD, 시퀀스 번호) 재구성
+                    const uint8_t headerBytes[8] = {
+                        (uint8_t)(receivedId_ >> 8), (uint8_t)(receivedId_ & 0xFF),
+                        (uint8_t)(senderId_ >> 8),   (uint8_t)(senderId_ & 0xFF),
+                        (uint8_t)(cmd_ >> 8),        (uint8_t)(cmd_ & 0xFF),
+                        (uint8_t)(seq_ >> 8),        (uint8_t)(seq_ & 0xFF)
+                    };
+
+                    // CRC 계산 : 헤더에 이어서 페이로드 (있는 경우, 임시 버퍼 없음)
+                    calculatedCRC_ = crc16XModemUpdate(0x0000, headerBytes, 8);
+                    if (expectedLength_ > 10) { // 10 = header(8) + CRC(2)
+                        calculatedCRC_ = crc16XModemUpdate(calculatedCRC_, receiveBuffer_,
+                                                           expectedLength_ - 10);
+                    }
+
+                    if (calculatedCRC_ == receivedCRC_) {
+                        // CRC 검증 성공
+                        deliverFrame(receiveBuffer_, expectedLength_ - 8);
+                        // 상태 초기화
+                        enterState(ReceiveState::WAIT_START);
+                        startSequenceCount_ = 0;
+                    } else {
+                        // CRC 검증 실패
+                        bump(linkRxErrors_);
+                        countRx(RX_CRC_ERRORS);
+                        sampleFrameQuality(true);
+                        abortFrame();
+                    }
+                }
+                break;
+
+            case ReceiveState::READ_FEC_BLOCK:
+                receiveBuffer_[payloadIndex_++] = data;
+                if (payloadIndex_ == 2 + expectedLength_ + rxFecParity_) {
+                    processFecBlock();
+                }
+                break;
+        }
+    }
+    countRx(RX_BYTES, readBytes);
+}
+
+// 수신 시퀀스 번호 추적
+COM_PROTOCOL_ENGINE_TEMPLATE
+void COM_PROTOCOL_ENGINE::trackSequence() {
+    if (cmd_ == CMD_SYNC) {
+        expectedSequenceNumber_ = 0;
+        return;
+    }
+    uint16_t diff = seq_ - expectedSequenceNumber_;
+    if (diff == 0) {
+        expectedSequenceNumber_++;
+        quality_.sampleSequence(0);
+    } else if (diff > 0 && diff <= SEQUENCE_JUMP_THRESHOLD) {
+        missingPacketCount_ += diff;
+        countRx(RX_MISSING_PACKETS, diff);
+        expectedSequenceNumber_ = seq_ + 1;
+        quality_.sampleSequence(diff);
+    } else if (static_cast<uint16_t>(expectedSequenceNumber_ - 1 - seq_) >= SEQUENCE_REPLAY_WINDOW) {
+        missingPacketCount_ += diff;
+        countRx(RX_MISSING_PACKETS, diff);
+        expectedSequenceNumber_ = seq_ + 1;
+        quality_.sampleSequence(diff);
+    }
+    // 최근에 지난 번호 : 응답 유실 후 같은 번호로 재전송된 요청
+    // 기대 번호와 누락 수는 그대로 두고 수락 (중복 여부는 응답 캐시가 판단)
+}
+
+// FEC 부호어 : [길이(2) | 헤더(8) | 페이로드 | CRC(2) | parity] 를 정정한 뒤 일반 프레임과 같이 검증
+COM_PROTOCOL_ENGINE_TEMPLATE
+void COM_PROTOCOL_ENGINE::processFecBlock() {
+    const uint16_t lengthField = static_cast<uint16_t>((receiveBuffer_[0] << 8) | receiveBuffer_[1]);
+    const size_t codewordLength = 2 + expectedLength_ + rxFecParity_;
+
+    int corrected = ReedSolomon::decode(receiveBuffer_, codewordLength, rxFecParity_);
+    // 정정 불가, 또는 길이 필드가 정정됨 (잘못된 길이로 읽었으므로 부호어 경계가 틀림)
+    if (corrected < 0 ||
+        static_cast<uint16_t>((receiveBuffer_[0] << 8) | receiveBuffer_[1]) != lengthField) {
+        bump(linkRxErrors_);
+        countRx(RX_FEC_UNCORRECTABLE);
+        sampleFrameQuality(true);
+        abortFrame();
+        return;
+    }
+    fecCorrectedBytes_ += corrected;
+    countRx(RX_FEC_CORRECTED_BYTES, static_cast<uint32_t>(corrected));
+
+    const uint8_t* header = receiveBuffer_ + 2;
+    receivedId_ = static_cast<uint16_t>((header[0] << 8) | header[1]);
+    if (!acceptsReceiver(receivedId_)) {
+        countRx(RX_FOREIGN_FRAMES);
+        abortFrame();
+        return;
+    }
+    senderId_ = static_cast<uint16_t>((header[2] << 8) | header[3]);
+    cmd_ = static_cast<uint16_t>((header[4] << 8) | header[5]);
+    seq_ = static_cast<uint16_t>((header[6] << 8) | header[7]);
+
+    const uint8_t* crcBytes = header + expectedLength_ - 2;
+    receivedCRC_ = static_cast<uint16_t>((crcBytes[0] << 8) | crcBytes[1]);
+    calculatedCRC_ = crc16XModem(header, expectedLength_ - 2);   // 헤더 + 페이로드
+    if (calculatedCRC_ != receivedCRC_) {
+        bump(linkRxErrors_);
+        countRx(RX_CRC_ERRORS);
+        sampleFrameQuality(true);
+        abortFrame();
+        return;
+    }
+    trackSequence();
+
+    enterState(ReceiveState::WAIT_START);
+    startSequenceCount_ = 0;
+    deliverFrame(receiveBuffer_ + 10, expectedLength_ - 8);
+}
+
+// 검증된 프레임 전달 : 큐 모드면 빈 패킷 버퍼에 복사해 처리 단계로 넘기고 (가득 차면 버림), 아니면 바로 분기
+COM_PROTOCOL_ENGINE_TEMPLATE
+void COM_PROTOCOL_ENGINE::deliverFrame(uint8_t* payload, size_t payloadLength) {
+    bump(linkRxFrames_);
+    sampleFrameQuality(false);
+    payloadLength -= 2;     // 프레임 CRC 제외 : 핸들러 length 는 페이로드만 (CRC 값은 packet.crc)
+
+    PacketQueue::Packet inlinePacket;
+    PacketQueue::Packet* packet = &inlinePacket;
+    if (packetQueue_.enabled()) {
+        packet = packetQueue_.acquire();
+        if (!packet) {
+            countRx(RX_QUEUE_DROPS);
+            return;
+        }
+        memcpy(packet->payload, payload, payloadLength);
+    } else {
+        packet->payload = payload;
+    }
+    packet->senderId = senderId_;
+    packet->receiverId = receivedId_;
+    packet->cmd = cmd_;
+    packet->seq = seq_;
+    packet->crc = receivedCRC_;
+    packet->frameLength = expectedLength_;
+    packet->length = static_cast<uint16_t>(payloadLength);
+
+    if (!packetQueue_.enabled()) {
+        dispatchCommand(*packet);
+        return;
+    }
+    packetQueue_.commit();
+    uint32_t depth = static_cast<uint32_t>(packetQueue_.depth());
+    if (depth > queueHighWater_.load(std::memory_order_relaxed)) queueHighWater_.store(depth, std::memory_order_relaxed);
+    if (packetNotify_) packetNotify_(packetNotifyContext_);
+}
+
+// 처리 단계 : 타이머를 먼저 돌리고 대기 패킷을 도착 순서대로 분기, 분기가 끝난 버퍼는 파싱 단계에 돌려줌
+COM_PROTOCOL_ENGINE_TEMPLATE
+size_t COM_PROTOCOL_ENGINE::processQueuedPackets(size_t maxPackets) {
+    if (!serial_ || !packetQueue_.enabled()) return 0;
+
+    uint32_t currentTime = tick_->getTickCount();
+    serviceLinkSpeed(currentTime);
+    serviceMotion(currentTime);
+
+    size_t processed = 0;
+    while (maxPackets == 0 || processed < maxPackets) {
+        PacketQueue::Packet* packet = packetQueue_.front();
+        if (!packet) break;
+        dispatchCommand(*packet);
+        packetQueue_.release();
+        processed++;
+    }
+    return processed;
+}
+
+COM_PROTOCOL_ENGINE_TEMPLATE
+void COM_PROTOCOL_ENGINE::setPacketNotify(void (*notify)(void* context), void* context) {
+    packetNotifyContext_ = context;
+    packetNotify_ = notify;
+}
+
+// 검증된 프레임 분기 : 응답 캐시에 있는 요청이면 processCommand 없이 저장한 응답만 재전송
+// (응답, CMD_SYNC, 링크 속도 협상은 캐시하지 않음)
+COM_PROTOCOL_ENGINE_TEMPLATE
+void COM_PROTOCOL_ENGINE::dispatchCommand(const PacketQueue::Packet& packet) {
+    const uint16_t cmd = packet.cmd;
+    metrics_.rxFrames++;
+    metrics_.countCommand(cmd, false);
+    metrics_.rxSize[ProtocolMetrics::sizeBucket(packet.frameLength)]++;
+
+    const bool cacheable = replyCache_.enabled() && !(cmd & CMD_ACK_BIT) && cmd != CMD_SYNC && cmd != CMD_LINK_SPEED;
+    if (cacheable) {
+        ReplyCache::Entry* cached = replyCache_.find(packet.senderId, packet.seq, cmd, packet.crc);
+        if (cached) {
+            COM_PROTOCOL_HANDLER_TRACE_EVENT(ProtocolTraceFormat::REPLY_REPLAY, 0, cmd, traceOrigin(packet));
+            metrics_.replayedReplies++;
+            if (cached->length > 0) writeFrameBytes(cached->reply, cached->length, false);
+            return;
+        }
+        // 응답이 없는 요청도 기록 : 재전송되어도 동작(전원, 재생 제어 등)을 반복하지 않음
+        replyCapture_ = replyCache_.insert(packet.senderId, packet.seq, cmd, packet.crc);
+    }
+
+    COM_PROTOCOL_HANDLER_TRACE_EVENT(ProtocolTraceFormat::DISPATCH_BEGIN, 0, cmd, traceOrigin(packet));
+    if (GroupMembership::isGroupId(packet.receiverId)) metrics_.groupFrames++;
+    handlerReceiverId_ = packet.receiverId;
+    handlerSenderId_ = packet.senderId;
+    uint32_t started = ProtocolClock::now();
+    processCommand(packet.senderId, packet.receiverId, cmd, packet.payload, packet.length);
+    metrics_.countHandler(ProtocolClock::toMicros(ProtocolClock::now() - started));
+    handlerReceiverId_ = my_id_;    // 핸들러 밖의 송신(타이머, 응용)은 응답 억제 대상이 아님
+    COM_PROTOCOL_HANDLER_TRACE_EVENT(ProtocolTraceFormat::DISPATCH_END, 0, cmd);
+
+    if (cacheable) {
+        replyCache_.complete(replyCapture_);
+        replyCapture_ = nullptr;
+    }
+}
+
+// 재스캔 대기 바이트를 먼저, 없으면 직렬 포트에서 1바이트
+COM_PROTOCOL_ENGINE_TEMPLATE
+bool COM_PROTOCOL_ENGINE::readNextByte(uint8_t& data, bool& rescanned) {
+    rescanned = rescanIndex_ < rescanLength_;
+    if (rescanned) {
+        data = rescanBuffer_[rescanIndex_++];
+        return true;
+    }
+    uint8_t tempBuffer[1];
+    if (serial_->read(tempBuffer, 1) > 0) {
+        data = tempBuffer[0];
+        return true;
+    }
+    return false;
+}
+
+// 프레임 후보 폐기 : 재스캔 모드면 시작 시퀀스 이후의 원본 바이트를
+// 아직 스캔하지 않은 재스캔 바이트 앞에 붙여 다시 스캔 (시작 시퀀스 4바이트는 제외되므로 항상 진행)
+COM_PROTOCOL_ENGINE_TEMPLATE
+void COM_PROTOCOL_ENGINE::abortFrame() {
+    if (resyncRescan_ && rawLength_ > 0) {
+        uint16_t remaining = rescanLength_ - rescanIndex_;
+        // 원본 바이트가 재스캔 버퍼에서 왔다면 remaining + rawLength_ <= 이전 rescanLength_,
+        // 직렬 포트에서 온 바이트가 섞였다면 remaining == 0 이므로 용량을 넘지 않음
+        if (remaining > 0) {
+            memmove(rescanBuffer_ + rawLength_, rescanBuffer_ + rescanIndex_, remaining);
+        }
+        memcpy(rescanBuffer_, rawFrame_, rawLength_);
+        rescanIndex_ = 0;
+        rescanLength_ = rawLength_ + remaining;
+    }
+    COM_PROTOCOL_TRACE_EVENT(ProtocolTraceFormat::RX_ABORT, static_cast<uint8_t>(currentState_));
+    rawLength_ = 0;
+    currentState_ = ReceiveState::WAIT_START;
+    startSequenceCount_ = 0;
+    payloadIndex_ = 0;
+}
+
+// 현재 프레임 후보에서 아직 받지 않은 바이트 (길이 필드 이후 : 헤더 8 + 페이로드 + CRC [+ FEC parity])
+COM_PROTOCOL_ENGINE_TEMPLATE
+size_t COM_PROTOCOL_ENGINE::remainingFrameBytes() const {
+    switch (currentState_) {
+        case ReceiveState::READ_LENGTH: return 2 - payloadIndex_;
+        case ReceiveState::READ_RECEIVER_ID: return expectedLength_ - payloadIndex_;
+        case ReceiveState::READ_SENDER_ID: return expectedLength_ - 2 - payloadIndex_;
+        case ReceiveState::READ_CMD: return expectedLength_ - 4 - payloadIndex_;
+        case ReceiveState::READ_SEQ: return expectedLength_ - 6 - payloadIndex_;
+        case ReceiveState::READ_PAYLOAD: return expectedLength_ - 8 - payloadIndex_;
+        case ReceiveState::READ_FEC_BLOCK: return 2 + expectedLength_ + rxFecParity_ - payloadIndex_;
+        default: return bufferLength_;
+    }
+}
+
+COM_PROTOCOL_ENGINE_TEMPLATE
+uint32_t COM_PROTOCOL_ENGINE::getFrameTimeout() const {
+    return frameTimeoutFor(remainingFrameBytes());
+}
+
+// 남은 바이트의 전송 시간 + 바이트 간격 여유
+COM_PROTOCOL_ENGINE_TEMPLATE
+uint32_t COM_PROTOCOL_ENGINE::frameTimeoutFor(size_t remainingBytes) const {
+    const uint32_t baudRate = serialBaudRate();
+    if (!adaptiveTimeout_ || baudRate == 0) return PACKET_TIMEOUT_MS;
+
+    uint32_t guard = quality_.hasGapSamples() ? quality_.gapGuardMs() : PACKET_TIMEOUT_MS;
+    if (guard < RX_GUARD_MIN_MS) guard = RX_GUARD_MIN_MS;
+    if (guard > RX_GUARD_MAX_MS) guard = RX_GUARD_MAX_MS;
+    const uint32_t bits = static_cast<uint32_t>(remainingBytes) * RX_BITS_PER_BYTE * 1000;
+    return (bits + baudRate - 1) / baudRate + guard;
+}
+
+// 읽기 호출 사이 간격 : 프레임 도중이면 후보의 최대 간격으로, 타임아웃 직후면 잘린 프레임의 실제 간격으로 기록
+// (타임아웃 뒤 첫 바이트가 시작 마커면 새 프레임으로 보고 표본에서 제외 : 조용했던 버스가 여유를 늘리지 않도록)
+COM_PROTOCOL_ENGINE_TEMPLATE
+void COM_PROTOCOL_ENGINE::noteReadGap(uint8_t data, uint32_t now) {
+    const uint32_t gap = now - lastReceiveTime_;
+    if (rxStalled_) {
+        rxStalled_ = false;
+        if (data != START_MARKER && gap <= RX_GUARD_MAX_MS) quality_.sampleGap(gap);
+        return;
+    }
+    if (currentState_ != ReceiveState::WAIT_START && gap > rxFrameGap_) rxFrameGap_ = gap;
+}
+
+// 수신 알림 : 인터럽트 문맥에서 호출 가능 (플래그만 설정)
+COM_PROTOCOL_ENGINE_TEMPLATE
+void COM_PROTOCOL_ENGINE::notifyRxFromISR() {
+    rxPending_ = true;
+}
+
+// 다음 타임아웃까지 남은 시간 : 이벤트 루프의 대기 시간으로 사용
+COM_PROTOCOL_ENGINE_TEMPLATE
+uint32_t COM_PROTOCOL_ENGINE::timeUntilReceiveTimeout() {
+    uint32_t now = tick_->getTickCount();
+    uint32_t remaining = NO_RECEIVE_DEADLINE;
+
+    if (currentState_ != ReceiveState::WAIT_START) {
+        uint32_t timeout = getFrameTimeout();
+        uint32_t elapsed = now - lastReceiveTime_;
+        if (elapsed > timeout) return 0;
+        remaining = timeout + 1 - elapsed;  // 타임아웃 조건은 elapsed > timeout
+    }
+
+    // 큐 모드 : 타이머는 처리 단계에서 (timeUntilQueuedWork)
+    if (!packetQueue_.enabled()) {
+        uint32_t service = timeUntilServiceDeadline(now);
+        if (service < remaining) remaining = service;
+    }
+    return remaining;
+}
+
+// 처리 단계의 대기 시간 : 대기 패킷이 없으면 다음 타이머까지
+COM_PROTOCOL_ENGINE_TEMPLATE
+uint32_t COM_PROTOCOL_ENGINE::timeUntilQueuedWork() {
+    if (!packetQueue_.enabled()) return NO_RECEIVE_DEADLINE;
+    if (packetQueue_.depth() > 0) return 0;
+    return timeUntilServiceDeadline(tick_->getTickCount());
+}
+
+COM_PROTOCOL_ENGINE_TEMPLATE
+uint32_t COM_PROTOCOL_ENGINE::timeUntilServiceDeadline(uint32_t now) const {
+    uint32_t remaining = NO_RECEIVE_DEADLINE;
+
+    // 링크 속도 협상 : ACTIVE 는 에러 감시 창, 나머지 진행 상태는 단계별 기한
+    if (link_.state != LinkSpeedState::IDLE) {
+        uint32_t deadline = (link_.state == LinkSpeedState::ACTIVE) ?
+                            link_.windowStart + LINK_ERROR_WINDOW_MS : link_.deadline;
+        if (deadlinePassed(now, deadline)) return 0;
+        remaining = deadline - now;
+    }
+
+    if (motion_.state == MotionStreamState::PLAYING) {
+        uint32_t motion = timeUntilMotionFrame(now);
+        if (motion < remaining) remaining = motion;
+    }
+    return remaining;
+}
+
+COM_PROTOCOL_ENGINE_TEMPLATE
+bool COM_PROTOCOL_ENGINE::needsProcessing() {
+    return rxPending_ || timeUntilReceiveTimeout() == 0;
+}
+
+// 명령어 분기 : 핸들러는 Derived 를 통해 정적으로 호출
+COM_PROTOCOL_ENGINE_TEMPLATE
+void COM_PROTOCOL_ENGINE::processCommand(uint16_t senderId, uint16_t receiverId,
+                                         uint16_t cmd, uint8_t* payload, size_t payloadLength) {
+    // 응답은 요청 CMD 에 ACK 비트를 설정한 값
+    if (cmd & CMD_ACK_BIT) {
+        handleLinkSpeedResponse(senderId, cmd, payload, payloadLength);
+        derived().handleResponse(senderId, cmd, payload, payloadLength);
+        return;
+    }
+
+    switch (cmd) {
+        case CMD_PING:
+            derived().handlePing(senderId, payload, payloadLength);
+            break;
+
+        case CMD_FILE_RECEIVE:
+            derived().handleFileReceive(senderId, payload, payloadLength);
+            break;
+
+        case CMD_CONFIG:
+            derived().handleConfig(senderId, payload, payloadLength);
+            break;
+        case CMD_STATUS_SYNC:
+            derived().handleStatusSync(senderId, payload, payloadLength);
+            break;
+        case CMD_ID_SCAN:
+            derived().handleIdScan(senderId, payload, payloadLength);
+            break;
+        case CMD_STATS:
+            handleStats(senderId, payload, payloadLength);
+            break;
+        case CMD_GROUP:
+            handleGroup(senderId, payload, payloadLength);
+            break;
+        case CMD_SYNC:
+        {
+            SyncMessage sync;
+            // 수신 시퀀스는 파서가 헤더를 읽을 때 이미 초기화함 (trackSequence, 큐 모드에서는 파싱 단계 전용)
+            if (SyncSchema::deserialize(payload, payloadLength, sync) &&
+                sync.authToken == 0xABCD) {
+                sessionSynced_ = true;
+                replyCache_.invalidateSender(senderId);   // 새 세션 : 이전 시퀀스 번호와 다시 겹칠 수 있음
+                // 동기화 성공시 ACK 전송
+                sendSyncAck(senderId, sync.timestamp);
+            }
+            break;
+        }
+        case CMD_LINK_SPEED:
+            handleLinkSpeed(senderId, payload, payloadLength);
+            break;
+        case CMD_MAIN_POWER_CONTROL:
+            derived().handleMainPowerControl(senderId, payload, payloadLength);
+            break;
+        case CMD_PLAY_CONTROL:
+            derived().handlePlayControl(senderId, payload, payloadLength);
+            break;
+        case CMD_JOG_MOVE_CW_CCW:
+            derived().handleJogMoveCwCcw(senderId, payload, payloadLength);
+            break;
+        case CMD_MOTION_STREAM:
+            handleMotionStream(senderId, payload, payloadLength);
+            break;
+        default:
+            metrics_.unknownCommands++;
+            derived().handleUnknownCommand(cmd);
+            break;
+    }
+}
+
+COM_PROTOCOL_ENGINE_TEMPLATE
+void COM_PROTOCOL_ENGINE::handlePing(uint16_t senderId, uint8_t* payload, size_t length) {
+    // PING에 대한 응답으로 PONG 메시지 전송
+    uint8_t pongPayload[] = "PONG";
+
+    // PONG 메시지 전송 (송신자와 수신자 ID를 교체하여 응답)
+    sendData(senderId, my_id_, CMD_PONG, pongPayload, 4);
+}
+
+COM_PROTOCOL_ENGINE_TEMPLATE
+void COM_PROTOCOL_ENGINE::handleStatusSync(uint16_t senderId, uint8_t* payload, size_t length) {
+    // 페이로드 길이 체크
+
+    /* 상태 동기화 로직 구현  재정의 하여 측정된 값을 추가*/
+    // 메인파워 상태
+    uint8_t mainPowerStatus = 1; // 1: ON, 0: OFF
+    // 모션 재생 상태
+    uint8_t motionPlayStatus = 1; // 1:1회 재생, 2:반복 재생, 3:일시 정지 , 4:정지
+    // 연속 구동시간
+    uint32_t totalRunTime = 60000; // ms 단위의 전체 구동시간 획득
+    // 동작 회차
+    uint16_t currentCount = 1000; // 현재 동작 회차
+    uint16_t totalCount = 2000; // 총 동작 회차
+    // 전압
+    uint16_t voltage = 3000; // 30.00V
+    // 전류
+    uint16_t current = 4000; // 40.00A
+    // 모션 시간
+    uint32_t motionCurrentTime = 10000; // 10.00s
+    uint32_t motionEndTime = 20000; // 20.00s
+
+    // 마지막 에러
+    uint8_t f_error = 0;            // 0: 정상, 1: 에러
+    uint8_t can_id = 0;             // CAN ID
+    uint8_t can_sub_id = 0;         // CAN SUB ID
+    MotorType motor_type = MotorType::MOTOR_NULL;
+    char error_code_str[8] = {0};   // 8바이트 제한의 에러 코드 문자열
+    /************************************************* */
+
+
+
+    /*패킷 생성*/
+    StatusSyncAckMessage status;
+    status.mainPowerStatus = mainPowerStatus;
+    status.motionPlayStatus = motionPlayStatus;
+
+    // 시간 변환 (ms -> 시/분/초)
+    status.hours = totalRunTime / (1000 * 60 * 60);
+    status.minutes = (totalRunTime % (1000 * 60 * 60)) / (1000 * 60);
+    status.seconds = ((totalRunTime % (1000 * 60 * 60)) % (1000 * 60)) / 1000;
+
+    // 동작 회차 정보 (현재/총)
+    status.currentCount = currentCount;
+    status.totalCount = totalCount;
+
+    // 에너지 정보 (전압/전류)
+    status.voltage = voltage;
+    status.current = current;
+
+    // 모션 시간 (하위 16비트만 전송)
+    status.motionCurrentTime = static_cast<uint16_t>(motionCurrentTime);
+    status.motionEndTime = static_cast<uint16_t>(motionEndTime);
+
+    // 마지막 에러
+    status.error = f_error;
+    status.canId = can_id;
+    status.canSubId = can_sub_id;
+    status.motorType = motor_type;
+
+    // error_code_str 복사 (최대 8바이트, 나머지는 0)
+    memset(status.errorCode, 0, sizeof(status.errorCode));
+    strncpy(reinterpret_cast<char*>(status.errorCode), error_code_str, sizeof(status.errorCode));
+
+    // 응답 전송 (29바이트)
+    uint8_t responsePayload[StatusSyncAckSchema::SIZE];
+    StatusSyncAckSchema::serialize(status, responsePayload);
+    sendData(senderId, my_id_, CMD_STATUS_SYNC_ACK, responsePayload, StatusSyncAckSchema::SIZE);
+}
+
+// 설정 저장소 요청 : 응답은 항상 ACK 헤더 포함 (저장소가 없으면 CONFIG_UNSUPPORTED)
+COM_PROTOCOL_ENGINE_TEMPLATE
+void COM_PROTOCOL_ENGINE::handleConfig(uint16_t senderId, uint8_t* payload, size_t length) {
+    if (length < 1) return;
+
+    uint8_t response[CONFIG_MAX_PAYLOAD];
+    size_t responseLength;
+    if (configStore_) {
+        responseLength = configStore_->handleRequest(payload, length, response, sizeof(response));
+    } else {
+        ConfigAckMessage ack;
+        ack.op = static_cast<ConfigOp>(payload[0]);
+        ack.status = CONFIG_UNSUPPORTED;
+        ack.generation = 0;
+        ack.version = 0;
+        ack.key = CONFIG_NO_KEY;
+        ack.count = 0;
+        responseLength = ConfigAckSchema::serialize(ack, response);
+    }
+
+    if (responseLength > 0) sendData(senderId, my_id_, CMD_CONFIG_ACK, response, responseLength);
+}
+
+COM_PROTOCOL_ENGINE_TEMPLATE
+void COM_PROTOCOL_ENGINE::handleIdScan(uint16_t senderId, uint8_t* payload, size_t length){
+    // 페이로드 유효성 검사 : 스캔 요청된 ID (2바이트)
+    IdScanMessage scan;
+    if (!IdScanSchema::deserialize(payload, length, scan)) return;
+
+    // ID 매칭 여부 확인 및 응답 전송
+    if (scan.id == my_id_) {
+        IdScanMessage response;
+        response.id = my_id_;
+        uint8_t responsePayload[IdScanSchema::SIZE];
+        IdScanSchema::serialize(response, responsePayload);
+        sendData(senderId, my_id_, CMD_ID_SCAN_ACK, responsePayload, IdScanSchema::SIZE);
+    }
+}
+
+
+COM_PROTOCOL_ENGINE_TEMPLATE
+void COM_PROTOCOL_ENGINE::handleMainPowerControl(uint16_t senderId, uint8_t* payload, size_t length){
+    // 페이로드 길이 체크
+    MainPowerControlMessage control;
+    if (!MainPowerControlSchema::deserialize(payload, length, control)) return;
+
+    uint8_t powerFlag = control.powerFlag;
+
+    // 플래그 값 검증
+    if (powerFlag > 1) return;  // 0 또는 1만 유효
+
+    // 메인파워 제어 로직 구현
+    // - powerFlag가 0이면 메인파워 OFF
+    // - powerFlag가 1이면 메인파워 ON
+    // - 하드웨어 제어 인터페이스를 통해 실제 전원 제어 수행
+
+    // 제어 결과에 대한 응답 전송
+    // - 제어 성공/실패 여부를 포함한 응답 패킷 구성
+    // - sendData() 함수를 사용하여 응답 전송
+
+    derived().setMainPower(powerFlag);
+
+    /* 응답 구현 */
+    uint8_t ackPayload[MainPowerControlSchema::SIZE];
+    MainPowerControlSchema::serialize(control, ackPayload);
+
+    sendData(senderId, my_id_, CMD_MAIN_POWER_CONTROL_ACK, ackPayload, MainPowerControlSchema::SIZE);
+
+}
+
+COM_PROTOCOL_ENGINE_TEMPLATE
+void COM_PROTOCOL_ENGINE::setMainPower(uint8_t powerFlag){
+    if (powerFlag == 1){
+        // 메인파워 ON
+    } else {
+        // 메인파워 OFF
+    }
+}
+
+COM_PROTOCOL_ENGINE_TEMPLATE
+void COM_PROTOCOL_ENGINE::handlePlayControl(uint16_t senderId, uint8_t* payload, size_t length) {
+    // 페이로드 길이 체크
+    PlayControlMessage control;
+    if (!PlayControlSchema::deserialize(payload, length, control)) return;
+    // 페이로드에서 PlayControl 상태 추출
+    PlayControlState playState = static_cast<PlayControlState>(control.state);
+    uint32_t now = tick_->getTickCount();
+    // 상태에 따른 처리 : 모션 스트림이 열려 있으면 스트림 재생에 적용
+    switch (playState) {
+        case PlayControlState::PLAY_ONE:
+        case PlayControlState::PLAY_REPEAT:
+            // 재생 (스트림은 한 번만 재생, 반복은 호스트가 다시 스트리밍)
+            if (motion_.state == MotionStreamState::BUFFERING) {
+                motion_.armed = true;
+                startMotionIfReady(now);
+            } else if (motion_.state == MotionStreamState::PAUSED) {
+                motion_.clockBase = motion_.playheadMs;
+                motion_.clockStart = now;
+                motion_.state = MotionStreamState::PLAYING;
+            }
+            break;
+
+        case PlayControlState::PAUSE:
+            // 일시정지 : 재생 시각을 멈추고 수신은 계속
+            if (motion_.state == MotionStreamState::PLAYING) {
+                motion_.playheadMs = motionPlayhead(now);
+                motion_.state = MotionStreamState::PAUSED;
+            } else if (motion_.state == MotionStreamState::BUFFERING) {
+                motion_.armed = false;
+            }
+            break;
+
+        case PlayControlState::STOP:
+            // 정지 : 스트림 닫기 (남은 프레임 폐기)
+            if (motion_.state != MotionStreamState::IDLE) {
+                motion_.playheadMs = motionPlayhead(now);
+                motion_.state = MotionStreamState::IDLE;
+                motionBuffer_.reset(0);
+            }
+            break;
+
+        default:
+            // 잘못된 상태값 수신
+            return;
+    }
+
+    // 응답 전송 : 현재 재생 상태 (스트림 없음 : 0)
+    PlayControlMessage response;
+    response.state = 0;
+    switch (motion_.state) {
+        case MotionStreamState::BUFFERING:
+            response.state = motion_.armed ? static_cast<uint8_t>(PlayControlState::PLAY_ONE) :
+                                             static_cast<uint8_t>(PlayControlState::PAUSE);
+            break;
+        case MotionStreamState::PLAYING: response.state = static_cast<uint8_t>(PlayControlState::PLAY_ONE); break;
+        case MotionStreamState::PAUSED: response.state = static_cast<uint8_t>(PlayControlState::PAUSE); break;
+        case MotionStreamState::FINISHED: response.state = static_cast<uint8_t>(PlayControlState::STOP); break;
+        default: break;
+    }
+
+    uint8_t responsePayload[PlayControlSchema::SIZE];
+    PlayControlSchema::serialize(response, responsePayload);
+    sendData(senderId, my_id_, CMD_PLAY_CONTROL_ACK, responsePayload, PlayControlSchema::SIZE);
+}
+
+COM_PROTOCOL_ENGINE_TEMPLATE
+void COM_PROTOCOL_ENGINE::handleJogMoveCwCcw(uint16_t senderId, uint8_t* payload, size_t length){
+    // 페이로드 길이 체크 : 최소 7바이트 필요 (id, sub-id, speed[4], direction)
+    JogMoveCwCcwMessage jog;
+    if (!JogMoveCwCcwSchema::deserialize(payload, length, jog)) return;
+
+    // 방향 값 검증
+    if (jog.direction > 1) return;  // 0(CCW) 또는 1(CW)만 유효
+
+    /* 조그 이동 로직 사용자 재정의 */
+    derived().setJogMoveCwCcw(jog.id, jog.subId, jog.speed, jog.direction);
+
+    // 응답 없음
+}
+
+COM_PROTOCOL_ENGINE_TEMPLATE
+void COM_PROTOCOL_ENGINE::setJogMoveCwCcw(uint8_t id, uint8_t subId, uint32_t speed, uint8_t direction){
+    // 조그 이동 로직 구현
+    // - direction이 0이면 반시계 방향(CCW) 이동
+    // - direction이 1이면 시계 방향(CW) 이동
+
+    // TODO: 실제 모터 제어 로직 구현
+    // 여기에 id, subId, speed, direction을 사용하여 모터 제어 로직 추가
+}
+
+COM_PROTOCOL_ENGINE_TEMPLATE
+ProtocolMetrics COM_PROTOCOL_ENGINE::getMetrics() {
+    ProtocolMetrics snapshot;
+    snapshotMetrics(snapshot);
+    return snapshot;
+}
+
+COM_PROTOCOL_ENGINE_TEMPLATE
+void COM_PROTOCOL_ENGINE::resetMetrics() {
+    metrics_.clear();
+    for (size_t i = 0; i < RX_COUNTERS; i++) rxCounterBase_[i] = rxCounters_[i].load(std::memory_order_relaxed);
+    queueHighWater_.store(0, std::memory_order_relaxed);
+}
+
+// 스냅숏 : 처리 단계 카운터 복사 + 파싱 단계 카운터 (기준과의 차) + 스냅숏 시점 값 (카운터가 아닌 항목)
+// metrics_ 는 읽기만 하므로 처리 단계의 다른 갱신과 겹치지 않음
+COM_PROTOCOL_ENGINE_TEMPLATE
+void COM_PROTOCOL_ENGINE::snapshotMetrics(ProtocolMetrics& snapshot) {
+    static uint32_t ProtocolMetrics::* const RX_COUNTER_FIELDS[RX_COUNTERS] = {
+        &ProtocolMetrics::rxBytes,
+        &ProtocolMetrics::crcErrors,
+        &ProtocolMetrics::lengthErrors,
+        &ProtocolMetrics::frameTimeouts,
+        &ProtocolMetrics::foreignFrames,
+        &ProtocolMetrics::missingPackets,
+        &ProtocolMetrics::fecUncorrectable,
+        &ProtocolMetrics::fecCorrectedBytes,
+        &ProtocolMetrics::queueDrops,
+    };
+    snapshot = metrics_;
+    for (size_t i = 0; i < RX_COUNTERS; i++) {
+        snapshot.*RX_COUNTER_FIELDS[i] = rxCounters_[i].load(std::memory_order_relaxed) - rxCounterBase_[i];
+    }
+    snapshot.queueHighWater = queueHighWater_.load(std::memory_order_relaxed);
+    snapshot.tickMs = tick_->getTickCount();
+    snapshot.queueDepth = static_cast<uint32_t>(packetQueue_.depth());
+    snapshot.linkGapMeanUs = quality_.gapMeanUs();
+    snapshot.linkGapDevUs = quality_.gapDevUs();
+    snapshot.linkCrcErrorPpm = quality_.crcErrorPpm();
+    snapshot.linkSequenceLossPpm = quality_.sequenceLossPpm();
+    snapshot.frameTimeoutMs = frameTimeoutFor(bufferLength_);   // 파싱 상태와 무관한 최대 길이 기준
+}
+
+// 계측 조회 : 섹션마다 한 프레임 (COMMANDS 는 Start 번째부터 들어가는 만큼, 나머지는 Next 로 다시 요청)
+COM_PROTOCOL_ENGINE_TEMPLATE
+void COM_PROTOCOL_ENGINE::handleStats(uint16_t senderId, uint8_t* payload, size_t length) {
+    if (length < 1) return;
+
+    StatsRequestMessage request;
+    request.section = static_cast<StatsSection>(payload[0]);
+    request.start = 0;
+    StatsRequestSchema::deserialize(payload, length, request);
+
+    StatsAckMessage ack;
+    ack.section = request.section;
+    ack.status = STATS_OK;
+    ack.count = 0;
+    ack.next = STATS_NO_NEXT;
+
+    uint8_t response[STATS_MAX_PAYLOAD];
+    uint8_t* body = response + StatsAckSchema::SIZE;
+    size_t bodyLength = 0;
+
+    // COMMANDS, HISTOGRAMS 는 처리 단계 카운터뿐이므로 metrics_ 를 바로 읽음
+    switch (request.section) {
+        case StatsSection::SUMMARY: {
+            ProtocolMetrics snapshot;
+            snapshotMetrics(snapshot);
+            for (size_t i = 0; i < STATS_SUMMARY_COUNT; i++) {
+                storeBigEndian<uint32_t>(body + bodyLength, snapshot.*STATS_SUMMARY_FIELDS[i]);
+                bodyLength += 4;
+            }
+            ack.count = static_cast<uint8_t>(STATS_SUMMARY_COUNT);
+            break;
+        }
+
+        case StatsSection::COMMANDS: {
+            size_t perFrame = (STATS_MAX_PAYLOAD - StatsAckSchema::SIZE) / STATS_COMMAND_ENTRY;
+            size_t end = request.start + perFrame;
+            if (end > metrics_.commandCount) end = metrics_.commandCount;
+            for (size_t i = request.start; i < end; i++) {
+                const ProtocolMetrics::CommandCounter& counter = metrics_.commands[i];
+                storeBigEndian<uint16_t>(body + bodyLength, counter.cmd);
+                storeBigEndian<uint32_t>(body + bodyLength + 2, counter.rx);
+                storeBigEndian<uint32_t>(body + bodyLength + 6, counter.tx);
+                bodyLength += STATS_COMMAND_ENTRY;
+                ack.count++;
+            }
+            if (end < metrics_.commandCount) ack.next = static_cast<uint8_t>(end);
+            break;
+        }
+
+        case StatsSection::HISTOGRAMS:
+            body[0] = static_cast<uint8_t>(ProtocolMetrics::SIZE_BUCKETS);
+            body[1] = static_cast<uint8_t>(ProtocolMetrics::TIME_BUCKETS);
+            bodyLength = 2;
+            for (size_t i = 0; i < ProtocolMetrics::SIZE_BUCKETS; i++, bodyLength += 4) {
+                storeBigEndian<uint32_t>(body + bodyLength, metrics_.rxSize[i]);
+            }
+            for (size_t i = 0; i < ProtocolMetrics::SIZE_BUCKETS; i++, bodyLength += 4) {
+                storeBigEndian<uint32_t>(body + bodyLength, metrics_.txSize[i]);
+            }
+            for (size_t i = 0; i < ProtocolMetrics::TIME_BUCKETS; i++, bodyLength += 4) {
+                storeBigEndian<uint32_t>(body + bodyLength, metrics_.handlerTime[i]);
+            }
+            ack.count = static_cast<uint8_t>(ProtocolMetrics::SIZE_BUCKETS * 2 + ProtocolMetrics::TIME_BUCKETS);
+            break;
+
+        default:
+            ack.status = STATS_UNKNOWN_SECTION;
+            break;
+    }
+
+    StatsAckSchema::serialize(ack, response, StatsAckSchema::SIZE);
+    sendData(senderId, my_id_, CMD_STATS_ACK, response, StatsAckSchema::SIZE + bodyLength);
+}
+
+// 그룹 소속 변경 : 나열한 GroupId 를 모두 검사한 뒤 한꺼번에 적용 (하나라도 범위 밖이면 그대로 둠)
+// 응답은 변경 후 소속 비트맵 (그룹 주소로 받은 요청이면 sendFrame 에서 억제)
+COM_PROTOCOL_ENGINE_TEMPLATE
+void COM_PROTOCOL_ENGINE::handleGroup(uint16_t senderId, uint8_t* payload, size_t length) {
+
+    GroupRequestMessage request;
+    if (!GroupRequestSchema::deserialize(payload, length, request)) return;
+    const uint8_t* ids = payload + GroupRequestSchema::SIZE;
+
+    GroupAckMessage ack;
+    ack.op = request.op;
+    ack.status = GROUP_OK;
+    if (request.op != GroupOp::JOIN && request.op != GroupOp::LEAVE &&
+        request.op != GroupOp::SET && request.op != GroupOp::QUERY) {
+        ack.status = GROUP_UNKNOWN_OP;
+    } else if (length != GroupRequestSchema::SIZE + static_cast<size_t>(request.count) * 2) {
+        ack.status = GROUP_BAD_LENGTH;
+    } else {
+        for (uint8_t i = 0; i < request.count; i++) {
+            if (!GroupMembership::isGroupId(loadBigEndian<uint16_t>(ids + i * 2))) {
+                ack.status = GROUP_INVALID_ID;
+                break;
+            }
+        }
+    }
+
+    if (ack.status == GROUP_OK && request.op != GroupOp::QUERY) {
+        if (request.op == GroupOp::SET) groups_.clear();
+        for (uint8_t i = 0; i < request.count; i++) {
+            uint16_t groupId = loadBigEndian<uint16_t>(ids + i * 2);
+            if (request.op == GroupOp::LEAVE) {
+                groups_.leave(groupId);
+            } else {
+                groups_.join(groupId);
+            }
+        }
+    }
+
+    uint8_t response[GroupAckSchema::SIZE + GROUP_BITMAP_SIZE];
+    ack.members = static_cast<uint8_t>(groups_.count());
+    GroupAckSchema::serialize(ack, response, GroupAckSchema::SIZE);
+    groups_.toBytes(response + GroupAckSchema::SIZE);
+    sendData(senderId, my_id_, CMD_GROUP_ACK, response, sizeof(response));
+}
+
+COM_PROTOCOL_ENGINE_TEMPLATE
+bool COM_PROTOCOL_ENGINE::setMotionBuffer(size_t slots, size_t frameBytes) {
+    if (slots > 0xFFFF) return false;       // ACK 의 Credit 필드 (2 바이트)
+    if (!motionBuffer_.resize(slots, frameBytes)) return false;
+    motion_.state = MotionStreamState::IDLE;
+    return true;
+}
+
+COM_PROTOCOL_ENGINE_TEMPLATE
+uint32_t COM_PROTOCOL_ENGINE::getMotionPlayhead() {
+    return motionPlayhead(tick_->getTickCount());
+}
+
+COM_PROTOCOL_ENGINE_TEMPLATE
+uint32_t COM_PROTOCOL_ENGINE::motionPlayhead(uint32_t now) const {
+    if (motion_.state != MotionStreamState::PLAYING) return motion_.playheadMs;
+    return motion_.clockBase + (now - motion_.clockStart);
+}
+
+// 스트림 : OPEN 으로 버퍼를 비우고, DATA 는 번호 자리에 저장, END 이후 남은 프레임을 재생하면 FINISHED
+// 모든 요청에 같은 형식의 ACK (흐름 제어용 Credit, 언더런/늦은 프레임 집계 포함)
+COM_PROTOCOL_ENGINE_TEMPLATE
+void COM_PROTOCOL_ENGINE::handleMotionStream(uint16_t senderId, uint8_t* payload, size_t length) {
+    if (length < 1) return;
+
+    MotionStreamStage stage = static_cast<MotionStreamStage>(payload[0]);
+    uint32_t now = tick_->getTickCount();
+    uint8_t status = MOTION_OK;
+
+    if (!motionBuffer_.enabled()) {
+        status = MOTION_UNSUPPORTED;
+    } else if (stage == MotionStreamStage::OPEN) {
+        MotionOpenMessage open;
+        if (!MotionOpenSchema::deserialize(payload, length, open)) {
+            status = MOTION_MALFORMED;
+        } else if (open.frameBytes == 0 || !motionBuffer_.reset(open.frameBytes)) {
+            status = MOTION_UNSUPPORTED;
+        } else {
+            memset(&motion_, 0, sizeof(motion_));
+            motion_.state = MotionStreamState::BUFFERING;
+            motion_.armed = (open.flags & MOTION_FLAG_AUTO_START) != 0;
+            motion_.watermark = open.watermark == 0 ? 1 : open.watermark;
+            if (motion_.watermark > motionBuffer_.capacity()) {
+                motion_.watermark = static_cast<uint16_t>(motionBuffer_.capacity());
+            }
+        }
+    } else if (stage == MotionStreamStage::DATA || stage == MotionStreamStage::END) {
+        MotionDataMessage data;
+        MotionEndMessage end;
+        size_t entrySize = 4 + motionBuffer_.frameBytes();
+        if (motion_.state == MotionStreamState::IDLE) {
+            status = MOTION_NOT_OPEN;
+        } else if (stage == MotionStreamStage::END) {
+            if (MotionEndSchema::deserialize(payload, length, end)) {
+                motion_.ended = true;
+                motion_.totalFrames = end.totalFrames;
+            } else {
+                status = MOTION_MALFORMED;
+            }
+        } else if (!MotionDataSchema::deserialize(payload, length, data) ||
+                   length < MotionDataSchema::SIZE + data.count * entrySize) {
+            status = MOTION_MALFORMED;
+        } else {
+            const uint8_t* entry = payload + MotionDataSchema::SIZE;
+            for (uint8_t i = 0; i < data.count; i++, entry += entrySize) {
+                uint32_t index = data.firstIndex + i;
+                if (motion_.ended && index >= motion_.totalFrames) break;
+                if (motionBuffer_.store(index, loadBigEndian<uint32_t>(entry), entry + 4) ==
+                    MotionJitterBuffer::LATE) {
+                    motion_.lateFrames++;
+                }
+            }
+        }
+    } else if (stage != MotionStreamStage::STATUS) {
+        status = MOTION_MALFORMED;
+    }
+
+    if (status == MOTION_OK) startMotionIfReady(now);
+    sendMotionStreamAck(senderId, stage, status);
+}
+
+COM_PROTOCOL_ENGINE_TEMPLATE
+void COM_PROTOCOL_ENGINE::sendMotionStreamAck(uint16_t receiverId, MotionStreamStage stage, uint8_t status) {
+    MotionStreamAckMessage ack;
+    ack.stage = stage;
+    ack.status = status;
+    ack.state = motion_.state;
+    ack.nextIndex = motionBuffer_.nextIndex();
+    ack.playIndex = motionBuffer_.playIndex();
+    ack.credit = motion_.state == MotionStreamState::IDLE ? 0 : static_cast<uint16_t>(motionBuffer_.free());
+    ack.underruns = motion_.underruns;
+    ack.lateFrames = motion_.lateFrames;
+    ack.missedFrames = motion_.missedFrames;
+    ack.playheadMs = motionPlayhead(tick_->getTickCount());
+
+    uint8_t response[MotionStreamAckSchema::SIZE];
+    MotionStreamAckSchema::serialize(ack, response);
+    sendData(receiverId, my_id_, CMD_MOTION_STREAM_ACK, response, MotionStreamAckSchema::SIZE);
+}
+
+// 워터마크만큼 연속으로 받았으면 (또는 END 까지 모두 받았으면) 재생 시작
+// 처음에는 첫 프레임 타임스탬프부터, 언더런 후에는 멈춘 재생 시각부터 이어서 진행
+COM_PROTOCOL_ENGINE_TEMPLATE
+void COM_PROTOCOL_ENGINE::startMotionIfReady(uint32_t now) {
+    if (motion_.state != MotionStreamState::BUFFERING || !motion_.armed) return;
+    bool complete = motion_.ended && motionBuffer_.nextIndex() >= motion_.totalFrames;
+    if (motionBuffer_.contiguous() < motion_.watermark && !complete) return;
+
+    if (!motion_.clockValid) {
+        uint32_t timestamp;
+        const uint8_t* data;
+        motion_.playheadMs = motionBuffer_.front(timestamp, data) ? timestamp : 0;
+        motion_.clockValid = true;
+    }
+    motion_.clockBase = motion_.playheadMs;
+    motion_.clockStart = now;
+    motion_.state = MotionStreamState::PLAYING;
+}
+
+// 재생 : 재생 시각이 지난 프레임을 번호 순서로 전달
+//  - 재생 위치가 비었는데 뒤의 프레임이 이미 재생 시각이면 빈 번호를 건너뜀 (missedFrames)
+//  - 버퍼가 비고 다음 프레임 예정 시각(마지막 프레임 + 간격)이 지나면 언더런 : 시계를 멈추고 워터마크까지 다시 채움
+COM_PROTOCOL_ENGINE_TEMPLATE
+void COM_PROTOCOL_ENGINE::serviceMotion(uint32_t currentTime) {
+    if (motion_.state != MotionStreamState::PLAYING) return;
+
+    uint32_t playhead = motionPlayhead(currentTime);
+    while (true) {
+        uint32_t timestamp;
+        const uint8_t* data;
+        if (motionBuffer_.front(timestamp, data)) {
+            if (static_cast<int32_t>(timestamp - playhead) > 0) break;
+            if (motion_.played) motion_.framePeriod = timestamp - motion_.lastTimestamp;
+            motion_.lastTimestamp = timestamp;
+            motion_.played = true;
+            derived().handleMotionFrame(timestamp, data, motionBuffer_.frameBytes());
+            motionBuffer_.pop();
+            continue;
+        }
+
+        if (motion_.ended && motionBuffer_.playIndex() >= motion_.totalFrames) {
+            motion_.playheadMs = playhead;
+            motion_.state = MotionStreamState::FINISHED;
+            break;
+        }
+
+        uint32_t index;
+        if (motionBuffer_.nextFilled(index, timestamp)) {
+            if (static_cast<int32_t>(timestamp - playhead) > 0) break;
+            motion_.missedFrames = static_cast<uint16_t>(motion_.missedFrames + motionBuffer_.skipTo(index));
+            continue;
+        }
+
+        if (motion_.played && static_cast<int32_t>(motion_.lastTimestamp + motion_.framePeriod - playhead) > 0) break;
+        motion_.underruns++;
+        motion_.playheadMs = playhead;
+        motion_.state = MotionStreamState::BUFFERING;
+        break;
+    }
+}
+
+COM_PROTOCOL_ENGINE_TEMPLATE
+uint32_t COM_PROTOCOL_ENGINE::timeUntilMotionFrame(uint32_t now) const {
+    uint32_t playhead = motionPlayhead(now);
+    uint32_t timestamp;
+    const uint8_t* data;
+    uint32_t index;
+    if (!motionBuffer_.front(timestamp, data) && !motionBuffer_.nextFilled(index, timestamp)) {
+        if (motion_.ended && motionBuffer_.playIndex() >= motion_.totalFrames) return 0;
+        if (!motion_.played) return 0;
+        timestamp = motion_.lastTimestamp + motion_.framePeriod;
+    }
+    int32_t remaining = static_cast<int32_t>(timestamp - playhead);
+    return remaining > 0 ? static_cast<uint32_t>(remaining) : 0;
+}
+
+
+COM_PROTOCOL_ENGINE_TEMPLATE
+bool COM_PROTOCOL_ENGINE::setFileStore(uint8_t sessionId, IFileStore* store) {
+    if (sessionId == FILE_DEFAULT_SESSION) {
+        fileStore_ = store;
+        return true;
+    }
+    for (size_t i = 0; i < fileStoreBindingCount_; i++) {
+        if (fileStoreBindings_[i].sessionId == sessionId) {
+            fileStoreBindings_[i].store = store;
+            return true;
+        }
+    }
+    if (fileStoreBindingCount_ == MAX_FILE_SESSIONS) return false;
+    fileStoreBindings_[fileStoreBindingCount_].sessionId = sessionId;
+    fileStoreBindings_[fileStoreBindingCount_].store = store;
+    fileStoreBindingCount_++;
+    return true;
+}
+
+COM_PROTOCOL_ENGINE_TEMPLATE
+IFileStore* COM_PROTOCOL_ENGINE::selectFileStore(uint16_t senderId, uint8_t sessionId) {
+    for (size_t i = 0; i < fileStoreBindingCount_; i++) {
+        if (fileStoreBindings_[i].sessionId == sessionId) return fileStoreBindings_[i].store;
+    }
+    return fileStore_;
+}
+
+COM_PROTOCOL_ENGINE_TEMPLATE
+size_t COM_PROTOCOL_ENGINE::getActiveFileSessions() const {
+    size_t count = 0;
+    for (size_t i = 0; i < MAX_FILE_SESSIONS; i++) {
+        if (fileSessions_[i].isTransferring) count++;
+    }
+    return count;
+}
+
+COM_PROTOCOL_ENGINE_TEMPLATE
+typename COM_PROTOCOL_ENGINE::FileTransferContext* COM_PROTOCOL_ENGINE::findFileSession(uint16_t senderId,
+                                                                                      uint8_t sessionId) {
+    for (size_t i = 0; i < MAX_FILE_SESSIONS; i++) {
+        FileTransferContext& session = fileSessions_[i];
+        if (session.isTransferring && session.senderId == senderId && session.sessionId == sessionId) return &session;
+    }
+    return nullptr;
+}
+
+COM_PROTOCOL_ENGINE_TEMPLATE
+typename COM_PROTOCOL_ENGINE::FileTransferContext* COM_PROTOCOL_ENGINE::openFileSession(uint16_t senderId,
+                                                                                      uint8_t sessionId,
+                                                                                      IFileStore* store) {
+    FileTransferContext* same = nullptr;
+    FileTransferContext* empty = nullptr;
+    for (size_t i = 0; i < MAX_FILE_SESSIONS; i++) {
+        FileTransferContext& session = fileSessions_[i];
+        if (!session.isTransferring) {
+            if (!empty) empty = &session;
+        } else if (session.senderId == senderId && session.sessionId == sessionId) {
+            same = &session;
+        } else if (store != nullptr && session.store == store) {
+            return nullptr;     // 다른 세션이 같은 저장소에 기록 중
+        }
+    }
+    return same ? same : empty;
+}
+
+// 중단된 송신 측이 칸을 계속 차지하지 않도록 해제 (저장소 내용과 체크포인트는 그대로 두어 재개 가능)
+COM_PROTOCOL_ENGINE_TEMPLATE
+void COM_PROTOCOL_ENGINE::expireFileSessions(uint32_t now) {
+    if (fileSessionTimeoutMs_ == 0) return;
+    for (size_t i = 0; i < MAX_FILE_SESSIONS; i++) {
+        FileTransferContext& session = fileSessions_[i];
+        if (session.isTransferring && now - session.lastActivity >= fileSessionTimeoutMs_) {
+            resetFileTransferContext(session);
+        }
+    }
+}
+
+COM_PROTOCOL_ENGINE_TEMPLATE
+void COM_PROTOCOL_ENGINE::resetFileTransferContext(FileTransferContext& session) {
+    memset(&session, 0, sizeof(FileTransferContext));
+    session.isTransferring = false;
+    session.store = nullptr;
+}
+
+COM_PROTOCOL_ENGINE_TEMPLATE
+void COM_PROTOCOL_ENGINE::saveFileCheckpoint(FileTransferContext& session) {
+    session.blocksSinceCheckpoint = 0;
+    if (session.store == nullptr || session.fileId == 0) return;
+
+    FileCheckpoint checkpoint;
+    checkpoint.fileId = session.fileId;
+    checkpoint.fileSize = session.fileSize;
+    checkpoint.nextBlock = session.currentIndex;
+    checkpoint.receivedSize = session.receivedSize;
+    checkpoint.checksum = session.checksum;
+    checkpoint.codec = static_cast<uint8_t>(session.codec);
+    checkpoint.hasContentHash = session.hasContentHash;
+    memcpy(checkpoint.contentHash, session.contentHash, FILE_CONTENT_HASH_SIZE);
+    session.store->saveCheckpoint(checkpoint);
+}
+
+COM_PROTOCOL_ENGINE_TEMPLATE
+bool COM_PROTOCOL_ENGINE::appendFileData(FileTransferContext& session, const uint8_t* data, size_t length) {
+    if (length > session.fileSize - session.receivedSize ||
+        (session.store != nullptr && !session.store->write(session.receivedSize, data, length))) {
+        return false;
+    }
+    session.receivedSize += length;
+
+    // 누적 체크섬 업데이트 (파일 전체)
+    session.checksum = crc16XModemUpdate(session.checksum, data, length);
+    return true;
+}
+
+// 현재 파일 구간을 작은 버퍼로 나눠 새 파일에 기록 (실패 시 이번 명령 전체를 실패로 응답, 재전송 시 처음부터)
+COM_PROTOCOL_ENGINE_TEMPLATE
+bool COM_PROTOCOL_ENGINE::copyCurrentFile(FileTransferContext& session, uint32_t offset, uint32_t length) {
+    if (session.store == nullptr || length > session.fileSize - session.receivedSize) return false;
+
+    const uint32_t startSize = session.receivedSize;
+    const uint16_t startChecksum = session.checksum;
+    uint8_t chunk[FILE_COPY_CHUNK];
+    while (length > 0) {
+        size_t n = length < FILE_COPY_CHUNK ? length : FILE_COPY_CHUNK;
+        if (session.store->readCurrent(offset, chunk, n) != n || !appendFileData(session, chunk, n)) {
+            session.receivedSize = startSize;
+            session.checksum = startChecksum;
+            return false;
+        }
+        offset += static_cast<uint32_t>(n);
+        length -= static_cast<uint32_t>(n);
+    }
+    return true;
+}
+
+// 블록을 복원하며 64 바이트씩 바로 기록 (실패 시 이번 블록 전체를 되돌림)
+COM_PROTOCOL_ENGINE_TEMPLATE
+bool COM_PROTOCOL_ENGINE::decompressFileData(FileTransferContext& session, const uint8_t* data, size_t length) {
+    const uint32_t startSize = session.receivedSize;
+    const uint16_t startChecksum = session.checksum;
+
+    LzssDecoder decoder;
+    auto sink = [this, &session](const uint8_t* chunk, size_t n) { return appendFileData(session, chunk, n); };
+    if (!decoder.decode(data, length, sink)) {
+        session.receivedSize = startSize;
+        session.checksum = startChecksum;
+        return false;
+    }
+    return true;
+}
+
+// 현재 파일의 블록 서명 (약한 롤링 체크섬 + SHA-256 앞 8 바이트) 을 최대 FILE_SIGNATURES_PER_ACK 개 응답
+COM_PROTOCOL_ENGINE_TEMPLATE
+void COM_PROTOCOL_ENGINE::sendFileSignatures(uint16_t receiverId, IFileStore* store,
+                                             const FileSignatureQueryMessage& query) {
+    uint8_t response[FILE_SESSION_PREFIX_SIZE + FileSignatureAckSchema::SIZE +
+                     FILE_SIGNATURES_PER_ACK * FileBlockSignatureSchema::SIZE];
+    uint8_t* body = response + FILE_SESSION_PREFIX_SIZE;
+
+    FileSignatureAckMessage ack;
+    ack.stage = FileTransferStage::SIGNATURE_QUERY;
+    ack.success = FILE_ACK_FAILURE;
+    ack.startBlock = query.startBlock;
+    ack.fileSize = 0;
+    ack.count = 0;
+
+    uint32_t fileSize = store != nullptr ? store->currentSize() : 0;
+    if (fileSize == 0 || query.blockSize < FILE_SIGNATURE_MIN_BLOCK || query.blockSize > FILE_SIGNATURE_MAX_BLOCK) {
+        FileSignatureAckSchema::serialize(ack, body, FileSignatureAckSchema::SIZE);
+        sendFileReply(receiverId, response, FileSignatureAckSchema::SIZE);
+        return;
+    }
+
+    ack.success = FILE_ACK_SUCCESS;
+    ack.fileSize = fileSize;
+    uint32_t blockCount = (fileSize + query.blockSize - 1) / query.blockSize;
+    uint8_t* out = body + FileSignatureAckSchema::SIZE;
+
+    for (uint32_t index = query.startBlock; index < blockCount && ack.count < FILE_SIGNATURES_PER_ACK; index++) {
+        uint32_t offset = index * query.blockSize;
+        uint32_t remaining = fileSize - offset < query.blockSize ? fileSize - offset : query.blockSize;
+
+        RollingChecksum weak;
+        Sha256 strong;
+        uint8_t chunk[FILE_COPY_CHUNK];
+        while (remaining > 0) {
+            size_t n = remaining < FILE_COPY_CHUNK ? remaining : FILE_COPY_CHUNK;
+            n = store->readCurrent(offset, chunk, n);
+            if (n == 0) break;
+            weak.update(chunk, n);
+            strong.update(chunk, n);
+            offset += static_cast<uint32_t>(n);
+            remaining -= static_cast<uint32_t>(n);
+        }
+
+        uint8_t digest[Sha256::DIGEST_SIZE];
+        strong.finish(digest);
+        FileBlockSignature signature;
+        signature.weak = weak.value();
+        memcpy(signature.strong, digest, FILE_STRONG_SIGNATURE_SIZE);
+        out += FileBlockSignatureSchema::serialize(signature, out, FileBlockSignatureSchema::SIZE);
+        ack.count++;
+    }
+
+    FileSignatureAckSchema::serialize(ack, body, FileSignatureAckSchema::SIZE);
+    sendFileReply(receiverId, response, static_cast<size_t>(out - body));
+}
+
+// 세션마다 요청 하나에 응답 하나를 바로 보내므로 (송신 측은 ACK 를 받아야 다음 블록 전송)
+// 여러 세션의 프레임은 도착 순서대로 번갈아 처리되고, 한 세션이 다른 세션의 응답을 밀어내지 않음
+COM_PROTOCOL_ENGINE_TEMPLATE
+void COM_PROTOCOL_ENGINE::handleFileReceive(uint16_t senderId, uint8_t* payload, size_t length) {
+    if (length < 1) return;     // REQUEST_RECEIVE 는 길이로 선택 필드를 구분
+
+    // 세션 형식 : SessionId 를 떼어 내고 기존 형식으로 맞춤 (payload 는 이 프레임 전용 버퍼)
+    fileReplyFramed_ = (payload[0] & FILE_STAGE_SESSION_FLAG) != 0;
+    fileReplySession_ = FILE_DEFAULT_SESSION;
+    if (fileReplyFramed_) {
+        if (length < 1 + FILE_SESSION_PREFIX_SIZE) return;
+        fileReplySession_ = payload[1];
+        payload[1] = static_cast<uint8_t>(payload[0] & ~FILE_STAGE_SESSION_FLAG);
+        payload += FILE_SESSION_PREFIX_SIZE;
+        length -= FILE_SESSION_PREFIX_SIZE;
+    }
+    const uint8_t sessionId = fileReplySession_;
+
+    uint32_t now = tick_->getTickCount();
+    expireFileSessions(now);
+    FileTransferContext* session = findFileSession(senderId, sessionId);
+    if (session) session->lastActivity = now;
+
+    FileTransferStage stage = static_cast<FileTransferStage>(payload[0]);
+
+    switch (stage) {
+        case FileTransferStage::REQUEST_RECEIVE: {
+            // 파일 수신 요청 처리 (FileId, ContentHash 는 선택)
+            FileRequestReceiveMessage request;
+            request.fileId = 0;
+            request.codec = FileCodec::NONE;
+            bool hasContentHash = FileRequestReceiveCodecSchema::deserialize(payload, length, request) ||
+                                  FileRequestReceiveHashSchema::deserialize(payload, length, request);
+            if (!hasContentHash &&
+                !FileRequestReceiveIdSchema::deserialize(payload, length, request) &&
+                !FileRequestReceiveSchema::deserialize(payload, length, request)) return;  // 최소 크기 체크
+
+            // 전부 0 인 해시는 "해시 없음" (압축만 협상하는 요청)
+            if (hasContentHash) {
+                uint8_t bits = 0;
+                for (size_t i = 0; i < FILE_CONTENT_HASH_SIZE; i++) bits |= request.contentHash[i];
+                hasContentHash = bits != 0;
+            }
+            FileCodec codec = request.codec == FileCodec::LZSS ? FileCodec::LZSS : FileCodec::NONE;
+
+            uint32_t fileSize = request.fileSize;
+            IFileStore* store = derived().selectFileStore(senderId, sessionId);
+
+            // 같은 내용을 이미 보유 : 진행 중인 수신과 체크포인트는 건드리지 않고 데이터 단계 생략
+            uint32_t currentSize;
+            uint8_t currentHash[FILE_CONTENT_HASH_SIZE];
+            if (hasContentHash && store != nullptr &&
+                store->currentContent(currentSize, currentHash) && currentSize == fileSize &&
+                memcmp(currentHash, request.contentHash, FILE_CONTENT_HASH_SIZE) == 0) {
+                sendFileReceiveAck(senderId, stage, FILE_ACK_ALREADY_PRESENT);
+                return;
+            }
+
+            if (fileSize > MAX_FILE_SIZE) {
+                sendFileReceiveAck(senderId, stage, FILE_ACK_FAILURE);
+                return;
+            }
+            session = openFileSession(senderId, sessionId, store);
+            if (!session) {
+                sendFileReceiveAck(senderId, stage, FILE_ACK_BUSY);
+                return;
+            }
+            resetFileTransferContext(*session);
+            if (store != nullptr && !store->begin(fileSize)) {
+                sendFileReceiveAck(senderId, stage, FILE_ACK_FAILURE);
+                return;
+            }
+            if (store != nullptr) store->clearCheckpoint();
+
+            session->senderId = senderId;
+            session->sessionId = sessionId;
+            session->store = store;
+            session->lastActivity = now;
+            session->fileSize = fileSize;
+            session->fileId = request.fileId;
+            session->hasContentHash = hasContentHash;
+            if (hasContentHash) memcpy(session->contentHash, request.contentHash, FILE_CONTENT_HASH_SIZE);
+            session->codec = codec;
+            session->isTransferring = true;
+
+            if (codec != FileCodec::NONE) {
+                sendFileReceiveBlockAck(senderId, stage, FILE_ACK_SUCCESS, static_cast<uint32_t>(codec));
+            } else {
+                sendFileReceiveAck(senderId, stage, FILE_ACK_SUCCESS);
+            }
+            break;
+        }
+
+        case FileTransferStage::RESUME_QUERY: {
+            // 같은 파일(FileId, FileSize)의 중단된 수신이 있으면 다음 블록 번호로 응답
+            FileRequestReceiveMessage query;
+            if (!FileRequestReceiveIdSchema::deserialize(payload, length, query)) return;
+
+            bool resumable = query.fileId != 0 && session != nullptr &&
+                             session->fileId == query.fileId && session->fileSize == query.fileSize;
+
+            IFileStore* store = derived().selectFileStore(senderId, sessionId);
+            FileCheckpoint checkpoint;
+            if (!resumable && query.fileId != 0 && store != nullptr &&
+                store->loadCheckpoint(checkpoint) &&
+                checkpoint.fileId == query.fileId && checkpoint.fileSize == query.fileSize) {
+                // 재시작 또는 세션 타임아웃 후 : 체크포인트 이후 수신분은 다시 받음
+                session = openFileSession(senderId, sessionId, store);
+                if (!session) {
+                    sendFileReceiveAck(senderId, stage, FILE_ACK_BUSY);
+                    return;
+                }
+                resetFileTransferContext(*session);
+                session->senderId = senderId;
+                session->sessionId = sessionId;
+                session->store = store;
+                session->lastActivity = now;
+                session->fileSize = checkpoint.fileSize;
+                session->fileId = checkpoint.fileId;
+                session->currentIndex = checkpoint.nextBlock;
+                session->receivedSize = checkpoint.receivedSize;
+                session->checksum = checkpoint.checksum;
+                session->codec = static_cast<FileCodec>(checkpoint.codec);
+                session->hasContentHash = checkpoint.hasContentHash;
+                memcpy(session->contentHash, checkpoint.contentHash, FILE_CONTENT_HASH_SIZE);
+                session->isTransferring = true;
+                resumable = true;
+            }
+
+            sendFileReceiveBlockAck(senderId, stage, resumable ? FILE_ACK_SUCCESS : FILE_ACK_FAILURE,
+                                    resumable ? session->currentIndex : 0);
+            break;
+        }
+
+        case FileTransferStage::SIGNATURE_QUERY: {
+            FileSignatureQueryMessage query;
+            if (!FileSignatureQuerySchema::deserialize(payload, length, query)) return;
+            sendFileSignatures(senderId, derived().selectFileStore(senderId, sessionId), query);
+            break;
+        }
+
+        case FileTransferStage::RECEIVING_DATA:
+        case FileTransferStage::DELTA_COPY: {
+            if (!session) {
+                sendFileReceiveAck(senderId, stage, FILE_ACK_FAILURE);
+                return;
+            }
+
+            FileDataHeaderMessage block;
+            if (!FileDataHeaderSchema::deserialize(payload, length, block)) {
+                sendFileReceiveAck(senderId, stage, FILE_ACK_FAILURE);
+                return;
+            }
+
+            // 블록 번호는 데이터/복사 명령이 함께 사용하는 순서 번호
+            uint32_t blockIndex = block.blockIndex;
+            if (blockIndex < session->currentIndex) {
+                // 중복 블록 (ACK 유실 후 재전송) : 이미 반영했으므로 성공으로만 응답
+                sendFileReceiveBlockAck(senderId, stage, FILE_ACK_SUCCESS, blockIndex);
+                return;
+            }
+            if (blockIndex != session->currentIndex) {
+                sendFileReceiveBlockAck(senderId, stage, FILE_ACK_FAILURE, blockIndex);
+                return;
+            }
+
+            bool written;
+            if (stage == FileTransferStage::RECEIVING_DATA) {
+                // 데이터 처리 : stage(1) + blockIndex(4) 이후
+                // 프레임 CRC 는 압축된 바이트를, 누적 체크섬은 복원된 데이터를 검증
+                const uint8_t* data = payload + FileDataHeaderSchema::SIZE;
+                size_t dataSize = length - FileDataHeaderSchema::SIZE;
+                written = session->codec == FileCodec::LZSS ? decompressFileData(*session, data, dataSize)
+                                                            : appendFileData(*session, data, dataSize);
+            } else {
+                FileDeltaCopyMessage copy;
+                written = FileDeltaCopySchema::deserialize(payload, length, copy) &&
+                          copyCurrentFile(*session, copy.offset, copy.length);
+            }
+            if (!written) {
+                sendFileReceiveBlockAck(senderId, stage, FILE_ACK_FAILURE, blockIndex);
+                return;
+            }
+            session->currentIndex++;
+
+            if (++session->blocksSinceCheckpoint >= CHECKPOINT_INTERVAL_BLOCKS) {
+                saveFileCheckpoint(*session);
+            }
+
+            sendFileReceiveBlockAck(senderId, stage, FILE_ACK_SUCCESS, blockIndex);
+            break;
+        }
+
+        case FileTransferStage::VERIFY_CHECKSUM: {
+            if (!session) {
+                sendFileReceiveAck(senderId, stage, FILE_ACK_FAILURE);
+                return;
+            }
+
+            FileVerifyChecksumMessage verify;
+            if (!FileVerifyChecksumSchema::deserialize(payload, length, verify)) {
+                sendFileReceiveAck(senderId, stage, FILE_ACK_FAILURE);
+                return;
+            }
+            bool checksumMatch = (verify.checksum == session->checksum) &&
+                                 (session->receivedSize == session->fileSize);
+            IFileStore* store = session->store;
+            if (store != nullptr) {
+                if (checksumMatch) checksumMatch = store->commit(session->hasContentHash ? session->contentHash : nullptr);
+                else store->abort();
+                store->clearCheckpoint();
+            }
+
+            sendFileReceiveAck(senderId, stage, checksumMatch ? FILE_ACK_SUCCESS : FILE_ACK_FAILURE);
+
+            // 불일치 시에도 수신을 종료 (송신 측은 REQUEST_RECEIVE 부터 다시 시작)
+            resetFileTransferContext(*session);
+            break;
+        }
+
+        default:
+            break;
+    }
+}
+
+COM_PROTOCOL_ENGINE_TEMPLATE
+void COM_PROTOCOL_ENGINE::sendFileReply(uint16_t receiverId, uint8_t* response, size_t length) {
+    if (!fileReplyFramed_) {
+        sendData(receiverId, my_id_, CMD_FILE_RECEIVE_ACK, response + FILE_SESSION_PREFIX_SIZE, length);
+        return;
+    }
+    // [Stage | FLAG, SessionId, 나머지]
+    response[0] = static_cast<uint8_t>(response[1] | FILE_STAGE_SESSION_FLAG);
+    response[1] = fileReplySession_;
+    sendData(receiverId, my_id_, CMD_FILE_RECEIVE_ACK, response, length + FILE_SESSION_PREFIX_SIZE);
+}
+
+COM_PROTOCOL_ENGINE_TEMPLATE
+void COM_PROTOCOL_ENGINE::sendFileReceiveAck(uint16_t receiverId, FileTransferStage stage,
+                                             uint8_t result, uint32_t data) {
+    FileReceiveAckMessage ack;
+    ack.stage = stage;
+    ack.success = result;
+    ack.blockIndex = data;
+
+    uint8_t response[FILE_SESSION_PREFIX_SIZE + FileReceiveAckBlockSchema::SIZE];
+    if (data != 0) {
+        FileReceiveAckBlockSchema::serialize(ack, response + FILE_SESSION_PREFIX_SIZE, FileReceiveAckBlockSchema::SIZE);
+        sendFileReply(receiverId, response, FileReceiveAckBlockSchema::SIZE);
+    } else {
+        FileReceiveAckSchema::serialize(ack, response + FILE_SESSION_PREFIX_SIZE, FileReceiveAckSchema::SIZE);
+        sendFileReply(receiverId, response, FileReceiveAckSchema::SIZE);
+    }
+}
+
+COM_PROTOCOL_ENGINE_TEMPLATE
+void COM_PROTOCOL_ENGINE::sendFileReceiveBlockAck(uint16_t receiverId, FileTransferStage stage,
+                                                  uint8_t result, uint32_t blockIndex) {
+    FileReceiveAckMessage ack;
+    ack.stage = stage;
+    ack.success = result;
+    ack.blockIndex = blockIndex;
+
+    uint8_t response[FILE_SESSION_PREFIX_SIZE + FileReceiveAckBlockSchema::SIZE];
+    FileReceiveAckBlockSchema::serialize(ack, response + FILE_SESSION_PREFIX_SIZE, FileReceiveAckBlockSchema::SIZE);
+    sendFileReply(receiverId, response, FileReceiveAckBlockSchema::SIZE);
+}
+
+// ping 요청 함수 구현
+COM_PROTOCOL_ENGINE_TEMPLATE
+void COM_PROTOCOL_ENGINE::sendPing(uint16_t targetId) {
+    uint8_t pingPayload[] = "PING";
+    sendData(targetId, my_id_, CMD_PING, pingPayload, 4);
+}
+
+COM_PROTOCOL_ENGINE_TEMPLATE
+void COM_PROTOCOL_ENGINE::sendIdScan(uint16_t targetId){
+    IdScanMessage scan;
+    scan.id = targetId;         // 스캔할 ID : 수신 측은 자신의 ID 와 같을 때만 응답
+    uint8_t idScanPayload[IdScanSchema::SIZE];
+    IdScanSchema::serialize(scan, idScanPayload);
+    sendData(targetId, my_id_, CMD_ID_SCAN, idScanPayload, IdScanSchema::SIZE);
+}
+
+// 동기화 요청 함수
+COM_PROTOCOL_ENGINE_TEMPLATE
+void COM_PROTOCOL_ENGINE::sendSync() {
+    SyncMessage sync;
+    sync.timestamp = tick_->getTickCount();
+    sync.authToken = 0xABCD;
+
+    uint8_t syncPayload[SyncSchema::SIZE];
+    SyncSchema::serialize(sync, syncPayload);
+    sendData(0xFFFF, my_id_, CMD_SYNC, syncPayload, SyncSchema::SIZE);
+}
+
+// 동기화 응답 함수
+COM_PROTOCOL_ENGINE_TEMPLATE
+void COM_PROTOCOL_ENGINE::sendSyncAck(uint16_t targetId, uint32_t timestamp) {
+    SyncMessage sync;
+    sync.timestamp = timestamp;
+    sync.authToken = 0xABCD;
+
+    uint8_t syncAckPayload[SyncSchema::SIZE];
+    SyncSchema::serialize(sync, syncAckPayload);
+    sendData(targetId, my_id_, CMD_SYNC_ACK, syncAckPayload, SyncSchema::SIZE);
+}
+
+// 링크 속도 변경 요청 : ACK 수신 후 serviceLinkSpeed() 가 전환과 핑 버스트를 진행
+COM_PROTOCOL_ENGINE_TEMPLATE
+bool COM_PROTOCOL_ENGINE::requestLinkSpeed(uint16_t targetId, uint32_t baudRate) {
+    if (!serial_ || !sessionSynced_ || targetId == 0xFFFF || baudRate == 0) return false;
+    if (link_.state != LinkSpeedState::IDLE && link_.state != LinkSpeedState::ACTIVE) return false;
+
+    uint32_t currentBaudRate = serialBaudRate();
+    if (currentBaudRate == 0 || currentBaudRate == baudRate || !serialSupportsBaudRate(baudRate)) return false;
+
+    link_.peerId = targetId;
+    link_.targetBaudRate = baudRate;
+    if (link_.state == LinkSpeedState::IDLE) link_.fallbackBaudRate = currentBaudRate;
+    link_.state = LinkSpeedState::PROPOSED;
+    link_.deadline = tick_->getTickCount() + LINK_RESPONSE_TIMEOUT_MS;
+    sendLinkSpeed(LinkSpeedStage::PROPOSE);
+    return true;
+}
+
+COM_PROTOCOL_ENGINE_TEMPLATE
+void COM_PROTOCOL_ENGINE::sendLinkSpeed(LinkSpeedStage stage) {
+    LinkSpeedMessage message;
+    message.stage = stage;
+    message.baudRate = link_.targetBaudRate;
+
+    uint8_t payload[LinkSpeedSchema::SIZE];
+    LinkSpeedSchema::serialize(message, payload);
+    sendData(link_.peerId, my_id_, CMD_LINK_SPEED, payload, LinkSpeedSchema::SIZE);
+}
+
+// 응답 측 : 제안은 현재 속도로 ACK 후 LINK_SWITCH_DELAY_MS 뒤에 전환, CONFIRM 은 새 속도에서 확정
+COM_PROTOCOL_ENGINE_TEMPLATE
+void COM_PROTOCOL_ENGINE::handleLinkSpeed(uint16_t senderId, uint8_t* payload, size_t length) {
+    LinkSpeedMessage request;
+    if (!LinkSpeedSchema::deserialize(payload, length, request)) return;
+    if (handlerReceiverId_ != my_id_) return;  // 브로드캐스트/그룹 전환은 지원하지 않음 (응답 충돌)
+
+    LinkSpeedAckMessage ack;
+    ack.stage = request.stage;
+    ack.accepted = 0;
+    ack.baudRate = request.baudRate;
+
+    uint32_t now = tick_->getTickCount();
+
+    if (request.stage == LinkSpeedStage::PROPOSE) {
+        uint32_t currentBaudRate = serialBaudRate();
+        bool busy = link_.state != LinkSpeedState::IDLE && link_.state != LinkSpeedState::ACTIVE;
+        // 전송이 설정할 수 없는 속도는 ACK 전에 거절 (수락 후 전환 실패면 CONFIRM 타임아웃까지 링크가 끊김)
+        if (sessionSynced_ && !busy && currentBaudRate != 0 && serialSupportsBaudRate(request.baudRate)) {
+            ack.accepted = 1;
+            link_.peerId = senderId;
+            link_.targetBaudRate = request.baudRate;
+            if (link_.state == LinkSpeedState::IDLE) link_.fallbackBaudRate = currentBaudRate;
+            link_.state = LinkSpeedState::SWITCH_PENDING;
+            link_.deadline = now + LINK_SWITCH_DELAY_MS;
+        }
+    } else if (request.stage == LinkSpeedStage::CONFIRM) {
+        if (link_.state == LinkSpeedState::AWAIT_CONFIRM && senderId == link_.peerId &&
+            request.baudRate == link_.targetBaudRate) {
+            ack.accepted = 1;
+            link_.state = LinkSpeedState::ACTIVE;
+            restartLinkWindow(now);
+        } else if (link_.state == LinkSpeedState::ACTIVE && senderId == link_.peerId &&
+                   request.baudRate == link_.targetBaudRate) {
+            ack.accepted = 1;   // CONFIRM ACK 손실 후 재전송
+        }
+    } else {
+        return;
+    }
+
+    uint8_t response[LinkSpeedAckSchema::SIZE];
+    LinkSpeedAckSchema::serialize(ack, response);
+    sendData(senderId, my_id_, CMD_LINK_SPEED_ACK, response, LinkSpeedAckSchema::SIZE);
+}
+
+// 요청 측 : ACK 와 핑 버스트의 PONG 처리
+COM_PROTOCOL_ENGINE_TEMPLATE
+void COM_PROTOCOL_ENGINE::handleLinkSpeedResponse(uint16_t senderId, uint16_t cmd, uint8_t* payload, size_t length) {
+    if (cmd == CMD_SYNC_ACK) {
+        SyncMessage sync;
+        if (SyncSchema::deserialize(payload, length, sync) && sync.authToken == 0xABCD) {
+            sessionSynced_ = true;
+        }
+        return;
+    }
+    if (link_.state == LinkSpeedState::IDLE || senderId != link_.peerId) return;
+
+    uint32_t now = tick_->getTickCount();
+
+    if (cmd == CMD_PONG && link_.state == LinkSpeedState::PROBING && link_.pingOutstanding) {
+        link_.pongsReceived++;
+        link_.pingOutstanding = false;
+        link_.deadline = now;   // 다음 핑은 즉시
+        return;
+    }
+    if (cmd != CMD_LINK_SPEED_ACK) return;
+
+    LinkSpeedAckMessage ack;
+    if (!LinkSpeedAckSchema::deserialize(payload, length, ack) || ack.baudRate != link_.targetBaudRate) return;
+
+    if (link_.state == LinkSpeedState::PROPOSED && ack.stage == LinkSpeedStage::PROPOSE) {
+        if (!ack.accepted) {
+            settleLinkSpeed(now);
+            return;
+        }
+        if (!setSerialBaudRate(link_.targetBaudRate)) {
+            // 응답 측은 전환을 예약했으므로 양쪽 모두 기본 속도로 (응답 측은 CONFIRM 타임아웃으로 복귀)
+            revertLinkSpeed();
+            return;
+        }
+        link_.state = LinkSpeedState::PROBING;
+        link_.pingsSent = 0;
+        link_.pongsReceived = 0;
+        link_.pingOutstanding = false;
+        link_.deadline = now + LINK_SWITCH_DELAY_MS + LINK_SETTLE_MS;
+    } else if (link_.state == LinkSpeedState::CONFIRMING && ack.stage == LinkSpeedStage::CONFIRM) {
+        if (!ack.accepted) {
+            revertLinkSpeed();
+            return;
+        }
+        link_.state = LinkSpeedState::ACTIVE;
+        restartLinkWindow(now);
+    }
+}
+
+COM_PROTOCOL_ENGINE_TEMPLATE
+void COM_PROTOCOL_ENGINE::serviceLinkSpeed(uint32_t currentTime) {
+    switch (link_.state) {
+        case LinkSpeedState::IDLE:
+            break;
+
+        case LinkSpeedState::PROPOSED:
+            if (deadlinePassed(currentTime, link_.deadline)) {
+                settleLinkSpeed(currentTime);   // 응답 없음 : 현재 속도 유지
+            }
+            break;
+
+        case LinkSpeedState::SWITCH_PENDING:
+            if (deadlinePassed(currentTime, link_.deadline)) {
+                if (setSerialBaudRate(link_.targetBaudRate)) {
+                    link_.state = LinkSpeedState::AWAIT_CONFIRM;
+                    link_.deadline = currentTime + LINK_CONFIRM_TIMEOUT_MS;
+                } else {
+                    // 요청 측은 핑 버스트 실패로 기본 속도로 복귀
+                    revertLinkSpeed();
+                }
+            }
+            break;
+
+        case LinkSpeedState::AWAIT_CONFIRM:
+        case LinkSpeedState::CONFIRMING:
+            if (deadlinePassed(currentTime, link_.deadline)) {
+                revertLinkSpeed();
+            }
+            break;
+
+        case LinkSpeedState::PROBING:
+            if (!deadlinePassed(currentTime, link_.deadline)) break;
+            link_.pingOutstanding = false;  // 응답 없는 핑은 손실로 처리
+            if (link_.pingsSent < LINK_PING_BURST) {
+                link_.pingsSent++;
+                link_.pingOutstanding = true;
+                link_.deadline = currentTime + LINK_RESPONSE_TIMEOUT_MS;
+                sendPing(link_.peerId);
+            } else if (link_.pongsReceived >= LINK_PING_BURST_MIN_OK) {
+                link_.state = LinkSpeedState::CONFIRMING;
+                link_.deadline = currentTime + LINK_RESPONSE_TIMEOUT_MS;
+                sendLinkSpeed(LinkSpeedStage::CONFIRM);
+            } else {
+                revertLinkSpeed();
+            }
+            break;
+
+        case LinkSpeedState::ACTIVE:
+            if (deadlinePassed(currentTime, link_.windowStart + LINK_ERROR_WINDOW_MS)) {
+                uint32_t errors = link_.windowErrors +
+                                  (linkRxErrors_.load(std::memory_order_relaxed) - link_.windowRxErrors);
+                uint32_t frames = linkRxFrames_.load(std::memory_order_relaxed) - link_.windowRxFrames;
+                if (errors >= LINK_ERROR_SPIKE_THRESHOLD && errors * 100 >= frames * LINK_ERROR_SPIKE_PERCENT) {
+                    revertLinkSpeed();
+                    break;
+                }
+                restartLinkWindow(currentTime);
+            }
+            break;
+    }
+}
+
+// 기본 속도로 복귀 (상대도 확인 타임아웃 또는 에러 급증으로 같은 속도로 복귀)
+COM_PROTOCOL_ENGINE_TEMPLATE
+void COM_PROTOCOL_ENGINE::revertLinkSpeed() {
+    if (link_.fallbackBaudRate != 0 && serialBaudRate() != link_.fallbackBaudRate) {
+        setSerialBaudRate(link_.fallbackBaudRate);
+    }
+    link_.state = LinkSpeedState::IDLE;
+    link_.fallbackBaudRate = 0;
+    link_.windowErrors = 0;
+}
+
+// 협상이 무산된 경우 : 이미 협상된 속도를 쓰고 있으면 ACTIVE 로, 아니면 IDLE 로
+COM_PROTOCOL_ENGINE_TEMPLATE
+void COM_PROTOCOL_ENGINE::settleLinkSpeed(uint32_t currentTime) {
+    if (link_.fallbackBaudRate != 0 && serialBaudRate() != link_.fallbackBaudRate) {
+        link_.state = LinkSpeedState::ACTIVE;
+    } else {
+        link_.state = LinkSpeedState::IDLE;
+        link_.fallbackBaudRate = 0;
+    }
+    restartLinkWindow(currentTime);
+}
+
+// 에러 감시 창 시작 : 파싱 단계의 누적값을 기준으로 기록
+COM_PROTOCOL_ENGINE_TEMPLATE
+void COM_PROTOCOL_ENGINE::restartLinkWindow(uint32_t now) {
+    link_.windowStart = now;
+    link_.windowErrors = 0;
+    link_.windowRxErrors = linkRxErrors_.load(std::memory_order_relaxed);
+    link_.windowRxFrames = linkRxFrames_.load(std::memory_order_relaxed);
+}
+
+#undef COM_PROTOCOL_ENGINE
+#undef COM_PROTOCOL_ENGINE_TEMPLATE
+
+#endif /* COM_PROTOCOL_CLASS_COM_PROTOCOL_ENGINE_H_ */
@@ -0,0 +1,70 @@
+/*
+ * com_protocol_group.cpp
+ *
+ *  CMD_GROUP 노드 그룹 소속 설정 (호스트 빌드 전용)
+ */
+#include "com_protocol_group.h"
+
+#if defined(__cpp_impl_coroutine) && !defined(USE_HAL_DRIVER)
+#include <string.h>
+
+namespace {
+
+bool parseGroupAck(const RequestResult& response, GroupOp expected, GroupAckMessage& ack) {
+    if (!response.ok || response.length < GroupAckSchema::SIZE + GROUP_BITMAP_SIZE) return false;
+    if (!GroupAckSchema::deserialize(response.payload, response.length, ack)) return false;
+    return ack.op == expected;
+}
+
+}  // namespace
+
+// co_await 지점을 하나로 두어 코루틴 프레임을 ConversationFramePool 블록 안에 유지
+Conversation configureGroups(AsyncCom_Protocol& protocol, const uint16_t* targets, size_t count, GroupOp op,
+                             const uint16_t* groups, size_t groupCount, NodeGroups* nodes,
+                             GroupConfigResult& result, uint32_t timeoutMs, uint8_t retries) {
+    result = GroupConfigResult();
+    if (groupCount > GROUP_MAX_IDS) {
+        result.failed = static_cast<uint32_t>(count);
+        result.done = true;
+        co_return;
+    }
+
+    // 모든 노드에 같은 요청
+    uint8_t frame[GroupRequestSchema::SIZE + GROUP_MAX_IDS * 2];
+    GroupRequestMessage request;
+    request.op = op;
+    request.count = static_cast<uint8_t>(groupCount);
+    GroupRequestSchema::serialize(request, frame, GroupRequestSchema::SIZE);
+    for (size_t i = 0; i < groupCount; i++) {
+        storeBigEndian<uint16_t>(frame + GroupRequestSchema::SIZE + i * 2, groups[i]);
+    }
+    const size_t frameLength = GroupRequestSchema::SIZE + groupCount * 2;
+
+    for (size_t node = 0; node < count; node++) {
+        const RequestResult& response = co_await protocol.request(targets[node], AsyncCom_Protocol::CMD_GROUP,
+                                                                  frame, frameLength, timeoutMs, retries);
+        result.retransmits += response.retransmits;
+
+        GroupAckMessage ack;
+        bool answered = parseGroupAck(response, op, ack);
+        bool ok = answered && ack.status == GROUP_OK;
+        if (nodes) {
+            nodes[node] = NodeGroups();
+            nodes[node].nodeId = targets[node];
+            nodes[node].ok = ok;
+            if (answered) {
+                nodes[node].status = ack.status;
+                nodes[node].members = ack.members;
+                memcpy(nodes[node].bitmap, response.payload + GroupAckSchema::SIZE, GROUP_BITMAP_SIZE);
+            }
+        }
+        if (ok) {
+            result.nodes++;
+        } else {
+            result.failed++;
+        }
+    }
+    result.done = true;
+}
+
+#endif
@@ -0,0 +1,59 @@
+/*
+ * com_protocol_group.h
+ *
+ *  CMD_GROUP 노드 그룹 소속 설정 (호스트 빌드 전용, -std=c++20)
+ *
+ *  uint16_t legs[] = { 3, 4, 7, 8 };
+ *  uint16_t group = 0xFF01;
+ *  GroupConfigResult result;
+ *  configureGroups(protocol, legs, 4, GroupOp::JOIN, &group, 1, nullptr, result);
+ *  while (!result.done) {
+ *      protocol.processReceivedData();
+ *      protocol.poll();
+ *  }
+ *  protocol.sendData(0xFF01, myId, AsyncCom_Protocol::CMD_PLAY_CONTROL, &play, 1);    // 프레임 하나로 4 노드 제어
+ *
+ *  - 노드마다 같은 요청을 유니캐스트로 보내고 응답의 소속 비트맵을 받음 (버스에서 응답이 겹치지 않도록 한 번에 한 노드)
+ *  - 그룹 주소로 보낸 요청에는 노드가 응답하지 않으므로 request() 대신 sendData() 로 보냄
+ *    (응답 캐시를 켠 노드에는 같은 시퀀스 번호로 여러 번 보내 유실에 대비할 수 있음)
+ *  - 소속은 노드 RAM 에만 있으므로 노드가 재부팅하면 다시 설정
+ *  - targets, groups, nodes 는 설정이 끝날 때까지 유효해야 함
+ */
+
+#ifndef COM_PROTOCOL_CLASS_COM_PROTOCOL_GROUP_H_
+#define COM_PROTOCOL_CLASS_COM_PROTOCOL_GROUP_H_
+
+#include "com_protocol_async.h"
+
+#if defined(__cpp_impl_coroutine) && !defined(USE_HAL_DRIVER)
+#include "protocol_messages.h"
+#include "group_membership.h"
+
+struct NodeGroups {
+    uint16_t nodeId = 0;
+    bool ok = false;                // GROUP_OK 응답을 받음
+    uint8_t status = GROUP_OK;      // 응답을 받은 경우 노드의 Status
+    uint8_t members = 0;
+    uint8_t bitmap[GROUP_BITMAP_SIZE] = {};
+
+    bool contains(uint16_t groupId) const {
+        if (!GroupMembership::isGroupId(groupId)) return false;
+        uint8_t index = static_cast<uint8_t>(groupId & 0xFF);
+        return (bitmap[index >> 3] >> (index & 7)) & 1;
+    }
+};
+
+struct GroupConfigResult {
+    bool done = false;
+    uint32_t nodes = 0;             // GROUP_OK 응답을 받은 노드 수
+    uint32_t failed = 0;            // 응답 없음 또는 거부
+    uint32_t retransmits = 0;
+};
+
+// groupCount 최대 GROUP_MAX_IDS, nodes 는 nullptr 가능 (count 개)
+Conversation configureGroups(AsyncCom_Protocol& protocol, const uint16_t* targets, size_t count, GroupOp op,
+                             const uint16_t* groups, size_t groupCount, NodeGroups* nodes,
+                             GroupConfigResult& result, uint32_t timeoutMs = 100, uint8_t retries = 2);
+
+#endif
+#endif /* COM_PROTOCOL_CLASS_COM_PROTOCOL_GROUP_H_ */
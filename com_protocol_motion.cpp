@@ -0,0 +1,193 @@
+/*
+ * com_protocol_motion.cpp
+ *
+ *  CMD_MOTION_STREAM 모션 스트리밍 재생 (호스트 빌드 전용)
+ */
+#include "com_protocol_motion.h"
+
+#if defined(__cpp_impl_coroutine) && !defined(USE_HAL_DRIVER)
+#include <string.h>
+
+namespace {
+
+enum class MotionStep : uint8_t {
+    OPEN,
+    DATA,
+    END,
+    FINISH
+};
+
+bool parseMotionAck(const RequestResult& response, MotionStreamStage expected, MotionStreamAckMessage& ack) {
+    if (!response.ok) return false;
+    if (!MotionStreamAckSchema::deserialize(response.payload, response.length, ack)) return false;
+    return ack.stage == expected;
+}
+
+MotionStreamStage stageOf(MotionStep step) {
+    switch (step) {
+        case MotionStep::OPEN: return MotionStreamStage::OPEN;
+        case MotionStep::DATA: return MotionStreamStage::DATA;
+        case MotionStep::END: return MotionStreamStage::END;
+        case MotionStep::FINISH: break;
+    }
+    return MotionStreamStage::STATUS;
+}
+
+// DATA 한 번에 담을 수 있는 프레임 수
+uint32_t framesPerRequest(uint8_t frameBytes) {
+    uint32_t fit = static_cast<uint32_t>((MOTION_MAX_PAYLOAD - MotionDataSchema::SIZE) / (4 + frameBytes));
+    return fit > UINT8_MAX ? UINT8_MAX : fit;
+}
+
+// DATA : next 부터 credit 과 페이로드 크기 안에서 최대한 묶음, 담은 프레임 수는 sent 로 반환
+size_t buildMotionRequest(MotionStep step, const uint32_t* timestamps, const uint8_t* frames, uint32_t count,
+                          uint8_t frameBytes, const MotionStreamOptions& options, uint32_t next, uint32_t credit,
+                          uint8_t* frame, uint32_t& sent) {
+    sent = 0;
+    switch (step) {
+        case MotionStep::OPEN: {
+            MotionOpenMessage open;
+            open.stage = MotionStreamStage::OPEN;
+            open.frameBytes = frameBytes;
+            open.watermark = options.watermark;
+            open.flags = options.autoStart ? MOTION_FLAG_AUTO_START : 0;
+            return MotionOpenSchema::serialize(open, frame, MOTION_MAX_PAYLOAD);
+        }
+        case MotionStep::DATA: {
+            size_t entrySize = 4 + frameBytes;
+            uint32_t fit = framesPerRequest(frameBytes);
+            if (fit > credit) fit = credit;
+            if (fit > count - next) fit = count - next;
+
+            MotionDataMessage data;
+            data.stage = MotionStreamStage::DATA;
+            data.firstIndex = next;
+            data.count = static_cast<uint8_t>(fit);
+            size_t length = MotionDataSchema::serialize(data, frame, MOTION_MAX_PAYLOAD);
+            for (uint32_t i = 0; i < fit; i++) {
+                storeBigEndian<uint32_t>(frame + length, timestamps[next + i]);
+                memcpy(frame + length + 4, frames + static_cast<size_t>(next + i) * frameBytes, frameBytes);
+                length += entrySize;
+            }
+            sent = fit;
+            return length;
+        }
+        case MotionStep::END: {
+            MotionEndMessage end;
+            end.stage = MotionStreamStage::END;
+            end.totalFrames = count;
+            return MotionEndSchema::serialize(end, frame, MOTION_MAX_PAYLOAD);
+        }
+        case MotionStep::FINISH:
+            break;
+    }
+    frame[0] = static_cast<uint8_t>(MotionStreamStage::STATUS);
+    return 1;
+}
+
+// 노드가 재생 위치부터 frames 개를 소비할 때까지 남은 시간 (재생 중이 아니면 pollMs 후 다시 확인)
+uint32_t waitForPlayback(const MotionStreamAckMessage& ack, const uint32_t* timestamps, uint32_t count,
+                         uint32_t frames, uint32_t pollMs) {
+    if (ack.state != MotionStreamState::PLAYING || ack.playIndex >= count) return pollMs;
+    uint32_t last = frames > 0 ? ack.playIndex + frames - 1 : ack.playIndex;
+    if (last >= count) last = count - 1;
+    int32_t remaining = static_cast<int32_t>(timestamps[last] - ack.playheadMs) + 1;
+    return remaining > 0 ? static_cast<uint32_t>(remaining) : 1;
+}
+
+// 요청과 sleep 을 같은 대기 객체 하나로 (코루틴 프레임에 대기 객체가 두 개 생기지 않도록)
+AsyncCom_Protocol::RequestAwaiter requestOrSleep(AsyncCom_Protocol& protocol, uint16_t targetId, uint32_t waitMs,
+                                                 const uint8_t* frame, size_t length,
+                                                 const MotionStreamOptions& options) {
+    if (waitMs > 0) return protocol.sleep(waitMs);
+    return protocol.request(targetId, AsyncCom_Protocol::CMD_MOTION_STREAM, frame, length,
+                            options.timeoutMs, options.retries);
+}
+
+}  // namespace
+
+// co_await 지점을 하나로 두어 코루틴 프레임을 ConversationFramePool 블록 안에 유지 (sleep 도 같은 지점)
+Conversation streamMotion(AsyncCom_Protocol& protocol, uint16_t targetId, const uint32_t* timestamps,
+                          const uint8_t* frames, uint32_t count, uint8_t frameBytes,
+                          MotionStreamOptions options, MotionStreamResult& result) {
+    result = MotionStreamResult();
+    if (frameBytes == 0 || 4 + static_cast<size_t>(frameBytes) > MOTION_MAX_PAYLOAD - MotionDataSchema::SIZE) {
+        result.status = MOTION_UNSUPPORTED;
+        result.done = true;
+        co_return;
+    }
+
+    MotionStep step = MotionStep::OPEN;
+    uint32_t next = 0;
+    uint32_t credit = 0;
+    uint32_t waitMs = 0;
+    uint8_t failures = 0;
+    uint8_t frame[MOTION_MAX_PAYLOAD];
+
+    while (true) {
+        bool sleeping = waitMs > 0;
+        uint32_t sent = 0;
+        size_t length = sleeping ? 0 : buildMotionRequest(step, timestamps, frames, count, frameBytes, options,
+                                                          next, credit, frame, sent);
+
+        const RequestResult& response = co_await requestOrSleep(protocol, targetId, waitMs, frame, length, options);
+        if (sleeping) {
+            waitMs = 0;
+            continue;
+        }
+
+        result.retransmits += response.retransmits;
+        MotionStreamAckMessage ack;
+        if (!parseMotionAck(response, stageOf(step), ack)) {
+            if (++failures > options.maxFailures) break;
+            continue;
+        }
+        failures = 0;
+        result.requests++;
+        result.framesSent += sent;
+        result.state = ack.state;
+        result.underruns = ack.underruns;
+        result.lateFrames = ack.lateFrames;
+        result.missedFrames = ack.missedFrames;
+        result.playheadMs = ack.playheadMs;
+        if (ack.status != MOTION_OK) {
+            result.status = ack.status;
+            break;
+        }
+
+        if (step == MotionStep::OPEN || step == MotionStep::DATA) {
+            // 노드가 연속으로 받은 다음 번호부터 (유실된 DATA 는 여기서 다시 보냄)
+            // 재생 중 여유가 적으면 묶음 하나(또는 버퍼 절반)가 빌 때까지 기다렸다가 보냄 (요청 수 절약)
+            next = ack.nextIndex < count ? ack.nextIndex : count;
+            credit = ack.credit;
+            uint32_t window = credit + (ack.nextIndex - ack.playIndex);
+            uint32_t batch = framesPerRequest(frameBytes);
+            if (batch > window / 2) batch = window / 2;
+            if (batch > count - next) batch = count - next;
+            if (next >= count) {
+                step = MotionStep::END;
+            } else {
+                step = MotionStep::DATA;
+                if (credit == 0 || (credit < batch && ack.state == MotionStreamState::PLAYING)) {
+                    waitMs = waitForPlayback(ack, timestamps, count, batch - credit, options.pollMs);
+                    result.waits++;
+                }
+            }
+        } else if (step == MotionStep::END) {
+            if (!options.waitFinish) {
+                result.ok = true;
+                break;
+            }
+            step = MotionStep::FINISH;
+            waitMs = waitForPlayback(ack, timestamps, count, count - ack.playIndex, options.pollMs);
+        } else if (ack.state == MotionStreamState::FINISHED || ack.state == MotionStreamState::IDLE) {
+            result.ok = ack.state == MotionStreamState::FINISHED;
+            break;
+        } else {
+            waitMs = options.pollMs;
+        }
+    }
+    result.done = true;
+}
+
+#endif
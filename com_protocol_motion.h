@@ -0,0 +1,59 @@
+/*
+ * com_protocol_motion.h
+ *
+ *  CMD_MOTION_STREAM 모션 스트리밍 재생 (호스트 빌드 전용, -std=c++20)
+ *
+ *  MotionStreamResult result;
+ *  streamMotion(protocol, target, timestamps, frames, count, frameBytes, MotionStreamOptions(), result);
+ *  while (!result.done) {
+ *      protocol.processReceivedData();
+ *      protocol.poll();
+ *  }
+ *
+ *  - OPEN 후 노드의 지터 버퍼가 받을 수 있는 만큼(ACK 의 Credit) DATA 로 묶어 보냄
+ *  - autoStart 이면 노드는 워터마크만큼 받는 즉시 재생을 시작하고, 호스트는 재생과 함께 계속 보냄
+ *  - 버퍼가 가득 차면 재생 위치의 프레임이 소비될 시각까지 sleep() 후 다시 보냄
+ *  - 모두 보내면 END, waitFinish 이면 노드가 FINISHED 가 될 때까지 STATUS 로 확인
+ *  - 노드가 보고한 언더런, 늦은 프레임, 건너뛴 프레임 수는 result 에 기록
+ *  - timestamps (프레임마다 ms, 증가 순서) 와 frames (count x frameBytes) 는 끝날 때까지 유효해야 함
+ */
+
+#ifndef COM_PROTOCOL_CLASS_COM_PROTOCOL_MOTION_H_
+#define COM_PROTOCOL_CLASS_COM_PROTOCOL_MOTION_H_
+
+#include "com_protocol_async.h"
+
+#if defined(__cpp_impl_coroutine) && !defined(USE_HAL_DRIVER)
+#include "protocol_messages.h"
+
+struct MotionStreamOptions {
+    uint16_t watermark = 16;        // 재생 시작 전 노드가 받아 둘 프레임 수
+    bool autoStart = true;          // false : PLAY_ONE (CMD_PLAY_CONTROL) 을 받아야 재생
+    bool waitFinish = true;         // END 후 재생 완료까지 대기
+    uint32_t timeoutMs = 200;
+    uint8_t retries = 3;            // 같은 시퀀스 번호로 재전송
+    uint8_t maxFailures = 3;        // 재전송까지 모두 실패한 요청의 연속 허용 횟수
+    uint32_t pollMs = 50;           // 노드가 재생 중이 아닐 때 다시 확인할 간격
+};
+
+struct MotionStreamResult {
+    bool done = false;
+    bool ok = false;
+    uint8_t status = MOTION_OK;     // 노드가 거부한 경우의 MOTION_*
+    MotionStreamState state = MotionStreamState::IDLE;
+    uint32_t framesSent = 0;        // DATA 로 보낸 프레임 (다시 보낸 프레임 포함)
+    uint32_t requests = 0;          // 응답을 받은 요청 수
+    uint32_t waits = 0;             // 버퍼가 가득 차 기다린 횟수
+    uint32_t retransmits = 0;
+    uint16_t underruns = 0;
+    uint16_t lateFrames = 0;
+    uint16_t missedFrames = 0;
+    uint32_t playheadMs = 0;
+};
+
+Conversation streamMotion(AsyncCom_Protocol& protocol, uint16_t targetId, const uint32_t* timestamps,
+                          const uint8_t* frames, uint32_t count, uint8_t frameBytes,
+                          MotionStreamOptions options, MotionStreamResult& result);
+
+#endif
+#endif /* COM_PROTOCOL_CLASS_COM_PROTOCOL_MOTION_H_ */
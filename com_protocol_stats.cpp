@@ -0,0 +1,126 @@
+/*
+ * com_protocol_stats.cpp
+ *
+ *  CMD_STATS 노드 계측 수집 (호스트 빌드 전용)
+ */
+#include "com_protocol_stats.h"
+
+#if defined(__cpp_impl_coroutine) && !defined(USE_HAL_DRIVER)
+
+namespace {
+
+// 본문 길이는 body 로 반환
+bool parseStatsAck(const RequestResult& response, StatsSection expected, StatsAckMessage& ack, size_t& body) {
+    if (!response.ok) return false;
+    if (!StatsAckSchema::deserialize(response.payload, response.length, ack)) return false;
+    body = response.length - StatsAckSchema::SIZE;
+    return ack.section == expected && ack.status == STATS_OK;
+}
+
+// 모르는 필드(노드가 더 새 버전)는 무시, 없는 필드(더 오래된 버전)는 0
+bool applySummary(const uint8_t* body, size_t length, uint8_t count, ProtocolMetrics& metrics) {
+    if (length < static_cast<size_t>(count) * 4) return false;
+    for (size_t i = 0; i < count && i < STATS_SUMMARY_COUNT; i++) {
+        metrics.*STATS_SUMMARY_FIELDS[i] = loadBigEndian<uint32_t>(body + i * 4);
+    }
+    return true;
+}
+
+bool applyCommands(const uint8_t* body, size_t length, uint8_t count, ProtocolMetrics& metrics) {
+    if (length < static_cast<size_t>(count) * STATS_COMMAND_ENTRY) return false;
+    for (uint8_t i = 0; i < count; i++, body += STATS_COMMAND_ENTRY) {
+        if (metrics.commandCount == ProtocolMetrics::MAX_COMMANDS) break;
+        ProtocolMetrics::CommandCounter& counter = metrics.commands[metrics.commandCount++];
+        counter.cmd = loadBigEndian<uint16_t>(body);
+        counter.rx = loadBigEndian<uint32_t>(body + 2);
+        counter.tx = loadBigEndian<uint32_t>(body + 6);
+    }
+    return true;
+}
+
+// 버킷 수가 다르면 (노드 빌드 설정이 다름) 앞쪽만 채우고 남는 버킷은 마지막 버킷에 더함
+void applyBuckets(const uint8_t* values, size_t count, uint32_t* buckets, size_t capacity) {
+    for (size_t i = 0; i < count; i++) {
+        buckets[i < capacity ? i : capacity - 1] += loadBigEndian<uint32_t>(values + i * 4);
+    }
+}
+
+bool applyHistograms(const uint8_t* body, size_t length, ProtocolMetrics& metrics) {
+    if (length < 2) return false;
+    size_t sizeBuckets = body[0];
+    size_t timeBuckets = body[1];
+    if (sizeBuckets == 0 || timeBuckets == 0 || length < 2 + (sizeBuckets * 2 + timeBuckets) * 4) return false;
+    const uint8_t* values = body + 2;
+    applyBuckets(values, sizeBuckets, metrics.rxSize, ProtocolMetrics::SIZE_BUCKETS);
+    applyBuckets(values + sizeBuckets * 4, sizeBuckets, metrics.txSize, ProtocolMetrics::SIZE_BUCKETS);
+    applyBuckets(values + sizeBuckets * 8, timeBuckets, metrics.handlerTime, ProtocolMetrics::TIME_BUCKETS);
+    return true;
+}
+
+}  // namespace
+
+// co_await 지점을 하나로 두어 코루틴 프레임을 ConversationFramePool 블록 안에 유지
+Conversation collectStats(AsyncCom_Protocol& protocol, const uint16_t* targets, size_t count, NodeStats* stats,
+                          StatsCollectResult& result, uint32_t timeoutMs, uint8_t retries) {
+    result = StatsCollectResult();
+
+    size_t node = 0;
+    StatsRequestMessage request;
+    request.section = StatsSection::SUMMARY;
+    request.start = 0;
+    uint8_t frame[StatsRequestSchema::SIZE];
+
+    for (size_t i = 0; i < count; i++) {
+        stats[i] = NodeStats();
+        stats[i].nodeId = targets[i];
+    }
+
+    while (node < count) {
+        StatsRequestSchema::serialize(request, frame);
+        const RequestResult& response = co_await protocol.request(targets[node], AsyncCom_Protocol::CMD_STATS,
+                                                                  frame, sizeof(frame), timeoutMs, retries);
+        result.retransmits += response.retransmits;
+
+        StatsAckMessage ack;
+        size_t bodyLength = 0;
+        bool applied = parseStatsAck(response, request.section, ack, bodyLength);
+        if (applied) {
+            result.frames++;
+            const uint8_t* body = response.payload + StatsAckSchema::SIZE;
+            ProtocolMetrics& metrics = stats[node].metrics;
+            switch (request.section) {
+                case StatsSection::SUMMARY: applied = applySummary(body, bodyLength, ack.count, metrics); break;
+                case StatsSection::COMMANDS: applied = applyCommands(body, bodyLength, ack.count, metrics); break;
+                case StatsSection::HISTOGRAMS: applied = applyHistograms(body, bodyLength, metrics); break;
+            }
+        }
+
+        if (applied && request.section == StatsSection::SUMMARY) {
+            request.section = StatsSection::COMMANDS;
+            request.start = 0;
+            continue;
+        }
+        if (applied && request.section == StatsSection::COMMANDS) {
+            if (ack.next != STATS_NO_NEXT) {
+                request.start = ack.next;
+            } else {
+                request.section = StatsSection::HISTOGRAMS;
+            }
+            continue;
+        }
+
+        // HISTOGRAMS 까지 받았거나 실패 : 다음 노드
+        stats[node].ok = applied;
+        if (applied) {
+            result.nodes++;
+        } else {
+            result.failed++;
+        }
+        node++;
+        request.section = StatsSection::SUMMARY;
+        request.start = 0;
+    }
+    result.done = true;
+}
+
+#endif
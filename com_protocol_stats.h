@@ -0,0 +1,48 @@
+/*
+ * com_protocol_stats.h
+ *
+ *  CMD_STATS 노드 계측 수집 (호스트 빌드 전용, -std=c++20)
+ *
+ *  uint16_t targets[] = { 1, 2, 3 };
+ *  NodeStats stats[3];
+ *  StatsCollectResult result;
+ *  collectStats(protocol, targets, 3, stats, result);
+ *  while (!result.done) {
+ *      protocol.processReceivedData();
+ *      protocol.poll();
+ *  }
+ *
+ *  - 노드마다 SUMMARY, COMMANDS(여러 프레임), HISTOGRAMS 를 차례로 요청 (버스에서 응답이 겹치지 않도록 한 번에 한 노드)
+ *  - 응답하지 않는 노드는 stats[i].ok = false 로 두고 다음 노드로 넘어감
+ *  - 카운터는 노드 부팅 이후 누적값 : 두 번 수집해 차이와 tickMs 간격으로 비율을 계산
+ *  - targets 와 stats 는 수집이 끝날 때까지 유효해야 함
+ */
+
+#ifndef COM_PROTOCOL_CLASS_COM_PROTOCOL_STATS_H_
+#define COM_PROTOCOL_CLASS_COM_PROTOCOL_STATS_H_
+
+#include "com_protocol_async.h"
+
+#if defined(__cpp_impl_coroutine) && !defined(USE_HAL_DRIVER)
+#include "protocol_messages.h"
+#include "protocol_metrics.h"
+
+struct NodeStats {
+    uint16_t nodeId = 0;
+    bool ok = false;                // 세 섹션을 모두 받음
+    ProtocolMetrics metrics = {};
+};
+
+struct StatsCollectResult {
+    bool done = false;
+    uint32_t nodes = 0;             // 모두 받은 노드 수
+    uint32_t failed = 0;
+    uint32_t frames = 0;            // 응답을 받은 요청 수
+    uint32_t retransmits = 0;
+};
+
+Conversation collectStats(AsyncCom_Protocol& protocol, const uint16_t* targets, size_t count, NodeStats* stats,
+                          StatsCollectResult& result, uint32_t timeoutMs = 100, uint8_t retries = 2);
+
+#endif
+#endif /* COM_PROTOCOL_CLASS_COM_PROTOCOL_STATS_H_ */
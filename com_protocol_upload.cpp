@@ -0,0 +1,497 @@
+/*
+ * com_protocol_upload.cpp
+ *
+ *  CMD_FILE_RECEIVE 재개 가능 파일 업로드 (호스트 빌드 전용)
+ */
+#include "com_protocol_upload.h"
+
+#if defined(__cpp_impl_coroutine) && !defined(USE_HAL_DRIVER)
+#include "crc16.h"
+#include "lzss.h"
+#include "protocol_messages.h"
+#include "rolling_checksum.h"
+#include "sha256.h"
+#include <string.h>
+#include <vector>
+
+namespace {
+
+enum class UploadStep : uint8_t {
+    SIGNATURES,
+    RESUME,
+    REQUEST,
+    DATA,
+    VERIFY
+};
+
+// 전송 순서 번호(BlockIndex) 하나에 대응하는 명령 : 새 파일 데이터 또는 현재 파일 구간 복사
+struct UploadInstruction {
+    bool copy;
+    uint32_t offset;        // copy : 현재 파일 오프셋, 아니면 새 파일 오프셋
+    uint32_t length;        // 복원된 길이
+    uint32_t packedOffset;  // 압축 시 UploadPlan::packed 안의 위치
+    uint32_t packedLength;
+};
+
+struct UploadPlan {
+    FileCodec codec;
+    uint32_t packedLimit;           // 압축 블록 최대 크기 (세션 형식은 1 바이트 작음)
+    std::vector<UploadInstruction> instructions;
+    std::vector<uint8_t> packed;    // 압축한 리터럴 블록
+};
+
+// 압축 후 크기가 이 비율을 넘으면 압축하지 않음
+const uint32_t PACKED_LIMIT_PERCENT = 95;
+
+// 세션 형식 응답 [Stage | FLAG, SessionId, ...] 을 기존 형식으로 펼침 (세션 0 은 그대로)
+const uint8_t* fileAckPayload(const RequestResult& response, uint8_t sessionId,
+                              uint8_t (&buffer)[RequestResult::MAX_PAYLOAD], size_t& length) {
+    length = response.length;
+    if (sessionId == FILE_DEFAULT_SESSION) return response.payload;
+    if (length < 1 + FILE_SESSION_PREFIX_SIZE) return nullptr;
+    buffer[0] = static_cast<uint8_t>(response.payload[0] & ~FILE_STAGE_SESSION_FLAG);
+    length -= FILE_SESSION_PREFIX_SIZE;
+    memcpy(buffer + 1, response.payload + 1 + FILE_SESSION_PREFIX_SIZE, length - 1);
+    return buffer;
+}
+
+// 블록 번호가 있는 형식부터 시도
+bool parseFileAck(const RequestResult& response, uint8_t sessionId, FileTransferStage expected,
+                  FileReceiveAckMessage& ack) {
+    if (!response.ok) return false;
+    uint8_t buffer[RequestResult::MAX_PAYLOAD];
+    size_t length;
+    const uint8_t* payload = fileAckPayload(response, sessionId, buffer, length);
+    if (payload == nullptr) return false;
+    ack.blockIndex = 0;
+    if (length >= FileReceiveAckBlockSchema::SIZE) {
+        if (!FileReceiveAckBlockSchema::deserialize(payload, length, ack)) return false;
+    } else if (!FileReceiveAckSchema::deserialize(payload, length, ack)) {
+        return false;
+    }
+    return ack.stage == expected;
+}
+
+FileTransferStage stageOf(UploadStep step, const UploadPlan& plan, uint32_t block) {
+    switch (step) {
+        case UploadStep::SIGNATURES: return FileTransferStage::SIGNATURE_QUERY;
+        case UploadStep::RESUME: return FileTransferStage::RESUME_QUERY;
+        case UploadStep::REQUEST: return FileTransferStage::REQUEST_RECEIVE;
+        case UploadStep::DATA:
+            return plan.instructions[block].copy ? FileTransferStage::DELTA_COPY : FileTransferStage::RECEIVING_DATA;
+        case UploadStep::VERIFY: break;
+    }
+    return FileTransferStage::VERIFY_CHECKSUM;
+}
+
+// 서명 응답 한 쪽을 누적 : -1 형식 오류, 0 다음 쪽 필요, 1 완료
+int appendSignaturePage(const RequestResult& response, uint8_t sessionId, uint16_t blockSize,
+                        std::vector<FileBlockSignature>& signatures, uint32_t& currentSize) {
+    uint8_t buffer[RequestResult::MAX_PAYLOAD];
+    size_t length;
+    const uint8_t* payload = fileAckPayload(response, sessionId, buffer, length);
+    FileSignatureAckMessage page;
+    if (payload == nullptr || !FileSignatureAckSchema::deserialize(payload, length, page) ||
+        page.startBlock != signatures.size() ||
+        length < FileSignatureAckSchema::SIZE + page.count * FileBlockSignatureSchema::SIZE) {
+        return -1;
+    }
+
+    const uint8_t* in = payload + FileSignatureAckSchema::SIZE;
+    for (uint8_t i = 0; i < page.count; i++, in += FileBlockSignatureSchema::SIZE) {
+        FileBlockSignature signature;
+        FileBlockSignatureSchema::deserialize(in, FileBlockSignatureSchema::SIZE, signature);
+        signatures.push_back(signature);
+    }
+    currentSize = page.fileSize;
+
+    size_t blockCount = (page.fileSize + blockSize - 1) / blockSize;
+    if (signatures.size() >= blockCount) return 1;
+    return page.count > 0 ? 0 : -1;
+}
+
+// 압축 시 블록마다 packedLimit 에 들어가는 만큼 (최대 MAX_PACKED_INPUT) 입력을 사용
+void appendLiteral(UploadPlan& plan, const uint8_t* data, uint32_t begin, uint32_t end, uint32_t blockSize) {
+    for (uint32_t offset = begin; offset < end;) {
+        UploadInstruction instruction;
+        instruction.copy = false;
+        instruction.offset = offset;
+        instruction.packedOffset = static_cast<uint32_t>(plan.packed.size());
+        instruction.packedLength = 0;
+
+        if (plan.codec == FileCodec::LZSS) {
+            uint8_t packed[FileUploadOptions::MAX_BLOCK_SIZE];
+            uint32_t input = end - offset < FileUploadOptions::MAX_PACKED_INPUT ?
+                             end - offset : FileUploadOptions::MAX_PACKED_INPUT;
+            size_t consumed = 0;
+            size_t n = LzssEncoder::compress(data + offset, input, packed, plan.packedLimit, consumed);
+            plan.packed.insert(plan.packed.end(), packed, packed + n);
+            instruction.length = static_cast<uint32_t>(consumed);
+            instruction.packedLength = static_cast<uint32_t>(n);
+        } else {
+            instruction.length = end - offset < blockSize ? end - offset : blockSize;
+        }
+        plan.instructions.push_back(instruction);
+        offset += instruction.length;
+    }
+}
+
+void appendCopy(UploadPlan& plan, uint32_t offset, uint32_t length) {
+    std::vector<UploadInstruction>& list = plan.instructions;
+    if (!list.empty() && list.back().copy && list.back().offset + list.back().length == offset &&
+        list.back().length + length <= FileUploadOptions::MAX_COPY_LENGTH) {
+        list.back().length += length;
+        return;
+    }
+    UploadInstruction instruction;
+    instruction.copy = true;
+    instruction.offset = offset;
+    instruction.length = length;
+    instruction.packedOffset = 0;
+    instruction.packedLength = 0;
+    list.push_back(instruction);
+}
+
+// rsync 방식 블록 비교 : 새 파일을 한 바이트씩 밀며 약한 체크섬이 같은 현재 파일 블록을 찾고 강한 해시로 확인
+void buildDeltaPlan(const uint8_t* data, uint32_t size, uint32_t blockSize, uint32_t literalSize,
+                    const std::vector<FileBlockSignature>& signatures, uint32_t currentSize, UploadPlan& plan) {
+    // 끝의 짧은 블록은 비교하지 않음
+    std::unordered_map<uint32_t, std::vector<uint32_t> > table;
+    for (uint32_t index = 0; index < signatures.size(); index++) {
+        if ((index + 1) * blockSize <= currentSize) table[signatures[index].weak].push_back(index);
+    }
+
+    uint32_t literalStart = 0;
+    if (!table.empty() && size >= blockSize) {
+        uint32_t position = 0;
+        RollingChecksum sum;
+        sum.update(data, blockSize);
+
+        while (true) {
+            std::unordered_map<uint32_t, std::vector<uint32_t> >::const_iterator it = table.find(sum.value());
+            bool matched = false;
+            uint32_t matchIndex = 0;
+            if (it != table.end()) {
+                uint8_t digest[Sha256::DIGEST_SIZE];
+                Sha256::hash(data + position, blockSize, digest);
+                // 직전 복사에 이어지는 블록을 우선 선택 (복사 명령 병합)
+                const std::vector<UploadInstruction>& list = plan.instructions;
+                uint32_t preferred = !list.empty() && list.back().copy ?
+                                     (list.back().offset + list.back().length) / blockSize : 0xFFFFFFFF;
+                for (size_t i = 0; i < it->second.size(); i++) {
+                    uint32_t index = it->second[i];
+                    if (memcmp(signatures[index].strong, digest, FILE_STRONG_SIGNATURE_SIZE) != 0) continue;
+                    if (!matched || index == preferred) matchIndex = index;
+                    matched = true;
+                }
+            }
+
+            if (matched) {
+                appendLiteral(plan, data, literalStart, position, literalSize);
+                appendCopy(plan, matchIndex * blockSize, blockSize);
+                position += blockSize;
+                literalStart = position;
+                if (position + blockSize > size) break;
+                sum.reset();
+                sum.update(data + position, blockSize);
+                continue;
+            }
+
+            if (position + blockSize >= size) break;
+            sum.roll(data[position], data[position + blockSize]);
+            position++;
+        }
+    }
+    appendLiteral(plan, data, literalStart, size, literalSize);
+}
+
+// 전송 계획 작성 : 압축해도 줄지 않으면 압축 없이 다시 작성
+void buildUploadPlan(const uint8_t* data, uint32_t size, FileCodec codec, const FileUploadOptions& options,
+                     const std::vector<FileBlockSignature>& signatures, uint32_t currentSize, UploadPlan& plan) {
+    plan.codec = codec;
+    plan.packedLimit = FileUploadOptions::MAX_BLOCK_SIZE -
+                       (options.sessionId != FILE_DEFAULT_SESSION ? FILE_SESSION_PREFIX_SIZE : 0);
+    plan.instructions.clear();
+    plan.packed.clear();
+    buildDeltaPlan(data, size, options.deltaBlockSize, options.blockSize, signatures, currentSize, plan);
+
+    if (codec == FileCodec::NONE) return;
+    uint64_t literalBytes = 0;
+    for (size_t i = 0; i < plan.instructions.size(); i++) {
+        if (!plan.instructions[i].copy) literalBytes += plan.instructions[i].length;
+    }
+    if (plan.packed.size() * 100 > literalBytes * PACKED_LIMIT_PERCENT) {
+        buildUploadPlan(data, size, FileCodec::NONE, options, signatures, currentSize, plan);
+    }
+}
+
+// 전송 계획까지 포함한 파일 식별 : 블록 크기나 델타 기준이 바뀌면 다른 전송으로 취급 (재개 안 함)
+uint32_t planIdentity(uint32_t fileId, const UploadPlan& plan) {
+    uint32_t hash = (fileId ^ static_cast<uint8_t>(plan.codec)) * 16777619u;
+    const std::vector<UploadInstruction>& list = plan.instructions;
+    for (size_t i = 0; i < list.size(); i++) {
+        uint32_t words[3] = { list[i].copy ? 1u : 0u, list[i].offset, list[i].length };
+        for (int w = 0; w < 3; w++) {
+            for (int shift = 24; shift >= 0; shift -= 8) hash = (hash ^ ((words[w] >> shift) & 0xFF)) * 16777619u;
+        }
+    }
+    return hash != 0 ? hash : 1;
+}
+
+const size_t REQUEST_CAPACITY = FileDataHeaderSchema::SIZE + FileUploadOptions::MAX_BLOCK_SIZE;
+
+// 세션 형식 : Stage 에 플래그를 세우고 바로 뒤에 SessionId 삽입 (세션 0 은 기존 형식)
+size_t addFileSession(uint8_t sessionId, uint8_t* frame, size_t length) {
+    if (sessionId == FILE_DEFAULT_SESSION) return length;
+    memmove(frame + 1 + FILE_SESSION_PREFIX_SIZE, frame + 1, length - 1);
+    frame[0] |= FILE_STAGE_SESSION_FLAG;
+    frame[1] = sessionId;
+    return length + FILE_SESSION_PREFIX_SIZE;
+}
+
+// 현재 단계의 요청 페이로드 작성 (메시지 임시 변수가 코루틴 프레임에 잡히지 않도록 분리)
+size_t buildFileRequest(UploadStep step, const uint8_t* data, uint32_t size, const UploadPlan& plan, uint32_t block,
+                        uint32_t fileId, const uint8_t* contentHash, uint16_t signatureBlockSize,
+                        uint32_t signatureCount, uint8_t (&frame)[REQUEST_CAPACITY]) {
+    if (step == UploadStep::SIGNATURES) {
+        FileSignatureQueryMessage query;
+        query.stage = FileTransferStage::SIGNATURE_QUERY;
+        query.blockSize = signatureBlockSize;
+        query.startBlock = signatureCount;
+        return FileSignatureQuerySchema::serialize(query, frame);
+    }
+
+    if (step == UploadStep::RESUME || step == UploadStep::REQUEST) {
+        FileRequestReceiveMessage request;
+        request.stage = stageOf(step, plan, block);
+        request.fileSize = size;
+        request.fileId = fileId;
+        if (step == UploadStep::REQUEST && (contentHash != nullptr || plan.codec != FileCodec::NONE)) {
+            if (contentHash != nullptr) {
+                memcpy(request.contentHash, contentHash, FILE_CONTENT_HASH_SIZE);
+            } else {
+                memset(request.contentHash, 0, FILE_CONTENT_HASH_SIZE);   // 해시 없음
+            }
+            request.codec = plan.codec;
+            if (plan.codec != FileCodec::NONE) return FileRequestReceiveCodecSchema::serialize(request, frame);
+            return FileRequestReceiveHashSchema::serialize(request, frame);
+        }
+        return FileRequestReceiveIdSchema::serialize(request, frame);
+    }
+
+    if (step == UploadStep::DATA && plan.instructions[block].copy) {
+        FileDeltaCopyMessage copy;
+        copy.stage = FileTransferStage::DELTA_COPY;
+        copy.blockIndex = block;
+        copy.offset = plan.instructions[block].offset;
+        copy.length = plan.instructions[block].length;
+        return FileDeltaCopySchema::serialize(copy, frame);
+    }
+
+    if (step == UploadStep::DATA) {
+        const UploadInstruction& instruction = plan.instructions[block];
+        FileDataHeaderMessage header;
+        header.stage = FileTransferStage::RECEIVING_DATA;
+        header.blockIndex = block;
+        size_t length = FileDataHeaderSchema::serialize(header, frame);
+        if (plan.codec != FileCodec::NONE) {
+            memcpy(frame + length, plan.packed.data() + instruction.packedOffset, instruction.packedLength);
+            return length + instruction.packedLength;
+        }
+        memcpy(frame + length, data + instruction.offset, instruction.length);
+        return length + instruction.length;
+    }
+
+    FileVerifyChecksumMessage verify;
+    verify.stage = FileTransferStage::VERIFY_CHECKSUM;
+    verify.checksum = crc16XModem(data, size);
+    return FileVerifyChecksumSchema::serialize(verify, frame);
+}
+
+} // namespace
+
+bool FileContentIndex::holds(uint16_t nodeId, uint32_t fileSize,
+                             const uint8_t (&contentHash)[FILE_CONTENT_HASH_SIZE]) const {
+    std::unordered_map<uint16_t, Entry>::const_iterator it = entries_.find(nodeId);
+    return it != entries_.end() && it->second.fileSize == fileSize &&
+           memcmp(it->second.contentHash, contentHash, FILE_CONTENT_HASH_SIZE) == 0;
+}
+
+void FileContentIndex::record(uint16_t nodeId, uint32_t fileSize,
+                              const uint8_t (&contentHash)[FILE_CONTENT_HASH_SIZE]) {
+    Entry& entry = entries_[nodeId];
+    entry.fileSize = fileSize;
+    memcpy(entry.contentHash, contentHash, FILE_CONTENT_HASH_SIZE);
+}
+
+uint32_t fileIdentity(const uint8_t* data, uint32_t size) {
+    uint32_t hash = 2166136261u;
+    for (int shift = 24; shift >= 0; shift -= 8) {
+        hash = (hash ^ ((size >> shift) & 0xFF)) * 16777619u;
+    }
+    for (uint32_t i = 0; i < size; i++) {
+        hash = (hash ^ data[i]) * 16777619u;
+    }
+    return hash != 0 ? hash : 1;
+}
+
+// co_await 지점을 하나로 두어 코루틴 프레임을 ConversationFramePool 블록 안에 유지
+Conversation uploadFile(AsyncCom_Protocol& protocol, uint16_t targetId, const uint8_t* data, uint32_t size,
+                        FileUploadOptions options, FileUploadResult& result) {
+    result = FileUploadResult();
+    const uint32_t maxBlockSize = FileUploadOptions::MAX_BLOCK_SIZE -
+                                  (options.sessionId != FILE_DEFAULT_SESSION ? FILE_SESSION_PREFIX_SIZE : 0);
+    if (options.blockSize == 0 || options.blockSize > maxBlockSize ||
+        (options.delta && (options.deltaBlockSize < FILE_SIGNATURE_MIN_BLOCK ||
+                           options.deltaBlockSize > FILE_SIGNATURE_MAX_BLOCK))) {
+        result.done = true;
+        co_return;
+    }
+
+    uint8_t contentHash[FILE_CONTENT_HASH_SIZE];
+    Sha256::hash(data, size, contentHash);
+    if (options.index != nullptr && options.index->holds(targetId, size, contentHash)) {
+        result.alreadyPresent = true;
+        result.ok = true;
+        result.done = true;
+        co_return;
+    }
+
+    UploadPlan plan;
+    std::vector<FileBlockSignature> signatures;
+    uint32_t currentSize = 0;
+    uint32_t fileId = 0;
+    const UploadStep firstTransferStep = options.resume ? UploadStep::RESUME : UploadStep::REQUEST;
+    UploadStep step = UploadStep::SIGNATURES;
+    if (!options.delta) {
+        buildUploadPlan(data, size, options.codec, options, signatures, currentSize, plan);
+        fileId = planIdentity(fileIdentity(data, size), plan);
+        step = firstTransferStep;
+    }
+
+    uint32_t block = 0;
+    uint8_t failures = 0;
+    uint8_t frame[REQUEST_CAPACITY];
+
+    while (true) {
+        size_t length = buildFileRequest(step, data, size, plan, block, fileId,
+                                         options.dedup ? contentHash : nullptr, options.deltaBlockSize,
+                                         static_cast<uint32_t>(signatures.size()), frame);
+        length = addFileSession(options.sessionId, frame, length);
+
+        // 세션 형식은 응답의 [Stage | FLAG, SessionId] 로 같은 노드의 다른 업로드와 구분
+        const RequestResult& response = co_await protocol.request(
+            targetId, AsyncCom_Protocol::CMD_FILE_RECEIVE, frame, length, options.timeoutMs, 0,
+            options.sessionId != FILE_DEFAULT_SESSION ? AsyncCom_Protocol::MAX_MATCH_LENGTH : 0);
+        FileReceiveAckMessage ack;
+        bool answered = parseFileAck(response, options.sessionId, stageOf(step, plan, block), ack);
+
+        if (answered && step == UploadStep::SIGNATURES) {
+            // 현재 파일이 없으면 (실패 응답) 전체 전송
+            int page = ack.success == FILE_ACK_SUCCESS ?
+                       appendSignaturePage(response, options.sessionId, options.deltaBlockSize, signatures,
+                                           currentSize) : 1;
+            if (page < 0) {
+                answered = false;
+            } else if (page == 0) {
+                failures = 0;
+                continue;
+            } else {
+                buildUploadPlan(data, size, options.codec, options, signatures, currentSize, plan);
+                fileId = planIdentity(fileIdentity(data, size), plan);
+                failures = 0;
+                step = firstTransferStep;
+                continue;
+            }
+        }
+
+        if (answered && ack.success && step == UploadStep::DATA && ack.blockIndex != block) {
+            answered = false;   // 이전 블록의 늦은 ACK
+        }
+
+        if (answered && ack.success == FILE_ACK_BUSY &&
+            (step == UploadStep::REQUEST || step == UploadStep::RESUME)) {
+            result.busy = true;     // 노드의 세션 표나 저장소가 다른 전송에 사용 중 : 나중에 다시 시도
+            result.done = true;
+            co_return;
+        }
+
+        if (answered && step == UploadStep::REQUEST && ack.success == FILE_ACK_ALREADY_PRESENT) {
+            if (options.index != nullptr) options.index->record(targetId, size, contentHash);
+            result.alreadyPresent = true;
+            result.ok = true;
+            result.done = true;
+            co_return;
+        }
+
+        if (answered && step == UploadStep::REQUEST && ack.success == FILE_ACK_SUCCESS &&
+            plan.codec != FileCodec::NONE && ack.blockIndex != static_cast<uint32_t>(plan.codec)) {
+            // 압축 미지원 노드 : 압축 없는 계획으로 다시 요청
+            buildUploadPlan(data, size, FileCodec::NONE, options, signatures, currentSize, plan);
+            fileId = planIdentity(fileIdentity(data, size), plan);
+            continue;
+        }
+
+        if (answered && ack.success == FILE_ACK_SUCCESS) {
+            failures = 0;
+            switch (step) {
+                case UploadStep::SIGNATURES:
+                    break;
+                case UploadStep::RESUME:
+                    result.codec = plan.codec;
+                    block = ack.blockIndex < plan.instructions.size() ?
+                            ack.blockIndex : static_cast<uint32_t>(plan.instructions.size());
+                    result.startBlock = block;
+                    step = block < plan.instructions.size() ? UploadStep::DATA : UploadStep::VERIFY;
+                    break;
+                case UploadStep::REQUEST:
+                    block = 0;
+                    result.startBlock = 0;
+                    result.codec = plan.codec;
+                    step = !plan.instructions.empty() ? UploadStep::DATA : UploadStep::VERIFY;
+                    break;
+                case UploadStep::DATA:
+                    result.blocksSent++;
+                    if (plan.instructions[block].copy) {
+                        result.copiedBytes += plan.instructions[block].length;
+                    } else {
+                        result.literalBytes += plan.instructions[block].length;
+                        result.payloadBytes += plan.codec != FileCodec::NONE ? plan.instructions[block].packedLength
+                                                                             : plan.instructions[block].length;
+                    }
+                    if (++block >= plan.instructions.size()) step = UploadStep::VERIFY;
+                    break;
+                case UploadStep::VERIFY:
+                    if (options.index != nullptr) options.index->record(targetId, size, contentHash);
+                    result.ok = true;
+                    result.done = true;
+                    co_return;
+            }
+            continue;
+        }
+
+        if (answered) {
+            // 명시적 거절
+            if (step == UploadStep::RESUME) {
+                step = UploadStep::REQUEST;     // 체크포인트 없음 : 처음부터
+                continue;
+            }
+            if (step == UploadStep::DATA && options.resume) {
+                step = UploadStep::RESUME;      // 수신 측 위치를 다시 맞춤
+            } else if (step != UploadStep::DATA) {
+                if (options.index != nullptr) options.index->forget(targetId);
+                result.done = true;             // 수신 거부 또는 체크섬 불일치
+                co_return;
+            }
+        }
+
+        result.retries++;
+        if (++failures > options.maxRetries) {
+            if (options.index != nullptr) options.index->forget(targetId);
+            result.done = true;
+            co_return;
+        }
+    }
+}
+
+#endif
@@ -0,0 +1,95 @@
+/*
+ * com_protocol_upload.h
+ *
+ *  CMD_FILE_RECEIVE 재개 가능 파일 업로드 (호스트 빌드 전용, -std=c++20)
+ *
+ *  FileUploadResult result;
+ *  uploadFile(protocol, target, data, size, FileUploadOptions(), result);
+ *  while (!result.done) {
+ *      protocol.processReceivedData();
+ *      protocol.poll();
+ *  }
+ *
+ *  - resume 이 켜져 있으면 먼저 RESUME_QUERY 로 수신 측 체크포인트를 조회하여
+ *    이미 받은 블록은 건너뜀 (없으면 REQUEST_RECEIVE 부터 시작)
+ *  - 블록 ACK 가 실패로 오면 (수신 측 재시작 등) RESUME_QUERY 로 위치를 다시 맞춤
+ *  - dedup 이 켜져 있으면 REQUEST_RECEIVE 에 SHA-256 내용 해시를 실어 보내고,
+ *    수신 측이 같은 파일을 이미 가지고 있으면 데이터 단계 없이 끝남
+ *  - index 를 주면 노드별 현재 파일 해시를 기록하여, 이미 보낸 파일은 요청 없이 바로 끝남
+ *  - delta 가 켜져 있으면 SIGNATURE_QUERY 로 노드의 현재 파일 블록 서명을 받아
+ *    같은 블록은 DELTA_COPY 로, 나머지만 RECEIVING_DATA 로 보냄 (현재 파일이 없으면 전체 전송)
+ *  - codec 을 지정하면 RECEIVING_DATA 블록을 압축 (노드가 거절하거나 줄지 않으면 압축 없이 전송)
+ *  - sessionId 를 주면 세션 형식으로 보내어 같은 노드에 여러 파일을 동시에 업로드 (업로드마다 다른 값,
+ *    블록 최대 크기 1 바이트 감소). 노드의 세션 표나 저장소가 사용 중이면 result.busy 로 끝남
+ *  - data 는 업로드가 끝날 때까지 유효해야 함
+ */
+
+#ifndef COM_PROTOCOL_CLASS_COM_PROTOCOL_UPLOAD_H_
+#define COM_PROTOCOL_CLASS_COM_PROTOCOL_UPLOAD_H_
+
+#include "com_protocol_async.h"
+
+#if defined(__cpp_impl_coroutine) && !defined(USE_HAL_DRIVER)
+#include "IFileStore.h"
+#include "protocol_messages.h"
+#include <unordered_map>
+
+// 노드별 현재 파일 (크기, 내용 해시) 색인 : 배포 계획 시 노드에 묻지 않고 판단
+class FileContentIndex {
+public:
+    bool holds(uint16_t nodeId, uint32_t fileSize, const uint8_t (&contentHash)[FILE_CONTENT_HASH_SIZE]) const;
+    void record(uint16_t nodeId, uint32_t fileSize, const uint8_t (&contentHash)[FILE_CONTENT_HASH_SIZE]);
+    void forget(uint16_t nodeId) { entries_.erase(nodeId); }
+    void clear() { entries_.clear(); }
+    size_t size() const { return entries_.size(); }
+
+private:
+    struct Entry {
+        uint32_t fileSize;
+        uint8_t contentHash[FILE_CONTENT_HASH_SIZE];
+    };
+    std::unordered_map<uint16_t, Entry> entries_;
+};
+
+struct FileUploadOptions {
+    // 수신 버퍼(256) - 헤더(8) - CRC(2) - Stage/BlockIndex(5), 세션 형식은 SessionId(1) 만큼 작음
+    static const uint32_t MAX_BLOCK_SIZE = 241;
+    // DELTA_COPY 한 번에 복사하는 최대 길이 (노드 처리 시간 제한)
+    static const uint32_t MAX_COPY_LENGTH = 16384;
+    // 압축 블록 하나가 복원되는 최대 길이
+    static const uint32_t MAX_PACKED_INPUT = 4096;
+
+    uint32_t blockSize = 200;
+    uint8_t maxRetries = 5;         // 같은 단계에서 연속 실패 허용 횟수
+    bool resume = true;
+    bool dedup = true;              // REQUEST_RECEIVE 에 내용 해시 포함
+    bool delta = false;             // 노드의 현재 파일과 블록 비교 후 바뀐 부분만 전송
+    uint16_t deltaBlockSize = 512;  // 서명 블록 크기 (FILE_SIGNATURE_MIN_BLOCK ~ FILE_SIGNATURE_MAX_BLOCK)
+    FileCodec codec = FileCodec::NONE;
+    uint32_t timeoutMs = 500;
+    FileContentIndex* index = nullptr;
+    uint8_t sessionId = FILE_DEFAULT_SESSION;   // 0 : 기존 형식 (노드당 한 업로드)
+};
+
+struct FileUploadResult {
+    bool done = false;
+    bool ok = false;
+    bool alreadyPresent = false;    // 노드가 같은 내용을 이미 보유 (데이터 단계 생략)
+    bool busy = false;              // 노드가 FILE_ACK_BUSY 로 거절 (세션 표 또는 저장소 사용 중)
+    uint32_t startBlock = 0;        // 재개 시 첫 전송 블록
+    uint32_t blocksSent = 0;        // 전송한 명령 수 (데이터 + 복사)
+    uint32_t literalBytes = 0;      // RECEIVING_DATA 로 보낸 바이트 (복원 기준)
+    uint32_t payloadBytes = 0;      // RECEIVING_DATA 로 실제 보낸 바이트 (압축 후)
+    FileCodec codec = FileCodec::NONE;  // 실제 사용한 압축 방식
+    uint32_t copiedBytes = 0;       // DELTA_COPY 로 노드가 복사한 바이트
+    uint32_t retries = 0;
+};
+
+// 파일 식별 해시 (FNV-1a 32, 크기 포함) : 0 은 "재개 불가" 로 예약되어 있어 1 로 대체
+uint32_t fileIdentity(const uint8_t* data, uint32_t size);
+
+Conversation uploadFile(AsyncCom_Protocol& protocol, uint16_t targetId, const uint8_t* data, uint32_t size,
+                        FileUploadOptions options, FileUploadResult& result);
+
+#endif
+#endif /* COM_PROTOCOL_CLASS_COM_PROTOCOL_UPLOAD_H_ */
@@ -0,0 +1,315 @@
+/*
+ * config_store.h
+ *
+ *  CMD_CONFIG 키-값 설정 저장소 (노드)
+ *
+ *  키 정의는 키 오름차순으로 정렬된 상수 테이블로 두고 이진 탐색으로 찾습니다.
+ *  값이 바뀔 때마다 저장소 버전이 1 증가하고 키마다 마지막으로 바뀐 버전을 기록하므로,
+ *  호스트는 "버전 N 이후 바뀐 키" 만 받아 사본을 맞출 수 있습니다.
+ *
+ *  static const ConfigKeyDef KEYS[] = {            // key 오름차순
+ *      { 0x0001, ConfigType::U16, 0, 1000 },
+ *      { 0x0002, ConfigType::F32, 0, 0x3F800000 },  // 1.0f
+ *      { 0x0100, ConfigType::U32, CONFIG_FLAG_READ_ONLY, 0x00010203 },
+ *  };
+ *  ConfigStore store;
+ *  store.begin(KEYS, sizeof(KEYS) / sizeof(KEYS[0]), bootCount);
+ *  protocol.setConfigStore(&store);
+ *  uint16_t speed = store.getValue<uint16_t>(0x0001);
+ */
+
+#ifndef COM_PROTOCOL_CLASS_CONFIG_STORE_H_
+#define COM_PROTOCOL_CLASS_CONFIG_STORE_H_
+
+#include "protocol_messages.h"
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+
+static const uint8_t CONFIG_FLAG_READ_ONLY = 0x01;     // 호스트 SET 거부 (노드의 set() 은 허용)
+
+struct ConfigKeyDef {
+    uint16_t key;               // CONFIG_NO_KEY(0xFFFF) 는 사용 불가
+    ConfigType type;
+    uint8_t flags;              // CONFIG_FLAG_*
+    uint32_t defaultValue;      // 원시 값 (부호 있는 타입은 부호 확장, F32 는 IEEE-754 비트)
+};
+
+class ConfigStore {
+public:
+    // 호스트 SET 검증 : false 를 반환하면 프레임 전체를 거부 (적용 전에 호출되므로 부수 효과 없이 판단)
+    typedef bool (*ValidateHook)(void* context, uint16_t key, uint32_t value);
+
+    ConfigStore() : keys_(nullptr), slots_(nullptr), count_(0), version_(0), generation_(0),
+                    validate_(nullptr), validateContext_(nullptr) {}
+    ~ConfigStore() { delete[] slots_; }
+
+    // keys : 키 오름차순, 중복 없음, 저장소 수명 동안 유효. 모든 키는 기본값, 버전 1 로 시작
+    // generation : 부팅마다 달라야 함 (부팅 횟수, RTC 등). 호스트는 값이 바뀌면 사본을 버림
+    bool begin(const ConfigKeyDef* keys, size_t count, uint32_t generation) {
+        if (count >= CONFIG_NO_KEY) return false;
+        for (size_t i = 0; i < count; i++) {
+            if (keys[i].key == CONFIG_NO_KEY || configValueSize(keys[i].type) == 0) return false;
+            if (i > 0 && keys[i - 1].key >= keys[i].key) return false;
+        }
+
+        delete[] slots_;
+        slots_ = count ? new Slot[count] : nullptr;
+        keys_ = keys;
+        count_ = count;
+        version_ = 1;
+        generation_ = generation;
+        for (size_t i = 0; i < count; i++) {
+            slots_[i].value = normalize(keys[i].type, keys[i].defaultValue);
+            slots_[i].version = version_;
+        }
+        return true;
+    }
+
+    void setValidateHook(ValidateHook hook, void* context) {
+        validate_ = hook;
+        validateContext_ = context;
+    }
+
+    size_t size() const { return count_; }
+    uint32_t version() const { return version_; }
+    uint32_t generation() const { return generation_; }
+    const ConfigKeyDef& keyAt(size_t index) const { return keys_[index]; }
+
+    // 키 위치 (없으면 -1)
+    int indexOf(uint16_t key) const {
+        size_t low = 0;
+        size_t high = count_;
+        while (low < high) {
+            size_t mid = (low + high) / 2;
+            if (keys_[mid].key < key) {
+                low = mid + 1;
+            } else {
+                high = mid;
+            }
+        }
+        return (low < count_ && keys_[low].key == key) ? static_cast<int>(low) : -1;
+    }
+
+    bool get(uint16_t key, uint32_t& value) const {
+        int index = indexOf(key);
+        if (index < 0) return false;
+        value = slots_[index].value;
+        return true;
+    }
+
+    // 노드 자체 변경 (센서 보정값 등) : 읽기 전용 키도 허용, 값이 같으면 버전 유지
+    bool set(uint16_t key, uint32_t value) {
+        int index = indexOf(key);
+        if (index < 0) return false;
+        value = normalize(keys_[index].type, value);
+        if (slots_[index].value != value) {
+            slots_[index].value = value;
+            slots_[index].version = ++version_;
+        }
+        return true;
+    }
+
+    // 타입 편의 함수 : T 는 키 타입과 같은 크기의 정수 또는 float
+    template <typename T>
+    T getValue(uint16_t key) const {
+        uint32_t raw = 0;
+        get(key, raw);
+        return fromRaw<T>(raw);
+    }
+
+    template <typename T>
+    bool setValue(uint16_t key, T value) { return set(key, toRaw(value)); }
+
+    // CMD_CONFIG 요청 처리 : 응답(CMD_CONFIG_ACK) 페이로드를 response 에 만들고 길이 반환
+    size_t handleRequest(const uint8_t* request, size_t length, uint8_t* response, size_t capacity) {
+        ConfigAckMessage ack;
+        ack.op = length > 0 ? static_cast<ConfigOp>(request[0]) : ConfigOp::GET;
+        ack.status = CONFIG_MALFORMED;
+        ack.key = CONFIG_NO_KEY;
+        ack.count = 0;
+
+        if (capacity < ConfigAckSchema::SIZE) return 0;
+        size_t used = ConfigAckSchema::SIZE;
+
+        switch (ack.op) {
+            case ConfigOp::GET: used = handleGet(request, length, response, capacity, ack); break;
+            case ConfigOp::SET: handleSet(request, length, ack); break;
+            case ConfigOp::DIFF: used = handleDiff(request, length, response, capacity, ack); break;
+            default: break;
+        }
+
+        ack.generation = generation_;
+        ack.version = version_;
+        ConfigAckSchema::serialize(ack, response, capacity);
+        return used;
+    }
+
+private:
+    struct Slot {
+        uint32_t value;
+        uint32_t version;       // 마지막으로 바뀐 저장소 버전
+    };
+
+    const ConfigKeyDef* keys_;
+    Slot* slots_;
+    size_t count_;
+    uint32_t version_;
+    uint32_t generation_;
+    ValidateHook validate_;
+    void* validateContext_;
+
+    // 타입 범위로 자름 (전송 후 값과 같게) : BOOL 은 0/1, 부호 있는 타입은 부호 확장
+    static uint32_t normalize(ConfigType type, uint32_t raw) {
+        if (type == ConfigType::BOOL) return raw != 0;
+        uint8_t encoded[4];
+        configEncodeValue(type, raw, encoded);
+        return configDecodeValue(type, encoded);
+    }
+
+    template <typename T>
+    static T fromRaw(uint32_t raw) {
+        T value;
+        if (sizeof(T) == sizeof(raw)) {
+            memcpy(&value, &raw, sizeof(value));   // float, int32_t, uint32_t
+        } else {
+            value = static_cast<T>(raw);
+        }
+        return value;
+    }
+
+    template <typename T>
+    static uint32_t toRaw(T value) {
+        uint32_t raw = 0;
+        if (sizeof(T) == sizeof(raw)) {
+            memcpy(&raw, &value, sizeof(raw));
+        } else {
+            raw = static_cast<uint32_t>(value);    // 부호 있는 타입은 부호 확장
+        }
+        return raw;
+    }
+
+    // 응답 항목 [Key(2), Type(1), Value] 추가, 공간이 없으면 false
+    bool appendEntry(size_t index, uint8_t* response, size_t capacity, size_t& used) const {
+        const ConfigKeyDef& def = keys_[index];
+        size_t size = CONFIG_ENTRY_HEADER + configValueSize(def.type);
+        if (used + size > capacity) return false;
+        storeBigEndian<uint16_t>(response + used, def.key);
+        response[used + 2] = static_cast<uint8_t>(def.type);
+        configEncodeValue(def.type, slots_[index].value, response + used + CONFIG_ENTRY_HEADER);
+        used += size;
+        return true;
+    }
+
+    // 알 수 없는 키를 만나면 거기서 멈추고 그 앞까지 응답 (ack.key = 실패한 키)
+    size_t handleGet(const uint8_t* request, size_t length, uint8_t* response, size_t capacity,
+                     ConfigAckMessage& ack) const {
+        size_t used = ConfigAckSchema::SIZE;
+        ConfigRequestMessage message;
+        if (!ConfigRequestSchema::deserialize(request, length, message) ||
+            length < ConfigRequestSchema::SIZE + static_cast<size_t>(message.count) * 2) {
+            return used;
+        }
+
+        ack.status = CONFIG_OK;
+        const uint8_t* keys = request + ConfigRequestSchema::SIZE;
+        for (uint8_t i = 0; i < message.count; i++) {
+            uint16_t key = loadBigEndian<uint16_t>(keys + i * 2);
+            int index = indexOf(key);
+            if (index < 0) {
+                ack.status = CONFIG_UNKNOWN_KEY;
+                ack.key = key;
+                break;
+            }
+            if (!appendEntry(static_cast<size_t>(index), response, capacity, used)) break;   // 나머지는 다시 요청
+            ack.count++;
+        }
+        return used;
+    }
+
+    // 두 번 훑음 : 모든 항목을 검증한 뒤에만 적용 (부분 적용 없음), 적용 시 버전은 1만 증가
+    void handleSet(const uint8_t* request, size_t length, ConfigAckMessage& ack) {
+        ConfigRequestMessage message;
+        if (!ConfigRequestSchema::deserialize(request, length, message)) return;
+
+        size_t offset = ConfigRequestSchema::SIZE;
+        for (uint8_t i = 0; i < message.count; i++) {
+            if (offset + CONFIG_ENTRY_HEADER > length) return;
+            uint16_t key = loadBigEndian<uint16_t>(request + offset);
+            ConfigType type = static_cast<ConfigType>(request[offset + 2]);
+            size_t size = configValueSize(type);
+            if (size == 0 || offset + CONFIG_ENTRY_HEADER + size > length) return;
+
+            int index = indexOf(key);
+            uint8_t status = CONFIG_OK;
+            uint32_t value = configDecodeValue(type, request + offset + CONFIG_ENTRY_HEADER);
+            if (index < 0) {
+                status = CONFIG_UNKNOWN_KEY;
+            } else if (keys_[index].type != type || (type == ConfigType::BOOL && value > 1)) {
+                status = CONFIG_TYPE_MISMATCH;
+            } else if (keys_[index].flags & CONFIG_FLAG_READ_ONLY) {
+                status = CONFIG_READ_ONLY;
+            } else if (validate_ && !validate_(validateContext_, key, value)) {
+                status = CONFIG_REJECTED;
+            }
+            if (status != CONFIG_OK) {
+                ack.status = status;
+                ack.key = key;
+                return;
+            }
+            offset += CONFIG_ENTRY_HEADER + size;
+        }
+
+        bool changed = false;
+        offset = ConfigRequestSchema::SIZE;
+        for (uint8_t i = 0; i < message.count; i++) {
+            ConfigType type = static_cast<ConfigType>(request[offset + 2]);
+            Slot& slot = slots_[indexOf(loadBigEndian<uint16_t>(request + offset))];
+            uint32_t value = configDecodeValue(type, request + offset + CONFIG_ENTRY_HEADER);
+            if (slot.value != value) {
+                if (!changed) version_++;
+                changed = true;
+                slot.value = value;
+                slot.version = version_;
+            }
+            offset += CONFIG_ENTRY_HEADER + configValueSize(type);
+        }
+        ack.status = CONFIG_OK;
+        ack.count = message.count;
+    }
+
+    size_t handleDiff(const uint8_t* request, size_t length, uint8_t* response, size_t capacity,
+                      ConfigAckMessage& ack) const {
+        size_t used = ConfigAckSchema::SIZE;
+        ConfigDiffMessage message;
+        if (!ConfigDiffSchema::deserialize(request, length, message)) return used;
+
+        ack.status = CONFIG_OK;
+        // startKey 이상인 첫 키부터
+        size_t index = 0;
+        size_t high = count_;
+        while (index < high) {
+            size_t mid = (index + high) / 2;
+            if (keys_[mid].key < message.startKey) {
+                index = mid + 1;
+            } else {
+                high = mid;
+            }
+        }
+
+        for (; index < count_; index++) {
+            if (slots_[index].version <= message.sinceVersion) continue;
+            if (ack.count == UINT8_MAX || !appendEntry(index, response, capacity, used)) {
+                ack.key = keys_[index].key;    // 다음 요청의 StartKey
+                break;
+            }
+            ack.count++;
+        }
+        return used;
+    }
+
+    ConfigStore(const ConfigStore&);
+    ConfigStore& operator=(const ConfigStore&);
+};
+
+#endif /* COM_PROTOCOL_CLASS_CONFIG_STORE_H_ */
@@ -0,0 +1,79 @@
+/*
+ * group_membership.h
+ *
+ *  그룹 주소 소속 비트맵 (예약 ID 0xFF00 ~ 0xFFFE, 255 그룹)
+ *
+ *  수신 상태 머신이 수신자 ID 2 바이트를 읽는 즉시 contains() 로 판단하므로 그룹 수와 관계없이
+ *  비트 하나를 읽는 비용만 듭니다. (탐색/분기 없음, 32 바이트)
+ *  가입/탈퇴는 처리 단계(CMD_GROUP, 응용)가 하고 판단은 파싱 단계가 하므로 워드 단위로 원자적으로 갱신합니다.
+ *
+ *  GroupMembership groups;
+ *  groups.join(0xFF01);                        // 왼쪽 다리 모터
+ *  groups.join(0xFF10);                        // 전체 관절
+ *  if (groups.contains(receiverId)) { ... }
+ */
+
+#ifndef COM_PROTOCOL_CLASS_GROUP_MEMBERSHIP_H_
+#define COM_PROTOCOL_CLASS_GROUP_MEMBERSHIP_H_
+
+#include <stdint.h>
+#include <stddef.h>
+#include <atomic>
+
+class GroupMembership {
+public:
+    static const uint16_t FIRST_ID = 0xFF00;
+    static const uint16_t LAST_ID = 0xFFFE;     // 0xFFFF 는 브로드캐스트
+    static const size_t BITMAP_BYTES = 32;      // 하위 8비트 x 1비트 (0xFFFF 자리는 항상 0)
+
+    GroupMembership() { clear(); }
+
+    static bool isGroupId(uint16_t id) { return id >= FIRST_ID && id <= LAST_ID; }
+
+    // 0xFFFF 는 비트 255 이지만 join() 이 거부하므로 항상 false
+    bool contains(uint16_t id) const {
+        if ((id & 0xFF00) != FIRST_ID) return false;
+        return (words_[(id & 0xFF) >> 5].load(std::memory_order_relaxed) >> (id & 31)) & 1u;
+    }
+
+    bool join(uint16_t id) { return update(id, true); }
+    bool leave(uint16_t id) { return update(id, false); }
+
+    void clear() {
+        for (size_t i = 0; i < WORDS; i++) words_[i].store(0, std::memory_order_relaxed);
+    }
+
+    size_t count() const {
+        size_t total = 0;
+        for (size_t i = 0; i < WORDS; i++) {
+            for (uint32_t word = words_[i].load(std::memory_order_relaxed); word; word &= word - 1) total++;
+        }
+        return total;
+    }
+
+    // CMD_GROUP_ACK 비트맵 : out[n] 의 비트 b (LSB 0) = 그룹 FIRST_ID + n * 8 + b
+    void toBytes(uint8_t* out) const {
+        for (size_t i = 0; i < WORDS; i++) {
+            uint32_t word = words_[i].load(std::memory_order_relaxed);
+            for (size_t b = 0; b < 4; b++) out[i * 4 + b] = static_cast<uint8_t>(word >> (b * 8));
+        }
+    }
+
+private:
+    static const size_t WORDS = BITMAP_BYTES / 4;
+    std::atomic<uint32_t> words_[WORDS];   // 쓰는 쪽은 하나 (처리 단계), 읽는 쪽은 파싱 단계
+
+    bool update(uint16_t id, bool member) {
+        if (!isGroupId(id)) return false;
+        std::atomic<uint32_t>& word = words_[(id & 0xFF) >> 5];
+        uint32_t bit = 1u << (id & 31);
+        uint32_t value = word.load(std::memory_order_relaxed);
+        word.store(member ? (value | bit) : (value & ~bit), std::memory_order_relaxed);
+        return true;
+    }
+
+    GroupMembership(const GroupMembership&);
+    GroupMembership& operator=(const GroupMembership&);
+};
+
+#endif /* COM_PROTOCOL_CLASS_GROUP_MEMBERSHIP_H_ */
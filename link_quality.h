@@ -0,0 +1,113 @@
+/*
+ * link_quality.h
+ *
+ *  링크 품질 추정 : 프레임 안 바이트 간격, 검증 실패 비율, 시퀀스 누락 비율의 지수 가중 평균
+ *
+ *  파싱 단계가 프레임 후보마다 갱신하며 (정수 연산, 할당 없음), 엔진은 바이트 간격 평균 + 4 x 편차를
+ *  프레임 타임아웃의 여유로 씁니다. (TCP RTO 와 같은 방식, 평균 1/8, 편차 1/4, 비율 1/32)
+ *  쓰는 쪽은 파싱 단계 하나이고 필드는 atomic 이므로 큐 모드의 처리 단계나 다른 스레드에서 읽어도 됩니다.
+ *  호스트는 getLinkQuality() 또는 CMD_STATS SUMMARY 로 읽어 재전송 횟수와 창 크기를 정합니다.
+ *
+ *  const LinkQualityEstimator& q = protocol.getLinkQuality();
+ *  uint8_t retries = q.crcErrorPpm() > 20000 ? 4 : 2;
+ *  size_t window = q.sequenceLossPpm() > 50000 ? 2 : 8;
+ */
+
+#ifndef COM_PROTOCOL_CLASS_LINK_QUALITY_H_
+#define COM_PROTOCOL_CLASS_LINK_QUALITY_H_
+
+#include <stdint.h>
+#include <stddef.h>
+#include <atomic>
+
+class LinkQualityEstimator {
+public:
+    static const uint8_t GAP_SHIFT = 3;         // 간격 평균 가중치 1/8
+    static const uint8_t DEV_SHIFT = 2;         // 간격 편차 가중치 1/4
+    static const uint8_t RATE_SHIFT = 5;        // 오류/누락 비율 가중치 1/32
+    static const uint32_t MAX_GAP_MS = 60000;   // 표본 상한 (고정소수점 넘침 방지)
+    static const uint16_t MAX_LOSS_SAMPLES = 8; // 한 번에 반영하는 누락 수 (재동기화 등 큰 점프)
+
+    LinkQualityEstimator() { reset(); }
+
+    // 파싱 단계에서 (또는 수신을 멈춘 뒤) 호출 : 동시에 진행 중인 갱신 하나는 남을 수 있음
+    void reset() {
+        gapMean_.store(0, std::memory_order_relaxed);
+        gapDev_.store(0, std::memory_order_relaxed);
+        errorRate_.store(0, std::memory_order_relaxed);
+        lossRate_.store(0, std::memory_order_relaxed);
+        gapSamples_.store(0, std::memory_order_relaxed);
+        frames_.store(0, std::memory_order_relaxed);
+    }
+
+    // 프레임 후보 하나의 최대 바이트 간격 (ms, 읽기 호출 사이 간격). 프레임 타임아웃도 그때까지 기다린 시간으로 반영
+    void sampleGap(uint32_t gapMs) {
+        if (gapMs > MAX_GAP_MS) gapMs = MAX_GAP_MS;
+        int32_t sample = static_cast<int32_t>(gapMs << FRACTION_BITS);
+        if (gapSamples_.load(std::memory_order_relaxed) == 0) {
+            gapMean_.store(sample, std::memory_order_relaxed);
+            gapDev_.store(sample / 2, std::memory_order_relaxed);
+        } else {
+            int32_t mean = gapMean_.load(std::memory_order_relaxed);
+            int32_t dev = gapDev_.load(std::memory_order_relaxed);
+            int32_t error = sample - mean;
+            gapMean_.store(mean + (error >> GAP_SHIFT), std::memory_order_relaxed);
+            gapDev_.store(dev + (((error < 0 ? -error : error) - dev) >> DEV_SHIFT), std::memory_order_relaxed);
+        }
+        bump(gapSamples_);
+    }
+
+    // 검증을 마친 프레임 후보 (failed : CRC 불일치 또는 FEC 정정 실패)
+    void sampleFrame(bool failed) {
+        updateRate(errorRate_, failed);
+        bump(frames_);
+    }
+
+    // 수락한 시퀀스 번호 : 앞서 빠진 번호 수만큼 손실, 자신은 수신으로 반영
+    void sampleSequence(uint16_t missing) {
+        if (missing > MAX_LOSS_SAMPLES) missing = MAX_LOSS_SAMPLES;
+        for (uint16_t i = 0; i < missing; i++) updateRate(lossRate_, true);
+        updateRate(lossRate_, false);
+    }
+
+    bool hasGapSamples() const { return gapSamples_.load(std::memory_order_relaxed) > 0; }
+    uint32_t frames() const { return frames_.load(std::memory_order_relaxed); }
+
+    // 평균 + 4 x 편차 (ms, 올림)
+    uint32_t gapGuardMs() const {
+        int32_t guard = gapMean_.load(std::memory_order_relaxed) + 4 * gapDev_.load(std::memory_order_relaxed);
+        if (guard <= 0) return 0;
+        return (static_cast<uint32_t>(guard) + (1u << FRACTION_BITS) - 1) >> FRACTION_BITS;
+    }
+    uint32_t gapMeanUs() const { return toMicros(gapMean_.load(std::memory_order_relaxed)); }
+    uint32_t gapDevUs() const { return toMicros(gapDev_.load(std::memory_order_relaxed)); }
+    uint32_t crcErrorPpm() const { return toPpm(errorRate_.load(std::memory_order_relaxed)); }
+    uint32_t sequenceLossPpm() const { return toPpm(lossRate_.load(std::memory_order_relaxed)); }
+
+private:
+    static const uint8_t FRACTION_BITS = 8;     // 간격 : ms x 256
+    static const uint8_t RATE_BITS = 16;        // 비율 : 1.0 = 65536
+
+    std::atomic<int32_t> gapMean_;
+    std::atomic<int32_t> gapDev_;
+    std::atomic<int32_t> errorRate_;
+    std::atomic<int32_t> lossRate_;
+    std::atomic<uint32_t> gapSamples_;
+    std::atomic<uint32_t> frames_;
+
+    static void bump(std::atomic<uint32_t>& counter) {
+        counter.store(counter.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    }
+    static void updateRate(std::atomic<int32_t>& rate, bool event) {
+        int32_t value = rate.load(std::memory_order_relaxed);
+        rate.store(value + (((event ? (1 << RATE_BITS) : 0) - value) >> RATE_SHIFT), std::memory_order_relaxed);
+    }
+    static uint32_t toMicros(int32_t value) {
+        return value > 0 ? static_cast<uint32_t>((static_cast<uint64_t>(value) * 1000) >> FRACTION_BITS) : 0;
+    }
+    static uint32_t toPpm(int32_t rate) {
+        return rate > 0 ? static_cast<uint32_t>((static_cast<uint64_t>(rate) * 1000000) >> RATE_BITS) : 0;
+    }
+};
+
+#endif /* COM_PROTOCOL_CLASS_LINK_QUALITY_H_ */
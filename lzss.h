@@ -0,0 +1,168 @@
+/*
+ * lzss.h
+ *
+ *  파일 전송 블록용 경량 LZSS 압축 (heatshrink 방식 비트 스트림, 창 256 바이트)
+ *
+ *  토큰 (MSB 먼저) :
+ *   1 + 8비트                         : 리터럴 바이트
+ *   0 + 8비트(거리 - 1) + 4비트(길이 - 2) : 최대 256 바이트 앞에서 2 ~ 17 바이트 복사
+ *  블록마다 독립적으로 압축하므로 블록 사이 상태가 없고, 블록 끝의 남는 비트(8 미만)는 0 으로 채움
+ *
+ *  size_t consumed;
+ *  size_t n = LzssEncoder::compress(in, length, out, sizeof(out), consumed);   // out 에 맞는 만큼만 압축
+ *
+ *  LzssDecoder decoder;        // 창 256 바이트 (MCU RAM)
+ *  decoder.decode(block, n, sink);    // sink(const uint8_t*, size_t) 로 최대 64 바이트씩 출력
+ */
+
+#ifndef COM_PROTOCOL_CLASS_LZSS_H_
+#define COM_PROTOCOL_CLASS_LZSS_H_
+
+#include <stdint.h>
+#include <stddef.h>
+
+static const uint8_t LZSS_WINDOW_BITS = 8;
+static const uint8_t LZSS_LENGTH_BITS = 4;
+static const size_t LZSS_WINDOW_SIZE = 1u << LZSS_WINDOW_BITS;
+static const size_t LZSS_MIN_MATCH = 2;
+static const size_t LZSS_MAX_MATCH = LZSS_MIN_MATCH + (1u << LZSS_LENGTH_BITS) - 1;
+
+class LzssEncoder {
+public:
+    // capacity 안에 들어가는 만큼 압축 : 반환값은 출력 바이트 수, consumed 는 사용한 입력 길이
+    static size_t compress(const uint8_t* in, size_t length, uint8_t* out, size_t capacity, size_t& consumed) {
+        BitWriter writer(out, capacity);
+        size_t position = 0;
+
+        while (position < length) {
+            size_t bestLength = 0;
+            size_t bestDistance = 0;
+            size_t maxDistance = position < LZSS_WINDOW_SIZE ? position : LZSS_WINDOW_SIZE;
+            size_t maxLength = length - position < LZSS_MAX_MATCH ? length - position : LZSS_MAX_MATCH;
+
+            for (size_t distance = 1; distance <= maxDistance && bestLength < maxLength; distance++) {
+                const uint8_t* candidate = in + position - distance;
+                if (candidate[0] != in[position]) continue;
+                size_t n = 1;
+                while (n < maxLength && candidate[n] == in[position + n]) n++;
+                if (n > bestLength) {
+                    bestLength = n;
+                    bestDistance = distance;
+                }
+            }
+
+            if (bestLength >= LZSS_MIN_MATCH) {
+                if (!writer.fits(1 + LZSS_WINDOW_BITS + LZSS_LENGTH_BITS)) break;
+                writer.put(0, 1);
+                writer.put(static_cast<uint32_t>(bestDistance - 1), LZSS_WINDOW_BITS);
+                writer.put(static_cast<uint32_t>(bestLength - LZSS_MIN_MATCH), LZSS_LENGTH_BITS);
+                position += bestLength;
+            } else {
+                if (!writer.fits(9)) break;
+                writer.put(1, 1);
+                writer.put(in[position], 8);
+                position++;
+            }
+        }
+
+        consumed = position;
+        return writer.finish();
+    }
+
+private:
+    class BitWriter {
+    public:
+        BitWriter(uint8_t* out, size_t capacity) : out_(out), capacity_(capacity), bits_(0) {}
+
+        bool fits(size_t bits) const { return bits_ + bits <= capacity_ * 8; }
+
+        void put(uint32_t value, uint8_t bits) {
+            while (bits-- > 0) {
+                size_t byte = bits_ >> 3;
+                uint8_t mask = static_cast<uint8_t>(0x80 >> (bits_ & 7));
+                if ((bits_ & 7) == 0) out_[byte] = 0;
+                if ((value >> bits) & 1) out_[byte] |= mask;
+                bits_++;
+            }
+        }
+
+        size_t finish() const { return (bits_ + 7) >> 3; }
+
+    private:
+        uint8_t* out_;
+        size_t capacity_;
+        size_t bits_;
+    };
+};
+
+class LzssDecoder {
+public:
+    static const size_t OUTPUT_CHUNK = 64;
+
+    LzssDecoder() : head_(0), flushPosition_(0), pending_(0), produced_(0) {}
+
+    // 블록 하나를 복원 : 형식 오류(창 밖 참조)나 sink 가 false 를 반환하면 false
+    template <typename Sink>
+    bool decode(const uint8_t* in, size_t length, Sink& sink) {
+        head_ = 0;
+        flushPosition_ = 0;
+        pending_ = 0;
+        produced_ = 0;
+
+        const size_t totalBits = length * 8;
+        size_t bit = 0;
+        while (true) {
+            if (bit + 9 <= totalBits && read(in, bit, 1) == 1) {
+                bit++;
+                if (!emit(static_cast<uint8_t>(read(in, bit, 8)), sink)) return false;
+                bit += 8;
+            } else if (bit + 1 + LZSS_WINDOW_BITS + LZSS_LENGTH_BITS <= totalBits) {
+                bit++;
+                size_t distance = read(in, bit, LZSS_WINDOW_BITS) + 1;
+                bit += LZSS_WINDOW_BITS;
+                size_t count = read(in, bit, LZSS_LENGTH_BITS) + LZSS_MIN_MATCH;
+                bit += LZSS_LENGTH_BITS;
+                if (distance > produced_) return false;
+                for (size_t i = 0; i < count; i++) {
+                    uint8_t value = window_[(head_ - distance) & (LZSS_WINDOW_SIZE - 1)];
+                    if (!emit(value, sink)) return false;
+                }
+            } else {
+                break;  // 남은 비트는 채움
+            }
+        }
+        return pending_ == 0 || sink(window_ + flushPosition_, pending_);
+    }
+
+private:
+    uint8_t window_[LZSS_WINDOW_SIZE];
+    size_t head_;               // 다음 출력 위치 (창 안)
+    size_t flushPosition_;      // 아직 sink 로 보내지 않은 출력의 시작
+    size_t pending_;
+    size_t produced_;           // 이번 블록에서 복원한 바이트 수 (거리 검증)
+
+    static uint32_t read(const uint8_t* in, size_t bit, uint8_t bits) {
+        uint32_t value = 0;
+        for (uint8_t i = 0; i < bits; i++, bit++) {
+            value = (value << 1) | ((in[bit >> 3] >> (7 - (bit & 7))) & 1);
+        }
+        return value;
+    }
+
+    // 창에 기록하고, 64 바이트가 모이거나 창 끝에 닿으면 덮어쓰기 전에 sink 로 전달
+    template <typename Sink>
+    bool emit(uint8_t value, Sink& sink) {
+        window_[head_] = value;
+        head_ = (head_ + 1) & (LZSS_WINDOW_SIZE - 1);
+        pending_++;
+        produced_++;
+        if (pending_ == OUTPUT_CHUNK || head_ == 0) {
+            if (!sink(window_ + flushPosition_, pending_)) return false;
+            flushPosition_ = head_;
+            pending_ = 0;
+        }
+        return true;
+    }
+};
+
+#endif /* COM_PROTOCOL_CLASS_LZSS_H_ */
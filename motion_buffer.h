@@ -0,0 +1,172 @@
+/*
+ * motion_buffer.h
+ *
+ *  모션 스트리밍 지터 버퍼 (프레임 번호 -> 슬롯, 고정 크기)
+ *
+ *  프레임 번호 i 는 슬롯 i % capacity 에 저장합니다. 재생 위치(playIndex)부터 capacity 개 범위만 받으며,
+ *  순서가 바뀌어 도착해도 제자리에 들어가고 재생은 번호 순서로 진행합니다.
+ *  재생한 슬롯은 번호를 남겨 두므로 재전송된 중복 프레임과 건너뛴 뒤 늦게 온 프레임을 구분합니다.
+ *
+ *  MotionJitterBuffer buffer;
+ *  buffer.resize(64, 16);                      // 64 프레임 x 16 바이트
+ *  buffer.reset(12);                           // 스트림 시작 : 프레임 크기 12
+ *  buffer.store(index, timestampMs, data);
+ *  if (buffer.front(timestampMs, data)) { ... 재생 ... buffer.pop(); }
+ */
+
+#ifndef COM_PROTOCOL_CLASS_MOTION_BUFFER_H_
+#define COM_PROTOCOL_CLASS_MOTION_BUFFER_H_
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+
+class MotionJitterBuffer {
+public:
+    static const size_t MAX_SLOTS = 1024;
+    static const size_t MAX_FRAME_BYTES = 64;
+    static const uint32_t NO_INDEX = 0xFFFFFFFF;
+
+    enum StoreResult {
+        STORED,
+        DUPLICATE,          // 이미 받았거나 재생한 프레임
+        LATE,               // 받기 전에 건너뛴 프레임 (버림)
+        OUT_OF_WINDOW       // playIndex + capacity 이후 (버림)
+    };
+
+    MotionJitterBuffer() : slots_(nullptr), data_(nullptr), capacity_(0), maxFrameBytes_(0), frameBytes_(0),
+                           playIndex_(0), nextIndex_(0), filled_(0) {}
+    ~MotionJitterBuffer() {
+        delete[] slots_;
+        delete[] data_;
+    }
+
+    // 버퍼 할당 (기존 내용 폐기), slots 0 : 사용 안 함
+    bool resize(size_t slots, size_t frameBytes) {
+        if (slots > MAX_SLOTS || frameBytes == 0 || frameBytes > MAX_FRAME_BYTES) return false;
+        delete[] slots_;
+        delete[] data_;
+        slots_ = slots ? new Slot[slots] : nullptr;
+        data_ = slots ? new uint8_t[slots * frameBytes] : nullptr;
+        capacity_ = slots;
+        maxFrameBytes_ = frameBytes;
+        reset(0);
+        return true;
+    }
+
+    bool enabled() const { return capacity_ > 0; }
+    size_t capacity() const { return capacity_; }
+    size_t maxFrameBytes() const { return maxFrameBytes_; }
+    size_t frameBytes() const { return frameBytes_; }
+
+    // 새 스트림 : 모든 슬롯을 비우고 프레임 0 부터
+    bool reset(size_t frameBytes) {
+        if (frameBytes > maxFrameBytes_) return false;
+        for (size_t i = 0; i < capacity_; i++) {
+            slots_[i].index = NO_INDEX;
+            slots_[i].filled = false;
+        }
+        frameBytes_ = frameBytes;
+        playIndex_ = 0;
+        nextIndex_ = 0;
+        filled_ = 0;
+        return true;
+    }
+
+    StoreResult store(uint32_t index, uint32_t timestampMs, const uint8_t* data) {
+        Slot& slot = slots_[index % capacity_];
+        if (index < playIndex_) return slot.index == index ? DUPLICATE : LATE;
+        if (index - playIndex_ >= capacity_) return OUT_OF_WINDOW;
+        if (slot.filled) return DUPLICATE;     // 범위 안의 채워진 슬롯은 같은 번호
+
+        slot.index = index;
+        slot.timestampMs = timestampMs;
+        slot.filled = true;
+        memcpy(data_ + (index % capacity_) * maxFrameBytes_, data, frameBytes_);
+        filled_++;
+        advanceNext();
+        return STORED;
+    }
+
+    // 재생 위치의 프레임 (없으면 false)
+    bool front(uint32_t& timestampMs, const uint8_t*& data) const {
+        if (!capacity_) return false;
+        const Slot& slot = slots_[playIndex_ % capacity_];
+        if (!slot.filled || slot.index != playIndex_) return false;
+        timestampMs = slot.timestampMs;
+        data = data_ + (playIndex_ % capacity_) * maxFrameBytes_;
+        return true;
+    }
+
+    // 재생 위치 프레임 소비 (슬롯 번호는 중복 판별용으로 남김)
+    void pop() {
+        Slot& slot = slots_[playIndex_ % capacity_];
+        if (slot.filled && slot.index == playIndex_) {
+            slot.filled = false;
+            filled_--;
+        }
+        playIndex_++;
+        advanceNext();
+    }
+
+    // 재생 위치 이후 처음으로 받은 프레임 (재생 위치가 비었을 때 건너뛸 곳)
+    bool nextFilled(uint32_t& index, uint32_t& timestampMs) const {
+        if (filled_ == 0) return false;
+        for (uint32_t i = nextIndex_; i - playIndex_ < capacity_; i++) {
+            const Slot& slot = slots_[i % capacity_];
+            if (slot.filled && slot.index == i) {
+                index = i;
+                timestampMs = slot.timestampMs;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // 재생 위치를 index 로 옮김 (그 사이 프레임은 받지 못한 채 건너뜀), 건너뛴 프레임 수 반환
+    uint32_t skipTo(uint32_t index) {
+        uint32_t skipped = 0;
+        while (playIndex_ < index) {
+            const Slot& slot = slots_[playIndex_ % capacity_];
+            if (!(slot.filled && slot.index == playIndex_)) skipped++;
+            pop();
+        }
+        return skipped;
+    }
+
+    uint32_t playIndex() const { return playIndex_; }
+    uint32_t nextIndex() const { return nextIndex_; }               // 재생 위치부터 연속으로 받은 다음 번호
+    size_t contiguous() const { return nextIndex_ - playIndex_; }
+    size_t buffered() const { return filled_; }
+    size_t free() const { return capacity_ - contiguous(); }        // nextIndex 부터 더 받을 수 있는 프레임 수
+
+private:
+    struct Slot {
+        uint32_t index;         // 마지막으로 저장한 프레임 번호 (NO_INDEX : 없음)
+        uint32_t timestampMs;
+        bool filled;            // 재생 대기 중
+    };
+
+    Slot* slots_;
+    uint8_t* data_;             // 슬롯마다 maxFrameBytes_
+    size_t capacity_;
+    size_t maxFrameBytes_;
+    size_t frameBytes_;
+    uint32_t playIndex_;
+    uint32_t nextIndex_;
+    size_t filled_;
+
+    void advanceNext() {
+        if (nextIndex_ < playIndex_) nextIndex_ = playIndex_;
+        while (nextIndex_ - playIndex_ < capacity_) {
+            const Slot& slot = slots_[nextIndex_ % capacity_];
+            if (!slot.filled || slot.index != nextIndex_) break;
+            nextIndex_++;
+        }
+    }
+
+    MotionJitterBuffer(const MotionJitterBuffer&);
+    MotionJitterBuffer& operator=(const MotionJitterBuffer&);
+};
+
+#endif /* COM_PROTOCOL_CLASS_MOTION_BUFFER_H_ */
@@ -0,0 +1,112 @@
+/*
+ * packet_queue.h
+ *
+ *  검증된 수신 프레임 큐 (고정 크기 패킷 버퍼 풀, 단일 생산자 / 단일 소비자)
+ *
+ *  파싱 단계(생산자)가 빈 슬롯을 받아 헤더와 페이로드를 복사해 넣고, 처리 단계(소비자)가 앞에서부터 꺼내
+ *  핸들러를 실행한 뒤 슬롯을 돌려줍니다. 슬롯 자체가 패킷 버퍼이므로 핸들러는 복사 없이 슬롯의 페이로드를 읽습니다.
+ *  두 단계가 다른 스레드/태스크여도 잠금이 없으며 (인덱스만 원자적으로 공개), 가득 차면 acquire() 가 nullptr 를 돌려줍니다.
+ *
+ *  PacketQueue queue;
+ *  queue.resize(8, 248);                       // 8 패킷 x 페이로드 248 바이트
+ *  // 파싱 단계
+ *  PacketQueue::Packet* packet = queue.acquire();
+ *  if (packet) { ... 헤더, 페이로드 기록 ... queue.commit(); }
+ *  // 처리 단계
+ *  while (PacketQueue::Packet* packet = queue.front()) { ... 핸들러 ... queue.release(); }
+ */
+
+#ifndef COM_PROTOCOL_CLASS_PACKET_QUEUE_H_
+#define COM_PROTOCOL_CLASS_PACKET_QUEUE_H_
+
+#include <stdint.h>
+#include <stddef.h>
+#include <atomic>
+
+class PacketQueue {
+public:
+    static const size_t MAX_PACKETS = 64;
+
+    struct Packet {
+        uint16_t senderId;
+        uint16_t receiverId;    // 자신의 ID 또는 브로드캐스트
+        uint16_t cmd;
+        uint16_t seq;
+        uint16_t crc;           // 프레임 CRC (응답 캐시 키)
+        uint16_t frameLength;   // 길이 필드 값 (헤더 + 페이로드 + CRC)
+        uint16_t length;        // payload 바이트 (프레임 CRC 제외, 핸들러 length 와 같음)
+        uint8_t* payload;
+    };
+
+    PacketQueue() : packets_(nullptr), data_(nullptr), slots_(0), payloadBytes_(0), head_(0), tail_(0) {}
+    ~PacketQueue() {
+        delete[] packets_;
+        delete[] data_;
+    }
+
+    // 풀 할당 (기존 내용 폐기, 두 단계가 돌지 않을 때만), packets 0 : 사용 안 함
+    bool resize(size_t packets, size_t payloadBytes) {
+        if (packets > MAX_PACKETS || payloadBytes == 0) return false;
+        delete[] packets_;
+        delete[] data_;
+        // 한 칸은 비워 두어 가득 참과 비어 있음을 구분
+        slots_ = packets ? packets + 1 : 0;
+        packets_ = slots_ ? new Packet[slots_] : nullptr;
+        data_ = slots_ ? new uint8_t[slots_ * payloadBytes] : nullptr;
+        payloadBytes_ = payloadBytes;
+        for (size_t i = 0; i < slots_; i++) {
+            packets_[i].payload = data_ + i * payloadBytes;
+        }
+        head_.store(0, std::memory_order_relaxed);
+        tail_.store(0, std::memory_order_release);
+        return true;
+    }
+
+    bool enabled() const { return slots_ > 0; }
+    size_t capacity() const { return slots_ ? slots_ - 1 : 0; }
+    size_t payloadBytes() const { return payloadBytes_; }
+
+    // 대기 중인 패킷 수 (어느 단계에서 불러도 됨, 다른 단계가 진행 중이면 근삿값)
+    size_t depth() const {
+        size_t head = head_.load(std::memory_order_acquire);
+        size_t tail = tail_.load(std::memory_order_acquire);
+        return tail >= head ? tail - head : tail + slots_ - head;
+    }
+
+    // 생산자 전용 : 다음 빈 슬롯 (가득 차면 nullptr), commit() 전까지 소비자에게 보이지 않음
+    Packet* acquire() {
+        size_t tail = tail_.load(std::memory_order_relaxed);
+        if (next(tail) == head_.load(std::memory_order_acquire)) return nullptr;
+        return &packets_[tail];
+    }
+    void commit() {
+        size_t tail = tail_.load(std::memory_order_relaxed);
+        tail_.store(next(tail), std::memory_order_release);
+    }
+
+    // 소비자 전용 : 가장 오래된 패킷 (없으면 nullptr), release() 전까지 슬롯을 재사용하지 않음
+    Packet* front() {
+        size_t head = head_.load(std::memory_order_relaxed);
+        if (head == tail_.load(std::memory_order_acquire)) return nullptr;
+        return &packets_[head];
+    }
+    void release() {
+        size_t head = head_.load(std::memory_order_relaxed);
+        head_.store(next(head), std::memory_order_release);
+    }
+
+private:
+    Packet* packets_;
+    uint8_t* data_;
+    size_t slots_;
+    size_t payloadBytes_;
+    std::atomic<size_t> head_;  // 소비자가 갱신
+    std::atomic<size_t> tail_;  // 생산자가 갱신
+
+    size_t next(size_t index) const { return index + 1 == slots_ ? 0 : index + 1; }
+
+    PacketQueue(const PacketQueue&);
+    PacketQueue& operator=(const PacketQueue&);
+};
+
+#endif /* COM_PROTOCOL_CLASS_PACKET_QUEUE_H_ */
@@ -0,0 +1,134 @@
+/*
+ * payload_schema.h
+ *
+ *  컴파일 타임 페이로드 스키마 코덱
+ *
+ *  메시지를 구조체 + 필드 목록으로 한 번만 선언하면 빅 엔디안 직렬화/역직렬화
+ *  코드가 생성됩니다. 크기는 컴파일 타임 상수이고, 동적 할당과 분기가 없습니다.
+ *
+ *  struct JogMessage { uint8_t id; uint32_t speed; };
+ *  typedef PayloadSchema<JogMessage,
+ *      SchemaField<JogMessage, uint8_t,  &JogMessage::id>,
+ *      SchemaField<JogMessage, uint32_t, &JogMessage::speed> > JogSchema;
+ *
+ *  JogSchema::SIZE                          // 5
+ *  JogSchema::deserialize(payload, length, msg) // length < SIZE 이면 false
+ *  JogSchema::serialize(msg, buffer)        // buffer 배열 크기가 작으면 컴파일 에러
+ */
+
+#ifndef COM_PROTOCOL_CLASS_PAYLOAD_SCHEMA_H_
+#define COM_PROTOCOL_CLASS_PAYLOAD_SCHEMA_H_
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+
+// 빅 엔디안 저장/로드 (정렬 불필요, 호스트 엔디안 무관)
+template <typename T, size_t N = sizeof(T)>
+struct BigEndian {
+    static void store(uint8_t* out, T value) {
+        out[N - 1] = static_cast<uint8_t>(value & 0xFF);
+        BigEndian<T, N - 1>::store(out, static_cast<T>(value >> 8));
+    }
+    static T load(const uint8_t* in) {
+        return static_cast<T>((static_cast<T>(BigEndian<T, N - 1>::load(in)) << 8) | in[N - 1]);
+    }
+};
+
+template <typename T>
+struct BigEndian<T, 1> {
+    static void store(uint8_t* out, T value) { out[0] = static_cast<uint8_t>(value & 0xFF); }
+    static T load(const uint8_t* in) { return static_cast<T>(in[0]); }
+};
+
+template <typename T>
+inline void storeBigEndian(uint8_t* out, T value) { BigEndian<T>::store(out, value); }
+
+template <typename T>
+inline T loadBigEndian(const uint8_t* in) { return BigEndian<T>::load(in); }
+
+// 정수/열거형 필드 : Member 를 sizeof(T) 바이트 빅 엔디안으로 인코딩
+template <typename Msg, typename T, T Msg::*Member>
+struct SchemaField {
+    static const size_t SIZE = sizeof(T);
+
+    static void encode(const Msg& msg, uint8_t* out) { storeBigEndian<T>(out, msg.*Member); }
+    static void decode(const uint8_t* in, Msg& msg) { msg.*Member = loadBigEndian<T>(in); }
+};
+
+// 열거형 필드 : 기반 정수 타입 Raw 로 인코딩
+template <typename Msg, typename E, typename Raw, E Msg::*Member>
+struct SchemaEnumField {
+    static const size_t SIZE = sizeof(Raw);
+
+    static void encode(const Msg& msg, uint8_t* out) { storeBigEndian<Raw>(out, static_cast<Raw>(msg.*Member)); }
+    static void decode(const uint8_t* in, Msg& msg) { msg.*Member = static_cast<E>(loadBigEndian<Raw>(in)); }
+};
+
+// 고정 길이 바이트 배열 필드 (문자열, 예약 영역 등)
+template <typename Msg, size_t N, uint8_t (Msg::*Member)[N]>
+struct SchemaBytes {
+    static const size_t SIZE = N;
+
+    static void encode(const Msg& msg, uint8_t* out) { memcpy(out, msg.*Member, N); }
+    static void decode(const uint8_t* in, Msg& msg) { memcpy(msg.*Member, in, N); }
+};
+
+// 필드 목록 재귀 전개 (C++14, fold expression 미사용)
+template <typename... Fields>
+struct SchemaFieldList;
+
+template <>
+struct SchemaFieldList<> {
+    static const size_t SIZE = 0;
+
+    template <typename Msg> static void encode(const Msg&, uint8_t*) {}
+    template <typename Msg> static void decode(const uint8_t*, Msg&) {}
+};
+
+template <typename Field, typename... Rest>
+struct SchemaFieldList<Field, Rest...> {
+    static const size_t SIZE = Field::SIZE + SchemaFieldList<Rest...>::SIZE;
+
+    template <typename Msg>
+    static void encode(const Msg& msg, uint8_t* out) {
+        Field::encode(msg, out);
+        SchemaFieldList<Rest...>::encode(msg, out + Field::SIZE);
+    }
+
+    template <typename Msg>
+    static void decode(const uint8_t* in, Msg& msg) {
+        Field::decode(in, msg);
+        SchemaFieldList<Rest...>::decode(in + Field::SIZE, msg);
+    }
+};
+
+template <typename Msg, typename... Fields>
+struct PayloadSchema {
+    typedef Msg Message;
+    static const size_t SIZE = SchemaFieldList<Fields...>::SIZE;
+
+    // 고정 크기 배열 : 크기 부족은 컴파일 에러
+    template <size_t N>
+    static size_t serialize(const Msg& msg, uint8_t (&out)[N]) {
+        static_assert(N >= SIZE, "payload buffer too small for schema");
+        SchemaFieldList<Fields...>::encode(msg, out);
+        return SIZE;
+    }
+
+    // 가변 버퍼 : 용량 부족 시 0 반환
+    static size_t serialize(const Msg& msg, uint8_t* out, size_t capacity) {
+        if (!out || capacity < SIZE) return 0;
+        SchemaFieldList<Fields...>::encode(msg, out);
+        return SIZE;
+    }
+
+    // 길이 부족 시 false (msg 는 변경되지 않음)
+    static bool deserialize(const uint8_t* in, size_t length, Msg& msg) {
+        if (!in || length < SIZE) return false;
+        SchemaFieldList<Fields...>::decode(in, msg);
+        return true;
+    }
+};
+
+#endif /* COM_PROTOCOL_CLASS_PAYLOAD_SCHEMA_H_ */
@@ -0,0 +1,54 @@
+/*
+ * protocol_clock.h
+ *
+ *  트레이스/계측용 고해상도 시계 (32비트, 넘침은 부호 없는 뺄셈으로 처리)
+ *
+ *  MCU : DWT 사이클 카운터 (엔진 생성자가 enableCycleCounter() 를 호출, DWT 가 없는 코어는 HAL_GetTick ms)
+ *  호스트 : steady_clock 100ns 단위 (32비트 넘침까지 약 7분)
+ */
+
+#ifndef COM_PROTOCOL_CLASS_PROTOCOL_CLOCK_H_
+#define COM_PROTOCOL_CLASS_PROTOCOL_CLOCK_H_
+
+#include <stdint.h>
+
+#if defined(USE_HAL_DRIVER)
+#include "main.h"
+#else
+#include <chrono>
+#endif
+
+struct ProtocolClock {
+#if defined(USE_HAL_DRIVER) && defined(DWT)
+    // 사이클 카운터 시작 (이미 돌고 있으면 그대로 두므로 응용/디버거가 쓰는 카운터를 되돌리지 않음)
+    static void enableCycleCounter() {
+        if ((CoreDebug->DEMCR & CoreDebug_DEMCR_TRCENA_Msk) && (DWT->CTRL & DWT_CTRL_CYCCNTENA_Msk)) return;
+        CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+        DWT->CYCCNT = 0;
+        DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+    }
+    static uint32_t now() { return DWT->CYCCNT; }
+    static uint32_t hz() { return SystemCoreClock; }
+#elif defined(USE_HAL_DRIVER)
+    static void enableCycleCounter() {}
+    static uint32_t now() { return HAL_GetTick(); }
+    static uint32_t hz() { return 1000; }
+#else
+    static void enableCycleCounter() {}
+    static uint32_t now() {
+        typedef std::chrono::duration<int64_t, std::ratio<1, 10000000> > Units;
+        return static_cast<uint32_t>(std::chrono::duration_cast<Units>(
+            std::chrono::steady_clock::now().time_since_epoch()).count());
+    }
+    static uint32_t hz() { return 10000000; }
+#endif
+
+    // 두 시각의 차이를 us 로 (hz 가 1MHz 미만이면 그 단위로 올림 없이 환산)
+    static uint32_t toMicros(uint32_t elapsed) {
+        uint32_t perMicro = hz() / 1000000;
+        if (perMicro > 0) return elapsed / perMicro;
+        return elapsed * (1000000 / hz());
+    }
+};
+
+#endif /* COM_PROTOCOL_CLASS_PROTOCOL_CLOCK_H_ */
@@ -0,0 +1,585 @@
+/*
+ * protocol_messages.h
+ *
+ *  명령어별 페이로드 메시지 정의 (payload_schema.h 기반)
+ *  모든 멀티 바이트 필드는 빅 엔디안으로 전송됩니다. (Protocol.md 4장)
+ */
+
+#ifndef COM_PROTOCOL_CLASS_PROTOCOL_MESSAGES_H_
+#define COM_PROTOCOL_CLASS_PROTOCOL_MESSAGES_H_
+
+#include "payload_schema.h"
+#include "IFileStore.h"
+#include <stdint.h>
+#include <stddef.h>
+
+// 파일 전송 단계 정의
+enum class FileTransferStage : uint8_t {
+	REQUEST_RECEIVE = 1,     // 파일 수신 요청
+	READY_TO_RECEIVE = 2,    // 수신 준비 완료
+	RECEIVING_DATA = 3,      // 데이터 수신 중
+	VERIFY_CHECKSUM = 4,     // 체크섬 검증
+	RESUME_QUERY = 5,        // 중단된 수신의 재개 위치 조회
+	SIGNATURE_QUERY = 6,     // 현재 파일의 블록 서명 목록 조회 (델타 전송)
+	DELTA_COPY = 7           // 현재 파일의 구간을 새 파일에 복사 (RECEIVING_DATA 와 같은 블록 번호 순서)
+};
+
+/* CMD_FILE_RECEIVE / CMD_FILE_RECEIVE_ACK 세션 형식 : Stage 최상위 비트가 1 이면 바로 뒤에 SessionId(1)
+ *   [Stage | FILE_STAGE_SESSION_FLAG, SessionId(1), 이하 기존 형식의 Stage 다음 필드]
+ * 수신 측은 (송신자 ID, SessionId) 마다 전송을 따로 진행하고, 응답도 같은 세션 형식으로 보냄
+ * 플래그가 없는 기존 형식은 세션 0 (응답도 기존 형식) */
+static const uint8_t FILE_STAGE_SESSION_FLAG = 0x80;
+static const uint8_t FILE_DEFAULT_SESSION = 0;
+static const size_t FILE_SESSION_PREFIX_SIZE = 1;       // 세션 형식이 늘리는 바이트 (SessionId)
+
+// 파일 전송 블록 압축 방식 (REQUEST_RECEIVE 에서 협상)
+enum class FileCodec : uint8_t {
+    NONE = 0,
+    LZSS = 1                 // lzss.h : 창 256 바이트, 블록마다 독립
+};
+
+// 설정 저장소 요청 종류 (CMD_CONFIG)
+enum class ConfigOp : uint8_t {
+    GET = 1,                 // 여러 키 읽기
+    SET = 2,                 // 여러 키 쓰기 (프레임 단위로 전부 적용 또는 전부 거부)
+    DIFF = 3                 // 지정한 버전 이후 바뀐 키 목록 (키 순서, 여러 프레임으로 나눔)
+};
+
+// 설정 값 타입 : 값은 타입 크기만큼 빅 엔디안으로 전송 (F32 는 IEEE-754 비트)
+enum class ConfigType : uint8_t {
+    BOOL = 0,
+    U8 = 1,
+    I8 = 2,
+    U16 = 3,
+    I16 = 4,
+    U32 = 5,
+    I32 = 6,
+    F32 = 7
+};
+
+// PlayControl 상태 정의
+enum class PlayControlState : uint8_t {
+    PLAY_ONE = 0x01,
+    PLAY_REPEAT = 0x02,
+    PAUSE = 0x03,
+    STOP = 0x04
+};
+
+// 모션 스트리밍 단계 (CMD_MOTION_STREAM)
+enum class MotionStreamStage : uint8_t {
+    OPEN = 1,                // 스트림 시작 (버퍼 비움)
+    DATA = 2,                // 타임스탬프가 붙은 모션 프레임 묶음
+    END = 3,                 // 마지막 프레임 번호 통지 (남은 프레임 재생 후 FINISHED)
+    STATUS = 4               // 상태만 조회
+};
+
+// 모션 스트리밍 재생 상태
+enum class MotionStreamState : uint8_t {
+    IDLE = 0,                // 스트림 없음
+    BUFFERING = 1,           // 워터마크까지 채우는 중 (시작 전, 또는 언더런 후 다시 채움)
+    PLAYING = 2,
+    PAUSED = 3,
+    FINISHED = 4             // END 이후 모든 프레임 재생
+};
+
+// CMD_STATS 섹션
+enum class StatsSection : uint8_t {
+    SUMMARY = 1,             // 합계, 오류 원인 카운터 (STATS_SUMMARY_FIELDS 순서)
+    COMMANDS = 2,            // 명령어별 RX/TX (여러 프레임으로 나눔)
+    HISTOGRAMS = 3           // 프레임 크기(RX, TX), 핸들러 시간
+};
+
+// 그룹 주소 소속 변경 (CMD_GROUP)
+enum class GroupOp : uint8_t {
+    JOIN = 1,                // 나열한 그룹에 가입
+    LEAVE = 2,               // 나열한 그룹에서 탈퇴
+    SET = 3,                 // 나열한 그룹만 남김 (Count 0 : 모두 탈퇴)
+    QUERY = 4                // 현재 소속만 조회
+};
+
+// 링크 속도 협상 단계 정의
+enum class LinkSpeedStage : uint8_t {
+    PROPOSE = 1,             // 속도 변경 제안
+    CONFIRM = 2              // 새 속도에서 핑 버스트 확인 완료
+};
+
+// 모터 타입 정의
+enum class MotorType : uint8_t {
+    MOTOR_NULL = 0,
+    MOTOR_RC = 1,
+    MOTOR_AC = 2,
+    MOTOR_BL = 3,
+    MOTOR_ZER = 4,
+    MOTOR_DXL = 5
+};
+
+/* CMD_SYNC / CMD_SYNC_ACK : [Timestamp(4), AuthToken(2)] */
+struct SyncMessage {
+    uint32_t timestamp;
+    uint16_t authToken;
+};
+typedef PayloadSchema<SyncMessage,
+    SchemaField<SyncMessage, uint32_t, &SyncMessage::timestamp>,
+    SchemaField<SyncMessage, uint16_t, &SyncMessage::authToken>
+> SyncSchema;
+
+/* CMD_LINK_SPEED : [Stage(1), BaudRate(4)] */
+struct LinkSpeedMessage {
+    LinkSpeedStage stage;
+    uint32_t baudRate;
+};
+typedef PayloadSchema<LinkSpeedMessage,
+    SchemaEnumField<LinkSpeedMessage, LinkSpeedStage, uint8_t, &LinkSpeedMessage::stage>,
+    SchemaField<LinkSpeedMessage, uint32_t, &LinkSpeedMessage::baudRate>
+> LinkSpeedSchema;
+
+/* CMD_LINK_SPEED_ACK : [Stage(1), Accepted(1), BaudRate(4)] */
+struct LinkSpeedAckMessage {
+    LinkSpeedStage stage;
+    uint8_t accepted;           // 1: 수락, 0: 거절
+    uint32_t baudRate;
+};
+typedef PayloadSchema<LinkSpeedAckMessage,
+    SchemaEnumField<LinkSpeedAckMessage, LinkSpeedStage, uint8_t, &LinkSpeedAckMessage::stage>,
+    SchemaField<LinkSpeedAckMessage, uint8_t, &LinkSpeedAckMessage::accepted>,
+    SchemaField<LinkSpeedAckMessage, uint32_t, &LinkSpeedAckMessage::baudRate>
+> LinkSpeedAckSchema;
+
+/* CMD_STATUS_SYNC_ACK : 29 바이트 상태 응답 */
+struct StatusSyncAckMessage {
+    uint8_t mainPowerStatus;    // 1: ON, 0: OFF
+    uint8_t motionPlayStatus;   // 1:1회 재생, 2:반복 재생, 3:일시 정지 , 4:정지
+    uint8_t hours;              // 연속 구동시간 (시/분/초)
+    uint8_t minutes;
+    uint8_t seconds;
+    uint16_t currentCount;      // 현재 동작 회차
+    uint16_t totalCount;        // 총 동작 회차
+    uint16_t voltage;           // 0.01V 단위
+    uint16_t current;           // 0.01A 단위
+    uint16_t motionCurrentTime; // 모션 현재 시간 (하위 16비트)
+    uint16_t motionEndTime;     // 모션 종료 시간 (하위 16비트)
+    uint8_t error;              // 0: 정상, 1: 에러
+    uint8_t canId;
+    uint8_t canSubId;
+    MotorType motorType;
+    uint8_t errorCode[8];       // 8바이트 제한의 에러 코드 문자열
+};
+typedef PayloadSchema<StatusSyncAckMessage,
+    SchemaField<StatusSyncAckMessage, uint8_t, &StatusSyncAckMessage::mainPowerStatus>,
+    SchemaField<StatusSyncAckMessage, uint8_t, &StatusSyncAckMessage::motionPlayStatus>,
+    SchemaField<StatusSyncAckMessage, uint8_t, &StatusSyncAckMessage::hours>,
+    SchemaField<StatusSyncAckMessage, uint8_t, &StatusSyncAckMessage::minutes>,
+    SchemaField<StatusSyncAckMessage, uint8_t, &StatusSyncAckMessage::seconds>,
+    SchemaField<StatusSyncAckMessage, uint16_t, &StatusSyncAckMessage::currentCount>,
+    SchemaField<StatusSyncAckMessage, uint16_t, &StatusSyncAckMessage::totalCount>,
+    SchemaField<StatusSyncAckMessage, uint16_t, &StatusSyncAckMessage::voltage>,
+    SchemaField<StatusSyncAckMessage, uint16_t, &StatusSyncAckMessage::current>,
+    SchemaField<StatusSyncAckMessage, uint16_t, &StatusSyncAckMessage::motionCurrentTime>,
+    SchemaField<StatusSyncAckMessage, uint16_t, &StatusSyncAckMessage::motionEndTime>,
+    SchemaField<StatusSyncAckMessage, uint8_t, &StatusSyncAckMessage::error>,
+    SchemaField<StatusSyncAckMessage, uint8_t, &StatusSyncAckMessage::canId>,
+    SchemaField<StatusSyncAckMessage, uint8_t, &StatusSyncAckMessage::canSubId>,
+    SchemaEnumField<StatusSyncAckMessage, MotorType, uint8_t, &StatusSyncAckMessage::motorType>,
+    SchemaBytes<StatusSyncAckMessage, 8, &StatusSyncAckMessage::errorCode>
+> StatusSyncAckSchema;
+
+/* CMD_ID_SCAN / _ACK : [Id(2)] (요청 : 스캔할 ID, 응답 : 자신의 ID) */
+struct IdScanMessage {
+    uint16_t id;
+};
+typedef PayloadSchema<IdScanMessage,
+    SchemaField<IdScanMessage, uint16_t, &IdScanMessage::id>
+> IdScanSchema;
+
+/* CMD_PLAY_CONTROL : [State(1)] (PlayControlState), _ACK : [CurrentState(1)] (스트림 없음 : 0) */
+struct PlayControlMessage {
+    uint8_t state;
+};
+typedef PayloadSchema<PlayControlMessage,
+    SchemaField<PlayControlMessage, uint8_t, &PlayControlMessage::state>
+> PlayControlSchema;
+
+/* CMD_MAIN_POWER_CONTROL / _ACK : [PowerFlag(1)] */
+struct MainPowerControlMessage {
+    uint8_t powerFlag;          // 1: ON, 0: OFF
+};
+typedef PayloadSchema<MainPowerControlMessage,
+    SchemaField<MainPowerControlMessage, uint8_t, &MainPowerControlMessage::powerFlag>
+> MainPowerControlSchema;
+
+/* CMD_JOG_MOVE_CW_CCW : [Id(1), SubId(1), Speed(4), Direction(1)] */
+struct JogMoveCwCcwMessage {
+    uint8_t id;
+    uint8_t subId;
+    uint32_t speed;
+    uint8_t direction;          // 0: CCW, 1: CW
+};
+typedef PayloadSchema<JogMoveCwCcwMessage,
+    SchemaField<JogMoveCwCcwMessage, uint8_t, &JogMoveCwCcwMessage::id>,
+    SchemaField<JogMoveCwCcwMessage, uint8_t, &JogMoveCwCcwMessage::subId>,
+    SchemaField<JogMoveCwCcwMessage, uint32_t, &JogMoveCwCcwMessage::speed>,
+    SchemaField<JogMoveCwCcwMessage, uint8_t, &JogMoveCwCcwMessage::direction>
+> JogMoveCwCcwSchema;
+
+/* CMD_FILE_RECEIVE REQUEST_RECEIVE : [Stage(1), FileSize(4), (선택) FileId(4), (선택) ContentHash(32), (선택) Codec(1)]
+ * RESUME_QUERY : [Stage(1), FileSize(4), FileId(4)]
+ * FileId 가 있으면 수신 측이 체크포인트를 저장하여 재개 가능
+ * ContentHash(SHA-256) 가 현재 파일과 같으면 수신 측은 FILE_ACK_ALREADY_PRESENT 로 응답 (전부 0 : 해시 없음)
+ * Codec 을 수락하면 성공 ACK 의 BlockIndex 자리에 수락한 Codec 을 담아 응답 (2 바이트 ACK : 압축 안 함) */
+struct FileRequestReceiveMessage {
+    FileTransferStage stage;
+    uint32_t fileSize;
+    uint32_t fileId;
+    uint8_t contentHash[FILE_CONTENT_HASH_SIZE];
+    FileCodec codec;
+};
+typedef PayloadSchema<FileRequestReceiveMessage,
+    SchemaEnumField<FileRequestReceiveMessage, FileTransferStage, uint8_t, &FileRequestReceiveMessage::stage>,
+    SchemaField<FileRequestReceiveMessage, uint32_t, &FileRequestReceiveMessage::fileSize>
+> FileRequestReceiveSchema;
+typedef PayloadSchema<FileRequestReceiveMessage,
+    SchemaEnumField<FileRequestReceiveMessage, FileTransferStage, uint8_t, &FileRequestReceiveMessage::stage>,
+    SchemaField<FileRequestReceiveMessage, uint32_t, &FileRequestReceiveMessage::fileSize>,
+    SchemaField<FileRequestReceiveMessage, uint32_t, &FileRequestReceiveMessage::fileId>
+> FileRequestReceiveIdSchema;
+typedef PayloadSchema<FileRequestReceiveMessage,
+    SchemaEnumField<FileRequestReceiveMessage, FileTransferStage, uint8_t, &FileRequestReceiveMessage::stage>,
+    SchemaField<FileRequestReceiveMessage, uint32_t, &FileRequestReceiveMessage::fileSize>,
+    SchemaField<FileRequestReceiveMessage, uint32_t, &FileRequestReceiveMessage::fileId>,
+    SchemaBytes<FileRequestReceiveMessage, FILE_CONTENT_HASH_SIZE, &FileRequestReceiveMessage::contentHash>
+> FileRequestReceiveHashSchema;
+typedef PayloadSchema<FileRequestReceiveMessage,
+    SchemaEnumField<FileRequestReceiveMessage, FileTransferStage, uint8_t, &FileRequestReceiveMessage::stage>,
+    SchemaField<FileRequestReceiveMessage, uint32_t, &FileRequestReceiveMessage::fileSize>,
+    SchemaField<FileRequestReceiveMessage, uint32_t, &FileRequestReceiveMessage::fileId>,
+    SchemaBytes<FileRequestReceiveMessage, FILE_CONTENT_HASH_SIZE, &FileRequestReceiveMessage::contentHash>,
+    SchemaEnumField<FileRequestReceiveMessage, FileCodec, uint8_t, &FileRequestReceiveMessage::codec>
+> FileRequestReceiveCodecSchema;
+
+/* CMD_FILE_RECEIVE RECEIVING_DATA : [Stage(1), BlockIndex(4)] + Data(가변) */
+struct FileDataHeaderMessage {
+    FileTransferStage stage;
+    uint32_t blockIndex;
+};
+typedef PayloadSchema<FileDataHeaderMessage,
+    SchemaEnumField<FileDataHeaderMessage, FileTransferStage, uint8_t, &FileDataHeaderMessage::stage>,
+    SchemaField<FileDataHeaderMessage, uint32_t, &FileDataHeaderMessage::blockIndex>
+> FileDataHeaderSchema;
+
+/* CMD_FILE_RECEIVE DELTA_COPY : [Stage(1), BlockIndex(4), Offset(4), Length(4)]
+ * 현재 파일의 [Offset, Offset + Length) 를 새 파일의 다음 위치에 기록 */
+struct FileDeltaCopyMessage {
+    FileTransferStage stage;
+    uint32_t blockIndex;
+    uint32_t offset;
+    uint32_t length;
+};
+typedef PayloadSchema<FileDeltaCopyMessage,
+    SchemaEnumField<FileDeltaCopyMessage, FileTransferStage, uint8_t, &FileDeltaCopyMessage::stage>,
+    SchemaField<FileDeltaCopyMessage, uint32_t, &FileDeltaCopyMessage::blockIndex>,
+    SchemaField<FileDeltaCopyMessage, uint32_t, &FileDeltaCopyMessage::offset>,
+    SchemaField<FileDeltaCopyMessage, uint32_t, &FileDeltaCopyMessage::length>
+> FileDeltaCopySchema;
+
+/* CMD_FILE_RECEIVE SIGNATURE_QUERY : [Stage(1), BlockSize(2), StartBlock(4)] */
+struct FileSignatureQueryMessage {
+    FileTransferStage stage;
+    uint16_t blockSize;
+    uint32_t startBlock;
+};
+typedef PayloadSchema<FileSignatureQueryMessage,
+    SchemaEnumField<FileSignatureQueryMessage, FileTransferStage, uint8_t, &FileSignatureQueryMessage::stage>,
+    SchemaField<FileSignatureQueryMessage, uint16_t, &FileSignatureQueryMessage::blockSize>,
+    SchemaField<FileSignatureQueryMessage, uint32_t, &FileSignatureQueryMessage::startBlock>
+> FileSignatureQuerySchema;
+
+/* CMD_FILE_RECEIVE_ACK (SIGNATURE_QUERY) : [Stage(1), Success(1), StartBlock(4), FileSize(4), Count(1)]
+ *                                          + Count x [Weak(4), Strong(8)] */
+static const uint16_t FILE_SIGNATURE_MIN_BLOCK = 64;
+static const uint16_t FILE_SIGNATURE_MAX_BLOCK = 4096;
+static const uint8_t FILE_SIGNATURES_PER_ACK = 19;      // 11 + 19 x 12 = 239, 세션 형식 240 (페이로드 최대 246)
+static const size_t FILE_STRONG_SIGNATURE_SIZE = 8;    // 블록 SHA-256 앞 8 바이트
+
+struct FileSignatureAckMessage {
+    FileTransferStage stage;
+    uint8_t success;
+    uint32_t startBlock;
+    uint32_t fileSize;          // 현재 파일 크기 (블록 수 = 올림(fileSize / BlockSize))
+    uint8_t count;
+};
+typedef PayloadSchema<FileSignatureAckMessage,
+    SchemaEnumField<FileSignatureAckMessage, FileTransferStage, uint8_t, &FileSignatureAckMessage::stage>,
+    SchemaField<FileSignatureAckMessage, uint8_t, &FileSignatureAckMessage::success>,
+    SchemaField<FileSignatureAckMessage, uint32_t, &FileSignatureAckMessage::startBlock>,
+    SchemaField<FileSignatureAckMessage, uint32_t, &FileSignatureAckMessage::fileSize>,
+    SchemaField<FileSignatureAckMessage, uint8_t, &FileSignatureAckMessage::count>
+> FileSignatureAckSchema;
+
+// 블록 서명 : 약한 롤링 체크섬 (rsync 방식, a | b << 16) + 강한 해시
+struct FileBlockSignature {
+    uint32_t weak;
+    uint8_t strong[FILE_STRONG_SIGNATURE_SIZE];
+};
+typedef PayloadSchema<FileBlockSignature,
+    SchemaField<FileBlockSignature, uint32_t, &FileBlockSignature::weak>,
+    SchemaBytes<FileBlockSignature, FILE_STRONG_SIGNATURE_SIZE, &FileBlockSignature::strong>
+> FileBlockSignatureSchema;
+
+/* CMD_FILE_RECEIVE VERIFY_CHECKSUM : [Stage(1), Checksum(2)] */
+struct FileVerifyChecksumMessage {
+    FileTransferStage stage;
+    uint16_t checksum;
+};
+typedef PayloadSchema<FileVerifyChecksumMessage,
+    SchemaEnumField<FileVerifyChecksumMessage, FileTransferStage, uint8_t, &FileVerifyChecksumMessage::stage>,
+    SchemaField<FileVerifyChecksumMessage, uint16_t, &FileVerifyChecksumMessage::checksum>
+> FileVerifyChecksumSchema;
+
+/* CMD_FILE_RECEIVE_ACK : [Stage(1), Success(1), (선택) BlockIndex(4)] */
+static const uint8_t FILE_ACK_FAILURE = 0;
+static const uint8_t FILE_ACK_SUCCESS = 1;
+static const uint8_t FILE_ACK_ALREADY_PRESENT = 2;     // REQUEST_RECEIVE : 같은 내용을 이미 보유 (데이터 단계 생략)
+static const uint8_t FILE_ACK_BUSY = 3;                // REQUEST_RECEIVE/RESUME_QUERY : 세션 표가 가득 찼거나 저장소를 다른 세션이 사용 중
+
+struct FileReceiveAckMessage {
+    FileTransferStage stage;
+    uint8_t success;            // FILE_ACK_*
+    uint32_t blockIndex;
+};
+typedef PayloadSchema<FileReceiveAckMessage,
+    SchemaEnumField<FileReceiveAckMessage, FileTransferStage, uint8_t, &FileReceiveAckMessage::stage>,
+    SchemaField<FileReceiveAckMessage, uint8_t, &FileReceiveAckMessage::success>
+> FileReceiveAckSchema;
+typedef PayloadSchema<FileReceiveAckMessage,
+    SchemaEnumField<FileReceiveAckMessage, FileTransferStage, uint8_t, &FileReceiveAckMessage::stage>,
+    SchemaField<FileReceiveAckMessage, uint8_t, &FileReceiveAckMessage::success>,
+    SchemaField<FileReceiveAckMessage, uint32_t, &FileReceiveAckMessage::blockIndex>
+> FileReceiveAckBlockSchema;
+
+/* CMD_CONFIG GET  : [Op(1), Count(1)] + Count x Key(2)
+ * CMD_CONFIG SET  : [Op(1), Count(1)] + Count x [Key(2), Type(1), Value(타입 크기)]
+ * CMD_CONFIG DIFF : [Op(1), SinceVersion(4), StartKey(2)] */
+static const uint8_t CONFIG_OK = 0;
+static const uint8_t CONFIG_UNKNOWN_KEY = 1;
+static const uint8_t CONFIG_TYPE_MISMATCH = 2;
+static const uint8_t CONFIG_READ_ONLY = 3;
+static const uint8_t CONFIG_REJECTED = 4;           // 노드의 검증 훅이 값을 거부
+static const uint8_t CONFIG_MALFORMED = 5;
+static const uint8_t CONFIG_UNSUPPORTED = 6;        // 설정 저장소 없음
+static const uint16_t CONFIG_NO_KEY = 0xFFFF;       // 키로 사용하지 않음 (DIFF 끝, 실패 키 없음)
+static const size_t CONFIG_MAX_PAYLOAD = 240;       // 요청/응답 페이로드 최대 (페이로드 최대 246)
+static const size_t CONFIG_ENTRY_HEADER = 3;        // Key(2) + Type(1)
+
+struct ConfigRequestMessage {
+    ConfigOp op;
+    uint8_t count;
+};
+typedef PayloadSchema<ConfigRequestMessage,
+    SchemaEnumField<ConfigRequestMessage, ConfigOp, uint8_t, &ConfigRequestMessage::op>,
+    SchemaField<ConfigRequestMessage, uint8_t, &ConfigRequestMessage::count>
+> ConfigRequestSchema;
+
+struct ConfigDiffMessage {
+    ConfigOp op;
+    uint32_t sinceVersion;      // 이 버전보다 나중에 바뀐 키 (0 : 전체)
+    uint16_t startKey;          // 이 키부터 (이전 응답의 Key)
+};
+typedef PayloadSchema<ConfigDiffMessage,
+    SchemaEnumField<ConfigDiffMessage, ConfigOp, uint8_t, &ConfigDiffMessage::op>,
+    SchemaField<ConfigDiffMessage, uint32_t, &ConfigDiffMessage::sinceVersion>,
+    SchemaField<ConfigDiffMessage, uint16_t, &ConfigDiffMessage::startKey>
+> ConfigDiffSchema;
+
+/* CMD_CONFIG_ACK : [Op(1), Status(1), Generation(4), Version(4), Key(2), Count(1)]
+ *                  + Count x [Key(2), Type(1), Value(타입 크기)] (GET, DIFF) */
+struct ConfigAckMessage {
+    ConfigOp op;
+    uint8_t status;             // CONFIG_*
+    uint32_t generation;        // 노드 부팅마다 바뀌는 값 : 다르면 호스트 사본을 처음부터 다시 받음
+    uint32_t version;           // 저장소 버전 (SET 이 적용될 때마다 1 증가)
+    uint16_t key;               // 실패한 키, DIFF 는 다음 StartKey (CONFIG_NO_KEY : 끝)
+    uint8_t count;              // GET : 앞에서부터 응답에 담은 키 수, SET : 적용한 키 수
+};
+typedef PayloadSchema<ConfigAckMessage,
+    SchemaEnumField<ConfigAckMessage, ConfigOp, uint8_t, &ConfigAckMessage::op>,
+    SchemaField<ConfigAckMessage, uint8_t, &ConfigAckMessage::status>,
+    SchemaField<ConfigAckMessage, uint32_t, &ConfigAckMessage::generation>,
+    SchemaField<ConfigAckMessage, uint32_t, &ConfigAckMessage::version>,
+    SchemaField<ConfigAckMessage, uint16_t, &ConfigAckMessage::key>,
+    SchemaField<ConfigAckMessage, uint8_t, &ConfigAckMessage::count>
+> ConfigAckSchema;
+
+// 타입별 값 크기 (알 수 없는 타입 : 0)
+inline size_t configValueSize(ConfigType type) {
+    switch (type) {
+        case ConfigType::BOOL:
+        case ConfigType::U8:
+        case ConfigType::I8: return 1;
+        case ConfigType::U16:
+        case ConfigType::I16: return 2;
+        case ConfigType::U32:
+        case ConfigType::I32:
+        case ConfigType::F32: return 4;
+    }
+    return 0;
+}
+
+// 값 인코딩 : 원시 값(uint32_t, 부호 있는 타입은 부호 확장된 값)을 타입 크기만큼 기록
+inline void configEncodeValue(ConfigType type, uint32_t raw, uint8_t* out) {
+    switch (configValueSize(type)) {
+        case 1: out[0] = static_cast<uint8_t>(raw); break;
+        case 2: storeBigEndian<uint16_t>(out, static_cast<uint16_t>(raw)); break;
+        case 4: storeBigEndian<uint32_t>(out, raw); break;
+        default: break;
+    }
+}
+
+inline uint32_t configDecodeValue(ConfigType type, const uint8_t* in) {
+    switch (type) {
+        case ConfigType::BOOL:
+        case ConfigType::U8: return in[0];
+        case ConfigType::I8: return static_cast<uint32_t>(static_cast<int32_t>(static_cast<int8_t>(in[0])));
+        case ConfigType::U16: return loadBigEndian<uint16_t>(in);
+        case ConfigType::I16: return static_cast<uint32_t>(static_cast<int32_t>(static_cast<int16_t>(loadBigEndian<uint16_t>(in))));
+        case ConfigType::U32:
+        case ConfigType::I32:
+        case ConfigType::F32: return loadBigEndian<uint32_t>(in);
+    }
+    return 0;
+}
+
+/* CMD_MOTION_STREAM OPEN   : [Stage(1), FrameBytes(1), Watermark(2), Flags(1)]
+ * CMD_MOTION_STREAM DATA   : [Stage(1), FirstIndex(4), Count(1)] + Count x [Timestamp(4), Data(FrameBytes)]
+ * CMD_MOTION_STREAM END    : [Stage(1), TotalFrames(4)]
+ * CMD_MOTION_STREAM STATUS : [Stage(1)] */
+static const uint8_t MOTION_OK = 0;
+static const uint8_t MOTION_NOT_OPEN = 1;           // OPEN 전의 DATA/END
+static const uint8_t MOTION_MALFORMED = 2;
+static const uint8_t MOTION_UNSUPPORTED = 3;        // 지터 버퍼 없음 또는 FrameBytes 초과
+static const uint8_t MOTION_FLAG_AUTO_START = 0x01; // 워터마크에 도달하면 PLAY 명령 없이 재생 시작
+static const size_t MOTION_MAX_PAYLOAD = 240;
+
+struct MotionOpenMessage {
+    MotionStreamStage stage;
+    uint8_t frameBytes;         // 프레임 하나의 데이터 크기
+    uint16_t watermark;         // 재생 시작 전 연속으로 받아 둘 프레임 수
+    uint8_t flags;              // MOTION_FLAG_*
+};
+typedef PayloadSchema<MotionOpenMessage,
+    SchemaEnumField<MotionOpenMessage, MotionStreamStage, uint8_t, &MotionOpenMessage::stage>,
+    SchemaField<MotionOpenMessage, uint8_t, &MotionOpenMessage::frameBytes>,
+    SchemaField<MotionOpenMessage, uint16_t, &MotionOpenMessage::watermark>,
+    SchemaField<MotionOpenMessage, uint8_t, &MotionOpenMessage::flags>
+> MotionOpenSchema;
+
+struct MotionDataMessage {
+    MotionStreamStage stage;
+    uint32_t firstIndex;        // 첫 프레임 번호 (이후 프레임은 1씩 증가)
+    uint8_t count;
+};
+typedef PayloadSchema<MotionDataMessage,
+    SchemaEnumField<MotionDataMessage, MotionStreamStage, uint8_t, &MotionDataMessage::stage>,
+    SchemaField<MotionDataMessage, uint32_t, &MotionDataMessage::firstIndex>,
+    SchemaField<MotionDataMessage, uint8_t, &MotionDataMessage::count>
+> MotionDataSchema;
+
+struct MotionEndMessage {
+    MotionStreamStage stage;
+    uint32_t totalFrames;
+};
+typedef PayloadSchema<MotionEndMessage,
+    SchemaEnumField<MotionEndMessage, MotionStreamStage, uint8_t, &MotionEndMessage::stage>,
+    SchemaField<MotionEndMessage, uint32_t, &MotionEndMessage::totalFrames>
+> MotionEndSchema;
+
+/* CMD_MOTION_STREAM_ACK : 모든 단계 공통 23 바이트 */
+struct MotionStreamAckMessage {
+    MotionStreamStage stage;
+    uint8_t status;             // MOTION_*
+    MotionStreamState state;
+    uint32_t nextIndex;         // 재생 위치부터 연속으로 받은 다음 프레임 번호 (다음에 보낼 번호)
+    uint32_t playIndex;         // 다음에 재생할 프레임 번호
+    uint16_t credit;            // nextIndex 부터 더 받을 수 있는 프레임 수
+    uint16_t underruns;         // 재생 중 버퍼가 비어 다시 채운 횟수
+    uint16_t lateFrames;        // 건너뛴 뒤에 도착해 버린 프레임 수
+    uint16_t missedFrames;      // 재생 시각까지 도착하지 않아 건너뛴 프레임 수
+    uint32_t playheadMs;        // 재생 시각 (프레임 타임스탬프 기준)
+};
+typedef PayloadSchema<MotionStreamAckMessage,
+    SchemaEnumField<MotionStreamAckMessage, MotionStreamStage, uint8_t, &MotionStreamAckMessage::stage>,
+    SchemaField<MotionStreamAckMessage, uint8_t, &MotionStreamAckMessage::status>,
+    SchemaEnumField<MotionStreamAckMessage, MotionStreamState, uint8_t, &MotionStreamAckMessage::state>,
+    SchemaField<MotionStreamAckMessage, uint32_t, &MotionStreamAckMessage::nextIndex>,
+    SchemaField<MotionStreamAckMessage, uint32_t, &MotionStreamAckMessage::playIndex>,
+    SchemaField<MotionStreamAckMessage, uint16_t, &MotionStreamAckMessage::credit>,
+    SchemaField<MotionStreamAckMessage, uint16_t, &MotionStreamAckMessage::underruns>,
+    SchemaField<MotionStreamAckMessage, uint16_t, &MotionStreamAckMessage::lateFrames>,
+    SchemaField<MotionStreamAckMessage, uint16_t, &MotionStreamAckMessage::missedFrames>,
+    SchemaField<MotionStreamAckMessage, uint32_t, &MotionStreamAckMessage::playheadMs>
+> MotionStreamAckSchema;
+
+/* CMD_STATS 요청 : [Section(1), Start(1)]
+ * CMD_STATS_ACK  : [Section(1), Status(1), Count(1), Next(1)] + 본문
+ *   SUMMARY    : Count x 카운터(4)
+ *   COMMANDS   : Start 번째 항목부터 Count x [Cmd(2), Rx(4), Tx(4)], Next : 다음 Start (STATS_NO_NEXT : 끝)
+ *   HISTOGRAMS : [SizeBuckets(1), TimeBuckets(1)] + RX 크기 + TX 크기 + 핸들러 시간 버킷 (각 4), Count : 전체 버킷 수 */
+static const uint8_t STATS_OK = 0;
+static const uint8_t STATS_UNKNOWN_SECTION = 1;
+static const uint8_t STATS_NO_NEXT = 0xFF;
+static const size_t STATS_MAX_PAYLOAD = 240;
+static const size_t STATS_COMMAND_ENTRY = 10;       // Cmd(2) + Rx(4) + Tx(4)
+
+struct StatsRequestMessage {
+    StatsSection section;
+    uint8_t start;
+};
+typedef PayloadSchema<StatsRequestMessage,
+    SchemaEnumField<StatsRequestMessage, StatsSection, uint8_t, &StatsRequestMessage::section>,
+    SchemaField<StatsRequestMessage, uint8_t, &StatsRequestMessage::start>
+> StatsRequestSchema;
+
+struct StatsAckMessage {
+    StatsSection section;
+    uint8_t status;             // STATS_*
+    uint8_t count;
+    uint8_t next;
+};
+typedef PayloadSchema<StatsAckMessage,
+    SchemaEnumField<StatsAckMessage, StatsSection, uint8_t, &StatsAckMessage::section>,
+    SchemaField<StatsAckMessage, uint8_t, &StatsAckMessage::status>,
+    SchemaField<StatsAckMessage, uint8_t, &StatsAckMessage::count>,
+    SchemaField<StatsAckMessage, uint8_t, &StatsAckMessage::next>
+> StatsAckSchema;
+
+/* CMD_GROUP 요청 : [Op(1), Count(1)] + Count x GroupId(2)   (GroupId : 0xFF00 ~ 0xFFFE)
+ * CMD_GROUP_ACK  : [Op(1), Status(1), Members(1)] + 소속 비트맵(32)
+ *   비트맵 바이트 n 의 비트 b (LSB 0) = 그룹 0xFF00 + n * 8 + b, Members : 소속 그룹 수
+ *   GroupId 하나라도 범위를 벗어나면 아무것도 바꾸지 않음. 그룹 주소로 받은 요청에는 응답하지 않음 */
+static const uint8_t GROUP_OK = 0;
+static const uint8_t GROUP_UNKNOWN_OP = 1;
+static const uint8_t GROUP_INVALID_ID = 2;
+static const uint8_t GROUP_BAD_LENGTH = 3;         // Count 와 페이로드 길이가 맞지 않음
+static const size_t GROUP_BITMAP_SIZE = 32;
+static const size_t GROUP_MAX_IDS = 120;           // 요청 한 프레임 (2 + 240 바이트)
+
+struct GroupRequestMessage {
+    GroupOp op;
+    uint8_t count;
+};
+typedef PayloadSchema<GroupRequestMessage,
+    SchemaEnumField<GroupRequestMessage, GroupOp, uint8_t, &GroupRequestMessage::op>,
+    SchemaField<GroupRequestMessage, uint8_t, &GroupRequestMessage::count>
+> GroupRequestSchema;
+
+struct GroupAckMessage {
+    GroupOp op;
+    uint8_t status;             // GROUP_*
+    uint8_t members;
+};
+typedef PayloadSchema<GroupAckMessage,
+    SchemaEnumField<GroupAckMessage, GroupOp, uint8_t, &GroupAckMessage::op>,
+    SchemaField<GroupAckMessage, uint8_t, &GroupAckMessage::status>,
+    SchemaField<GroupAckMessage, uint8_t, &GroupAckMessage::members>
+> GroupAckSchema;
+
+#endif /* COM_PROTOCOL_CLASS_PROTOCOL_MESSAGES_H_ */
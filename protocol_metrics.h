@@ -0,0 +1,153 @@
+/*
+ * protocol_metrics.h
+ *
+ *  프로토콜 계측 : 명령어별 RX/TX, 오류 원인별 카운터, 프레임 크기/핸들러 시간 히스토그램
+ *
+ *  엔진이 수신/분기/송신 경로에서 직접 갱신하며 (카운터 증가뿐, 할당 없음), getMetrics() 는 이 구조체를 복사합니다.
+ *  카운터는 32비트에서 넘치므로 주기적으로 읽어 차이를 계산합니다. (CMD_STATS 로 원격 수집 가능)
+ *
+ *  ProtocolMetrics m = protocol.getMetrics();
+ *  const ProtocolMetrics::CommandCounter* ping = m.findCommand(CMD_PING);
+ *  uint32_t slow = m.handlerTime[ProtocolMetrics::timeBucket(1000)];     // 1ms 대 핸들러 수
+ */
+
+#ifndef COM_PROTOCOL_CLASS_PROTOCOL_METRICS_H_
+#define COM_PROTOCOL_CLASS_PROTOCOL_METRICS_H_
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+
+struct ProtocolMetrics {
+    static const size_t MAX_COMMANDS = 24;  // 넘치면 otherRx/otherTx 로 집계
+    static const size_t SIZE_BUCKETS = 6;   // 길이 필드(헤더 + 페이로드 + CRC) : <=16, <=32, <=64, <=128, <=256, 그 이상
+    static const size_t TIME_BUCKETS = 16;  // 핸들러 시간 us : <1, <2, <4, ..., <16384, 그 이상
+
+    struct CommandCounter {
+        uint16_t cmd;           // ACK 비트 포함 (요청과 응답을 따로 집계)
+        uint32_t rx;
+        uint32_t tx;
+    };
+
+    uint32_t tickMs;            // 스냅숏 시각 (Tick::getTickCount)
+
+    // 합계
+    uint32_t rxBytes;           // 직렬 포트에서 읽은 바이트 (다른 노드 프레임, 잡음 포함)
+    uint32_t txBytes;
+    uint32_t rxFrames;          // 검증을 통과한 자신(또는 브로드캐스트) 프레임
+    uint32_t txFrames;
+
+    // 버린 프레임 / 오류 원인
+    uint32_t crcErrors;
+    uint32_t lengthErrors;      // 길이 필드가 범위를 벗어남
+    uint32_t frameTimeouts;     // 프레임 도중 PACKET_TIMEOUT_MS 동안 바이트 없음
+    uint32_t foreignFrames;     // 다른 노드 주소 (오류는 아니지만 파싱 비용)
+    uint32_t unknownCommands;
+    uint32_t missingPackets;    // 수신 시퀀스 번호 누락
+    uint32_t fecUncorrectable;
+    uint32_t fecCorrectedBytes;
+    uint32_t replayedReplies;   // 응답 캐시에서 재전송 (핸들러 실행 없음)
+
+    uint32_t handlerMaxUs;
+
+    // 처리 단계 큐 (setPacketQueue) : 파싱이 앞서 나간 정도
+    uint32_t queueDepth;        // 스냅숏 시점에 처리를 기다리는 패킷
+    uint32_t queueHighWater;
+    uint32_t queueDrops;        // 큐가 가득 차 버린 검증된 프레임 (송신 측 재전송으로 복구)
+
+    uint32_t groupFrames;       // 가입한 그룹 주소로 받은 프레임 (rxFrames 에 포함, 응답 억제)
+
+    // 링크 품질 (LinkQualityEstimator, 스냅숏 시점의 지수 가중 평균)
+    uint32_t linkGapMeanUs;     // 프레임 후보 안의 최대 읽기 간격
+    uint32_t linkGapDevUs;
+    uint32_t linkCrcErrorPpm;   // 검증 실패 (CRC, FEC 정정 실패) 비율
+    uint32_t linkSequenceLossPpm;
+    uint32_t frameTimeoutMs;    // 최대 길이 프레임 기준 현재 프레임 타임아웃
+
+    uint32_t otherRx;
+    uint32_t otherTx;
+    uint8_t commandCount;
+    CommandCounter commands[MAX_COMMANDS];
+
+    uint32_t rxSize[SIZE_BUCKETS];
+    uint32_t txSize[SIZE_BUCKETS];
+    uint32_t handlerTime[TIME_BUCKETS]; // ProtocolClock 기준 (MCU 는 DWT 사이클 카운터, 엔진 생성자가 켬)
+
+    void clear() { memset(this, 0, sizeof(*this)); }
+
+    void countCommand(uint16_t cmd, bool tx) {
+        for (uint8_t i = 0; i < commandCount; i++) {
+            if (commands[i].cmd == cmd) {
+                if (tx) commands[i].tx++;
+                else commands[i].rx++;
+                return;
+            }
+        }
+        if (commandCount == MAX_COMMANDS) {
+            if (tx) otherTx++;
+            else otherRx++;
+            return;
+        }
+        CommandCounter& counter = commands[commandCount++];
+        counter.cmd = cmd;
+        counter.rx = tx ? 0 : 1;
+        counter.tx = tx ? 1 : 0;
+    }
+
+    const CommandCounter* findCommand(uint16_t cmd) const {
+        for (uint8_t i = 0; i < commandCount; i++) {
+            if (commands[i].cmd == cmd) return &commands[i];
+        }
+        return nullptr;
+    }
+
+    void countHandler(uint32_t us) {
+        handlerTime[timeBucket(us)]++;
+        if (us > handlerMaxUs) handlerMaxUs = us;
+    }
+
+    static size_t sizeBucket(size_t length) {
+        size_t bucket = 0;
+        for (size_t limit = 16; bucket < SIZE_BUCKETS - 1 && length > limit; limit <<= 1) bucket++;
+        return bucket;
+    }
+
+    static size_t timeBucket(uint32_t us) {
+        size_t bucket = 0;
+        while (bucket < TIME_BUCKETS - 1 && us >= (1u << bucket)) bucket++;
+        return bucket;
+    }
+};
+
+// CMD_STATS SUMMARY 의 전송 순서 (새 카운터는 뒤에만 추가, 모르는 필드는 받는 쪽이 무시)
+static uint32_t ProtocolMetrics::* const STATS_SUMMARY_FIELDS[] = {
+    &ProtocolMetrics::tickMs,
+    &ProtocolMetrics::rxBytes,
+    &ProtocolMetrics::txBytes,
+    &ProtocolMetrics::rxFrames,
+    &ProtocolMetrics::txFrames,
+    &ProtocolMetrics::crcErrors,
+    &ProtocolMetrics::lengthErrors,
+    &ProtocolMetrics::frameTimeouts,
+    &ProtocolMetrics::foreignFrames,
+    &ProtocolMetrics::unknownCommands,
+    &ProtocolMetrics::missingPackets,
+    &ProtocolMetrics::fecUncorrectable,
+    &ProtocolMetrics::fecCorrectedBytes,
+    &ProtocolMetrics::replayedReplies,
+    &ProtocolMetrics::handlerMaxUs,
+    &ProtocolMetrics::otherRx,
+    &ProtocolMetrics::otherTx,
+    &ProtocolMetrics::queueDepth,
+    &ProtocolMetrics::queueHighWater,
+    &ProtocolMetrics::queueDrops,
+    &ProtocolMetrics::groupFrames,
+    &ProtocolMetrics::linkGapMeanUs,
+    &ProtocolMetrics::linkGapDevUs,
+    &ProtocolMetrics::linkCrcErrorPpm,
+    &ProtocolMetrics::linkSequenceLossPpm,
+    &ProtocolMetrics::frameTimeoutMs
+};
+static const size_t STATS_SUMMARY_COUNT = sizeof(STATS_SUMMARY_FIELDS) / sizeof(STATS_SUMMARY_FIELDS[0]);
+
+#endif /* COM_PROTOCOL_CLASS_PROTOCOL_METRICS_H_ */
@@ -0,0 +1,153 @@
+/*
+ * protocol_trace.h
+ *
+ *  수신/분기/송신 경로 트레이스 기록 (빌드 플래그 COM_PROTOCOL_TRACE)
+ *
+ *  플래그가 없으면 엔진의 트레이스 지점은 ((void)0) 으로 사라지고 링도 생기지 않습니다.
+ *  엔진 인스턴스마다 고정 크기 링(COM_PROTOCOL_TRACE_EVENTS 개, 2의 거듭제곱)에 12 바이트 이벤트를 기록하며,
+ *  가장 오래된 이벤트부터 덮어씁니다. 기록은 엔진을 돌리는 스레드 하나만 하고(잠금 없음),
+ *  dump() 는 다른 스레드나 디버거에서 불러도 기록 중 덮어쓴 이벤트를 걸러 냅니다.
+ *
+ *  시각 : ProtocolClock (MCU 는 DWT 사이클 카운터, 호스트는 steady_clock 100ns)
+ *
+ *  uint8_t dump[16 + 256 * 12];
+ *  size_t n = protocol.dumpTrace(dump, sizeof(dump));     // 덤프 포맷은 ProtocolTraceFormat
+ *  // 호스트 : exportChromeTrace(dump, n, file)  (TraceExport.h, Chrome/Perfetto JSON)
+ */
+
+#ifndef COM_PROTOCOL_CLASS_PROTOCOL_TRACE_H_
+#define COM_PROTOCOL_CLASS_PROTOCOL_TRACE_H_
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include <atomic>
+#include "protocol_clock.h"
+
+#ifndef COM_PROTOCOL_TRACE_EVENTS
+#define COM_PROTOCOL_TRACE_EVENTS 256
+#endif
+
+/*
+ * 덤프 포맷 (빅 엔디안)
+ *
+ *  헤더   : "PTRC"(4) + 버전(1) + 예약(1) + 노드 ID(2) + 시계 Hz(4) + 이벤트 수(4)
+ *  이벤트 : 시각(4, 시계 단위, 32비트에서 넘침) + 종류(1) + Arg8(1) + Arg16(2) + Arg32(4), 오래된 순서
+ */
+namespace ProtocolTraceFormat {
+    static const uint8_t MAGIC[4] = { 'P', 'T', 'R', 'C' };
+    static const uint8_t VERSION = 1;
+    static const size_t HEADER_SIZE = 16;
+    static const size_t EVENT_SIZE = 12;
+
+    enum EventType : uint8_t {
+        RX_STATE = 1,           // 파서 상태 전환 : Arg8 새 상태, Arg16 프레임 길이 필드
+        RX_ABORT = 2,           // 프레임 후보 폐기 : Arg8 폐기 시점의 상태
+        DISPATCH_BEGIN = 3,     // processCommand 진입 : Arg16 CMD, Arg32 (송신자 << 16 | 시퀀스)
+        DISPATCH_END = 4,       // Arg16 CMD
+        REPLY_REPLAY = 5,       // 응답 캐시에서 재전송 (핸들러 실행 없음) : Arg16 CMD
+        WRITE_BEGIN = 6,        // serial write 진입 : Arg32 바이트 수
+        WRITE_END = 7
+    };
+
+    // RX_STATE 의 Arg8 (Com_ProtocolEngine::ReceiveState 순서)
+    enum RxState : uint8_t {
+        WAIT_START,
+        READ_LENGTH,
+        READ_RECEIVER_ID,
+        READ_SENDER_ID,
+        READ_CMD,
+        READ_SEQ,
+        READ_PAYLOAD,
+        READ_FEC_BLOCK
+    };
+}
+
+class ProtocolTraceRing {
+public:
+    static const size_t CAPACITY = COM_PROTOCOL_TRACE_EVENTS;
+    static_assert(CAPACITY > 0 && (CAPACITY & (CAPACITY - 1)) == 0, "COM_PROTOCOL_TRACE_EVENTS must be a power of two");
+
+    struct Event {
+        uint32_t timestamp;
+        uint32_t arg32;
+        uint16_t arg16;
+        uint8_t type;
+        uint8_t arg8;
+    };
+
+    ProtocolTraceRing() : head_(0) {}
+
+    // 엔진 스레드 전용
+    void record(uint8_t type, uint8_t arg8 = 0, uint16_t arg16 = 0, uint32_t arg32 = 0) {
+        uint32_t head = head_.load(std::memory_order_relaxed);
+        Event& event = events_[head & (CAPACITY - 1)];
+        event.timestamp = ProtocolClock::now();
+        event.arg32 = arg32;
+        event.arg16 = arg16;
+        event.type = type;
+        event.arg8 = arg8;
+        head_.store(head + 1, std::memory_order_release);
+    }
+
+    uint32_t recorded() const { return head_.load(std::memory_order_acquire); }   // 지금까지 기록한 수 (넘침 포함)
+    void clear() { head_.store(0, std::memory_order_release); }
+
+    // 헤더 + 들어가는 만큼의 최근 이벤트를 out 에 기록, 쓴 바이트 수 반환 (헤더도 안 들어가면 0)
+    size_t dump(uint8_t* out, size_t capacity, uint16_t nodeId) const {
+        using namespace ProtocolTraceFormat;
+        if (capacity < HEADER_SIZE) return 0;
+        size_t room = (capacity - HEADER_SIZE) / EVENT_SIZE;
+
+        uint32_t head = head_.load(std::memory_order_acquire);
+        uint32_t count = head < CAPACITY ? head : static_cast<uint32_t>(CAPACITY);
+        if (count > room) count = static_cast<uint32_t>(room);
+        uint32_t first = head - count;
+
+        uint8_t* p = out + HEADER_SIZE;
+        for (uint32_t i = first; i != head; i++, p += EVENT_SIZE) {
+            const Event& event = events_[i & (CAPACITY - 1)];
+            put32(p, event.timestamp);
+            p[4] = event.type;
+            p[5] = event.arg8;
+            p[6] = static_cast<uint8_t>(event.arg16 >> 8);
+            p[7] = static_cast<uint8_t>(event.arg16 & 0xFF);
+            put32(p + 8, event.arg32);
+        }
+
+        // 복사하는 동안 기록된 이벤트가 덮어쓴 슬롯(기록 중인 슬롯 포함)은 버림
+        uint32_t after = head_.load(std::memory_order_acquire);
+        uint32_t skip = 0;
+        if (after - first + 1 > CAPACITY) {
+            skip = after - first + 1 - static_cast<uint32_t>(CAPACITY);
+            if (skip > count) skip = count;
+            memmove(out + HEADER_SIZE, out + HEADER_SIZE + skip * EVENT_SIZE, (count - skip) * EVENT_SIZE);
+        }
+        count -= skip;
+
+        for (size_t i = 0; i < 4; i++) out[i] = MAGIC[i];
+        out[4] = VERSION;
+        out[5] = 0;
+        out[6] = static_cast<uint8_t>(nodeId >> 8);
+        out[7] = static_cast<uint8_t>(nodeId & 0xFF);
+        put32(out + 8, ProtocolClock::hz());
+        put32(out + 12, count);
+        return HEADER_SIZE + count * EVENT_SIZE;
+    }
+
+private:
+    Event events_[CAPACITY];
+    std::atomic<uint32_t> head_;
+
+    static void put32(uint8_t* p, uint32_t value) {
+        p[0] = static_cast<uint8_t>(value >> 24);
+        p[1] = static_cast<uint8_t>(value >> 16);
+        p[2] = static_cast<uint8_t>(value >> 8);
+        p[3] = static_cast<uint8_t>(value & 0xFF);
+    }
+
+    ProtocolTraceRing(const ProtocolTraceRing&);
+    ProtocolTraceRing& operator=(const ProtocolTraceRing&);
+};
+
+#endif /* COM_PROTOCOL_CLASS_PROTOCOL_TRACE_H_ */
@@ -0,0 +1,260 @@
+/*
+ * reed_solomon.h
+ *
+ *  GF(256) 리드-솔로몬 부호 (원시 다항식 0x11D, 첫 근 α^0)
+ *
+ *  parity 바이트 nsym 개로 부호어 하나(최대 255 바이트)당 nsym/2 바이트 오류까지 정정합니다.
+ *  곱셈은 exp/log 테이블 조회로만 처리하며 동적 할당이 없습니다.
+ *
+ *  ReedSolomon rs(8);
+ *  uint8_t parity[8] = {0};
+ *  rs.encodeUpdate(parity, head, headLength);      // 나누어 여러 번 호출 가능
+ *  rs.encodeUpdate(parity, payload, payloadLength);
+ *  int corrected = ReedSolomon::decode(codeword, length, 8);   // -1 : 정정 불가
+ */
+
+#ifndef COM_PROTOCOL_CLASS_REED_SOLOMON_H_
+#define COM_PROTOCOL_CLASS_REED_SOLOMON_H_
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+
+// 헤더 전용 템플릿으로 두어 여러 번역 단위에서 include 해도 테이블은 하나만 링크됨
+template <typename T = void>
+struct GaloisField256Table {
+    static const uint8_t exp[512];  // exp[i] = α^i (i < 510 까지 mod 255 없이 사용)
+    static const uint8_t log[256];  // log[0] 은 사용하지 않음
+};
+
+template <typename T>
+const uint8_t GaloisField256Table<T>::exp[512] = {
+    0x01, 0x02, 0x04, 0x08, 0x10, 0x20, 0x40, 0x80, 0x1d, 0x3a, 0x74, 0xe8, 0xcd, 0x87, 0x13, 0x26,
+    0x4c, 0x98, 0x2d, 0x5a, 0xb4, 0x75, 0xea, 0xc9, 0x8f, 0x03, 0x06, 0x0c, 0x18, 0x30, 0x60, 0xc0,
+    0x9d, 0x27, 0x4e, 0x9c, 0x25, 0x4a, 0x94, 0x35, 0x6a, 0xd4, 0xb5, 0x77, 0xee, 0xc1, 0x9f, 0x23,
+    0x46, 0x8c, 0x05, 0x0a, 0x14, 0x28, 0x50, 0xa0, 0x5d, 0xba, 0x69, 0xd2, 0xb9, 0x6f, 0xde, 0xa1,
+    0x5f, 0xbe, 0x61, 0xc2, 0x99, 0x2f, 0x5e, 0xbc, 0x65, 0xca, 0x89, 0x0f, 0x1e, 0x3c, 0x78, 0xf0,
+    0xfd, 0xe7, 0xd3, 0xbb, 0x6b, 0xd6, 0xb1, 0x7f, 0xfe, 0xe1, 0xdf, 0xa3, 0x5b, 0xb6, 0x71, 0xe2,
+    0xd9, 0xaf, 0x43, 0x86, 0x11, 0x22, 0x44, 0x88, 0x0d, 0x1a, 0x34, 0x68, 0xd0, 0xbd, 0x67, 0xce,
+    0x81, 0x1f, 0x3e, 0x7c, 0xf8, 0xed, 0xc7, 0x93, 0x3b, 0x76, 0xec, 0xc5, 0x97, 0x33, 0x66, 0xcc,
+    0x85, 0x17, 0x2e, 0x5c, 0xb8, 0x6d, 0xda, 0xa9, 0x4f, 0x9e, 0x21, 0x42, 0x84, 0x15, 0x2a, 0x54,
+    0xa8, 0x4d, 0x9a, 0x29, 0x52, 0xa4, 0x55, 0xaa, 0x49, 0x92, 0x39, 0x72, 0xe4, 0xd5, 0xb7, 0x73,
+    0xe6, 0xd1, 0xbf, 0x63, 0xc6, 0x91, 0x3f, 0x7e, 0xfc, 0xe5, 0xd7, 0xb3, 0x7b, 0xf6, 0xf1, 0xff,
+    0xe3, 0xdb, 0xab, 0x4b, 0x96, 0x31, 0x62, 0xc4, 0x95, 0x37, 0x6e, 0xdc, 0xa5, 0x57, 0xae, 0x41,
+    0x82, 0x19, 0x32, 0x64, 0xc8, 0x8d, 0x07, 0x0e, 0x1c, 0x38, 0x70, 0xe0, 0xdd, 0xa7, 0x53, 0xa6,
+    0x51, 0xa2, 0x59, 0xb2, 0x79, 0xf2, 0xf9, 0xef, 0xc3, 0x9b, 0x2b, 0x56, 0xac, 0x45, 0x8a, 0x09,
+    0x12, 0x24, 0x48, 0x90, 0x3d, 0x7a, 0xf4, 0xf5, 0xf7, 0xf3, 0xfb, 0xeb, 0xcb, 0x8b, 0x0b, 0x16,
+    0x2c, 0x58, 0xb0, 0x7d, 0xfa, 0xe9, 0xcf, 0x83, 0x1b, 0x36, 0x6c, 0xd8, 0xad, 0x47, 0x8e, 0x01,
+    0x02, 0x04, 0x08, 0x10, 0x20, 0x40, 0x80, 0x1d, 0x3a, 0x74, 0xe8, 0xcd, 0x87, 0x13, 0x26, 0x4c,
+    0x98, 0x2d, 0x5a, 0xb4, 0x75, 0xea, 0xc9, 0x8f, 0x03, 0x06, 0x0c, 0x18, 0x30, 0x60, 0xc0, 0x9d,
+    0x27, 0x4e, 0x9c, 0x25, 0x4a, 0x94, 0x35, 0x6a, 0xd4, 0xb5, 0x77, 0xee, 0xc1, 0x9f, 0x23, 0x46,
+    0x8c, 0x05, 0x0a, 0x14, 0x28, 0x50, 0xa0, 0x5d, 0xba, 0x69, 0xd2, 0xb9, 0x6f, 0xde, 0xa1, 0x5f,
+    0xbe, 0x61, 0xc2, 0x99, 0x2f, 0x5e, 0xbc, 0x65, 0xca, 0x89, 0x0f, 0x1e, 0x3c, 0x78, 0xf0, 0xfd,
+    0xe7, 0xd3, 0xbb, 0x6b, 0xd6, 0xb1, 0x7f, 0xfe, 0xe1, 0xdf, 0xa3, 0x5b, 0xb6, 0x71, 0xe2, 0xd9,
+    0xaf, 0x43, 0x86, 0x11, 0x22, 0x44, 0x88, 0x0d, 0x1a, 0x34, 0x68, 0xd0, 0xbd, 0x67, 0xce, 0x81,
+    0x1f, 0x3e, 0x7c, 0xf8, 0xed, 0xc7, 0x93, 0x3b, 0x76, 0xec, 0xc5, 0x97, 0x33, 0x66, 0xcc, 0x85,
+    0x17, 0x2e, 0x5c, 0xb8, 0x6d, 0xda, 0xa9, 0x4f, 0x9e, 0x21, 0x42, 0x84, 0x15, 0x2a, 0x54, 0xa8,
+    0x4d, 0x9a, 0x29, 0x52, 0xa4, 0x55, 0xaa, 0x49, 0x92, 0x39, 0x72, 0xe4, 0xd5, 0xb7, 0x73, 0xe6,
+    0xd1, 0xbf, 0x63, 0xc6, 0x91, 0x3f, 0x7e, 0xfc, 0xe5, 0xd7, 0xb3, 0x7b, 0xf6, 0xf1, 0xff, 0xe3,
+    0xdb, 0xab, 0x4b, 0x96, 0x31, 0x62, 0xc4, 0x95, 0x37, 0x6e, 0xdc, 0xa5, 0x57, 0xae, 0x41, 0x82,
+    0x19, 0x32, 0x64, 0xc8, 0x8d, 0x07, 0x0e, 0x1c, 0x38, 0x70, 0xe0, 0xdd, 0xa7, 0x53, 0xa6, 0x51,
+    0xa2, 0x59, 0xb2, 0x79, 0xf2, 0xf9, 0xef, 0xc3, 0x9b, 0x2b, 0x56, 0xac, 0x45, 0x8a, 0x09, 0x12,
+    0x24, 0x48, 0x90, 0x3d, 0x7a, 0xf4, 0xf5, 0xf7, 0xf3, 0xfb, 0xeb, 0xcb, 0x8b, 0x0b, 0x16, 0x2c,
+    0x58, 0xb0, 0x7d, 0xfa, 0xe9, 0xcf, 0x83, 0x1b, 0x36, 0x6c, 0xd8, 0xad, 0x47, 0x8e, 0x01, 0x02
+};
+
+template <typename T>
+const uint8_t GaloisField256Table<T>::log[256] = {
+    0x00, 0x00, 0x01, 0x19, 0x02, 0x32, 0x1a, 0xc6, 0x03, 0xdf, 0x33, 0xee, 0x1b, 0x68, 0xc7, 0x4b,
+    0x04, 0x64, 0xe0, 0x0e, 0x34, 0x8d, 0xef, 0x81, 0x1c, 0xc1, 0x69, 0xf8, 0xc8, 0x08, 0x4c, 0x71,
+    0x05, 0x8a, 0x65, 0x2f, 0xe1, 0x24, 0x0f, 0x21, 0x35, 0x93, 0x8e, 0xda, 0xf0, 0x12, 0x82, 0x45,
+    0x1d, 0xb5, 0xc2, 0x7d, 0x6a, 0x27, 0xf9, 0xb9, 0xc9, 0x9a, 0x09, 0x78, 0x4d, 0xe4, 0x72, 0xa6,
+    0x06, 0xbf, 0x8b, 0x62, 0x66, 0xdd, 0x30, 0xfd, 0xe2, 0x98, 0x25, 0xb3, 0x10, 0x91, 0x22, 0x88,
+    0x36, 0xd0, 0x94, 0xce, 0x8f, 0x96, 0xdb, 0xbd, 0xf1, 0xd2, 0x13, 0x5c, 0x83, 0x38, 0x46, 0x40,
+    0x1e, 0x42, 0xb6, 0xa3, 0xc3, 0x48, 0x7e, 0x6e, 0x6b, 0x3a, 0x28, 0x54, 0xfa, 0x85, 0xba, 0x3d,
+    0xca, 0x5e, 0x9b, 0x9f, 0x0a, 0x15, 0x79, 0x2b, 0x4e, 0xd4, 0xe5, 0xac, 0x73, 0xf3, 0xa7, 0x57,
+    0x07, 0x70, 0xc0, 0xf7, 0x8c, 0x80, 0x63, 0x0d, 0x67, 0x4a, 0xde, 0xed, 0x31, 0xc5, 0xfe, 0x18,
+    0xe3, 0xa5, 0x99, 0x77, 0x26, 0xb8, 0xb4, 0x7c, 0x11, 0x44, 0x92, 0xd9, 0x23, 0x20, 0x89, 0x2e,
+    0x37, 0x3f, 0xd1, 0x5b, 0x95, 0xbc, 0xcf, 0xcd, 0x90, 0x87, 0x97, 0xb2, 0xdc, 0xfc, 0xbe, 0x61,
+    0xf2, 0x56, 0xd3, 0xab, 0x14, 0x2a, 0x5d, 0x9e, 0x84, 0x3c, 0x39, 0x53, 0x47, 0x6d, 0x41, 0xa2,
+    0x1f, 0x2d, 0x43, 0xd8, 0xb7, 0x7b, 0xa4, 0x76, 0xc4, 0x17, 0x49, 0xec, 0x7f, 0x0c, 0x6f, 0xf6,
+    0x6c, 0xa1, 0x3b, 0x52, 0x29, 0x9d, 0x55, 0xaa, 0xfb, 0x60, 0x86, 0xb1, 0xbb, 0xcc, 0x3e, 0x5a,
+    0xcb, 0x59, 0x5f, 0xb0, 0x9c, 0xa9, 0xa0, 0x51, 0x0b, 0xf5, 0x16, 0xeb, 0x7a, 0x75, 0x2c, 0xd7,
+    0x4f, 0xae, 0xd5, 0xe9, 0xe6, 0xe7, 0xad, 0xe8, 0x74, 0xd6, 0xf4, 0xea, 0xa8, 0x50, 0x58, 0xaf
+};
+
+class ReedSolomon {
+public:
+    static const uint8_t MAX_PARITY = 64;
+    static const size_t MAX_CODEWORD = 255;
+
+    explicit ReedSolomon(uint8_t paritySize = 0) : paritySize_(0) { setParitySize(paritySize); }
+
+    // 0 : 사용 안 함, 짝수만 허용
+    bool setParitySize(uint8_t paritySize) {
+        if (paritySize > MAX_PARITY || (paritySize & 1)) return false;
+        paritySize_ = paritySize;
+
+        // 생성 다항식 g(x) = (x - α^0)(x - α^1)...(x - α^(nsym-1)), 최고차 계수 1
+        uint8_t generator[MAX_PARITY + 1];
+        memset(generator, 0, sizeof(generator));
+        generator[0] = 1;
+        for (uint8_t i = 0; i < paritySize; i++) {
+            for (uint8_t j = i + 1; j > 0; j--) {
+                generator[j] = generator[j - 1] ^ mul(generator[j], exp()[i]);
+            }
+            generator[0] = mul(generator[0], exp()[i]);
+        }
+        // 인코딩 루프용 : 최고차 다음 계수부터의 log 값 (0 계수는 0xFF 로 표시)
+        for (uint8_t j = 0; j < paritySize; j++) {
+            uint8_t coefficient = generator[paritySize - 1 - j];
+            generatorLog_[j] = coefficient ? log()[coefficient] : 0xFF;
+        }
+        return true;
+    }
+    uint8_t paritySize() const { return paritySize_; }
+
+    // 체계적 부호화 : parity(paritySize 바이트, 0 으로 시작)에 data 를 이어서 누적
+    void encodeUpdate(uint8_t* parity, const uint8_t* data, size_t length) const {
+        const uint8_t nsym = paritySize_;
+        if (nsym == 0) return;
+        while (length--) {
+            uint8_t feedback = *data++ ^ parity[0];
+            if (feedback == 0) {
+                memmove(parity, parity + 1, nsym - 1);
+                parity[nsym - 1] = 0;
+                continue;
+            }
+            // 한 칸 이동과 feedback * g(x) 누적을 한 번에
+            uint8_t feedbackLog = log()[feedback];
+            for (uint8_t j = 0; j + 1 < nsym; j++) {
+                uint8_t g = generatorLog_[j];
+                parity[j] = parity[j + 1] ^ (g != 0xFF ? exp()[feedbackLog + g] : 0);
+            }
+            uint8_t g = generatorLog_[nsym - 1];
+            parity[nsym - 1] = (g != 0xFF) ? exp()[feedbackLog + g] : 0;
+        }
+    }
+
+    // 부호어(데이터 + parity) 오류 정정 : 정정한 바이트 수, 정정 불가 시 -1
+    static int decode(uint8_t* codeword, size_t length, uint8_t paritySize) {
+        const uint8_t nsym = paritySize;
+        if (nsym == 0 || nsym > MAX_PARITY || length <= nsym || length > MAX_CODEWORD) return -1;
+
+        // 신드롬 S_j = c(α^j) : 모두 0 이면 오류 없음
+        // (바이트 바깥 루프 : j 별 계산이 서로 독립이라 파이프라인에서 겹쳐 실행됨)
+        uint8_t syndrome[MAX_PARITY];
+        memset(syndrome, 0, nsym);
+        for (size_t i = 0; i < length; i++) {
+            uint8_t c = codeword[i];
+            for (uint8_t j = 0; j < nsym; j++) {
+                uint8_t s = syndrome[j];
+                syndrome[j] = (s ? exp()[log()[s] + j] : 0) ^ c;
+            }
+        }
+        bool clean = true;
+        for (uint8_t j = 0; j < nsym; j++) {
+            if (syndrome[j]) clean = false;
+        }
+        if (clean) return 0;
+
+        // Berlekamp-Massey : 오류 위치 다항식 Λ(x) (낮은 차수부터)
+        uint8_t locator[MAX_PARITY + 1];
+        uint8_t previous[MAX_PARITY + 1];
+        uint8_t temp[MAX_PARITY + 1];
+        memset(locator, 0, sizeof(locator));
+        memset(previous, 0, sizeof(previous));
+        locator[0] = 1;
+        previous[0] = 1;
+        uint8_t errors = 0;
+        uint8_t shift = 1;
+        uint8_t previousDiscrepancy = 1;
+
+        for (uint8_t r = 0; r < nsym; r++) {
+            uint8_t discrepancy = syndrome[r];
+            for (uint8_t i = 1; i <= errors; i++) {
+                discrepancy ^= mul(locator[i], syndrome[r - i]);
+            }
+            if (discrepancy == 0) {
+                shift++;
+                continue;
+            }
+            uint8_t scale = div(discrepancy, previousDiscrepancy);
+            memcpy(temp, locator, sizeof(locator));
+            for (uint8_t i = 0; i + shift <= nsym; i++) {
+                locator[i + shift] ^= mul(scale, previous[i]);
+            }
+            if (2 * errors <= r) {
+                errors = r + 1 - errors;
+                memcpy(previous, temp, sizeof(previous));
+                previousDiscrepancy = discrepancy;
+                shift = 1;
+            } else {
+                shift++;
+            }
+        }
+        if (2 * errors > nsym) return -1;
+
+        // Chien 탐색 : 위치 i(차수 p = length-1-i)의 X = α^p, Λ(X^-1) == 0 이면 오류
+        uint8_t positions[MAX_PARITY / 2];
+        uint8_t found = 0;
+        for (size_t i = 0; i < length; i++) {
+            uint8_t inversePower = static_cast<uint8_t>((255 - (length - 1 - i)) % 255);
+            uint8_t value = locator[0];
+            for (uint8_t k = 1; k <= errors; k++) {
+                if (locator[k]) value ^= exp()[log()[locator[k]] + (inversePower * k) % 255];
+            }
+            if (value == 0) {
+                if (found == errors) return -1;
+                positions[found++] = static_cast<uint8_t>(i);
+            }
+        }
+        if (found != errors) return -1;
+
+        // 오류 평가 다항식 Ω(x) = S(x)Λ(x) mod x^nsym
+        uint8_t evaluator[MAX_PARITY];
+        for (uint8_t j = 0; j < nsym; j++) {
+            uint8_t v = 0;
+            for (uint8_t k = 0; k <= errors && k <= j; k++) {
+                v ^= mul(locator[k], syndrome[j - k]);
+            }
+            evaluator[j] = v;
+        }
+
+        // Forney : e = X * Ω(X^-1) / Λ'(X^-1)
+        for (uint8_t e = 0; e < found; e++) {
+            uint8_t power = static_cast<uint8_t>(length - 1 - positions[e]);
+            uint8_t inversePower = static_cast<uint8_t>((255 - power) % 255);
+
+            uint8_t omega = 0;
+            for (uint8_t j = 0; j < nsym; j++) {
+                if (evaluator[j]) omega ^= exp()[log()[evaluator[j]] + (inversePower * j) % 255];
+            }
+            uint8_t derivative = 0;
+            for (uint8_t k = 1; k <= errors; k += 2) {
+                if (locator[k]) derivative ^= exp()[log()[locator[k]] + (inversePower * (k - 1)) % 255];
+            }
+            if (derivative == 0) return -1;
+
+            uint8_t magnitude = mul(exp()[power], div(omega, derivative));
+            codeword[positions[e]] ^= magnitude;
+        }
+        return found;
+    }
+
+private:
+    uint8_t paritySize_;
+    uint8_t generatorLog_[MAX_PARITY];
+
+    static const uint8_t* exp() { return GaloisField256Table<>::exp; }
+    static const uint8_t* log() { return GaloisField256Table<>::log; }
+
+    static uint8_t mul(uint8_t a, uint8_t b) {
+        return (a && b) ? exp()[log()[a] + log()[b]] : 0;
+    }
+    static uint8_t div(uint8_t a, uint8_t b) {
+        return a ? exp()[log()[a] + 255 - log()[b]] : 0;
+    }
+};
+
+#endif /* COM_PROTOCOL_CLASS_REED_SOLOMON_H_ */
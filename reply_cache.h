@@ -0,0 +1,150 @@
+/*
+ * reply_cache.h
+ *
+ *  중복 요청 응답 캐시 (송신자 ID, 시퀀스 번호, CMD) -> 응답 프레임 원본 바이트
+ *
+ *  응답이 유실되어 호스트가 같은 시퀀스 번호로 요청을 재전송하면 핸들러를 다시 실행하지 않고
+ *  저장해 둔 응답 바이트를 그대로 다시 보냅니다. 항목 수는 고정이며 clock(second chance) 방식으로 교체합니다.
+ *  요청 프레임 CRC 도 함께 비교하므로 시퀀스 번호가 한 바퀴 돈 뒤의 다른 요청과는 혼동하지 않습니다.
+ *
+ *  ReplyCache cache;
+ *  cache.resize(8);
+ *  ReplyCache::Entry* hit = cache.find(sender, seq, cmd, crc);
+ *  if (!hit) {
+ *      ReplyCache::Entry* entry = cache.insert(sender, seq, cmd, crc);
+ *      ... 핸들러 실행, 응답 바이트는 cache.append(entry, data, length) ...
+ *      cache.complete(entry);
+ *  }
+ */
+
+#ifndef COM_PROTOCOL_CLASS_REPLY_CACHE_H_
+#define COM_PROTOCOL_CLASS_REPLY_CACHE_H_
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+
+class ReplyCache {
+public:
+    static const size_t MAX_REPLY = 64;     // 항목당 응답 바이트 (제어 ACK, PONG 등 짧은 응답)
+    static const size_t MAX_ENTRIES = 64;
+
+    struct Entry {
+        uint16_t senderId;
+        uint16_t seq;
+        uint16_t cmd;
+        uint16_t requestCrc;    // 요청 프레임 CRC
+        bool valid;             // 핸들러 실행 완료 + 응답이 MAX_REPLY 이하
+        bool referenced;        // clock 교체 : 최근 적중
+        bool overflow;          // 응답이 MAX_REPLY 를 넘음 (저장 안 함)
+        uint8_t length;
+        uint8_t reply[MAX_REPLY];
+    };
+
+    ReplyCache() : entries_(nullptr), count_(0), hand_(0), hits_(0), evictions_(0) {}
+    ~ReplyCache() { delete[] entries_; }
+
+    // 항목 수 변경 (기존 내용 폐기), 0 : 사용 안 함
+    bool resize(size_t count) {
+        if (count > MAX_ENTRIES) return false;
+        delete[] entries_;
+        entries_ = count ? new Entry[count] : nullptr;
+        count_ = count;
+        hand_ = 0;
+        clear();
+        return true;
+    }
+
+    bool enabled() const { return count_ > 0; }
+    size_t size() const { return count_; }
+
+    void clear() {
+        for (size_t i = 0; i < count_; i++) {
+            entries_[i].valid = false;
+            entries_[i].referenced = false;
+        }
+    }
+
+    // 송신자가 세션을 다시 시작함 (CMD_SYNC) : 이전 세션의 시퀀스 번호는 더 이상 중복이 아님
+    void invalidateSender(uint16_t senderId) {
+        for (size_t i = 0; i < count_; i++) {
+            if (entries_[i].senderId == senderId) entries_[i].valid = false;
+        }
+    }
+
+    Entry* find(uint16_t senderId, uint16_t seq, uint16_t cmd, uint16_t requestCrc) {
+        for (size_t i = 0; i < count_; i++) {
+            Entry& entry = entries_[i];
+            if (entry.valid && entry.seq == seq && entry.senderId == senderId &&
+                entry.cmd == cmd && entry.requestCrc == requestCrc) {
+                entry.referenced = true;
+                hits_++;
+                return &entry;
+            }
+        }
+        return nullptr;
+    }
+
+    // 새 요청 기록 시작 : 빈 항목, 없으면 clock 바늘이 가리키는 최근 미적중 항목을 교체
+    Entry* insert(uint16_t senderId, uint16_t seq, uint16_t cmd, uint16_t requestCrc) {
+        if (!count_) return nullptr;
+
+        Entry* victim = nullptr;
+        for (size_t i = 0; i < count_; i++) {
+            if (!entries_[i].valid) {
+                victim = &entries_[i];
+                break;
+            }
+        }
+        while (!victim) {
+            Entry& entry = entries_[hand_];
+            hand_ = (hand_ + 1) % count_;
+            if (entry.referenced) {
+                entry.referenced = false;
+            } else {
+                victim = &entry;
+                evictions_++;
+            }
+        }
+
+        victim->senderId = senderId;
+        victim->seq = seq;
+        victim->cmd = cmd;
+        victim->requestCrc = requestCrc;
+        victim->valid = false;
+        victim->referenced = false;
+        victim->overflow = false;
+        victim->length = 0;
+        return victim;
+    }
+
+    void append(Entry* entry, const uint8_t* data, size_t length) {
+        if (!entry || entry->overflow) return;
+        if (length > MAX_REPLY - entry->length) {
+            entry->overflow = true;
+            return;
+        }
+        memcpy(entry->reply + entry->length, data, length);
+        entry->length = static_cast<uint8_t>(entry->length + length);
+    }
+
+    // 핸들러 종료 : 응답이 넘친 항목은 저장하지 않음 (중복 시 핸들러 재실행)
+    void complete(Entry* entry) {
+        if (entry) entry->valid = !entry->overflow;
+    }
+
+    uint32_t hits() const { return hits_; }
+    uint32_t evictions() const { return evictions_; }
+
+private:
+    Entry* entries_;
+    size_t count_;
+    size_t hand_;
+    uint32_t hits_;
+    uint32_t evictions_;
+
+    ReplyCache(const ReplyCache&);
+    ReplyCache& operator=(const ReplyCache&);
+};
+
+#endif /* COM_PROTOCOL_CLASS_REPLY_CACHE_H_ */
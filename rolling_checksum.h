@@ -0,0 +1,50 @@
+/*
+ * rolling_checksum.h
+ *
+ *  델타 전송용 약한 롤링 체크섬 (rsync 방식)
+ *   a = sum(x[i]), b = sum((L - i) * x[i])  (각각 mod 2^16), 값 = a | (b << 16)
+ *   한 바이트씩 밀 때 O(1) 로 갱신 : roll(나가는 바이트, 들어오는 바이트)
+ */
+
+#ifndef COM_PROTOCOL_CLASS_ROLLING_CHECKSUM_H_
+#define COM_PROTOCOL_CLASS_ROLLING_CHECKSUM_H_
+
+#include <stdint.h>
+#include <stddef.h>
+
+class RollingChecksum {
+public:
+    RollingChecksum() : a_(0), b_(0), length_(0) {}
+
+    void reset() { a_ = 0; b_ = 0; length_ = 0; }
+
+    // 블록 끝에 바이트 추가 (블록을 여러 조각으로 나눠 계산 가능)
+    void update(const uint8_t* data, size_t length) {
+        for (size_t i = 0; i < length; i++) {
+            a_ = static_cast<uint16_t>(a_ + data[i]);
+            b_ = static_cast<uint16_t>(b_ + a_);
+        }
+        length_ += static_cast<uint32_t>(length);
+    }
+
+    // 창을 한 바이트 이동 (창 길이 유지)
+    void roll(uint8_t out, uint8_t in) {
+        a_ = static_cast<uint16_t>(a_ - out + in);
+        b_ = static_cast<uint16_t>(b_ - length_ * out + a_);
+    }
+
+    uint32_t value() const { return static_cast<uint32_t>(a_) | (static_cast<uint32_t>(b_) << 16); }
+
+    static uint32_t of(const uint8_t* data, size_t length) {
+        RollingChecksum sum;
+        sum.update(data, length);
+        return sum.value();
+    }
+
+private:
+    uint16_t a_;
+    uint16_t b_;
+    uint32_t length_;
+};
+
+#endif /* COM_PROTOCOL_CLASS_ROLLING_CHECKSUM_H_ */
@@ -0,0 +1,130 @@
+/*
+ * sha256.h
+ *
+ *  SHA-256 (FIPS 180-4) 스트리밍 계산 : 파일 내용 식별용 해시
+ */
+
+#ifndef COM_PROTOCOL_CLASS_SHA256_H_
+#define COM_PROTOCOL_CLASS_SHA256_H_
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+
+// 헤더 전용 템플릿으로 두어 여러 번역 단위에서 include 해도 테이블은 하나만 링크됨
+template <typename T = void>
+struct Sha256Table {
+    static const uint32_t k[64];
+};
+
+template <typename T>
+const uint32_t Sha256Table<T>::k[64] = {
+    0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+    0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+    0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+    0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+    0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+    0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+    0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+    0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2
+};
+
+class Sha256 {
+public:
+    static const size_t DIGEST_SIZE = 32;
+
+    Sha256() { reset(); }
+
+    void reset() {
+        static const uint32_t init[8] = {
+            0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a, 0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19
+        };
+        memcpy(state_, init, sizeof(state_));
+        totalLength_ = 0;
+        bufferLength_ = 0;
+    }
+
+    void update(const uint8_t* data, size_t length) {
+        totalLength_ += length;
+        if (bufferLength_ > 0) {
+            size_t n = BLOCK_SIZE - bufferLength_ < length ? BLOCK_SIZE - bufferLength_ : length;
+            memcpy(buffer_ + bufferLength_, data, n);
+            bufferLength_ += n;
+            data += n;
+            length -= n;
+            if (bufferLength_ < BLOCK_SIZE) return;
+            transform(buffer_);
+            bufferLength_ = 0;
+        }
+        while (length >= BLOCK_SIZE) {
+            transform(data);
+            data += BLOCK_SIZE;
+            length -= BLOCK_SIZE;
+        }
+        memcpy(buffer_, data, length);
+        bufferLength_ = length;
+    }
+
+    // 호출 후 객체는 reset() 전까지 재사용 불가
+    void finish(uint8_t (&digest)[DIGEST_SIZE]) {
+        uint64_t bits = totalLength_ * 8;
+        uint8_t pad = 0x80;
+        update(&pad, 1);
+        pad = 0x00;
+        while (bufferLength_ != BLOCK_SIZE - 8) update(&pad, 1);
+
+        uint8_t length[8];
+        for (int i = 0; i < 8; i++) length[i] = static_cast<uint8_t>(bits >> (56 - 8 * i));
+        update(length, 8);
+
+        for (int i = 0; i < 8; i++) {
+            digest[i * 4] = static_cast<uint8_t>(state_[i] >> 24);
+            digest[i * 4 + 1] = static_cast<uint8_t>(state_[i] >> 16);
+            digest[i * 4 + 2] = static_cast<uint8_t>(state_[i] >> 8);
+            digest[i * 4 + 3] = static_cast<uint8_t>(state_[i]);
+        }
+    }
+
+    static void hash(const uint8_t* data, size_t length, uint8_t (&digest)[DIGEST_SIZE]) {
+        Sha256 sha;
+        sha.update(data, length);
+        sha.finish(digest);
+    }
+
+private:
+    static const size_t BLOCK_SIZE = 64;
+
+    uint32_t state_[8];
+    uint64_t totalLength_;
+    uint8_t buffer_[BLOCK_SIZE];
+    size_t bufferLength_;
+
+    static uint32_t rotr(uint32_t x, int n) { return (x >> n) | (x << (32 - n)); }
+
+    void transform(const uint8_t* block) {
+        uint32_t w[64];
+        for (int i = 0; i < 16; i++) {
+            w[i] = (uint32_t(block[i * 4]) << 24) | (uint32_t(block[i * 4 + 1]) << 16) |
+                   (uint32_t(block[i * 4 + 2]) << 8) | uint32_t(block[i * 4 + 3]);
+        }
+        for (int i = 16; i < 64; i++) {
+            uint32_t s0 = rotr(w[i - 15], 7) ^ rotr(w[i - 15], 18) ^ (w[i - 15] >> 3);
+            uint32_t s1 = rotr(w[i - 2], 17) ^ rotr(w[i - 2], 19) ^ (w[i - 2] >> 10);
+            w[i] = w[i - 16] + s0 + w[i - 7] + s1;
+        }
+
+        uint32_t a = state_[0], b = state_[1], c = state_[2], d = state_[3];
+        uint32_t e = state_[4], f = state_[5], g = state_[6], h = state_[7];
+        for (int i = 0; i < 64; i++) {
+            uint32_t t1 = h + (rotr(e, 6) ^ rotr(e, 11) ^ rotr(e, 25)) + ((e & f) ^ (~e & g)) +
+                          Sha256Table<>::k[i] + w[i];
+            uint32_t t2 = (rotr(a, 2) ^ rotr(a, 13) ^ rotr(a, 22)) + ((a & b) ^ (a & c) ^ (b & c));
+            h = g; g = f; f = e; e = d + t1;
+            d = c; c = b; b = a; a = t1 + t2;
+        }
+        state_[0] += a; state_[1] += b; state_[2] += c; state_[3] += d;
+        state_[4] += e; state_[5] += f; state_[6] += g; state_[7] += h;
+    }
+};
+
+#endif /* COM_PROTOCOL_CLASS_SHA256_H_ */